@@ -51,6 +51,10 @@ public class Cocos2dxLocalStorage {
     		TABLE_NAME = tableName;
     		mDatabaseOpenHelper = new DBOpenHelper(Cocos2dxActivity.getContext());
     		mDatabase = mDatabaseOpenHelper.getWritableDatabase();
+    		// with a write-ahead log, a commit appends to the log instead of rewriting the database and its journal
+    		if (android.os.Build.VERSION.SDK_INT >= 11) {
+    			mDatabase.enableWriteAheadLogging();
+    		}
     		return true;
     	}
         return false;
@@ -71,6 +75,33 @@ public class Cocos2dxLocalStorage {
     	}
     }
     
+    /**
+     * Sets several items in a single transaction. The items with a null value are removed.
+     * @return false if the transaction was rolled back
+     */
+    public static boolean setItems(String[] keys, String[] values) {
+    	boolean succeeded = false;
+    	mDatabase.beginTransaction();
+    	try {
+    		String replaceSql = "replace into "+TABLE_NAME+"(key,value)values(?,?)";
+    		String deleteSql = "delete from "+TABLE_NAME+" where key=?";
+    		for (int i = 0; i < keys.length; i++) {
+    			if (values[i] != null) {
+    				mDatabase.execSQL(replaceSql, new Object[] { keys[i], values[i] });
+    			} else {
+    				mDatabase.execSQL(deleteSql, new Object[] { keys[i] });
+    			}
+    		}
+    		mDatabase.setTransactionSuccessful();
+    		succeeded = true;
+    	} catch (Exception e) {
+    		e.printStackTrace();
+    	} finally {
+    		mDatabase.endTransaction();
+    	}
+    	return succeeded;
+    }
+    
     public static String getItem(String key) {
     	String ret = null;
     	try {
@@ -43,6 +43,7 @@ THE SOFTWARE.
 #include "layers_scenes_transitions_nodes/CCTransition.h"
 #include "textures/CCTextureCache.h"
 #include "sprite_nodes/CCSpriteFrameCache.h"
+#include "sprite_nodes/CCAutoBatcher.h"
 #include "cocoa/CCAutoreleasePool.h"
 #include "platform/platform.h"
 #include "platform/CCFileUtils.h"
@@ -284,6 +285,9 @@ void CCDirector::drawScene(void)
     {
         showStats();
     }
+
+    // draw the sprites still queued
+    CCAutoBatcher::flushShared();
     
     kmGLPopMatrix();
 
@@ -734,12 +738,14 @@ void CCDirector::purgeDirector()
     CCAnimationCache::purgeSharedAnimationCache();
     CCSpriteFrameCache::purgeSharedSpriteFrameCache();
     CCTextureCache::purgeSharedTextureCache();
+    CCAutoBatcher::purgeSharedAutoBatcher();
     CCShaderCache::purgeSharedShaderCache();
+    // saves the values with the file utils, which are purged next
+    CCUserDefault::purgeSharedUserDefault();
     CCFileUtils::purgeFileUtils();
     CCConfiguration::purgeConfiguration();
 
     // cocos2d-x specific data structures
-    CCUserDefault::purgeSharedUserDefault();
     CCNotificationCenter::purgeNotificationCenter();
 
     ccGLInvalidateStateCache();
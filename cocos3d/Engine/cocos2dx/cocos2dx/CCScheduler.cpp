@@ -27,10 +27,14 @@ THE SOFTWARE.
 #include "CCScheduler.h"
 #include "ccMacros.h"
 #include "CCDirector.h"
-#include "support/data_support/utlist.h"
 #include "support/data_support/ccCArray.h"
 #include "cocoa/CCArray.h"
 #include "script_support/CCScriptSupport.h"
+#include <algorithm>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
+#include <windows.h>
+#endif
 
 using namespace std;
 
@@ -38,21 +42,20 @@ NS_CC_BEGIN
 
 // data structures
 
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry
+// An entry of the array used for "updates with priority"
+typedef struct _updateEntry
 {
-    struct _listEntry   *prev, *next;
-    CCObject            *target;        // not retained (retained by hashUpdateEntry)
-    int                 priority;
-    bool                paused;
-    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
+    CCObject                *target;        // retained, NULL once removed
+    struct _hashUpdateEntry *hashEntry;     // NULL once removed
+    int                     priority;
+    bool                    paused;
+    bool                    markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
+} tUpdateEntry;
 
 typedef struct _hashUpdateEntry
 {
-    tListEntry          **list;        // Which list does it belong to ?
-    tListEntry          *entry;        // entry in the list
-    CCObject            *target;        // hash key (retained)
+    unsigned int        index;          // index of the entry in the updates array
+    CCObject            *target;        // hash key (retained by the entry)
     UT_hash_handle      hh;
 } tHashUpdateEntry;
 
@@ -61,13 +64,38 @@ typedef struct _hashSelectorEntry
 {
     ccArray             *timers;
     CCObject            *target;    // hash key (retained)
-    unsigned int        timerIndex;
-    CCTimer             *currentTimer;
-    bool                currentTimerSalvaged;
     bool                paused;
     UT_hash_handle      hh;
 } tHashTimerEntry;
 
+// A callback posted by another thread
+typedef struct _performEntry
+{
+    struct _performEntry    *next;
+    SEL_CallFuncO           selector;
+    CCObject                *target;
+    CCObject                *object;
+    void                    (*function)(void*);
+    void                    *userData;
+} tPerformEntry;
+
+// Lists holding a CCTimer, besides the slots of the timer wheel
+enum {
+    kCCTimerListNone = -1,      // not in any list: unscheduled, paused, or not scheduled by a CCScheduler
+    kCCTimerListDue = -2,       // tick reached, compared against the exact due time each frame
+    kCCTimerListNew = -3,       // starts counting at the end of the next update
+    kCCTimerListFiring = -4,    // being fired by the current update
+};
+
+static inline bool ccCompareAndSwapPerformEntry(tPerformEntry * volatile *ppHead, tPerformEntry *pOld, tPerformEntry *pNew)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
+    return InterlockedCompareExchangePointer((PVOID volatile *)ppHead, pNew, pOld) == pOld;
+#else
+    return __sync_bool_compare_and_swap(ppHead, pOld, pNew);
+#endif
+}
+
 // implementation CCTimer
 
 CCTimer::CCTimer()
@@ -81,6 +109,12 @@ CCTimer::CCTimer()
 , m_fInterval(0.0f)
 , m_pfnSelector(NULL)
 , m_nScriptHandler(0)
+, m_dStartTime(0)
+, m_dDueTime(0)
+, m_pWheelPrev(NULL)
+, m_pWheelNext(NULL)
+, m_nWheelSlot(kCCTimerListNone)
+, m_uScheduleOrder(0)
 {
 }
 
@@ -141,6 +175,19 @@ bool CCTimer::initWithTarget(CCObject *pTarget, SEL_SCHEDULE pfnSelector, float
     return true;
 }
 
+void CCTimer::trigger(float dt)
+{
+    if (m_pTarget && m_pfnSelector)
+    {
+        (m_pTarget->*m_pfnSelector)(dt);
+    }
+
+    if (m_nScriptHandler)
+    {
+        CCScriptEngineManager::sharedManager()->getScriptEngine()->executeSchedule(m_nScriptHandler, dt);
+    }
+}
+
 void CCTimer::update(float dt)
 {
     if (m_fElapsed == -1)
@@ -155,15 +202,7 @@ void CCTimer::update(float dt)
             m_fElapsed += dt;
             if (m_fElapsed >= m_fInterval)
             {
-                if (m_pTarget && m_pfnSelector)
-                {
-                    (m_pTarget->*m_pfnSelector)(m_fElapsed);
-                }
-
-                if (m_nScriptHandler)
-                {
-                    CCScriptEngineManager::sharedManager()->getScriptEngine()->executeSchedule(m_nScriptHandler, m_fElapsed);
-                }
+                trigger(m_fElapsed);
                 m_fElapsed = 0;
             }
         }    
@@ -174,15 +213,7 @@ void CCTimer::update(float dt)
             {
                 if( m_fElapsed >= m_fDelay )
                 {
-                    if (m_pTarget && m_pfnSelector)
-                    {
-                        (m_pTarget->*m_pfnSelector)(m_fElapsed);
-                    }
-
-                    if (m_nScriptHandler)
-                    {
-                        CCScriptEngineManager::sharedManager()->getScriptEngine()->executeSchedule(m_nScriptHandler, m_fElapsed);
-                    }
+                    trigger(m_fElapsed);
 
                     m_fElapsed = m_fElapsed - m_fDelay;
                     m_uTimesExecuted += 1;
@@ -193,15 +224,7 @@ void CCTimer::update(float dt)
             {
                 if (m_fElapsed >= m_fInterval)
                 {
-                    if (m_pTarget && m_pfnSelector)
-                    {
-                        (m_pTarget->*m_pfnSelector)(m_fElapsed);
-                    }
-
-                    if (m_nScriptHandler)
-                    {
-                        CCScriptEngineManager::sharedManager()->getScriptEngine()->executeSchedule(m_nScriptHandler, m_fElapsed);
-                    }
+                    trigger(m_fElapsed);
 
                     m_fElapsed = 0;
                     m_uTimesExecuted += 1;
@@ -236,23 +259,44 @@ SEL_SCHEDULE CCTimer::getSelector() const
 
 CCScheduler::CCScheduler(void)
 : m_fTimeScale(1.0f)
-, m_pUpdatesNegList(NULL)
-, m_pUpdates0List(NULL)
-, m_pUpdatesPosList(NULL)
+, m_pUpdates(NULL)
+, m_uUpdatesCount(0)
+, m_uUpdatesCapacity(0)
+, m_uRemovedUpdates(0)
+, m_uCurrentUpdate(0)
 , m_pHashForUpdates(NULL)
 , m_pHashForTimers(NULL)
 , m_pCurrentTarget(NULL)
 , m_bCurrentTargetSalvaged(false)
 , m_bUpdateHashLocked(false)
 , m_pScriptHandlerEntries(NULL)
+, m_dTime(0)
+, m_uWheelTick(0)
+, m_pDueTimers(NULL)
+, m_pNewTimers(NULL)
+, m_pFiringTimers(NULL)
+, m_uTimersScheduled(0)
+, m_pFunctionsToPerform(NULL)
 {
-
+    memset(m_pTimerWheel, 0, sizeof(m_pTimerWheel));
+    m_pFiringTimers = ccArrayNew(16);
 }
 
 CCScheduler::~CCScheduler(void)
 {
     unscheduleAll();
     CC_SAFE_RELEASE(m_pScriptHandlerEntries);
+    ccArrayFree(m_pFiringTimers);
+    free(m_pUpdates);
+
+    // the callbacks that were never performed
+    tPerformEntry *pEntry = m_pFunctionsToPerform;
+    while (pEntry)
+    {
+        tPerformEntry *pNext = pEntry->next;
+        delete pEntry;
+        pEntry = pNext;
+    }
 }
 
 void CCScheduler::removeHashElement(_hashSelectorEntry *pElement)
@@ -260,6 +304,10 @@ void CCScheduler::removeHashElement(_hashSelectorEntry *pElement)
 
 	cocos2d::CCObject *target = pElement->target;
 
+    for (unsigned int i = 0; i < pElement->timers->num; ++i)
+    {
+        unlinkTimer((CCTimer*)pElement->timers->arr[i]);
+    }
     ccArrayFree(pElement->timers);
     HASH_DEL(m_pHashForTimers, pElement);
     free(pElement);
@@ -316,6 +364,13 @@ void CCScheduler::scheduleSelector(SEL_SCHEDULE pfnSelector, CCObject *pTarget,
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), fInterval);
                 timer->setInterval(fInterval);
+
+                // the due time of a running timer depends on its interval
+                if (timer->m_nWheelSlot >= 0 || timer->m_nWheelSlot == kCCTimerListDue)
+                {
+                    unlinkTimer(timer);
+                    insertTimer(timer);
+                }
                 return;
             }        
         }
@@ -324,8 +379,14 @@ void CCScheduler::scheduleSelector(SEL_SCHEDULE pfnSelector, CCObject *pTarget,
 
     CCTimer *pTimer = new CCTimer();
     pTimer->initWithTarget(pTarget, pfnSelector, fInterval, repeat, delay);
+    pTimer->m_uScheduleOrder = m_uTimersScheduled++;
     ccArrayAppendObject(pElement->timers, pTimer);
     pTimer->release();    
+
+    if (! pElement->paused)
+    {
+        linkTimer(pTimer, kCCTimerListNew);
+    }
 }
 
 void CCScheduler::unscheduleSelector(SEL_SCHEDULE pfnSelector, CCObject *pTarget)
@@ -350,20 +411,10 @@ void CCScheduler::unscheduleSelector(SEL_SCHEDULE pfnSelector, CCObject *pTarget
 
             if (pfnSelector == pTimer->getSelector())
             {
-                if (pTimer == pElement->currentTimer && (! pElement->currentTimerSalvaged))
-                {
-                    pElement->currentTimer->retain();
-                    pElement->currentTimerSalvaged = true;
-                }
-
+                // a timer being fired is retained by m_pFiringTimers until its step is done
+                unlinkTimer(pTimer);
                 ccArrayRemoveObjectAtIndex(pElement->timers, i, true);
 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (pElement->timerIndex >= i)
-                {
-                    pElement->timerIndex--;
-                }
-
                 if (pElement->timers->num == 0)
                 {
                     if (m_pCurrentTarget == pElement)
@@ -382,80 +433,71 @@ void CCScheduler::unscheduleSelector(SEL_SCHEDULE pfnSelector, CCObject *pTarget
     }
 }
 
-void CCScheduler::priorityIn(tListEntry **ppList, CCObject *pTarget, int nPriority, bool bPaused)
+void CCScheduler::insertUpdate(CCObject *pTarget, int nPriority, bool bPaused)
 {
-    tListEntry *pListElement = (tListEntry *)malloc(sizeof(*pListElement));
-
-    pListElement->target = pTarget;
-    pListElement->priority = nPriority;
-    pListElement->paused = bPaused;
-    pListElement->next = pListElement->prev = NULL;
-    pListElement->markedForDeletion = false;
-
-    // empty list ?
-    if (! *ppList)
+    if (m_uUpdatesCount == m_uUpdatesCapacity)
     {
-        DL_APPEND(*ppList, pListElement);
+        // the entries can't move while they are being updated
+        if (m_uRemovedUpdates > 0 && ! m_bUpdateHashLocked)
+        {
+            compactUpdates();
+        }
+        if (m_uUpdatesCount == m_uUpdatesCapacity)
+        {
+            m_uUpdatesCapacity = MAX(64, m_uUpdatesCapacity * 2);
+            m_pUpdates = (tUpdateEntry *)realloc(m_pUpdates, m_uUpdatesCapacity * sizeof(tUpdateEntry));
+        }
     }
-    else
-    {
-        bool bAdded = false;
 
-        for (tListEntry *pElement = *ppList; pElement; pElement = pElement->next)
+    // after all the entries with a lower or equal priority.
+    // most of the updates are going to be 0 and are simply appended
+    unsigned int uIndex = m_uUpdatesCount;
+    if (uIndex > 0 && m_pUpdates[uIndex - 1].priority > nPriority)
+    {
+        unsigned int uLow = 0;
+        while (uLow < uIndex)
         {
-            if (nPriority < pElement->priority)
+            unsigned int uMid = uLow + (uIndex - uLow) / 2;
+            if (m_pUpdates[uMid].priority <= nPriority)
             {
-                if (pElement == *ppList)
-                {
-                    DL_PREPEND(*ppList, pListElement);
-                }
-                else
-                {
-                    pListElement->next = pElement;
-                    pListElement->prev = pElement->prev;
-
-                    pElement->prev->next = pListElement;
-                    pElement->prev = pListElement;
-                }
+                uLow = uMid + 1;
+            }
+            else
+            {
+                uIndex = uMid;
+            }
+        }
 
-                bAdded = true;
-                break;
+        memmove(&m_pUpdates[uIndex + 1], &m_pUpdates[uIndex], (m_uUpdatesCount - uIndex) * sizeof(tUpdateEntry));
+        for (unsigned int i = uIndex + 1; i <= m_uUpdatesCount; ++i)
+        {
+            if (m_pUpdates[i].hashEntry)
+            {
+                m_pUpdates[i].hashEntry->index = i;
             }
         }
 
-        // Not added? priority has the higher value. Append it.
-        if (! bAdded)
+        // don't update the current entry twice if this happens during the update loop
+        if (m_bUpdateHashLocked && uIndex <= m_uCurrentUpdate)
         {
-            DL_APPEND(*ppList, pListElement);
+            ++m_uCurrentUpdate;
         }
     }
+    ++m_uUpdatesCount;
 
     // update hash entry for quick access
     tHashUpdateEntry *pHashElement = (tHashUpdateEntry *)calloc(sizeof(*pHashElement), 1);
     pHashElement->target = pTarget;
-    pTarget->retain();
-    pHashElement->list = ppList;
-    pHashElement->entry = pListElement;
+    pHashElement->index = uIndex;
     HASH_ADD_INT(m_pHashForUpdates, target, pHashElement);
-}
-
-void CCScheduler::appendIn(_listEntry **ppList, CCObject *pTarget, bool bPaused)
-{
-    tListEntry *pListElement = (tListEntry *)malloc(sizeof(*pListElement));
-
-    pListElement->target = pTarget;
-    pListElement->paused = bPaused;
-    pListElement->markedForDeletion = false;
-
-    DL_APPEND(*ppList, pListElement);
 
-    // update hash entry for quicker access
-    tHashUpdateEntry *pHashElement = (tHashUpdateEntry *)calloc(sizeof(*pHashElement), 1);
-    pHashElement->target = pTarget;
+    tUpdateEntry *pEntry = &m_pUpdates[uIndex];
+    pEntry->target = pTarget;
     pTarget->retain();
-    pHashElement->list = ppList;
-    pHashElement->entry = pListElement;
-    HASH_ADD_INT(m_pHashForUpdates, target, pHashElement);
+    pEntry->hashEntry = pHashElement;
+    pEntry->priority = nPriority;
+    pEntry->paused = bPaused;
+    pEntry->markedForDeletion = false;
 }
 
 void CCScheduler::scheduleUpdateForTarget(CCObject *pTarget, int nPriority, bool bPaused)
@@ -465,52 +507,61 @@ void CCScheduler::scheduleUpdateForTarget(CCObject *pTarget, int nPriority, bool
     HASH_FIND_INT(m_pHashForUpdates, &pTarget, pHashElement);
     if (pHashElement)
     {
+        tUpdateEntry *pEntry = &m_pUpdates[pHashElement->index];
 #if COCOS2D_DEBUG >= 1
-        CCAssert(pHashElement->entry->markedForDeletion,"");
+        CCAssert(pEntry->markedForDeletion,"");
 #endif
         // TODO: check if priority has changed!
-        pHashElement->entry->paused = bPaused;
-        pHashElement->entry->markedForDeletion = false;
+        pEntry->paused = bPaused;
+        pEntry->markedForDeletion = false;
         return;
     }
 
-    // most of the updates are going to be 0, that's way there
-    // is an special list for updates with priority 0
-    if (nPriority == 0)
-    {
-        appendIn(&m_pUpdates0List, pTarget, bPaused);
-    }
-    else if (nPriority < 0)
-    {
-        priorityIn(&m_pUpdatesNegList, pTarget, nPriority, bPaused);
-    }
-    else
-    {
-        // priority > 0
-        priorityIn(&m_pUpdatesPosList, pTarget, nPriority, bPaused);
-    }
+    insertUpdate(pTarget, nPriority, bPaused);
 }
 
-void CCScheduler::removeUpdateFromHash(struct _listEntry *entry)
+void CCScheduler::removeUpdate(unsigned int uIndex)
 {
-    tHashUpdateEntry *element = NULL;
+    // the entry is left in place with a NULL target, so that the other entries don't move until compactUpdates()
+    tUpdateEntry *pEntry = &m_pUpdates[uIndex];
+    CCObject* pTarget = pEntry->target;
 
-    HASH_FIND_INT(m_pHashForUpdates, &entry->target, element);
-    if (element)
-    {
-        // list entry
-        DL_DELETE(*element->list, element->entry);
-        free(element->entry);
+    HASH_DEL(m_pHashForUpdates, pEntry->hashEntry);
+    free(pEntry->hashEntry);
+
+    pEntry->hashEntry = NULL;
+    pEntry->target = NULL;
+    pEntry->markedForDeletion = true;
+    ++m_uRemovedUpdates;
 
-        // hash entry
-        CCObject* pTarget = element->target;
-        HASH_DEL(m_pHashForUpdates, element);
-        free(element);
+    // target#release should be the last one to prevent
+    // a possible double-free. eg: If the [target dealloc] might want to remove it itself from there
+    pTarget->release();
+}
 
-        // target#release should be the last one to prevent
-        // a possible double-free. eg: If the [target dealloc] might want to remove it itself from there
-        pTarget->release();
+void CCScheduler::compactUpdates()
+{
+    if (m_uRemovedUpdates == 0)
+    {
+        return;
     }
+
+    unsigned int uCount = 0;
+    for (unsigned int i = 0; i < m_uUpdatesCount; ++i)
+    {
+        if (m_pUpdates[i].target)
+        {
+            if (uCount != i)
+            {
+                m_pUpdates[uCount] = m_pUpdates[i];
+                m_pUpdates[uCount].hashEntry->index = uCount;
+            }
+            ++uCount;
+        }
+    }
+
+    m_uUpdatesCount = uCount;
+    m_uRemovedUpdates = 0;
 }
 
 void CCScheduler::unscheduleUpdateForTarget(const CCObject *pTarget)
@@ -526,11 +577,11 @@ void CCScheduler::unscheduleUpdateForTarget(const CCObject *pTarget)
     {
         if (m_bUpdateHashLocked)
         {
-            pElement->entry->markedForDeletion = true;
+            m_pUpdates[pElement->index].markedForDeletion = true;
         }
         else
         {
-            this->removeUpdateFromHash(pElement->entry);
+            this->removeUpdate(pElement->index);
         }
     }
 }
@@ -555,31 +606,11 @@ void CCScheduler::unscheduleAllWithMinPriority(int nMinPriority)
     }
 
     // Updates selectors
-    tListEntry *pEntry, *pTmp;
-    if(nMinPriority < 0) 
+    for (unsigned int i = 0; i < m_uUpdatesCount; ++i)
     {
-        DL_FOREACH_SAFE(m_pUpdatesNegList, pEntry, pTmp)
+        if (m_pUpdates[i].target && m_pUpdates[i].priority >= nMinPriority)
         {
-            if(pEntry->priority >= nMinPriority) 
-            {
-                unscheduleUpdateForTarget(pEntry->target);
-            }
-        }
-    }
-
-    if(nMinPriority <= 0) 
-    {
-        DL_FOREACH_SAFE(m_pUpdates0List, pEntry, pTmp)
-        {
-            unscheduleUpdateForTarget(pEntry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE(m_pUpdatesPosList, pEntry, pTmp)
-    {
-        if(pEntry->priority >= nMinPriority) 
-        {
-            unscheduleUpdateForTarget(pEntry->target);
+            unscheduleUpdateForTarget(m_pUpdates[i].target);
         }
     }
 
@@ -603,11 +634,9 @@ void CCScheduler::unscheduleAllForTarget(CCObject *pTarget)
 
     if (pElement)
     {
-        if (ccArrayContainsObject(pElement->timers, pElement->currentTimer)
-            && (! pElement->currentTimerSalvaged))
+        for (unsigned int i = 0; i < pElement->timers->num; ++i)
         {
-            pElement->currentTimer->retain();
-            pElement->currentTimerSalvaged = true;
+            unlinkTimer((CCTimer*)pElement->timers->arr[i]);
         }
         ccArrayRemoveAllObjects(pElement->timers);
 
@@ -659,7 +688,7 @@ void CCScheduler::resumeTarget(CCObject *pTarget)
     HASH_FIND_INT(m_pHashForTimers, &pTarget, pElement);
     if (pElement)
     {
-        pElement->paused = false;
+        setTimersPaused(pElement, false);
     }
 
     // update selector
@@ -667,8 +696,7 @@ void CCScheduler::resumeTarget(CCObject *pTarget)
     HASH_FIND_INT(m_pHashForUpdates, &pTarget, pElementUpdate);
     if (pElementUpdate)
     {
-        CCAssert(pElementUpdate->entry != NULL, "");
-        pElementUpdate->entry->paused = false;
+        m_pUpdates[pElementUpdate->index].paused = false;
     }
 }
 
@@ -681,7 +709,7 @@ void CCScheduler::pauseTarget(CCObject *pTarget)
     HASH_FIND_INT(m_pHashForTimers, &pTarget, pElement);
     if (pElement)
     {
-        pElement->paused = true;
+        setTimersPaused(pElement, true);
     }
 
     // update selector
@@ -689,8 +717,7 @@ void CCScheduler::pauseTarget(CCObject *pTarget)
     HASH_FIND_INT(m_pHashForUpdates, &pTarget, pElementUpdate);
     if (pElementUpdate)
     {
-        CCAssert(pElementUpdate->entry != NULL, "");
-        pElementUpdate->entry->paused = true;
+        m_pUpdates[pElementUpdate->index].paused = true;
     }
 }
 
@@ -711,7 +738,7 @@ bool CCScheduler::isTargetPaused(CCObject *pTarget)
 	HASH_FIND_INT(m_pHashForUpdates, &pTarget, elementUpdate);
 	if ( elementUpdate )
     {
-		return elementUpdate->entry->paused;
+		return m_pUpdates[elementUpdate->index].paused;
     }
     
     return false;  // should never get here
@@ -731,132 +758,422 @@ CCSet* CCScheduler::pauseAllTargetsWithMinPriority(int nMinPriority)
     for(tHashTimerEntry *element = m_pHashForTimers; element != NULL;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        setTimersPaused(element, true);
         idsWithSelectors->addObject(element->target);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(nMinPriority < 0) 
+    for (unsigned int i = 0; i < m_uUpdatesCount; ++i)
     {
-        DL_FOREACH_SAFE( m_pUpdatesNegList, entry, tmp ) 
+        tUpdateEntry *entry = &m_pUpdates[i];
+        if (entry->target && entry->priority >= nMinPriority)
         {
-            if(entry->priority >= nMinPriority) 
-            {
-                entry->paused = true;
-                idsWithSelectors->addObject(entry->target);
-            }
+            entry->paused = true;
+            idsWithSelectors->addObject(entry->target);
         }
     }
 
-    if(nMinPriority <= 0) 
+    return idsWithSelectors;
+}
+
+void CCScheduler::resumeTargets(CCSet* pTargetsToResume)
+{
+    CCSetIterator iter;
+    for (iter = pTargetsToResume->begin(); iter != pTargetsToResume->end(); ++iter)
+    {
+        resumeTarget(*iter);
+    }
+}
+
+// timer wheel
+
+CCTimer** CCScheduler::timerList(int nSlot)
+{
+    if (nSlot >= 0)
+    {
+        return &m_pTimerWheel[nSlot];
+    }
+    else if (nSlot == kCCTimerListDue)
+    {
+        return &m_pDueTimers;
+    }
+    else if (nSlot == kCCTimerListNew)
+    {
+        return &m_pNewTimers;
+    }
+    return NULL;
+}
+
+void CCScheduler::linkTimer(CCTimer *pTimer, int nSlot)
+{
+    pTimer->m_nWheelSlot = nSlot;
+    pTimer->m_pWheelPrev = NULL;
+    pTimer->m_pWheelNext = NULL;
+
+    CCTimer **ppList = timerList(nSlot);
+    if (ppList)
     {
-        DL_FOREACH_SAFE( m_pUpdates0List, entry, tmp )
+        pTimer->m_pWheelNext = *ppList;
+        if (*ppList)
         {
-            entry->paused = true;
-            idsWithSelectors->addObject(entry->target);
+            (*ppList)->m_pWheelPrev = pTimer;
         }
+        *ppList = pTimer;
     }
+}
 
-    DL_FOREACH_SAFE( m_pUpdatesPosList, entry, tmp ) 
+void CCScheduler::unlinkTimer(CCTimer *pTimer)
+{
+    CCTimer **ppList = timerList(pTimer->m_nWheelSlot);
+    if (ppList)
     {
-        if(entry->priority >= nMinPriority) 
+        if (pTimer->m_pWheelPrev)
         {
-            entry->paused = true;
-            idsWithSelectors->addObject(entry->target);
+            pTimer->m_pWheelPrev->m_pWheelNext = pTimer->m_pWheelNext;
+        }
+        else
+        {
+            *ppList = pTimer->m_pWheelNext;
+        }
+        if (pTimer->m_pWheelNext)
+        {
+            pTimer->m_pWheelNext->m_pWheelPrev = pTimer->m_pWheelPrev;
         }
     }
 
-    return idsWithSelectors;
+    pTimer->m_nWheelSlot = kCCTimerListNone;
+    pTimer->m_pWheelPrev = NULL;
+    pTimer->m_pWheelNext = NULL;
 }
 
-void CCScheduler::resumeTargets(CCSet* pTargetsToResume)
+void CCScheduler::insertTimer(CCTimer *pTimer)
 {
-    CCSetIterator iter;
-    for (iter = pTargetsToResume->begin(); iter != pTargetsToResume->end(); ++iter)
+    pTimer->m_dDueTime = pTimer->m_dStartTime + (pTimer->m_bUseDelay ? pTimer->m_fDelay : pTimer->m_fInterval);
+
+    unsigned long long uDueTick = (unsigned long long)(pTimer->m_dDueTime * kCCTimerWheelTicksPerSecond);
+    if (uDueTick <= m_uWheelTick)
     {
-        resumeTarget(*iter);
+        linkTimer(pTimer, kCCTimerListDue);
+        return;
+    }
+
+    // the level is the first one whose span covers the delay, the slot in that level is given by the due tick
+    unsigned long long uDelta = uDueTick - m_uWheelTick;
+    int nLevel = 0;
+    while (nLevel < kCCTimerWheelLevels - 1 && uDelta >= (1ULL << (kCCTimerWheelSlotBits * (nLevel + 1))))
+    {
+        ++nLevel;
+    }
+    if (uDelta >= (1ULL << (kCCTimerWheelSlotBits * kCCTimerWheelLevels)))
+    {
+        // beyond the span of the wheel: parked in its farthest slot, and inserted again from there
+        uDueTick = m_uWheelTick + (1ULL << (kCCTimerWheelSlotBits * kCCTimerWheelLevels)) - 1;
     }
+
+    int nSlot = (int)((uDueTick >> (kCCTimerWheelSlotBits * nLevel)) & (kCCTimerWheelSlots - 1));
+    linkTimer(pTimer, nLevel * kCCTimerWheelSlots + nSlot);
 }
 
-// main loop
-void CCScheduler::update(float dt)
+void CCScheduler::startTimer(CCTimer *pTimer)
 {
-    m_bUpdateHashLocked = true;
+    pTimer->m_fElapsed = 0;
+    pTimer->m_uTimesExecuted = 0;
+    pTimer->m_dStartTime = m_dTime;
+    insertTimer(pTimer);
+}
 
-    if (m_fTimeScale != 1.0f)
+void CCScheduler::setTimersPaused(tHashTimerEntry *pElement, bool bPaused)
+{
+    if (pElement->paused == bPaused)
     {
-        dt *= m_fTimeScale;
+        return;
     }
+    pElement->paused = bPaused;
 
-    // Iterate over all the Updates' selectors
-    tListEntry *pEntry, *pTmp;
-
-    // updates with priority < 0
-    DL_FOREACH_SAFE(m_pUpdatesNegList, pEntry, pTmp)
+    for (unsigned int i = 0; i < pElement->timers->num; ++i)
     {
-        if ((! pEntry->paused) && (! pEntry->markedForDeletion))
+        CCTimer *pTimer = (CCTimer*)pElement->timers->arr[i];
+
+        // a timer being fired checks whether its target is paused once its step is done
+        if (pTimer->m_nWheelSlot == kCCTimerListFiring)
         {
-            pEntry->target->update(dt);
+            continue;
+        }
+
+        if (bPaused)
+        {
+            // the elapsed time is frozen while paused
+            if (pTimer->m_nWheelSlot != kCCTimerListNew)
+            {
+                pTimer->m_fElapsed = (float)(m_dTime - pTimer->m_dStartTime);
+            }
+            unlinkTimer(pTimer);
+        }
+        else if (pTimer->m_fElapsed == -1)
+        {
+            linkTimer(pTimer, kCCTimerListNew);
+        }
+        else
+        {
+            pTimer->m_dStartTime = m_dTime - pTimer->m_fElapsed;
+            insertTimer(pTimer);
         }
     }
+}
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(m_pUpdates0List, pEntry, pTmp)
+void CCScheduler::advanceTimerWheel()
+{
+    unsigned long long uTick = (unsigned long long)(m_dTime * kCCTimerWheelTicksPerSecond);
+    while (m_uWheelTick < uTick)
     {
-        if ((! pEntry->paused) && (! pEntry->markedForDeletion))
+        ++m_uWheelTick;
+
+        // when a level completes a turn, the next slot of the level above is spread over the levels below
+        for (int nLevel = 1; nLevel < kCCTimerWheelLevels; ++nLevel)
         {
-            pEntry->target->update(dt);
+            int nShift = kCCTimerWheelSlotBits * nLevel;
+            if (m_uWheelTick & ((1ULL << nShift) - 1))
+            {
+                break;
+            }
+
+            CCTimer **ppList = &m_pTimerWheel[nLevel * kCCTimerWheelSlots + ((m_uWheelTick >> nShift) & (kCCTimerWheelSlots - 1))];
+            CCTimer *pTimer = *ppList;
+            *ppList = NULL;
+            while (pTimer)
+            {
+                CCTimer *pNext = pTimer->m_pWheelNext;
+                insertTimer(pTimer);
+                pTimer = pNext;
+            }
+        }
+
+        CCTimer **ppList = &m_pTimerWheel[m_uWheelTick & (kCCTimerWheelSlots - 1)];
+        CCTimer *pTimer = *ppList;
+        *ppList = NULL;
+        while (pTimer)
+        {
+            CCTimer *pNext = pTimer->m_pWheelNext;
+            linkTimer(pTimer, kCCTimerListDue);
+            pTimer = pNext;
         }
     }
+}
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(m_pUpdatesPosList, pEntry, pTmp)
+bool CCScheduler::compareFiringTimers(CCObject *pObject1, CCObject *pObject2)
+{
+    CCTimer *pTimer1 = (CCTimer*)pObject1;
+    CCTimer *pTimer2 = (CCTimer*)pObject2;
+    if (pTimer1->m_dDueTime != pTimer2->m_dDueTime)
     {
-        if ((! pEntry->paused) && (! pEntry->markedForDeletion))
+        return pTimer1->m_dDueTime < pTimer2->m_dDueTime;
+    }
+    return pTimer1->m_uScheduleOrder < pTimer2->m_uScheduleOrder;
+}
+
+void CCScheduler::fireDueTimers()
+{
+    // the timers are taken out of the due list first, since firing them may schedule or unschedule others
+    CCTimer *pTimer = m_pDueTimers;
+    while (pTimer)
+    {
+        CCTimer *pNext = pTimer->m_pWheelNext;
+        if (pTimer->m_dDueTime <= m_dTime)
         {
-            pEntry->target->update(dt);
+            unlinkTimer(pTimer);
+            linkTimer(pTimer, kCCTimerListFiring);
+            ccArrayAppendObjectWithResize(m_pFiringTimers, pTimer);
+        }
+        else if ((unsigned long long)(pTimer->m_dDueTime * kCCTimerWheelTicksPerSecond) > m_uWheelTick)
+        {
+            // parked beyond the span of the wheel
+            unlinkTimer(pTimer);
+            insertTimer(pTimer);
         }
+        pTimer = pNext;
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = m_pHashForTimers; elt != NULL; )
+    std::sort(m_pFiringTimers->arr, m_pFiringTimers->arr + m_pFiringTimers->num, compareFiringTimers);
+
+    for (unsigned int i = 0; i < m_pFiringTimers->num; ++i)
     {
-        m_pCurrentTarget = elt;
-        m_bCurrentTargetSalvaged = false;
+        pTimer = (CCTimer*)m_pFiringTimers->arr[i];
 
-        if (! m_pCurrentTarget->paused)
+        // unscheduled by one of the selectors fired before
+        if (pTimer->m_nWheelSlot != kCCTimerListFiring)
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-            {
-                elt->currentTimer = (CCTimer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
+            continue;
+        }
 
-                elt->currentTimer->update(dt);
+        CCObject *pTarget = pTimer->m_pTarget;
+        tHashTimerEntry *pElement = NULL;
+        HASH_FIND_INT(m_pHashForTimers, &pTarget, pElement);
+        CCAssert(pElement, "A scheduled timer must belong to a target");
 
-                if (elt->currentTimerSalvaged)
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
+        m_pCurrentTarget = pElement;
+        m_bCurrentTargetSalvaged = false;
+
+        // same steps as CCTimer::update, with an elapsed time derived from the time of the scheduler
+        pTimer->trigger((float)(m_dTime - pTimer->m_dStartTime));
+
+        if (pTimer->m_bRunForever && !pTimer->m_bUseDelay)
+        {
+            pTimer->m_dStartTime = m_dTime;
+        }
+        else
+        {
+            if (pTimer->m_bUseDelay)
+            {
+                pTimer->m_dStartTime += pTimer->m_fDelay;
+                pTimer->m_bUseDelay = false;
+            }
+            else
+            {
+                pTimer->m_dStartTime = m_dTime;
+            }
+            pTimer->m_uTimesExecuted += 1;
 
-                elt->currentTimer = NULL;
+            if (!pTimer->m_bRunForever && pTimer->m_uTimesExecuted > pTimer->m_uRepeat)
+            {
+                unscheduleSelector(pTimer->m_pfnSelector, pTarget);
             }
         }
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
+        if (pTimer->m_nWheelSlot == kCCTimerListFiring)
+        {
+            pTimer->m_nWheelSlot = kCCTimerListNone;
+            if (pElement->paused)
+            {
+                pTimer->m_fElapsed = (float)(m_dTime - pTimer->m_dStartTime);
+            }
+            else
+            {
+                insertTimer(pTimer);
+            }
+        }
 
         // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (m_bCurrentTargetSalvaged && m_pCurrentTarget->timers->num == 0)
+        if (m_bCurrentTargetSalvaged && pElement->timers->num == 0)
         {
-            removeHashElement(m_pCurrentTarget);
+            removeHashElement(pElement);
         }
+        m_pCurrentTarget = NULL;
+    }
+
+    ccArrayRemoveAllObjects(m_pFiringTimers);
+}
+
+void CCScheduler::startNewTimers()
+{
+    while (m_pNewTimers)
+    {
+        CCTimer *pTimer = m_pNewTimers;
+        unlinkTimer(pTimer);
+        startTimer(pTimer);
     }
+}
+
+// callbacks from other threads
+
+void CCScheduler::performFunctionInCocosThread(SEL_CallFuncO pfnSelector, CCObject *pTarget, CCObject *pObject)
+{
+    tPerformEntry *pEntry = new tPerformEntry();
+    pEntry->selector = pfnSelector;
+    pEntry->target = pTarget;
+    pEntry->object = pObject;
+    pEntry->function = NULL;
+    pEntry->userData = NULL;
+    postFunction(pEntry);
+}
+
+void CCScheduler::performFunctionInCocosThread(void (*pfnFunction)(void*), void *pUserData)
+{
+    tPerformEntry *pEntry = new tPerformEntry();
+    pEntry->selector = NULL;
+    pEntry->target = NULL;
+    pEntry->object = NULL;
+    pEntry->function = pfnFunction;
+    pEntry->userData = pUserData;
+    postFunction(pEntry);
+}
+
+void CCScheduler::postFunction(tPerformEntry *pEntry)
+{
+    // pushed on a lock-free stack, which the cocos thread takes as a whole
+    do
+    {
+        pEntry->next = m_pFunctionsToPerform;
+    } while (! ccCompareAndSwapPerformEntry(&m_pFunctionsToPerform, pEntry->next, pEntry));
+}
+
+void CCScheduler::performFunctions()
+{
+    if (! m_pFunctionsToPerform)
+    {
+        return;
+    }
+
+    tPerformEntry *pEntries = NULL;
+    do
+    {
+        pEntries = m_pFunctionsToPerform;
+    } while (! ccCompareAndSwapPerformEntry(&m_pFunctionsToPerform, pEntries, NULL));
+
+    // the stack holds the most recent callback first
+    tPerformEntry *pOrdered = NULL;
+    while (pEntries)
+    {
+        tPerformEntry *pNext = pEntries->next;
+        pEntries->next = pOrdered;
+        pOrdered = pEntries;
+        pEntries = pNext;
+    }
+
+    while (pOrdered)
+    {
+        tPerformEntry *pNext = pOrdered->next;
+        if (pOrdered->target && pOrdered->selector)
+        {
+            (pOrdered->target->*pOrdered->selector)(pOrdered->object);
+        }
+        else if (pOrdered->function)
+        {
+            pOrdered->function(pOrdered->userData);
+        }
+        delete pOrdered;
+        pOrdered = pNext;
+    }
+}
+
+// main loop
+void CCScheduler::update(float dt)
+{
+    m_bUpdateHashLocked = true;
+
+    if (m_fTimeScale != 1.0f)
+    {
+        dt *= m_fTimeScale;
+    }
+
+    m_dTime += dt;
+
+    // Iterate over all the Updates' selectors, ordered by priority.
+    // Entries may be inserted while iterating, so the array is indexed again after each call
+    for (m_uCurrentUpdate = 0; m_uCurrentUpdate < m_uUpdatesCount; ++m_uCurrentUpdate)
+    {
+        tUpdateEntry *pEntry = &m_pUpdates[m_uCurrentUpdate];
+        if ((! pEntry->paused) && (! pEntry->markedForDeletion))
+        {
+            pEntry->target->update(dt);
+        }
+    }
+
+    // Fire the custom selectors that are due
+    advanceTimerWheel();
+    fireDueTimers();
+
+    // The custom selectors scheduled since the last update start counting from now
+    startNewTimers();
 
     // Iterate over all the script callbacks
     if (m_pScriptHandlerEntries)
@@ -876,36 +1193,22 @@ void CCScheduler::update(float dt)
     }
 
     // delete all updates that are marked for deletion
-    // updates with priority < 0
-    DL_FOREACH_SAFE(m_pUpdatesNegList, pEntry, pTmp)
+    for (unsigned int i = 0; i < m_uUpdatesCount; ++i)
     {
-        if (pEntry->markedForDeletion)
+        if (m_pUpdates[i].markedForDeletion && m_pUpdates[i].target)
         {
-            this->removeUpdateFromHash(pEntry);
-        }
-    }
-
-    // updates with priority == 0
-    DL_FOREACH_SAFE(m_pUpdates0List, pEntry, pTmp)
-    {
-        if (pEntry->markedForDeletion)
-        {
-            this->removeUpdateFromHash(pEntry);
-        }
-    }
-
-    // updates with priority > 0
-    DL_FOREACH_SAFE(m_pUpdatesPosList, pEntry, pTmp)
-    {
-        if (pEntry->markedForDeletion)
-        {
-            this->removeUpdateFromHash(pEntry);
+            this->removeUpdate(i);
         }
     }
 
     m_bUpdateHashLocked = false;
 
+    compactUpdates();
+
     m_pCurrentTarget = NULL;
+
+    // Perform the callbacks posted by other threads
+    performFunctions();
 }
 
 
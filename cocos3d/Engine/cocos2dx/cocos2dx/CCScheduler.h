@@ -43,7 +43,18 @@ NS_CC_BEGIN
 // Minimum priority level for user scheduling.
 #define kCCPriorityNonSystemMin (kCCPrioritySystem+1)
 
+// Resolution of the timer wheel holding the selectors with an interval.
+#define kCCTimerWheelTicksPerSecond 64
+
+// Number of slots of each level of the timer wheel.
+#define kCCTimerWheelSlotBits 6
+#define kCCTimerWheelSlots (1 << kCCTimerWheelSlotBits)
+
+// Number of levels of the timer wheel. A level covers kCCTimerWheelSlots times the span of the previous one.
+#define kCCTimerWheelLevels 4
+
 class CCSet;
+class CCScheduler;
 //
 // CCTimer
 //
@@ -101,6 +112,10 @@ public:
      */
     inline int getScriptHandler() { return m_nScriptHandler; };
 
+protected:
+    /** calls the selector and the script handler */
+    void trigger(float dt);
+
 protected:
     CCObject *m_pTarget;
     float m_fElapsed;
@@ -113,14 +128,25 @@ protected:
     SEL_SCHEDULE m_pfnSelector;
     
     int m_nScriptHandler;
+
+    // state of the timer while it is scheduled by a CCScheduler, which doesn't call update()
+    double m_dStartTime;    // scheduler time at which the elapsed time was 0
+    double m_dDueTime;      // scheduler time at which the selector is called next
+    CCTimer *m_pWheelPrev;
+    CCTimer *m_pWheelNext;
+    int m_nWheelSlot;       // list holding the timer: a slot of the timer wheel, or one of the kCCTimerList values
+    unsigned int m_uScheduleOrder; // orders the timers due at the same time
+
+    friend class CCScheduler;
 };
 
 //
 // CCScheduler
 //
-struct _listEntry;
+struct _updateEntry;
 struct _hashSelectorEntry;
 struct _hashUpdateEntry;
+struct _performEntry;
 
 class CCArray;
 
@@ -134,6 +160,10 @@ There are 2 different types of callbacks (selectors):
 
 The 'custom selectors' should be avoided when possible. It is faster, and consumes less memory to use the 'update selector'.
 
+The update selectors are held in a contiguous array sorted by priority, which is walked once per frame.
+The custom selectors are held in a hierarchical timer wheel: a frame only visits the selectors that are due,
+whatever the number of scheduled selectors.
+
 */
 class CC_DLL CCScheduler : public CCObject
 {
@@ -282,14 +312,49 @@ public:
      */
     void resumeTargets(CCSet* targetsToResume);
 
+    /** Calls a selector on the thread running the scheduler, at the end of its next update.
+     This method can be called from any thread, and doesn't lock: it is meant for worker threads
+     to hand their results over to the cocos thread.
+     Neither the target nor the object are retained, since retaining isn't thread-safe:
+     they must remain alive until the selector has been called.
+     @since v2.2.6
+     @js NA
+     @lua NA
+     */
+    void performFunctionInCocosThread(SEL_CallFuncO pfnSelector, CCObject *pTarget, CCObject *pObject);
+
+    /** Calls a function with its user data on the thread running the scheduler, at the end of its next update.
+     This method can be called from any thread, and doesn't lock.
+     @since v2.2.6
+     @js NA
+     @lua NA
+     */
+    void performFunctionInCocosThread(void (*pfnFunction)(void*), void *pUserData);
+
 private:
     void removeHashElement(struct _hashSelectorEntry *pElement);
-    void removeUpdateFromHash(struct _listEntry *entry);
 
     // update specific
 
-    void priorityIn(struct _listEntry **ppList, CCObject *pTarget, int nPriority, bool bPaused);
-    void appendIn(struct _listEntry **ppList, CCObject *pTarget, bool bPaused);
+    void insertUpdate(CCObject *pTarget, int nPriority, bool bPaused);
+    void removeUpdate(unsigned int uIndex);
+    void compactUpdates();
+
+    // timer wheel specific
+
+    CCTimer** timerList(int nSlot);
+    void insertTimer(CCTimer *pTimer);
+    void unlinkTimer(CCTimer *pTimer);
+    void linkTimer(CCTimer *pTimer, int nSlot);
+    void startTimer(CCTimer *pTimer);
+    void setTimersPaused(struct _hashSelectorEntry *pElement, bool bPaused);
+    void advanceTimerWheel();
+    void fireDueTimers();
+    void startNewTimers();
+    static bool compareFiringTimers(CCObject *pObject1, CCObject *pObject2);
+
+    void performFunctions();
+    void postFunction(struct _performEntry *pEntry);
 
 protected:
     float m_fTimeScale;
@@ -297,10 +362,12 @@ protected:
     //
     // "updates with priority" stuff
     //
-    struct _listEntry *m_pUpdatesNegList;        // list of priority < 0
-    struct _listEntry *m_pUpdates0List;            // list priority == 0
-    struct _listEntry *m_pUpdatesPosList;        // list priority > 0
-    struct _hashUpdateEntry *m_pHashForUpdates; // hash used to fetch quickly the list entries for pause,delete,etc
+    struct _updateEntry *m_pUpdates;            // sorted by priority, removed entries have a NULL target until compacted
+    unsigned int m_uUpdatesCount;
+    unsigned int m_uUpdatesCapacity;
+    unsigned int m_uRemovedUpdates;             // number of removed entries waiting to be compacted
+    unsigned int m_uCurrentUpdate;              // index of the entry being updated
+    struct _hashUpdateEntry *m_pHashForUpdates; // hash used to fetch quickly the entries for pause,delete,etc
 
     // Used for "selectors with interval"
     struct _hashSelectorEntry *m_pHashForTimers;
@@ -309,6 +376,18 @@ protected:
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool m_bUpdateHashLocked;
     CCArray* m_pScriptHandlerEntries;
+
+    // timer wheel: the elapsed time of the scheduled timers is derived from m_dTime instead of being accumulated
+    double m_dTime;                             // scaled time elapsed since the scheduler was created
+    unsigned long long m_uWheelTick;            // last tick processed by the wheel
+    CCTimer *m_pTimerWheel[kCCTimerWheelLevels * kCCTimerWheelSlots];
+    CCTimer *m_pDueTimers;                      // timers whose tick has been reached
+    CCTimer *m_pNewTimers;                      // timers that start counting at the end of the next update
+    struct _ccArray *m_pFiringTimers;
+    unsigned int m_uTimersScheduled;
+
+    // callbacks posted by other threads, in reverse order
+    struct _performEntry * volatile m_pFunctionsToPerform;
 };
 
 // end of global group
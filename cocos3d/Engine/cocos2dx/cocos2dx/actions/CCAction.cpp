@@ -26,6 +26,7 @@ THE SOFTWARE.
 
 #include "CCAction.h"
 #include "CCActionInterval.h"
+#include "CCActionManager.h"
 #include "base_nodes/CCNode.h"
 #include "support/CCPointExtension.h"
 #include "CCDirector.h"
@@ -41,6 +42,8 @@ CCAction::CCAction()
 ,m_pTarget(NULL)
 ,m_nTag(kCCActionTagInvalid)
 ,m_pUserData(NULL)
+,m_nActionPool(kCCActionPoolNone)
+,m_uActionPoolIndex(0)
 {
 }
 
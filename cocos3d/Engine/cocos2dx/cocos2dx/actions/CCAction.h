@@ -48,6 +48,7 @@ enum {
  */
 class CC_DLL CCAction : public CCObject 
 {
+    friend class CCActionManager;
 public:
     /**
      * @js ctor
@@ -127,6 +128,11 @@ protected:
     int     m_nTag;
 
 	void*	m_pUserData;
+
+    /** The pool of CCActionManager in which the action is evaluated, kCCActionPoolNone if it is stepped */
+    int             m_nActionPool;
+    /** The index of the record of the action in that pool */
+    unsigned int    m_uActionPoolIndex;
 };
 
 /** 
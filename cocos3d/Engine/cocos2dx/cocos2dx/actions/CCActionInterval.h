@@ -60,6 +60,7 @@ CCAction *pingPongAction = CCSequence::actions(action, action->reverse(), NULL);
 */
 class CC_DLL CCActionInterval : public CCFiniteTimeAction
 {
+    friend class CCActionManager;
 public:
     /** how many seconds had elapsed since the actions started to run. */
     inline float getElapsed(void) { return m_elapsed; }
@@ -330,6 +331,7 @@ protected:
 */ 
 class CC_DLL CCRotateTo : public CCActionInterval
 {
+    friend class CCActionManager;
 public:
     /** creates the action */
     static CCRotateTo* create(float fDuration, float fDeltaAngle);
@@ -361,6 +363,7 @@ protected:
 */
 class CC_DLL CCRotateBy : public CCActionInterval
 {
+    friend class CCActionManager;
 public:
     /** creates the action */
     static CCRotateBy* create(float fDuration, float fDeltaAngle);
@@ -393,6 +396,7 @@ protected:
  */
 class CC_DLL CCMoveBy : public CCActionInterval
 {
+    friend class CCActionManager;
 public:
     /** initializes the action */
     bool initWithDuration(float duration, const CCPoint& deltaPosition);
@@ -620,6 +624,7 @@ protected:
  */
 class CC_DLL CCScaleTo : public CCActionInterval
 {
+    friend class CCActionManager;
 public:
     /** initializes the action with the same scale factor for X and Y */
     bool initWithDuration(float duration, float s);
@@ -746,6 +751,7 @@ public:
  */
 class CC_DLL CCFadeTo : public CCActionInterval
 {
+    friend class CCActionManager;
 public:
     /** initializes the action with duration and opacity */
     bool initWithDuration(float duration, GLubyte opacity);
@@ -771,6 +777,7 @@ protected:
 */
 class CC_DLL CCTintTo : public CCActionInterval
 {
+    friend class CCActionManager;
 public:
     /** initializes the action with duration and color */
     bool initWithDuration(float duration, GLubyte red, GLubyte green, GLubyte blue);
@@ -795,6 +802,7 @@ protected:
  */
 class CC_DLL CCTintBy : public CCActionInterval
 {
+    friend class CCActionManager;
 public:
     /** initializes the action with duration and color */
     bool initWithDuration(float duration, GLshort deltaRed, GLshort deltaGreen, GLshort deltaBlue);
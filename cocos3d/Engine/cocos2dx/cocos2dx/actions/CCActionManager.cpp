@@ -26,13 +26,63 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "CCActionManager.h"
+#include "CCActionInterval.h"
+#include "CCActionEase.h"
 #include "base_nodes/CCNode.h"
 #include "CCScheduler.h"
+#include "CCProtocols.h"
 #include "ccMacros.h"
 #include "support/data_support/ccCArray.h"
 #include "cocoa/CCSet.h"
+#include <float.h>
+#include <typeinfo>
 
 NS_CC_BEGIN
+
+// the easings applied by the pooled actions
+enum {
+    kCCActionEasingNone,
+    kCCActionEasingIn,
+    kCCActionEasingOut,
+    kCCActionEasingInOut,
+    kCCActionEasingExponentialIn,
+    kCCActionEasingExponentialOut,
+    kCCActionEasingExponentialInOut,
+    kCCActionEasingSineIn,
+    kCCActionEasingSineOut,
+    kCCActionEasingSineInOut,
+};
+
+// same as the update methods of the ease actions
+static inline float easeTime(int easing, float rate, float time)
+{
+    switch (easing)
+    {
+    case kCCActionEasingIn:
+        return powf(time, rate);
+    case kCCActionEasingOut:
+        return powf(time, 1 / rate);
+    case kCCActionEasingInOut:
+        time *= 2;
+        return time < 1 ? 0.5f * powf(time, rate) : 1.0f - 0.5f * powf(2 - time, rate);
+    case kCCActionEasingExponentialIn:
+        return time == 0 ? 0 : powf(2, 10 * (time/1 - 1)) - 1 * 0.001f;
+    case kCCActionEasingExponentialOut:
+        return time == 1 ? 1 : (-powf(2, -10 * time / 1) + 1);
+    case kCCActionEasingExponentialInOut:
+        time /= 0.5f;
+        return time < 1 ? 0.5f * powf(2, 10 * (time - 1)) : 0.5f * (-powf(2, -10 * (time - 1)) + 2);
+    case kCCActionEasingSineIn:
+        return -1 * cosf(time * (float)M_PI_2) + 1;
+    case kCCActionEasingSineOut:
+        return sinf(time * (float)M_PI_2);
+    case kCCActionEasingSineInOut:
+        return -0.5f * (cosf((float)M_PI * time) - 1);
+    default:
+        return time;
+    }
+}
+
 //
 // singleton stuff
 //
@@ -40,9 +90,10 @@ NS_CC_BEGIN
 CCActionManager::CCActionManager(void)
 : m_pTargets(NULL), 
   m_pCurrentTarget(NULL),
-  m_bCurrentTargetSalvaged(false)
+  m_bCurrentTargetSalvaged(false),
+  m_nUpdatingPool(kCCActionPoolNone)
 {
-
+    memset(m_pPools, 0, sizeof(m_pPools));
 }
 
 CCActionManager::~CCActionManager(void)
@@ -50,6 +101,11 @@ CCActionManager::~CCActionManager(void)
     CCLOGINFO("cocos2d: deallocing %p", this);
 
     removeAllActions();
+
+    for (int i = 0; i < kCCActionPoolCount; ++i)
+    {
+        free(m_pPools[i].records);
+    }
 }
 
 // private
@@ -80,6 +136,11 @@ void CCActionManager::removeActionAtIndex(unsigned int uIndex, tHashElement *pEl
 {
     CCAction *pAction = (CCAction*)pElement->actions->arr[uIndex];
 
+    if (pAction->m_nActionPool != kCCActionPoolNone)
+    {
+        removePooledAction(pAction, pElement);
+    }
+
     if (pAction == pElement->currentAction && (! pElement->currentActionSalvaged))
     {
         pElement->currentAction->retain();
@@ -107,6 +168,324 @@ void CCActionManager::removeActionAtIndex(unsigned int uIndex, tHashElement *pEl
     }
 }
 
+// pools
+
+void CCActionManager::addPooledAction(CCAction *pAction, tHashElement *pElement)
+{
+    // only the exact classes are pooled, since subclasses may override update()
+    const std::type_info& type = typeid(*pAction);
+    CCAction *pInner = pAction;
+    int easing = kCCActionEasingNone;
+    float rate = 1;
+
+    if (type == typeid(CCEaseIn) || type == typeid(CCEaseOut) || type == typeid(CCEaseInOut))
+    {
+        easing = (type == typeid(CCEaseIn)) ? kCCActionEasingIn : (type == typeid(CCEaseOut)) ? kCCActionEasingOut : kCCActionEasingInOut;
+        rate = ((CCEaseRateAction*)pAction)->getRate();
+        pInner = ((CCActionEase*)pAction)->getInnerAction();
+    }
+    else if (type == typeid(CCEaseExponentialIn) || type == typeid(CCEaseExponentialOut) || type == typeid(CCEaseExponentialInOut))
+    {
+        easing = (type == typeid(CCEaseExponentialIn)) ? kCCActionEasingExponentialIn : (type == typeid(CCEaseExponentialOut)) ? kCCActionEasingExponentialOut : kCCActionEasingExponentialInOut;
+        pInner = ((CCActionEase*)pAction)->getInnerAction();
+    }
+    else if (type == typeid(CCEaseSineIn) || type == typeid(CCEaseSineOut) || type == typeid(CCEaseSineInOut))
+    {
+        easing = (type == typeid(CCEaseSineIn)) ? kCCActionEasingSineIn : (type == typeid(CCEaseSineOut)) ? kCCActionEasingSineOut : kCCActionEasingSineInOut;
+        pInner = ((CCActionEase*)pAction)->getInnerAction();
+    }
+    else if (type == typeid(CCActionEase))
+    {
+        pInner = ((CCActionEase*)pAction)->getInnerAction();
+    }
+
+    if (pInner == NULL)
+    {
+        return;
+    }
+
+    tActionRecord record;
+    memset(&record, 0, sizeof(record));
+    int nPool = kCCActionPoolNone;
+
+    const std::type_info& innerType = typeid(*pInner);
+    if (innerType == typeid(CCMoveBy) || innerType == typeid(CCMoveTo))
+    {
+        CCMoveBy *pMove = (CCMoveBy*)pInner;
+        nPool = kCCActionPoolPosition;
+        record.start[0] = pMove->m_startPosition.x;
+        record.start[1] = pMove->m_startPosition.y;
+        record.delta[0] = pMove->m_positionDelta.x;
+        record.delta[1] = pMove->m_positionDelta.y;
+        record.previous[0] = pMove->m_previousPosition.x;
+        record.previous[1] = pMove->m_previousPosition.y;
+    }
+    else if (innerType == typeid(CCScaleBy) || innerType == typeid(CCScaleTo))
+    {
+        CCScaleTo *pScale = (CCScaleTo*)pInner;
+        nPool = kCCActionPoolScale;
+        record.start[0] = pScale->m_fStartScaleX;
+        record.start[1] = pScale->m_fStartScaleY;
+        record.delta[0] = pScale->m_fDeltaX;
+        record.delta[1] = pScale->m_fDeltaY;
+    }
+    else if (innerType == typeid(CCRotateTo))
+    {
+        CCRotateTo *pRotate = (CCRotateTo*)pInner;
+        nPool = kCCActionPoolRotation;
+        record.start[0] = pRotate->m_fStartAngleX;
+        record.start[1] = pRotate->m_fStartAngleY;
+        record.delta[0] = pRotate->m_fDiffAngleX;
+        record.delta[1] = pRotate->m_fDiffAngleY;
+    }
+    else if (innerType == typeid(CCRotateBy))
+    {
+        CCRotateBy *pRotate = (CCRotateBy*)pInner;
+        nPool = kCCActionPoolRotation;
+        record.start[0] = pRotate->m_fStartAngleX;
+        record.start[1] = pRotate->m_fStartAngleY;
+        record.delta[0] = pRotate->m_fAngleX;
+        record.delta[1] = pRotate->m_fAngleY;
+    }
+    else if (innerType == typeid(CCFadeIn) || innerType == typeid(CCFadeOut))
+    {
+        nPool = kCCActionPoolOpacity;
+        record.start[0] = (innerType == typeid(CCFadeIn)) ? 0 : 255;
+        record.delta[0] = (innerType == typeid(CCFadeIn)) ? 255 : -255;
+    }
+    else if (innerType == typeid(CCFadeTo))
+    {
+        CCFadeTo *pFade = (CCFadeTo*)pInner;
+        nPool = kCCActionPoolOpacity;
+        record.start[0] = pFade->m_fromOpacity;
+        record.delta[0] = pFade->m_toOpacity - pFade->m_fromOpacity;
+    }
+    else if (innerType == typeid(CCTintTo))
+    {
+        CCTintTo *pTint = (CCTintTo*)pInner;
+        nPool = kCCActionPoolColor;
+        record.start[0] = pTint->m_from.r;
+        record.start[1] = pTint->m_from.g;
+        record.start[2] = pTint->m_from.b;
+        record.delta[0] = pTint->m_to.r - pTint->m_from.r;
+        record.delta[1] = pTint->m_to.g - pTint->m_from.g;
+        record.delta[2] = pTint->m_to.b - pTint->m_from.b;
+    }
+    else if (innerType == typeid(CCTintBy))
+    {
+        CCTintBy *pTint = (CCTintBy*)pInner;
+        nPool = kCCActionPoolColor;
+        record.start[0] = pTint->m_fromR;
+        record.start[1] = pTint->m_fromG;
+        record.start[2] = pTint->m_fromB;
+        record.delta[0] = pTint->m_deltaR;
+        record.delta[1] = pTint->m_deltaG;
+        record.delta[2] = pTint->m_deltaB;
+    }
+
+    if (nPool == kCCActionPoolNone)
+    {
+        return;
+    }
+
+    CCActionInterval *pInterval = (CCActionInterval*)pAction;
+    record.action = pInterval;
+    record.target = pInterval->getTarget();
+    record.protocol = dynamic_cast<CCRGBAProtocol*>(record.target);
+    record.element = pElement;
+    record.elapsed = pInterval->m_elapsed;
+    record.duration = pInterval->getDuration();
+    record.rate = rate;
+    record.easing = easing;
+    record.firstTick = pInterval->m_bFirstTick;
+    record.paused = pElement->paused;
+
+    tActionPool *pPool = &m_pPools[nPool];
+    if (pPool->count == pPool->capacity)
+    {
+        pPool->capacity = MAX(64, pPool->capacity * 2);
+        pPool->records = (tActionRecord*)realloc(pPool->records, pPool->capacity * sizeof(tActionRecord));
+    }
+
+    pAction->m_nActionPool = nPool;
+    pAction->m_uActionPoolIndex = pPool->count;
+    pPool->records[pPool->count++] = record;
+    pElement->pooledActions++;
+}
+
+void CCActionManager::removePooledAction(CCAction *pAction, tHashElement *pElement)
+{
+    tActionPool *pPool = &m_pPools[pAction->m_nActionPool];
+    unsigned int uIndex = pAction->m_uActionPoolIndex;
+
+    if (pAction->m_nActionPool == m_nUpdatingPool)
+    {
+        // the pool is being evaluated, it is compacted once done
+        pPool->records[uIndex].action = NULL;
+        pPool->dirty = true;
+    }
+    else
+    {
+        pPool->records[uIndex] = pPool->records[--pPool->count];
+        if (uIndex < pPool->count)
+        {
+            pPool->records[uIndex].action->m_uActionPoolIndex = uIndex;
+        }
+    }
+
+    pAction->m_nActionPool = kCCActionPoolNone;
+    pElement->pooledActions--;
+}
+
+void CCActionManager::setPausedWithHashElement(tHashElement *pElement, bool bPaused)
+{
+    pElement->paused = bPaused;
+
+    if (pElement->pooledActions > 0)
+    {
+        for (unsigned int i = 0; i < pElement->actions->num; ++i)
+        {
+            CCAction *pAction = (CCAction*)pElement->actions->arr[i];
+            if (pAction->m_nActionPool != kCCActionPoolNone)
+            {
+                m_pPools[pAction->m_nActionPool].records[pAction->m_uActionPoolIndex].paused = bPaused;
+            }
+        }
+    }
+}
+
+void CCActionManager::updatePool(int nPool, float dt)
+{
+    tActionPool *pPool = &m_pPools[nPool];
+    // the actions added while calling the targets are evaluated from the next frame
+    unsigned int count = pPool->count;
+
+    // same as CCActionInterval::step and the ease actions
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        tActionRecord *pRecord = &pPool->records[i];
+        if (pRecord->paused)
+        {
+            continue;
+        }
+
+        if (pRecord->firstTick)
+        {
+            pRecord->firstTick = false;
+            pRecord->elapsed = 0;
+        }
+        else
+        {
+            pRecord->elapsed += dt;
+        }
+
+        float time = MAX(0, MIN(1, pRecord->elapsed / MAX(pRecord->duration, FLT_EPSILON)));
+        pRecord->time = easeTime(pRecord->easing, pRecord->rate, time);
+    }
+
+    m_nUpdatingPool = nPool;
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        // the targets may add actions, the records are fetched again after calling them
+        tActionRecord *pRecord = &pPool->records[i];
+        if (pRecord->action == NULL || pRecord->paused)
+        {
+            continue;
+        }
+
+        m_pCurrentTarget = pRecord->element;
+        m_bCurrentTargetSalvaged = false;
+
+        pRecord->action->m_elapsed = pRecord->elapsed;
+        pRecord->action->m_bFirstTick = false;
+
+        CCNode *pTarget = pRecord->target;
+        float time = pRecord->time;
+
+        switch (nPool)
+        {
+        case kCCActionPoolPosition:
+            {
+#if CC_ENABLE_STACKABLE_ACTIONS
+                const CCPoint& currentPos = pTarget->getPosition();
+                pRecord->start[0] += currentPos.x - pRecord->previous[0];
+                pRecord->start[1] += currentPos.y - pRecord->previous[1];
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+                CCPoint newPos(pRecord->start[0] + pRecord->delta[0] * time, pRecord->start[1] + pRecord->delta[1] * time);
+                pRecord->previous[0] = newPos.x;
+                pRecord->previous[1] = newPos.y;
+                pTarget->setPosition(newPos);
+            }
+            break;
+        case kCCActionPoolScale:
+            {
+                float scaleY = pRecord->start[1] + pRecord->delta[1] * time;
+                pTarget->setScaleX(pRecord->start[0] + pRecord->delta[0] * time);
+                pTarget->setScaleY(scaleY);
+            }
+            break;
+        case kCCActionPoolRotation:
+            {
+                float rotationY = pRecord->start[1] + pRecord->delta[1] * time;
+                pTarget->setRotationX(pRecord->start[0] + pRecord->delta[0] * time);
+                pTarget->setRotationY(rotationY);
+            }
+            break;
+        case kCCActionPoolOpacity:
+            if (pRecord->protocol)
+            {
+                pRecord->protocol->setOpacity((GLubyte)(pRecord->start[0] + pRecord->delta[0] * time));
+            }
+            break;
+        case kCCActionPoolColor:
+            if (pRecord->protocol)
+            {
+                pRecord->protocol->setColor(ccc3((GLubyte)(pRecord->start[0] + pRecord->delta[0] * time),
+                    (GLubyte)(pRecord->start[1] + pRecord->delta[1] * time),
+                    (GLubyte)(pRecord->start[2] + pRecord->delta[2] * time)));
+            }
+            break;
+        }
+
+        pRecord = &pPool->records[i];
+        CCActionInterval *pAction = pRecord->action;
+        if (pAction && pRecord->elapsed >= pRecord->duration)
+        {
+            pAction->stop();
+            removeAction(pAction);
+        }
+
+        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
+        if (m_bCurrentTargetSalvaged && m_pCurrentTarget->actions->num == 0)
+        {
+            deleteHashElement(m_pCurrentTarget);
+        }
+    }
+
+    m_pCurrentTarget = NULL;
+    m_nUpdatingPool = kCCActionPoolNone;
+
+    if (pPool->dirty)
+    {
+        unsigned int alive = 0;
+        for (unsigned int i = 0; i < pPool->count; ++i)
+        {
+            if (pPool->records[i].action)
+            {
+                if (alive != i)
+                {
+                    pPool->records[alive] = pPool->records[i];
+                    pPool->records[alive].action->m_uActionPoolIndex = alive;
+                }
+                alive++;
+            }
+        }
+        pPool->count = alive;
+        pPool->dirty = false;
+    }
+}
+
 // pause / resume
 
 void CCActionManager::pauseTarget(CCObject *pTarget)
@@ -115,7 +494,7 @@ void CCActionManager::pauseTarget(CCObject *pTarget)
     HASH_FIND_INT(m_pTargets, &pTarget, pElement);
     if (pElement)
     {
-        pElement->paused = true;
+        setPausedWithHashElement(pElement, true);
     }
 }
 
@@ -125,7 +504,7 @@ void CCActionManager::resumeTarget(CCObject *pTarget)
     HASH_FIND_INT(m_pTargets, &pTarget, pElement);
     if (pElement)
     {
-        pElement->paused = false;
+        setPausedWithHashElement(pElement, false);
     }
 }
 
@@ -138,7 +517,7 @@ CCSet* CCActionManager::pauseAllRunningActions()
     {
         if (! element->paused) 
         {
-            element->paused = true;
+            setPausedWithHashElement(element, true);
             idsWithActions->addObject(element->target);
         }
     }    
@@ -181,6 +560,8 @@ void CCActionManager::addAction(CCAction *pAction, CCNode *pTarget, bool paused)
      ccArrayAppendObject(pElement->actions, pAction);
  
      pAction->startWithTarget(pTarget);
+
+     addPooledAction(pAction, pElement);
 }
 
 // remove
@@ -213,6 +594,15 @@ void CCActionManager::removeAllActionsFromTarget(CCObject *pTarget)
             pElement->currentActionSalvaged = true;
         }
 
+        for (unsigned int i = 0; pElement->pooledActions > 0 && i < pElement->actions->num; ++i)
+        {
+            CCAction *pAction = (CCAction*)pElement->actions->arr[i];
+            if (pAction->m_nActionPool != kCCActionPoolNone)
+            {
+                removePooledAction(pAction, pElement);
+            }
+        }
+
         ccArrayRemoveAllObjects(pElement->actions);
         if (m_pCurrentTarget == pElement)
         {
@@ -332,7 +722,8 @@ void CCActionManager::update(float dt)
         m_pCurrentTarget = elt;
         m_bCurrentTargetSalvaged = false;
 
-        if (! m_pCurrentTarget->paused)
+        // the pooled actions are evaluated below
+        if (! m_pCurrentTarget->paused && m_pCurrentTarget->actions->num > m_pCurrentTarget->pooledActions)
         {
             // The 'actions' CCMutableArray may change while inside this loop.
             for (m_pCurrentTarget->actionIndex = 0; m_pCurrentTarget->actionIndex < m_pCurrentTarget->actions->num;
@@ -344,6 +735,12 @@ void CCActionManager::update(float dt)
                     continue;
                 }
 
+                if (m_pCurrentTarget->currentAction->m_nActionPool != kCCActionPoolNone)
+                {
+                    m_pCurrentTarget->currentAction = NULL;
+                    continue;
+                }
+
                 m_pCurrentTarget->currentActionSalvaged = false;
 
                 m_pCurrentTarget->currentAction->step(dt);
@@ -382,6 +779,14 @@ void CCActionManager::update(float dt)
 
     // issue #635
     m_pCurrentTarget = NULL;
+
+    for (int i = 0; i < kCCActionPoolCount; ++i)
+    {
+        if (m_pPools[i].count > 0)
+        {
+            updatePool(i, dt);
+        }
+    }
 }
 
 NS_CC_END
@@ -36,6 +36,8 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class CCSet;
+class CCActionInterval;
+class CCRGBAProtocol;
 
 typedef struct _hashElement
 {
@@ -45,9 +47,54 @@ typedef struct _hashElement
 	CCAction                    *currentAction;
 	bool                        currentActionSalvaged;
 	bool                        paused;
+	unsigned int                pooledActions;
 	UT_hash_handle                hh;
 } tHashElement;
 
+/** The pools in which CCActionManager evaluates the common interval actions, grouped by the property they animate. */
+enum {
+    kCCActionPoolNone = -1,
+    //! CCMoveBy, CCMoveTo
+    kCCActionPoolPosition,
+    //! CCScaleBy, CCScaleTo
+    kCCActionPoolScale,
+    //! CCRotateBy, CCRotateTo
+    kCCActionPoolRotation,
+    //! CCFadeIn, CCFadeOut, CCFadeTo
+    kCCActionPoolOpacity,
+    //! CCTintBy, CCTintTo
+    kCCActionPoolColor,
+
+    kCCActionPoolCount,
+};
+
+/** The state of a pooled action, which is evaluated by CCActionManager in place of CCAction::step. */
+typedef struct _actionRecord
+{
+    CCActionInterval            *action;
+    CCNode                      *target;
+    CCRGBAProtocol              *protocol;
+    struct _hashElement         *element;
+    float                       elapsed;
+    float                       duration;
+    float                       time;
+    float                       rate;
+    int                         easing;
+    bool                        firstTick;
+    bool                        paused;
+    float                       start[3];
+    float                       delta[3];
+    float                       previous[2];
+} tActionRecord;
+
+typedef struct _actionPool
+{
+    tActionRecord               *records;
+    unsigned int                count;
+    unsigned int                capacity;
+    bool                        dirty;
+} tActionPool;
+
 /**
  * @addtogroup actions
  * @{
@@ -61,6 +108,12 @@ typedef struct _hashElement
  Examples:
     - When you want to run an action where the target is different from a CCNode. 
     - When you want to pause / resume the actions
+
+ The CCMoveBy/To, CCScaleBy/To, CCRotateBy/To, CCFadeIn/Out/To and CCTintBy/To actions, whether run alone or
+ wrapped in a CCEaseIn/Out/InOut, CCEaseExponential or CCEaseSine action, are not stepped one by one. Their state
+ is copied into contiguous pools grouped by the animated property, which are evaluated in a batch every frame.
+ The CCAction objects remain the handles of these actions: they can be stopped, looked up by tag or paused as usual.
+ Subclasses of these actions are stepped as any other action.
  
  @since v0.8
  */
@@ -138,10 +191,18 @@ protected:
     void actionAllocWithHashElement(struct _hashElement *pElement);
     void update(float dt);
 
+    /** moves the action into a pool if it is one of the pooled actions */
+    void addPooledAction(CCAction *pAction, struct _hashElement *pElement);
+    void removePooledAction(CCAction *pAction, struct _hashElement *pElement);
+    void setPausedWithHashElement(struct _hashElement *pElement, bool bPaused);
+    void updatePool(int nPool, float dt);
+
 protected:
     struct _hashElement    *m_pTargets;
     struct _hashElement    *m_pCurrentTarget;
     bool            m_bCurrentTargetSalvaged;
+    tActionPool     m_pPools[kCCActionPoolCount];
+    int             m_nUpdatingPool;
 };
 
 // end of actions group
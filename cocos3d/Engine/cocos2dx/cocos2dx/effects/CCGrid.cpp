@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "shaders/CCGLProgram.h"
 #include "shaders/CCShaderCache.h"
 #include "shaders/ccGLStateCache.h"
+#include "sprite_nodes/CCAutoBatcher.h"
 #include "CCGL.h"
 #include "support/CCPointExtension.h"
 #include "support/TransformUtils.h"
@@ -199,6 +200,9 @@ void CCGridBase::set2DProjection()
 
 void CCGridBase::beforeDraw(void)
 {
+    // the grabber switches to its own frame buffer
+    CCAutoBatcher::flushShared();
+
     // save projection
     CCDirector *director = CCDirector::sharedDirector();
     m_directorProjection = director->getProjection();
@@ -211,6 +215,8 @@ void CCGridBase::beforeDraw(void)
 
 void CCGridBase::afterDraw(cocos2d::CCNode *pTarget)
 {
+    CCAutoBatcher::flushShared();
+
     m_pGrabber->afterRender(m_pTexture);
 
     // restore projection
@@ -250,6 +250,7 @@ THE SOFTWARE.
 // sprite_nodes
 #include "sprite_nodes/CCAnimation.h"
 #include "sprite_nodes/CCAnimationCache.h"
+#include "sprite_nodes/CCAutoBatcher.h"
 #include "sprite_nodes/CCSprite.h"
 #include "sprite_nodes/CCSpriteBatchNode.h"
 #include "sprite_nodes/CCSpriteFrame.h"
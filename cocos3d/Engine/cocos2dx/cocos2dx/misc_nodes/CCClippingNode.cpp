@@ -32,6 +32,7 @@
 #include "CCDirector.h"
 #include "support/CCPointExtension.h"
 #include "draw_nodes/CCDrawingPrimitives.h"
+#include "sprite_nodes/CCAutoBatcher.h"
 
 NS_CC_BEGIN
 
@@ -201,6 +202,9 @@ void CCClippingNode::visit()
     // mask of all layers less than or equal to the current (ie: for layer 3: 00000111)
     GLint mask_layer_le = mask_layer | mask_layer_l;
     
+    // the sprites queued so far must not be drawn with the stencil test
+    CCAutoBatcher::flushShared();
+
     // manually save the stencil state
     GLboolean currentStencilEnabled = GL_FALSE;
     GLuint currentStencilWriteMask = ~0;
@@ -309,6 +313,7 @@ void CCClippingNode::visit()
     kmGLPushMatrix();
     transform();
     m_pStencil->visit();
+    CCAutoBatcher::flushShared();
     kmGLPopMatrix();
     
     // restore alpha test state
@@ -346,6 +351,7 @@ void CCClippingNode::visit()
     
     // draw (according to the stencil test func) this node and its childs
     CCNode::visit();
+    CCAutoBatcher::flushShared();
     
     ///////////////////////////////////
     // CLEANUP
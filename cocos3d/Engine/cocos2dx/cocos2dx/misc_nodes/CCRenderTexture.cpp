@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "support/CCNotificationCenter.h"
 #include "CCEventType.h"
 #include "effects/CCGrid.h"
+#include "sprite_nodes/CCAutoBatcher.h"
 // extern
 #include "kazmath/GL/matrix.h"
 #include "CCEGLView.h"
@@ -362,6 +363,9 @@ bool CCRenderTexture::initWithWidthAndHeight(int w, int h, CCTexture2DPixelForma
 
 void CCRenderTexture::begin()
 {
+    // the sprites queued so far belong to the previous frame buffer
+    CCAutoBatcher::flushShared();
+
     kmGLMatrixMode(KM_GL_PROJECTION);
 	kmGLPushMatrix();
 	kmGLMatrixMode(KM_GL_MODELVIEW);
@@ -471,6 +475,8 @@ void CCRenderTexture::beginWithClear(float r, float g, float b, float a, float d
 
 void CCRenderTexture::end()
 {
+    CCAutoBatcher::flushShared();
+
     CCDirector *director = CCDirector::sharedDirector();
     
     glBindFramebuffer(GL_FRAMEBUFFER, m_nOldFBO);
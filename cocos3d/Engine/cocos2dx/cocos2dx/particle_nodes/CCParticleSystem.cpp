@@ -81,10 +81,14 @@ NS_CC_BEGIN
 //  cocos2d uses a another approach, but the results are almost identical. 
 //
 
+// number of float arrays in tCCParticleArrays, which are allocated one after the other
+static const unsigned int kCCParticleArraysFloatCount = 21;
+
 CCParticleSystem::CCParticleSystem()
 : m_sPlistFile("")
 , m_fElapsed(0)
 , m_pParticles(NULL)
+, m_pParticleArraysBuffer(NULL)
 , m_fEmitCounter(0)
 , m_uParticleIdx(0)
 , m_pBatchNode(NULL)
@@ -116,7 +120,9 @@ CCParticleSystem::CCParticleSystem()
 , m_ePositionType(kCCPositionTypeFree)
 , m_bIsAutoRemoveOnFinish(false)
 , m_nEmitterMode(kCCParticleModeGravity)
+, m_eParticleStorage(kCCParticleStorageStructs)
 {
+    memset(&m_tParticleArrays, 0, sizeof(m_tParticleArrays));
     modeA.gravity = CCPointZero;
     modeA.speed = 0;
     modeA.speedVar = 0;
@@ -397,7 +403,7 @@ bool CCParticleSystem::initWithTotalParticles(unsigned int numberOfParticles)
     
     m_pParticles = (tCCParticle*)calloc(m_uTotalParticles, sizeof(tCCParticle));
 
-    if( ! m_pParticles )
+    if( ! m_pParticles || (m_eParticleStorage == kCCParticleStorageArrays && ! allocParticleArrays(numberOfParticles)) )
     {
         CCLOG("Particle system: not enough memory");
         this->release();
@@ -448,6 +454,7 @@ CCParticleSystem::~CCParticleSystem()
 	// it is not needed to call "unscheduleUpdate" here. In fact, it will be called in "cleanup"
     //unscheduleUpdate();
     CC_SAFE_FREE(m_pParticles);
+    CC_SAFE_FREE(m_pParticleArraysBuffer);
     CC_SAFE_RELEASE(m_pTexture);
 }
 
@@ -458,8 +465,17 @@ bool CCParticleSystem::addParticle()
         return false;
     }
 
-    tCCParticle * particle = &m_pParticles[ m_uParticleCount ];
-    this->initParticle(particle);
+    if (m_eParticleStorage == kCCParticleStorageArrays)
+    {
+        tCCParticle particle = tCCParticle();
+        this->initParticle(&particle);
+        storeParticle(m_uParticleCount, particle);
+    }
+    else
+    {
+        tCCParticle * particle = &m_pParticles[ m_uParticleCount ];
+        this->initParticle(particle);
+    }
     ++m_uParticleCount;
 
     return true;
@@ -588,6 +604,12 @@ void CCParticleSystem::resetSystem()
 {
     m_bIsActive = true;
     m_fElapsed = 0;
+    if (m_eParticleStorage == kCCParticleStorageArrays)
+    {
+        memset(m_tParticleArrays.timeToLive, 0, m_uParticleCount * sizeof(float));
+        m_uParticleIdx = m_uParticleCount;
+        return;
+    }
     for (m_uParticleIdx = 0; m_uParticleIdx < m_uParticleCount; ++m_uParticleIdx)
     {
         tCCParticle *p = &m_pParticles[m_uParticleIdx];
@@ -640,6 +662,12 @@ void CCParticleSystem::update(float dt)
 
     if (m_bVisible)
     {
+        // updates all the particles, leaving nothing to do to the loop below
+        if (m_eParticleStorage == kCCParticleStorageArrays && ! updateParticleArrays(dt, currentPosition))
+        {
+            return;
+        }
+
         while (m_uParticleIdx < m_uParticleCount)
         {
             tCCParticle *p = &m_pParticles[m_uParticleIdx];
@@ -787,6 +815,287 @@ void CCParticleSystem::postStep()
     // should be overridden
 }
 
+// ParticleSystem - particles stored as arrays
+tCCParticleStorage CCParticleSystem::getParticleStorage()
+{
+    return m_eParticleStorage;
+}
+
+void CCParticleSystem::setParticleStorage(tCCParticleStorage var)
+{
+    if (m_eParticleStorage == var)
+    {
+        return;
+    }
+
+    // the living particles are moved to the new storage
+    if (var == kCCParticleStorageArrays)
+    {
+        if (! allocParticleArrays(m_uAllocatedParticles))
+        {
+            CCLOG("Particle system: not enough memory");
+            return;
+        }
+        for (unsigned int i = 0; i < m_uAllocatedParticles; i++)
+        {
+            if (i < m_uParticleCount)
+            {
+                storeParticle(i, m_pParticles[i]);
+            }
+            m_tParticleArrays.atlasIndex[i] = m_pBatchNode ? m_pParticles[i].atlasIndex : i;
+        }
+    }
+    else
+    {
+        for (unsigned int i = 0; i < m_uAllocatedParticles; i++)
+        {
+            if (i < m_uParticleCount)
+            {
+                loadParticle(i, m_pParticles[i]);
+            }
+            m_pParticles[i].atlasIndex = m_tParticleArrays.atlasIndex[i];
+        }
+        CC_SAFE_FREE(m_pParticleArraysBuffer);
+        memset(&m_tParticleArrays, 0, sizeof(m_tParticleArrays));
+    }
+    m_eParticleStorage = var;
+}
+
+bool CCParticleSystem::allocParticleArrays(unsigned int count)
+{
+    CC_SAFE_FREE(m_pParticleArraysBuffer);
+    memset(&m_tParticleArrays, 0, sizeof(m_tParticleArrays));
+
+    unsigned int allocated = MAX(count, 1);
+    m_pParticleArraysBuffer = calloc(allocated, kCCParticleArraysFloatCount * sizeof(float) + sizeof(unsigned int));
+    if (! m_pParticleArraysBuffer)
+    {
+        return false;
+    }
+
+    tCCParticleArrays& a = m_tParticleArrays;
+    float** arrays[kCCParticleArraysFloatCount] = {
+        &a.posX, &a.posY, &a.startPosX, &a.startPosY,
+        &a.colorR, &a.colorG, &a.colorB, &a.colorA,
+        &a.deltaColorR, &a.deltaColorG, &a.deltaColorB, &a.deltaColorA,
+        &a.size, &a.deltaSize, &a.rotation, &a.deltaRotation, &a.timeToLive,
+        &a.modeA.dirX, &a.modeA.dirY, &a.modeA.radialAccel, &a.modeA.tangentialAccel
+    };
+    float* values = (float*)m_pParticleArraysBuffer;
+    for (unsigned int i = 0; i < kCCParticleArraysFloatCount; i++)
+    {
+        *arrays[i] = values + i * allocated;
+    }
+    a.modeB.angle = a.modeA.dirX;
+    a.modeB.degreesPerSecond = a.modeA.dirY;
+    a.modeB.radius = a.modeA.radialAccel;
+    a.modeB.deltaRadius = a.modeA.tangentialAccel;
+
+    a.atlasIndex = (unsigned int*)(values + kCCParticleArraysFloatCount * allocated);
+    for (unsigned int i = 0; i < allocated; i++)
+    {
+        a.atlasIndex[i] = i;
+    }
+    return true;
+}
+
+void CCParticleSystem::storeParticle(unsigned int index, const tCCParticle& particle)
+{
+    // the atlas index belongs to the slot, not to the particle
+    const tCCParticleArrays& a = m_tParticleArrays;
+    a.posX[index] = particle.pos.x;
+    a.posY[index] = particle.pos.y;
+    a.startPosX[index] = particle.startPos.x;
+    a.startPosY[index] = particle.startPos.y;
+    a.colorR[index] = particle.color.r;
+    a.colorG[index] = particle.color.g;
+    a.colorB[index] = particle.color.b;
+    a.colorA[index] = particle.color.a;
+    a.deltaColorR[index] = particle.deltaColor.r;
+    a.deltaColorG[index] = particle.deltaColor.g;
+    a.deltaColorB[index] = particle.deltaColor.b;
+    a.deltaColorA[index] = particle.deltaColor.a;
+    a.size[index] = particle.size;
+    a.deltaSize[index] = particle.deltaSize;
+    a.rotation[index] = particle.rotation;
+    a.deltaRotation[index] = particle.deltaRotation;
+    a.timeToLive[index] = particle.timeToLive;
+    if (m_nEmitterMode == kCCParticleModeGravity)
+    {
+        a.modeA.dirX[index] = particle.modeA.dir.x;
+        a.modeA.dirY[index] = particle.modeA.dir.y;
+        a.modeA.radialAccel[index] = particle.modeA.radialAccel;
+        a.modeA.tangentialAccel[index] = particle.modeA.tangentialAccel;
+    }
+    else
+    {
+        a.modeB.angle[index] = particle.modeB.angle;
+        a.modeB.degreesPerSecond[index] = particle.modeB.degreesPerSecond;
+        a.modeB.radius[index] = particle.modeB.radius;
+        a.modeB.deltaRadius[index] = particle.modeB.deltaRadius;
+    }
+}
+
+void CCParticleSystem::loadParticle(unsigned int index, tCCParticle& particle)
+{
+    const tCCParticleArrays& a = m_tParticleArrays;
+    particle.pos = ccp(a.posX[index], a.posY[index]);
+    particle.startPos = ccp(a.startPosX[index], a.startPosY[index]);
+    particle.color = ccc4f(a.colorR[index], a.colorG[index], a.colorB[index], a.colorA[index]);
+    particle.deltaColor = ccc4f(a.deltaColorR[index], a.deltaColorG[index], a.deltaColorB[index], a.deltaColorA[index]);
+    particle.size = a.size[index];
+    particle.deltaSize = a.deltaSize[index];
+    particle.rotation = a.rotation[index];
+    particle.deltaRotation = a.deltaRotation[index];
+    particle.timeToLive = a.timeToLive[index];
+    particle.atlasIndex = a.atlasIndex[index];
+    if (m_nEmitterMode == kCCParticleModeGravity)
+    {
+        particle.modeA.dir = ccp(a.modeA.dirX[index], a.modeA.dirY[index]);
+        particle.modeA.radialAccel = a.modeA.radialAccel[index];
+        particle.modeA.tangentialAccel = a.modeA.tangentialAccel[index];
+    }
+    else
+    {
+        particle.modeB.angle = a.modeB.angle[index];
+        particle.modeB.degreesPerSecond = a.modeB.degreesPerSecond[index];
+        particle.modeB.radius = a.modeB.radius[index];
+        particle.modeB.deltaRadius = a.modeB.deltaRadius[index];
+    }
+}
+
+bool CCParticleSystem::updateParticleArrays(float dt, const CCPoint& currentPosition)
+{
+    const tCCParticleArrays& a = m_tParticleArrays;
+    const unsigned int count = m_uParticleCount;
+
+    // Each value is updated by its own loop without branches, so that the compiler vectorizes it.
+    // The particles that are dying are updated as well, and removed afterwards.
+    if (m_nEmitterMode == kCCParticleModeGravity)
+    {
+        // Mode A: gravity, direction, tangential accel & radial accel
+        const float gravityX = modeA.gravity.x;
+        const float gravityY = modeA.gravity.y;
+        float *posX = a.posX, *posY = a.posY, *dirX = a.modeA.dirX, *dirY = a.modeA.dirY;
+        const float *radialAccel = a.modeA.radialAccel, *tangentialAccel = a.modeA.tangentialAccel;
+        for (unsigned int i = 0; i < count; i++)
+        {
+            float x = posX[i];
+            float y = posY[i];
+            float lengthSQ = x * x + y * y;
+            float inverseLength = (lengthSQ > 0) ? 1.0f / sqrtf(lengthSQ) : 0.0f;
+            float radialX = x * inverseLength;
+            float radialY = y * inverseLength;
+
+            // (gravity + radial + tangential) * dt
+            float dx = dirX[i] + (radialX * radialAccel[i] - radialY * tangentialAccel[i] + gravityX) * dt;
+            float dy = dirY[i] + (radialY * radialAccel[i] + radialX * tangentialAccel[i] + gravityY) * dt;
+            dirX[i] = dx;
+            dirY[i] = dy;
+            posX[i] = x + dx * dt;
+            posY[i] = y + dy * dt;
+        }
+    }
+    else
+    {
+        // Mode B: radius movement
+        float *posX = a.posX, *posY = a.posY, *angle = a.modeB.angle, *radius = a.modeB.radius;
+        const float *degreesPerSecond = a.modeB.degreesPerSecond, *deltaRadius = a.modeB.deltaRadius;
+        for (unsigned int i = 0; i < count; i++)
+        {
+            float newAngle = angle[i] + degreesPerSecond[i] * dt;
+            float newRadius = radius[i] + deltaRadius[i] * dt;
+            angle[i] = newAngle;
+            radius[i] = newRadius;
+            posX[i] = - cosf(newAngle) * newRadius;
+            posY[i] = - sinf(newAngle) * newRadius;
+        }
+    }
+
+    // color, size, angle and life
+    for (unsigned int i = 0; i < count; i++)
+    {
+        a.colorR[i] += a.deltaColorR[i] * dt;
+        a.colorG[i] += a.deltaColorG[i] * dt;
+        a.colorB[i] += a.deltaColorB[i] * dt;
+        a.colorA[i] += a.deltaColorA[i] * dt;
+    }
+    for (unsigned int i = 0; i < count; i++)
+    {
+        float size = a.size[i] + a.deltaSize[i] * dt;
+        a.size[i] = MAX(0, size);
+        a.rotation[i] += a.deltaRotation[i] * dt;
+        a.timeToLive[i] -= dt;
+    }
+
+    // remove the dead particles by moving the last particles in their place
+    float *values = a.posX;
+    const unsigned int stride = MAX(m_uAllocatedParticles, 1);
+    unsigned int i = 0;
+    while (i < m_uParticleCount)
+    {
+        if (a.timeToLive[i] > 0)
+        {
+            ++i;
+            continue;
+        }
+
+        unsigned int last = m_uParticleCount - 1;
+        if (i != last)
+        {
+            for (unsigned int j = 0; j < kCCParticleArraysFloatCount; j++)
+            {
+                values[j * stride + i] = values[j * stride + last];
+            }
+        }
+        if (m_pBatchNode)
+        {
+            //disable the switched particle
+            unsigned int currentIndex = a.atlasIndex[i];
+            m_pBatchNode->disableParticle(m_uAtlasIndex+currentIndex);
+
+            //switch indexes
+            a.atlasIndex[i] = a.atlasIndex[last];
+            a.atlasIndex[last] = currentIndex;
+        }
+
+        --m_uParticleCount;
+
+        if( m_uParticleCount == 0 && m_bIsAutoRemoveOnFinish )
+        {
+            this->unscheduleUpdate();
+            if ( m_pParent != NULL )
+                m_pParent->removeChild(this, true);
+            return false;
+        }
+    }
+
+    updateQuadsWithParticleArrays(currentPosition);
+    m_uParticleIdx = m_uParticleCount;
+    return true;
+}
+
+void CCParticleSystem::updateQuadsWithParticleArrays(const CCPoint& currentPosition)
+{
+    for (m_uParticleIdx = 0; m_uParticleIdx < m_uParticleCount; ++m_uParticleIdx)
+    {
+        tCCParticle particle;
+        loadParticle(m_uParticleIdx, particle);
+
+        CCPoint newPos = particle.pos;
+        if (m_ePositionType == kCCPositionTypeFree || m_ePositionType == kCCPositionTypeRelative) 
+        {
+            newPos = ccpSub(particle.pos, ccpSub(currentPosition, particle.startPos));
+        }
+        if (m_pBatchNode)
+        {
+            newPos = ccpAdd(newPos, m_obPosition);
+        }
+
+        updateQuadWithParticle(&particle, newPos);
+    }
+}
+
 // ParticleSystem - CCTexture protocol
 void CCParticleSystem::setTexture(CCTexture2D* var)
 {
@@ -1321,6 +1630,15 @@ void CCParticleSystem::setBatchNode(CCParticleBatchNode* batchNode)
                 m_pParticles[i].atlasIndex=i;
             }
         }
+
+        // the quads of the particles stored as arrays are found through their atlas index, even without a batch node
+        if (m_eParticleStorage == kCCParticleStorageArrays)
+        {
+            for (unsigned int i = 0; i < m_uAllocatedParticles; i++)
+            {
+                m_tParticleArrays.atlasIndex[i] = i;
+            }
+        }
     }
 }
 
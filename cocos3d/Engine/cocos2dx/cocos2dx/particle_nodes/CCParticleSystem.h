@@ -125,6 +125,68 @@ typedef struct sCCParticle {
 
 }tCCParticle;
 
+/** @typedef tCCParticleStorage
+possible ways of storing and updating the particles of a system
+@since v2.2.6
+*/
+typedef enum {
+    /** Each particle is a tCCParticle of the particles array, whose quad is updated by updateQuadWithParticle(). */
+    kCCParticleStorageStructs,
+
+    /** Each value of the particles is stored in its own array, updated by loops that the compiler can vectorize.
+    CCParticleSystemQuad writes the quads directly from the arrays, without calling updateQuadWithParticle().
+    */
+    kCCParticleStorageArrays,
+} tCCParticleStorage;
+
+/**
+Structure that contains the arrays of the values of the particles, when they are stored as arrays.
+The arrays of the radius mode share their storage with the arrays of the gravity mode.
+@since v2.2.6
+*/
+typedef struct sCCParticleArrays {
+    float       *posX;
+    float       *posY;
+    float       *startPosX;
+    float       *startPosY;
+
+    float       *colorR;
+    float       *colorG;
+    float       *colorB;
+    float       *colorA;
+    float       *deltaColorR;
+    float       *deltaColorG;
+    float       *deltaColorB;
+    float       *deltaColorA;
+
+    float       *size;
+    float       *deltaSize;
+
+    float       *rotation;
+    float       *deltaRotation;
+
+    float       *timeToLive;
+
+    unsigned int    *atlasIndex;
+
+    //! Mode A: gravity, direction, radial accel, tangential accel
+    struct {
+        float   *dirX;
+        float   *dirY;
+        float   *radialAccel;
+        float   *tangentialAccel;
+    } modeA;
+
+    //! Mode B: radius mode
+    struct {
+        float   *angle;
+        float   *degreesPerSecond;
+        float   *radius;
+        float   *deltaRadius;
+    } modeB;
+
+}tCCParticleArrays;
+
 //typedef void (*CC_UPDATE_PARTICLE_IMP)(id, SEL, tCCParticle*, CCPoint);
 
 class CCTexture2D;
@@ -219,6 +281,10 @@ protected:
     //! Array of particles
     tCCParticle *m_pParticles;
 
+    //! Arrays of the values of the particles, when they are stored as arrays
+    tCCParticleArrays m_tParticleArrays;
+    void *m_pParticleArraysBuffer;
+
     // color modulate
     //    BOOL colorModulate;
 
@@ -368,6 +434,13 @@ public:
     */
     CC_PROPERTY(int, m_nEmitterMode, EmitterMode)
 
+    /** How the particles are stored and updated. kCCParticleStorageStructs by default.
+    Stored as arrays, the particles of large systems, or of many systems, are updated several times faster.
+    Subclasses that override updateQuadWithParticle() to customize the quads should keep the default.
+    @since v2.2.6
+    */
+    CC_PROPERTY(tCCParticleStorage, m_eParticleStorage, ParticleStorage)
+
 public:
     CCParticleSystem();
     virtual ~CCParticleSystem();
@@ -424,6 +497,17 @@ public:
 
 protected:
     virtual void updateBlendFunc();
+
+    /** updates the quads of the particles stored as arrays.
+    By default calls updateQuadWithParticle() for each particle.
+    @since v2.2.6
+    */
+    virtual void updateQuadsWithParticleArrays(const CCPoint& currentPosition);
+
+    bool allocParticleArrays(unsigned int count);
+    void storeParticle(unsigned int index, const tCCParticle& particle);
+    void loadParticle(unsigned int index, tCCParticle& particle);
+    bool updateParticleArrays(float dt, const CCPoint& currentPosition);
 };
 
 // end of particle_nodes group
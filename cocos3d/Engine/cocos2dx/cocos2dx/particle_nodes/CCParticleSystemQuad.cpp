@@ -323,12 +323,99 @@ void CCParticleSystemQuad::updateQuadWithParticle(tCCParticle* particle, const C
         quad->tr.vertices.y = newPosition.y + size_2;                
     }
 }
+void CCParticleSystemQuad::updateQuadsWithParticleArrays(const CCPoint& currentPosition)
+{
+    const tCCParticleArrays& a = m_tParticleArrays;
+    const unsigned int count = m_uParticleCount;
+
+    ccV3F_C4B_T2F_Quad *quads = m_pQuads;
+    if (m_pBatchNode)
+    {
+        quads = m_pBatchNode->getTextureAtlas()->getQuads() + m_uAtlasIndex;
+    }
+
+    // newPos = pos - (currentPosition - startPos), translated by the position of the system in a batch node,
+    // and = pos when the particles are grouped
+    const float startFactor = (m_ePositionType == kCCPositionTypeFree || m_ePositionType == kCCPositionTypeRelative) ? 1.0f : 0.0f;
+    const float offsetX = (m_pBatchNode ? m_obPosition.x : 0) - currentPosition.x * startFactor;
+    const float offsetY = (m_pBatchNode ? m_obPosition.y : 0) - currentPosition.y * startFactor;
+
+    // the alpha multiplies the colors when the opacity modifies them
+    const float opacityFactor = m_bOpacityModifyRGB ? 1.0f : 0.0f;
+
+    bool rotated = false;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        rotated |= (a.rotation[i] != 0);
+    }
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        ccV3F_C4B_T2F_Quad *quad = &quads[a.atlasIndex[i]];
+
+        float alpha = a.colorA[i];
+        float colorFactor = (alpha * opacityFactor + (1 - opacityFactor)) * 255;
+        ccColor4B color = ccc4(a.colorR[i] * colorFactor, a.colorG[i] * colorFactor, a.colorB[i] * colorFactor, alpha * 255);
+        quad->bl.colors = color;
+        quad->br.colors = color;
+        quad->tl.colors = color;
+        quad->tr.colors = color;
+    }
+
+    if (rotated)
+    {
+        for (unsigned int i = 0; i < count; i++)
+        {
+            ccV3F_C4B_T2F_Quad *quad = &quads[a.atlasIndex[i]];
+
+            GLfloat x = a.posX[i] + a.startPosX[i] * startFactor + offsetX;
+            GLfloat y = a.posY[i] + a.startPosY[i] * startFactor + offsetY;
+            GLfloat size_2 = a.size[i] / 2;
+
+            GLfloat r = (GLfloat)-CC_DEGREES_TO_RADIANS(a.rotation[i]);
+            GLfloat cr = cosf(r) * size_2;
+            GLfloat sr = sinf(r) * size_2;
+
+            // bottom-left, bottom-right, top-left and top-right vertices of the rotated square
+            quad->bl.vertices.x = - cr + sr + x;
+            quad->bl.vertices.y = - sr - cr + y;
+            quad->br.vertices.x = cr + sr + x;
+            quad->br.vertices.y = sr - cr + y;
+            quad->tl.vertices.x = - cr - sr + x;
+            quad->tl.vertices.y = - sr + cr + y;
+            quad->tr.vertices.x = cr - sr + x;
+            quad->tr.vertices.y = sr + cr + y;
+        }
+    }
+    else
+    {
+        for (unsigned int i = 0; i < count; i++)
+        {
+            ccV3F_C4B_T2F_Quad *quad = &quads[a.atlasIndex[i]];
+
+            GLfloat x = a.posX[i] + a.startPosX[i] * startFactor + offsetX;
+            GLfloat y = a.posY[i] + a.startPosY[i] * startFactor + offsetY;
+            GLfloat size_2 = a.size[i] / 2;
+
+            quad->bl.vertices.x = x - size_2;
+            quad->bl.vertices.y = y - size_2;
+            quad->br.vertices.x = x + size_2;
+            quad->br.vertices.y = y - size_2;
+            quad->tl.vertices.x = x - size_2;
+            quad->tl.vertices.y = y + size_2;
+            quad->tr.vertices.x = x + size_2;
+            quad->tr.vertices.y = y + size_2;
+        }
+    }
+}
+
 void CCParticleSystemQuad::postStep()
 {
     glBindBuffer(GL_ARRAY_BUFFER, m_pBuffersVBO[0]);
 	
-	// Option 1: Sub Data
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(m_pQuads[0])*m_uTotalParticles, m_pQuads);
+	// Option 1: Orphaning + Sub Data of the quads of the living particles, which are the only ones drawn
+    glBufferData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0])*m_uTotalParticles, NULL, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(m_pQuads[0])*m_uParticleIdx, m_pQuads);
 	
 	// Option 2: Data
     //	glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * particleCount, quads_, GL_DYNAMIC_DRAW);
@@ -436,6 +523,12 @@ void CCParticleSystemQuad::setTotalParticles(unsigned int tp)
             memset(m_pQuads, 0, quadsSize);
             memset(m_pIndices, 0, indicesSize);
 
+            if (m_eParticleStorage == kCCParticleStorageArrays && ! allocParticleArrays(tp))
+            {
+                CCLOG("Particle system: out of memory");
+                return;
+            }
+
             m_uAllocatedParticles = tp;
         }
         else
@@ -111,6 +111,11 @@ public:
      * @js NA
      */
     virtual void postStep();
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual void updateQuadsWithParticleArrays(const CCPoint& currentPosition);
     /**
      * @js NA
      * @lua NA
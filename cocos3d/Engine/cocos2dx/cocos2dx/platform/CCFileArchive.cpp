@@ -0,0 +1,360 @@
+/****************************************************************************
+Copyright (c) 2010-2013 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CCFileArchive.h"
+#include "ccMacros.h"
+#include "support/zip_support/ZipUtils.h"
+#include <zlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) \
+    || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_BLACKBERRY) || (CC_TARGET_PLATFORM == CC_PLATFORM_TIZEN)
+#define CC_FILE_ARCHIVE_USE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <windows.h>
+#endif
+
+NS_CC_BEGIN
+
+CCFileArchive::CCFileArchive()
+: m_pData(NULL)
+, m_uSize(0)
+, m_bMapped(false)
+, m_pEntries(NULL)
+, m_uEntryCount(0)
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+, m_hFile(NULL)
+, m_hMapping(NULL)
+#endif
+{
+}
+
+CCFileArchive::~CCFileArchive()
+{
+    close();
+}
+
+bool CCFileArchive::openFile(const std::string& fullPath)
+{
+    close();
+
+#if defined(CC_FILE_ARCHIVE_USE_MMAP)
+    int fd = open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void* pMapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pMapping != MAP_FAILED)
+        {
+            m_pData = (unsigned char*)pMapping;
+            m_uSize = st.st_size;
+            m_bMapped = true;
+        }
+    }
+    // the mapping remains valid once the file is closed
+    ::close(fd);
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    HANDLE hFile = CreateFileA(fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    DWORD size = GetFileSize(hFile, NULL);
+    HANDLE hMapping = (size > 0) ? CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    void* pMapping = hMapping ? MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (pMapping)
+    {
+        m_pData = (unsigned char*)pMapping;
+        m_uSize = size;
+        m_bMapped = true;
+        m_hFile = hFile;
+        m_hMapping = hMapping;
+    }
+    else
+    {
+        if (hMapping)
+        {
+            CloseHandle(hMapping);
+        }
+        CloseHandle(hFile);
+    }
+#endif
+
+    if (!m_pData)
+    {
+        // read the whole archive where it cannot be mapped
+        FILE* fp = fopen(fullPath.c_str(), "rb");
+        if (!fp)
+        {
+            return false;
+        }
+        fseek(fp, 0, SEEK_END);
+        unsigned long size = ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+        unsigned char* pData = new unsigned char[size];
+        size = fread(pData, sizeof(unsigned char), size, fp);
+        fclose(fp);
+        return openData(pData, size);
+    }
+
+    if (!validate())
+    {
+        CCLOG("cocos2d: CCFileArchive: %s is not a valid archive", fullPath.c_str());
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool CCFileArchive::openData(unsigned char* pData, unsigned long size)
+{
+    close();
+
+    m_pData = pData;
+    m_uSize = size;
+    m_bMapped = false;
+
+    if (!validate())
+    {
+        CCLOG("cocos2d: CCFileArchive: invalid archive data");
+        close();
+        return false;
+    }
+    return true;
+}
+
+void CCFileArchive::close()
+{
+    if (m_pData)
+    {
+        if (!m_bMapped)
+        {
+            delete [] m_pData;
+        }
+#if defined(CC_FILE_ARCHIVE_USE_MMAP)
+        else
+        {
+            munmap(m_pData, m_uSize);
+        }
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        else
+        {
+            UnmapViewOfFile(m_pData);
+            CloseHandle((HANDLE)m_hMapping);
+            CloseHandle((HANDLE)m_hFile);
+            m_hMapping = NULL;
+            m_hFile = NULL;
+        }
+#endif
+    }
+
+    m_pData = NULL;
+    m_uSize = 0;
+    m_bMapped = false;
+    m_pEntries = NULL;
+    m_uEntryCount = 0;
+}
+
+bool CCFileArchive::validate()
+{
+    if (m_uSize < sizeof(CCFileArchiveHeader))
+    {
+        return false;
+    }
+
+    const CCFileArchiveHeader* header = (const CCFileArchiveHeader*)m_pData;
+    if (header->sig[0] != 'C' || header->sig[1] != 'C' || header->sig[2] != 'P' || header->sig[3] != 'K')
+    {
+        return false;
+    }
+    if (header->version != 1)
+    {
+        CCLOG("cocos2d: CCFileArchive: unsupported version %d", header->version);
+        return false;
+    }
+
+    // the table is read in place, so it must be aligned and lie within the archive
+    unsigned long tableSize = (unsigned long)header->entryCount * sizeof(CCFileArchiveEntry);
+    if ((header->entriesOffset % 4) != 0 || header->entriesOffset > m_uSize || tableSize > m_uSize - header->entriesOffset)
+    {
+        return false;
+    }
+
+    const CCFileArchiveEntry* entries = (const CCFileArchiveEntry*)(m_pData + header->entriesOffset);
+    for (unsigned int i = 0; i < header->entryCount; ++i)
+    {
+        const CCFileArchiveEntry& entry = entries[i];
+        if (entry.nameOffset > m_uSize || entry.nameLength > m_uSize - entry.nameOffset
+            || entry.dataOffset > m_uSize || entry.storedSize > m_uSize - entry.dataOffset
+            || (i > 0 && entries[i - 1].hash > entry.hash)
+            || (entry.compression == kCCFileArchiveCompressionNone && entry.storedSize != entry.size))
+        {
+            return false;
+        }
+    }
+
+    m_pEntries = entries;
+    m_uEntryCount = header->entryCount;
+    return true;
+}
+
+unsigned int CCFileArchive::hashPath(const char* path, unsigned int length)
+{
+    unsigned int hash = 2166136261u;
+    for (unsigned int i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)path[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+const CCFileArchiveEntry* CCFileArchive::findEntry(const std::string& fileName) const
+{
+    if (!m_pEntries)
+    {
+        return NULL;
+    }
+
+    unsigned int hash = hashPath(fileName.c_str(), fileName.length());
+
+    // find the first entry with the hash, then compare the paths of all entries sharing it
+    unsigned int low = 0;
+    unsigned int high = m_uEntryCount;
+    while (low < high)
+    {
+        unsigned int mid = low + (high - low) / 2;
+        if (m_pEntries[mid].hash < hash)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    for (unsigned int i = low; i < m_uEntryCount && m_pEntries[i].hash == hash; ++i)
+    {
+        const CCFileArchiveEntry& entry = m_pEntries[i];
+        if (entry.nameLength == fileName.length()
+            && memcmp(m_pData + entry.nameOffset, fileName.c_str(), entry.nameLength) == 0)
+        {
+            return &entry;
+        }
+    }
+    return NULL;
+}
+
+bool CCFileArchive::fileExists(const std::string& fileName) const
+{
+    return findEntry(fileName) != NULL;
+}
+
+const unsigned char* CCFileArchive::getMappedData(const std::string& fileName, unsigned long* pSize) const
+{
+    const CCFileArchiveEntry* entry = findEntry(fileName);
+    if (!entry || entry->compression != kCCFileArchiveCompressionNone)
+    {
+        if (pSize)
+        {
+            *pSize = 0;
+        }
+        return NULL;
+    }
+
+    if (pSize)
+    {
+        *pSize = entry->size;
+    }
+    return m_pData + entry->dataOffset;
+}
+
+unsigned char* CCFileArchive::getFileData(const std::string& fileName, unsigned long* pSize) const
+{
+    unsigned char* pBuffer = NULL;
+    if (pSize)
+    {
+        *pSize = 0;
+    }
+
+    do
+    {
+        const CCFileArchiveEntry* entry = findEntry(fileName);
+        CC_BREAK_IF(!entry);
+
+        const unsigned char* pStored = m_pData + entry->dataOffset;
+        pBuffer = new unsigned char[entry->size];
+
+        switch (entry->compression)
+        {
+            case kCCFileArchiveCompressionNone:
+                memcpy(pBuffer, pStored, entry->size);
+                break;
+
+            case kCCFileArchiveCompressionZlib:
+            {
+                uLongf size = entry->size;
+                if (uncompress(pBuffer, &size, pStored, entry->storedSize) != Z_OK || size != entry->size)
+                {
+                    CCLOG("cocos2d: CCFileArchive: failed to uncompress %s", fileName.c_str());
+                    CC_SAFE_DELETE_ARRAY(pBuffer);
+                }
+                break;
+            }
+
+            case kCCFileArchiveCompressionLZ4:
+                if (ZipUtils::ccDecompressLZ4(pStored, entry->storedSize, pBuffer, entry->size) != (int)entry->size)
+                {
+                    CCLOG("cocos2d: CCFileArchive: failed to decompress %s", fileName.c_str());
+                    CC_SAFE_DELETE_ARRAY(pBuffer);
+                }
+                break;
+
+            default:
+                CCLOG("cocos2d: CCFileArchive: unsupported compression %d for %s", entry->compression, fileName.c_str());
+                CC_SAFE_DELETE_ARRAY(pBuffer);
+                break;
+        }
+
+        if (pBuffer && pSize)
+        {
+            *pSize = entry->size;
+        }
+    } while (0);
+
+    return pBuffer;
+}
+
+NS_CC_END
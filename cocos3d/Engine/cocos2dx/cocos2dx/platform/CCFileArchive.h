@@ -0,0 +1,146 @@
+/****************************************************************************
+Copyright (c) 2010-2013 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CC_FILEARCHIVE_H__
+#define __CC_FILEARCHIVE_H__
+
+#include <string>
+#include "CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** @struct CCFileArchiveHeader
+ *  The header at the start of a packed file archive. All fields are little-endian.
+ */
+struct CCFileArchiveHeader {
+    unsigned char   sig[4];             // signature. Should be 'CCPK' 4 bytes
+    unsigned short  version;            // should be 1
+    unsigned short  reserved;           // Reserved for users.
+    unsigned int    entryCount;         // number of entries in the table
+    unsigned int    entriesOffset;      // offset of the entry table, sorted by path hash
+};
+
+/** @struct CCFileArchiveEntry
+ *  An entry of the table of a packed file archive.
+ */
+struct CCFileArchiveEntry {
+    unsigned int    hash;               // CCFileArchive::hashPath() of the path
+    unsigned int    nameOffset;         // offset of the path, which is not null-terminated
+    unsigned short  nameLength;         // length of the path
+    unsigned short  compression;        // one of the CCFileArchiveCompression values
+    unsigned int    dataOffset;         // offset of the stored data
+    unsigned int    storedSize;         // size of the stored data
+    unsigned int    size;               // size of the file once uncompressed
+};
+
+enum CCFileArchiveCompression {
+    kCCFileArchiveCompressionNone,      // stored as is, and can be read without copying.
+    kCCFileArchiveCompressionZlib,      // zlib format.
+    kCCFileArchiveCompressionLZ4,       // lz4 block format. Faster to decompress than zlib, but larger.
+};
+
+/**
+ * Packed file archive - reader helper class.
+ *
+ * A packed archive holds many files in one file, along with a table of their paths sorted by
+ * hash, so that a file is located without scanning the archive or querying the file system.
+ * Archives are built with tools/pack-archive/pack_archive.py.
+ *
+ * When the archive is a file on disk, it is memory mapped, and the files that are stored
+ * uncompressed can be read directly from the mapping, without any copy.
+ *
+ * @since v2.2.6
+ */
+class CC_DLL CCFileArchive
+{
+public:
+    CCFileArchive();
+    virtual ~CCFileArchive();
+
+    /**
+     * Opens the archive file at the specified full path, mapping it into memory when the platform allows.
+     * @return true if the archive is valid.
+     */
+    bool openFile(const std::string& fullPath);
+
+    /**
+     * Opens an archive held in memory. The archive takes ownership of the buffer,
+     * which must have been allocated with new[].
+     * @return true if the archive is valid. The buffer is freed if not.
+     */
+    bool openData(unsigned char* pData, unsigned long size);
+
+    /** Closes the archive, invalidating all the pointers returned by getMappedData. */
+    void close();
+
+    bool isOpen() const { return m_pData != NULL; }
+
+    /** Returns the number of files in the archive. */
+    unsigned int getEntryCount() const { return m_uEntryCount; }
+
+    /** Checks whether a file exists in the archive. */
+    bool fileExists(const std::string& fileName) const;
+
+    /**
+     * Returns the content of a file that is stored uncompressed, without copying it.
+     * The content remains valid until the archive is closed.
+     * @return NULL if the file is not in the archive, or is compressed.
+     */
+    const unsigned char* getMappedData(const std::string& fileName, unsigned long* pSize) const;
+
+    /**
+     * Gets the content of a file in the archive, uncompressing it if needed.
+     * @param[out] pSize If the file read operation succeeds, it will be the data size, otherwise 0.
+     * @warning Recall: you are responsible for calling delete[] on any Non-NULL pointer returned.
+     */
+    unsigned char* getFileData(const std::string& fileName, unsigned long* pSize) const;
+
+    /** The hash by which the paths of the archive are sorted (32-bit FNV-1a). */
+    static unsigned int hashPath(const char* path, unsigned int length);
+
+private:
+    bool validate();
+    const CCFileArchiveEntry* findEntry(const std::string& fileName) const;
+
+    unsigned char* m_pData;
+    unsigned long m_uSize;
+    bool m_bMapped;
+    const CCFileArchiveEntry* m_pEntries;
+    unsigned int m_uEntryCount;
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    void* m_hFile;
+    void* m_hMapping;
+#endif
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif    // __CC_FILEARCHIVE_H__
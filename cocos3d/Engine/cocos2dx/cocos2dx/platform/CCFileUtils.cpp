@@ -24,13 +24,25 @@ THE SOFTWARE.
 
 #include "CCFileUtils.h"
 #include "CCDirector.h"
+#include "CCScheduler.h"
 #include "cocoa/CCDictionary.h"
 #include "cocoa/CCString.h"
 #include "CCSAXParser.h"
 #include "support/tinyxml2/tinyxml2.h"
 #include "support/zip_support/unzip.h"
+#include "support/zip_support/ZipUtils.h"
+#include "CCFileArchive.h"
+#include "CCThread.h"
 #include <stack>
+#include <list>
 #include <algorithm>
+#include <pthread.h>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
+#include <ppl.h>
+#include <ppltasks.h>
+using namespace concurrency;
+#endif
 
 using namespace std;
 
@@ -468,8 +480,13 @@ CCFileUtils::CCFileUtils()
 {
 }
 
+static void stopAsyncFileLoader();
+
 CCFileUtils::~CCFileUtils()
 {
+    stopAsyncFileLoader();
+    closeZipFiles();
+    unmountAllArchives();
     CC_SAFE_RELEASE(m_pFilenameLookupDict);
 }
 
@@ -483,6 +500,7 @@ bool CCFileUtils::init()
 void CCFileUtils::purgeCachedEntries()
 {
     m_fullPathCache.clear();
+    closeZipFiles();
 }
 
 unsigned char* CCFileUtils::getFileData(const char* pszFileName, const char* pszMode, unsigned long * pSize)
@@ -494,6 +512,7 @@ unsigned char* CCFileUtils::getFileData(const char* pszFileName, const char* psz
     {
         // read the file from hardware
         std::string fullPath = fullPathForFilename(pszFileName);
+        CC_BREAK_IF(getFileDataFromArchives(fullPath, &pBuffer, pSize));
         FILE *fp = fopen(fullPath.c_str(), pszMode);
         CC_BREAK_IF(!fp);
         
@@ -515,10 +534,188 @@ unsigned char* CCFileUtils::getFileData(const char* pszFileName, const char* psz
     return pBuffer;
 }
 
+// The mounted archives are changed on the main thread while the loading threads read from them.
+static pthread_mutex_t s_archivesMutex = PTHREAD_MUTEX_INITIALIZER;
+
+bool CCFileUtils::mountArchive(const char* pszArchivePath)
+{
+    CCAssert(pszArchivePath != NULL, "Invalid parameters.");
+
+    std::string fullPath = fullPathForFilename(pszArchivePath);
+    unmountArchive(fullPath.c_str());
+
+    CCFileArchive* pArchive = new CCFileArchive();
+    bool bOpened = pArchive->openFile(fullPath);
+    if (!bOpened)
+    {
+        // the archive may not be a file on disk, such as the assets of an Android package
+        unsigned long size = 0;
+        unsigned char* pData = getFileData(fullPath.c_str(), "rb", &size);
+        bOpened = pData && pArchive->openData(pData, size);
+    }
+
+    if (!bOpened)
+    {
+        CCLOG("cocos2d: CCFileUtils: can not mount archive %s", fullPath.c_str());
+        delete pArchive;
+        return false;
+    }
+
+    pthread_mutex_lock(&s_archivesMutex);
+    m_mountedArchives.push_back(std::make_pair(fullPath + "/", pArchive));
+    pthread_mutex_unlock(&s_archivesMutex);
+
+    // files that were found on the search paths may now be found in the archive
+    m_fullPathCache.clear();
+    return true;
+}
+
+void CCFileUtils::unmountArchive(const char* pszArchivePath)
+{
+    CCAssert(pszArchivePath != NULL, "Invalid parameters.");
+
+    std::string mountPoint = fullPathForFilename(pszArchivePath) + "/";
+    pthread_mutex_lock(&s_archivesMutex);
+    for (std::vector<std::pair<std::string, CCFileArchive*> >::iterator it = m_mountedArchives.begin(); it != m_mountedArchives.end(); ++it)
+    {
+        if (it->first == mountPoint)
+        {
+            delete it->second;
+            m_mountedArchives.erase(it);
+            m_fullPathCache.clear();
+            break;
+        }
+    }
+    pthread_mutex_unlock(&s_archivesMutex);
+}
+
+void CCFileUtils::unmountAllArchives()
+{
+    pthread_mutex_lock(&s_archivesMutex);
+    for (unsigned int i = 0; i < m_mountedArchives.size(); ++i)
+    {
+        delete m_mountedArchives[i].second;
+    }
+    m_mountedArchives.clear();
+    pthread_mutex_unlock(&s_archivesMutex);
+    m_fullPathCache.clear();
+}
+
+CCFileArchive* CCFileUtils::getArchiveForFullPath(const std::string& fullPath, std::string& archivedPath)
+{
+    for (std::vector<std::pair<std::string, CCFileArchive*> >::reverse_iterator it = m_mountedArchives.rbegin(); it != m_mountedArchives.rend(); ++it)
+    {
+        const std::string& mountPoint = it->first;
+        if (fullPath.compare(0, mountPoint.length(), mountPoint) == 0)
+        {
+            archivedPath = fullPath.substr(mountPoint.length());
+            return it->second;
+        }
+    }
+    return NULL;
+}
+
+std::string CCFileUtils::getPathInArchives(const std::string& filename)
+{
+    std::string file = filename;
+    std::string file_path = "";
+    size_t pos = filename.find_last_of("/");
+    if (pos != std::string::npos)
+    {
+        file_path = filename.substr(0, pos+1);
+        file = filename.substr(pos+1);
+    }
+
+    // file_path + resourceDirectory + file, as on the search paths
+    std::string fullPath = "";
+    pthread_mutex_lock(&s_archivesMutex);
+    for (std::vector<std::string>::iterator resOrderIter = m_searchResolutionsOrderArray.begin();
+         resOrderIter != m_searchResolutionsOrderArray.end() && fullPath.empty(); ++resOrderIter)
+    {
+        std::string archivedPath = file_path + *resOrderIter + file;
+        for (std::vector<std::pair<std::string, CCFileArchive*> >::reverse_iterator it = m_mountedArchives.rbegin(); it != m_mountedArchives.rend(); ++it)
+        {
+            if (it->second->fileExists(archivedPath))
+            {
+                fullPath = it->first + archivedPath;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&s_archivesMutex);
+    return fullPath;
+}
+
+bool CCFileUtils::getFileDataFromArchives(const std::string& fullPath, unsigned char** ppBuffer, unsigned long * pSize)
+{
+    // held until the data is read, so that the archive can not be unmounted under a loading thread
+    pthread_mutex_lock(&s_archivesMutex);
+    std::string archivedPath;
+    CCFileArchive* pArchive = getArchiveForFullPath(fullPath, archivedPath);
+    if (pArchive)
+    {
+        *ppBuffer = pArchive->getFileData(archivedPath, pSize);
+    }
+    pthread_mutex_unlock(&s_archivesMutex);
+    return pArchive != NULL;
+}
+
+const unsigned char* CCFileUtils::getMappedFileData(const char* pszFileName, unsigned long * pSize)
+{
+    CCAssert(pszFileName != NULL && pSize != NULL, "Invalid parameters.");
+    *pSize = 0;
+
+    if (m_mountedArchives.empty())
+    {
+        return NULL;
+    }
+
+    std::string fullPath = fullPathForFilename(pszFileName);
+    pthread_mutex_lock(&s_archivesMutex);
+    std::string archivedPath;
+    CCFileArchive* pArchive = getArchiveForFullPath(fullPath, archivedPath);
+    const unsigned char* pData = pArchive ? pArchive->getMappedData(archivedPath, pSize) : NULL;
+    pthread_mutex_unlock(&s_archivesMutex);
+    return pData;
+}
+
+// The open zip files are shared by the main thread and the loading thread.
+static pthread_mutex_t s_zipFileMutex = PTHREAD_MUTEX_INITIALIZER;
+
+ZipFile* CCFileUtils::getZipFile(const std::string& zipFilePath)
+{
+    std::map<std::string, ZipFile*>::iterator it = m_openZipFiles.find(zipFilePath);
+    if (it != m_openZipFiles.end())
+    {
+        return it->second;
+    }
+
+    // index the central directory once, so later reads seek straight to their entry
+    ZipFile* pZipFile = new ZipFile(zipFilePath);
+    if (!pZipFile->isOpen())
+    {
+        // not cached, the zip file may be created later
+        delete pZipFile;
+        return NULL;
+    }
+    m_openZipFiles[zipFilePath] = pZipFile;
+    return pZipFile;
+}
+
+void CCFileUtils::closeZipFiles()
+{
+    pthread_mutex_lock(&s_zipFileMutex);
+    for (std::map<std::string, ZipFile*>::iterator it = m_openZipFiles.begin(); it != m_openZipFiles.end(); ++it)
+    {
+        delete it->second;
+    }
+    m_openZipFiles.clear();
+    pthread_mutex_unlock(&s_zipFileMutex);
+}
+
 unsigned char* CCFileUtils::getFileDataFromZip(const char* pszZipFilePath, const char* pszFileName, unsigned long * pSize)
 {
     unsigned char * pBuffer = NULL;
-    unzFile pFile = NULL;
     *pSize = 0;
 
     do 
@@ -526,34 +723,383 @@ unsigned char* CCFileUtils::getFileDataFromZip(const char* pszZipFilePath, const
         CC_BREAK_IF(!pszZipFilePath || !pszFileName);
         CC_BREAK_IF(strlen(pszZipFilePath) == 0);
 
-        pFile = unzOpen(pszZipFilePath);
-        CC_BREAK_IF(!pFile);
+        pthread_mutex_lock(&s_zipFileMutex);
+        ZipFile* pZipFile = getZipFile(pszZipFilePath);
+        if (pZipFile)
+        {
+            pBuffer = pZipFile->getFileData(pszFileName, pSize);
+        }
+        pthread_mutex_unlock(&s_zipFileMutex);
+    } while (0);
 
-        int nRet = unzLocateFile(pFile, pszFileName, 1);
-        CC_BREAK_IF(UNZ_OK != nRet);
+    return pBuffer;
+}
 
-        char szFilePathA[260];
-        unz_file_info FileInfo;
-        nRet = unzGetCurrentFileInfo(pFile, &FileInfo, szFilePathA, sizeof(szFilePathA), NULL, 0, NULL, 0);
-        CC_BREAK_IF(UNZ_OK != nRet);
+unsigned char* CCFileUtils::getFileDataOnLoadingThread(const char* pszFileName, const char* pszMode, unsigned long * pSize)
+{
+    return getFileData(pszFileName, pszMode, pSize);
+}
 
-        nRet = unzOpenCurrentFile(pFile);
-        CC_BREAK_IF(UNZ_OK != nRet);
+// implementation of CCFileDataRequest
 
-        pBuffer = new unsigned char[FileInfo.uncompressed_size];
-        int CC_UNUSED nSize = unzReadCurrentFile(pFile, pBuffer, FileInfo.uncompressed_size);
-        CCAssert(nSize == 0 || nSize == (int)FileInfo.uncompressed_size, "the file size is wrong");
+CCFileDataRequest::CCFileDataRequest()
+: m_uRequestID(0)
+, m_nPriority(0)
+, m_bCancelled(false)
+, m_pTarget(NULL)
+, m_pSelector(NULL)
+, m_pData(NULL)
+, m_uSize(0)
+{
+}
 
-        *pSize = FileInfo.uncompressed_size;
-        unzCloseCurrentFile(pFile);
-    } while (0);
+CCFileDataRequest::~CCFileDataRequest()
+{
+    CC_SAFE_DELETE_ARRAY(m_pData);
+}
+
+unsigned char* CCFileDataRequest::takeData()
+{
+    unsigned char* pData = m_pData;
+    m_pData = NULL;
+    m_uSize = 0;
+    return pData;
+}
+
+// The maximum number of requests the loading thread takes from the queue at once.
+#define CC_ASYNC_FILE_BATCH_SIZE 16
+
+static pthread_t s_asyncFileThread;
+static pthread_mutex_t s_asyncFileMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_asyncFileCondition = PTHREAD_COND_INITIALIZER;
+
+// Requests waiting to be read, ordered by descending priority, then by arrival.
+static std::list<CCFileDataRequest*> s_pendingFileRequests;
 
-    if (pFile)
+// Requests being read by the loading thread.
+static std::vector<CCFileDataRequest*> s_loadingFileRequests;
+
+// Requests that have been read, waiting to be delivered on the main thread.
+static std::vector<CCFileDataRequest*> s_finishedFileRequests;
+
+// Requests being delivered on the main thread, set to NULL once their callback has been invoked.
+static std::vector<CCFileDataRequest*> s_dispatchingFileRequests;
+
+static unsigned int s_uNextFileRequestID = 0;
+static unsigned int s_uOutstandingFileRequests = 0;
+static bool s_bAsyncFileThreadStarted = false;
+static bool s_bAsyncFileThreadQuit = false;
+
+static bool compareZipFilePaths(CCFileDataRequest* a, CCFileDataRequest* b)
+{
+    return a->getZipFilePath() < b->getZipFilePath();
+}
+
+/** Reads the asynchronous requests in the background, and delivers their callbacks on the main thread. */
+class CCAsyncFileLoader : public CCObject
+{
+public:
+    static CCAsyncFileLoader* sharedLoader()
     {
-        unzClose(pFile);
+        static CCAsyncFileLoader s_loader;
+        return &s_loader;
     }
 
-    return pBuffer;
+    /** Reads one batch of pending requests. Returns false if there were no pending requests. */
+    static bool readRequestBatch()
+    {
+        CCFileUtils* pFileUtils = CCFileUtils::sharedFileUtils();
+
+        std::vector<CCFileDataRequest*> batch;
+        pthread_mutex_lock(&s_asyncFileMutex);
+        while (!s_pendingFileRequests.empty() && batch.size() < CC_ASYNC_FILE_BATCH_SIZE)
+        {
+            batch.push_back(s_pendingFileRequests.front());
+            s_pendingFileRequests.pop_front();
+        }
+        s_loadingFileRequests.insert(s_loadingFileRequests.end(), batch.begin(), batch.end());
+        pthread_mutex_unlock(&s_asyncFileMutex);
+
+        if (batch.empty())
+        {
+            return false;
+        }
+
+        // group the reads from the same zip file, so that each zip file is locked once per batch
+        std::stable_sort(batch.begin(), batch.end(), compareZipFilePaths);
+
+        unsigned int i = 0;
+        while (i < batch.size())
+        {
+            const std::string& zipFilePath = batch[i]->getZipFilePath();
+            if (zipFilePath.empty())
+            {
+                CCFileDataRequest* pRequest = batch[i++];
+                // a path that was not resolved on the main thread names a missing file, and resolving it
+                // again here would race with the main thread on the full path cache
+                if (pFileUtils->isAbsolutePath(pRequest->m_strFullPath))
+                {
+                    pRequest->m_pData = pFileUtils->getFileDataOnLoadingThread(pRequest->m_strFullPath.c_str(), pRequest->m_strMode.c_str(), &pRequest->m_uSize);
+                }
+                continue;
+            }
+
+            pthread_mutex_lock(&s_zipFileMutex);
+            ZipFile* pZipFile = pFileUtils->getZipFile(zipFilePath);
+            for (; i < batch.size() && batch[i]->getZipFilePath() == zipFilePath; ++i)
+            {
+                CCFileDataRequest* pRequest = batch[i];
+                if (pZipFile)
+                {
+                    pRequest->m_pData = pZipFile->getFileData(pRequest->m_strFileName, &pRequest->m_uSize);
+                }
+            }
+            pthread_mutex_unlock(&s_zipFileMutex);
+        }
+
+        pthread_mutex_lock(&s_asyncFileMutex);
+        s_finishedFileRequests.insert(s_finishedFileRequests.end(), batch.begin(), batch.end());
+        for (unsigned int j = 0; j < batch.size(); ++j)
+        {
+            s_loadingFileRequests.erase(std::find(s_loadingFileRequests.begin(), s_loadingFileRequests.end(), batch[j]));
+        }
+        pthread_mutex_unlock(&s_asyncFileMutex);
+
+        return true;
+    }
+
+    static void* loadingThread(void* data)
+    {
+        // create autorelease pool for iOS
+        CCThread thread;
+        thread.createAutoreleasePool();
+
+        while (true)
+        {
+            pthread_mutex_lock(&s_asyncFileMutex);
+            while (s_pendingFileRequests.empty() && !s_bAsyncFileThreadQuit)
+            {
+                pthread_cond_wait(&s_asyncFileCondition, &s_asyncFileMutex);
+            }
+            bool bQuit = s_bAsyncFileThreadQuit;
+            pthread_mutex_unlock(&s_asyncFileMutex);
+
+            if (bQuit)
+            {
+                break;
+            }
+            readRequestBatch();
+        }
+        return 0;
+    }
+
+    /** Queues the request, and starts the loading thread if needed. Invoked on the main thread. */
+    static unsigned int addRequest(CCFileDataRequest* pRequest)
+    {
+        CC_SAFE_RETAIN(pRequest->m_pTarget);
+
+        if (0 == s_uOutstandingFileRequests++)
+        {
+            CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(CCAsyncFileLoader::dispatchFinishedRequests), sharedLoader(), 0, false);
+        }
+
+        pthread_mutex_lock(&s_asyncFileMutex);
+        pRequest->m_uRequestID = ++s_uNextFileRequestID;
+        std::list<CCFileDataRequest*>::iterator it = s_pendingFileRequests.begin();
+        while (it != s_pendingFileRequests.end() && (*it)->m_nPriority >= pRequest->m_nPriority)
+        {
+            ++it;
+        }
+        s_pendingFileRequests.insert(it, pRequest);
+        pthread_mutex_unlock(&s_asyncFileMutex);
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8)
+        // WinRT uses an Async Task to read the file since the ThreadPool has a limited number of threads
+        create_task([] {
+            readRequestBatch();
+        });
+#elif defined(EMSCRIPTEN)
+        readRequestBatch();
+#else
+        if (!s_bAsyncFileThreadStarted)
+        {
+            s_bAsyncFileThreadStarted = true;
+            s_bAsyncFileThreadQuit = false;
+            pthread_create(&s_asyncFileThread, NULL, loadingThread, NULL);
+        }
+        pthread_cond_signal(&s_asyncFileCondition);
+#endif
+        return pRequest->m_uRequestID;
+    }
+
+    /** Cancels the requests matching the ID, or the target if the ID is zero. Invoked on the main thread. */
+    static void cancelRequests(unsigned int requestID, CCObject* target)
+    {
+        std::vector<CCFileDataRequest*> removedRequests;
+
+        pthread_mutex_lock(&s_asyncFileMutex);
+        std::list<CCFileDataRequest*>::iterator it = s_pendingFileRequests.begin();
+        while (it != s_pendingFileRequests.end())
+        {
+            CCFileDataRequest* pRequest = *it;
+            if (requestID ? pRequest->m_uRequestID == requestID : pRequest->m_pTarget == target)
+            {
+                removedRequests.push_back(pRequest);
+                it = s_pendingFileRequests.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        // requests that are being read, or waiting to be delivered, are dropped when delivered
+        for (unsigned int i = 0; i < s_loadingFileRequests.size(); ++i)
+        {
+            CCFileDataRequest* pRequest = s_loadingFileRequests[i];
+            if (requestID ? pRequest->m_uRequestID == requestID : pRequest->m_pTarget == target)
+            {
+                pRequest->m_bCancelled = true;
+            }
+        }
+        for (unsigned int i = 0; i < s_finishedFileRequests.size(); ++i)
+        {
+            CCFileDataRequest* pRequest = s_finishedFileRequests[i];
+            if (requestID ? pRequest->m_uRequestID == requestID : pRequest->m_pTarget == target)
+            {
+                pRequest->m_bCancelled = true;
+            }
+        }
+        // the callback of a request may cancel the requests that follow it in the same frame
+        for (unsigned int i = 0; i < s_dispatchingFileRequests.size(); ++i)
+        {
+            CCFileDataRequest* pRequest = s_dispatchingFileRequests[i];
+            if (pRequest && (requestID ? pRequest->m_uRequestID == requestID : pRequest->m_pTarget == target))
+            {
+                pRequest->m_bCancelled = true;
+            }
+        }
+        pthread_mutex_unlock(&s_asyncFileMutex);
+
+        for (unsigned int i = 0; i < removedRequests.size(); ++i)
+        {
+            sharedLoader()->finishRequest(removedRequests[i]);
+        }
+    }
+
+    /** Stops the loading thread, dropping the requests that have not been delivered yet. */
+    static void stop()
+    {
+        if (!s_bAsyncFileThreadStarted)
+        {
+            return;
+        }
+
+        pthread_mutex_lock(&s_asyncFileMutex);
+        s_bAsyncFileThreadQuit = true;
+        pthread_mutex_unlock(&s_asyncFileMutex);
+        pthread_cond_signal(&s_asyncFileCondition);
+        pthread_join(s_asyncFileThread, NULL);
+        s_bAsyncFileThreadStarted = false;
+
+        // the director may already be gone, so the scheduler is left alone
+        std::vector<CCFileDataRequest*> droppedRequests(s_pendingFileRequests.begin(), s_pendingFileRequests.end());
+        droppedRequests.insert(droppedRequests.end(), s_finishedFileRequests.begin(), s_finishedFileRequests.end());
+        s_pendingFileRequests.clear();
+        s_finishedFileRequests.clear();
+        for (unsigned int i = 0; i < droppedRequests.size(); ++i)
+        {
+            CC_SAFE_RELEASE(droppedRequests[i]->m_pTarget);
+            droppedRequests[i]->release();
+        }
+        s_uOutstandingFileRequests = 0;
+    }
+
+    /** Delivers all the requests read since the last frame. */
+    void dispatchFinishedRequests(float dt)
+    {
+        pthread_mutex_lock(&s_asyncFileMutex);
+        s_dispatchingFileRequests.swap(s_finishedFileRequests);
+        pthread_mutex_unlock(&s_asyncFileMutex);
+
+        for (unsigned int i = 0; i < s_dispatchingFileRequests.size(); ++i)
+        {
+            CCFileDataRequest* pRequest = s_dispatchingFileRequests[i];
+            if (!pRequest->m_bCancelled && pRequest->m_pTarget && pRequest->m_pSelector)
+            {
+                (pRequest->m_pTarget->*pRequest->m_pSelector)(pRequest);
+            }
+            pthread_mutex_lock(&s_asyncFileMutex);
+            s_dispatchingFileRequests[i] = NULL;
+            pthread_mutex_unlock(&s_asyncFileMutex);
+            finishRequest(pRequest);
+        }
+
+        pthread_mutex_lock(&s_asyncFileMutex);
+        s_dispatchingFileRequests.clear();
+        pthread_mutex_unlock(&s_asyncFileMutex);
+    }
+
+private:
+    void finishRequest(CCFileDataRequest* pRequest)
+    {
+        CC_SAFE_RELEASE(pRequest->m_pTarget);
+        pRequest->release();
+
+        if (0 == --s_uOutstandingFileRequests)
+        {
+            CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(CCAsyncFileLoader::dispatchFinishedRequests), this);
+        }
+    }
+};
+
+static void stopAsyncFileLoader()
+{
+    CCAsyncFileLoader::stop();
+}
+
+unsigned int CCFileUtils::getFileDataAsync(const char* pszFileName, const char* pszMode, CCObject* target, SEL_CallFuncO selector, int priority)
+{
+    CCAssert(pszFileName != NULL && pszMode != NULL, "Invalid parameters.");
+
+    CCFileDataRequest* pRequest = new CCFileDataRequest();
+    pRequest->m_strFileName = pszFileName;
+    // the loading threads only read the absolute path, which fullPathForFilename() returns without the cache
+    pRequest->m_strFullPath = fullPathForFilename(pszFileName);
+    pRequest->m_strMode = pszMode;
+    pRequest->m_nPriority = priority;
+    pRequest->m_pTarget = target;
+    pRequest->m_pSelector = selector;
+    return CCAsyncFileLoader::addRequest(pRequest);
+}
+
+unsigned int CCFileUtils::getFileDataFromZipAsync(const char* pszZipFilePath, const char* pszFileName, CCObject* target, SEL_CallFuncO selector, int priority)
+{
+    CCAssert(pszZipFilePath != NULL && strlen(pszZipFilePath) > 0 && pszFileName != NULL, "Invalid parameters.");
+
+    CCFileDataRequest* pRequest = new CCFileDataRequest();
+    pRequest->m_strFileName = pszFileName;
+    pRequest->m_strZipFilePath = pszZipFilePath;
+    pRequest->m_nPriority = priority;
+    pRequest->m_pTarget = target;
+    pRequest->m_pSelector = selector;
+    return CCAsyncFileLoader::addRequest(pRequest);
+}
+
+void CCFileUtils::cancelFileDataAsync(unsigned int requestID)
+{
+    if (requestID != 0)
+    {
+        CCAsyncFileLoader::cancelRequests(requestID, NULL);
+    }
+}
+
+void CCFileUtils::cancelFileDataAsyncForTarget(CCObject* target)
+{
+    if (target != NULL)
+    {
+        CCAsyncFileLoader::cancelRequests(0, target);
+    }
 }
 
 std::string CCFileUtils::getNewFilename(const char* pszFileName)
@@ -618,6 +1164,17 @@ std::string CCFileUtils::fullPathForFilename(const char* pszFileName)
     
     string fullpath = "";
     
+    // The mounted archives are searched first, without touching the file system.
+    if (!m_mountedArchives.empty())
+    {
+        fullpath = getPathInArchives(newFilename);
+        if (fullpath.length() > 0)
+        {
+            m_fullPathCache.insert(std::pair<std::string, std::string>(pszFileName, fullpath));
+            return fullpath;
+        }
+    }
+    
     for (std::vector<std::string>::iterator searchPathsIter = m_searchPathArray.begin();
          searchPathsIter != m_searchPathArray.end(); ++searchPathsIter) {
         for (std::vector<std::string>::iterator resOrderIter = m_searchResolutionsOrderArray.begin();
@@ -30,11 +30,59 @@ THE SOFTWARE.
 #include "CCPlatformMacros.h"
 #include "ccTypes.h"
 #include "ccTypeInfo.h"
+#include "cocoa/CCObject.h"
 
 NS_CC_BEGIN
 
 class CCDictionary;
 class CCArray;
+class ZipFile;
+class CCFileArchive;
+
+/** @brief The result of an asynchronous read requested from CCFileUtils::getFileDataAsync.
+ *  It is passed to the callback of the request on the main thread.
+ *  @js NA
+ *  @lua NA
+ */
+class CC_DLL CCFileDataRequest : public CCObject
+{
+public:
+    CCFileDataRequest();
+    virtual ~CCFileDataRequest();
+
+    /** The identifier returned by the method that requested the read. */
+    unsigned int getRequestID() const { return m_uRequestID; }
+
+    /** The file that was read, as it was requested. */
+    const std::string& getFileName() const { return m_strFileName; }
+
+    /** The zip file from which the file was read, or an empty string if it was read from the file system. */
+    const std::string& getZipFilePath() const { return m_strZipFilePath; }
+
+    /** The content of the file, or NULL if it could not be read. The buffer is owned by this request. */
+    unsigned char* getData() const { return m_pData; }
+    unsigned long getSize() const { return m_uSize; }
+    bool isSucceed() const { return m_pData != NULL; }
+
+    /** Hands the content over to the caller, who becomes responsible for calling delete[] on it. */
+    unsigned char* takeData();
+
+private:
+    friend class CCFileUtils;
+    friend class CCAsyncFileLoader;
+
+    unsigned int m_uRequestID;
+    std::string m_strFileName;
+    std::string m_strFullPath;
+    std::string m_strZipFilePath;
+    std::string m_strMode;
+    int m_nPriority;
+    bool m_bCancelled;
+    CCObject* m_pTarget;
+    SEL_CallFuncO m_pSelector;
+    unsigned char* m_pData;
+    unsigned long m_uSize;
+};
 /**
  * @addtogroup platform
  * @{
@@ -45,6 +93,7 @@ class CC_DLL CCFileUtils : public TypeInfo
 {
     friend class CCArray;
     friend class CCDictionary;
+    friend class CCAsyncFileLoader;
 public:
     /**
      *  Returns an unique ID for this class.
@@ -77,7 +126,7 @@ public:
     virtual ~CCFileUtils();
     
     /**
-     *  Purges the file searching cache.
+     *  Purges the file searching cache, and closes the zip files kept open by getFileDataFromZip.
      *
      *  @note It should be invoked after the resources were updated.
      *        For instance, in the CocosPlayer sample, every time you run application from CocosBuilder,
@@ -109,6 +158,95 @@ public:
      */
     virtual unsigned char* getFileDataFromZip(const char* pszZipFilePath, const char* pszFileName, unsigned long * pSize);
 
+    /**
+     *  Reads resource file data on a background thread.
+     *
+     *  Requests are served in order of descending priority, then in the order they were made.
+     *  Once the file has been read, the selector is invoked on the main thread with the
+     *  CCFileDataRequest holding the content, whether or not the read succeeded.
+     *  The target is retained until the callback has been invoked or the request is cancelled.
+     *
+     *  @param[in]  pszFileName The resource file name which contains the path.
+     *  @param[in]  pszMode The read mode of the file.
+     *  @return An identifier that can be used to cancel the request.
+     *  @since v2.2.6
+     *  @js NA
+     *  @lua NA
+     */
+    virtual unsigned int getFileDataAsync(const char* pszFileName, const char* pszMode, CCObject* target, SEL_CallFuncO selector, int priority = 0);
+
+    /**
+     *  Reads resource file data from a zip file on a background thread.
+     *  Behaves like getFileDataAsync, reading the file through the zip file handle kept open by getFileDataFromZip.
+     *  @since v2.2.6
+     *  @js NA
+     *  @lua NA
+     */
+    virtual unsigned int getFileDataFromZipAsync(const char* pszZipFilePath, const char* pszFileName, CCObject* target, SEL_CallFuncO selector, int priority = 0);
+
+    /**
+     *  Cancels an asynchronous read. The callback of the request will not be invoked, and its target is released.
+     *  @since v2.2.6
+     *  @js NA
+     *  @lua NA
+     */
+    virtual void cancelFileDataAsync(unsigned int requestID);
+
+    /**
+     *  Cancels all asynchronous reads made with the specified target.
+     *  @since v2.2.6
+     *  @js NA
+     *  @lua NA
+     */
+    virtual void cancelFileDataAsyncForTarget(CCObject* target);
+
+    /**
+     *  Mounts a packed file archive built with tools/pack-archive.
+     *
+     *  The files of mounted archives are found by fullPathForFilename before the search paths are
+     *  walked, using the resolution directories the same way, and archives mounted later take
+     *  precedence over earlier ones. Their full path is the path of the archive followed by the
+     *  path of the file in the archive, such as "/path/to/assets.pak/images/hero.png".
+     *
+     *  Mount and unmount archives on the main thread. A pending asynchronous read of a file in an
+     *  archive fails if the archive is unmounted before the file is read.
+     *
+     *  @param[in]  pszArchivePath The path of the archive, resolved with fullPathForFilename.
+     *  @return true if the archive was mounted.
+     *  @since v2.2.6
+     */
+    virtual bool mountArchive(const char* pszArchivePath);
+
+    /**
+     *  Unmounts an archive mounted by mountArchive, invalidating the pointers returned by getMappedFileData for its files.
+     *  @since v2.2.6
+     */
+    virtual void unmountArchive(const char* pszArchivePath);
+
+    /**
+     *  Unmounts all archives.
+     *  @since v2.2.6
+     */
+    virtual void unmountAllArchives();
+
+    /**
+     *  Gets the content of a file stored uncompressed in a mounted archive, without copying it.
+     *
+     *  @param[out] pSize If the file is found, it will be the data size, otherwise 0.
+     *  @return NULL if the file is not stored uncompressed in a mounted archive. Otherwise the content,
+     *          which remains valid until the archive is unmounted, and must not be freed.
+     *  @since v2.2.6
+     *  @js NA
+     *  @lua NA
+     */
+    virtual const unsigned char* getMappedFileData(const char* pszFileName, unsigned long * pSize);
+
+    /**
+     *  Closes the zip files kept open by getFileDataFromZip.
+     *  @since v2.2.6
+     */
+    virtual void closeZipFiles();
+
     
     /** Returns the fullpath for a given filename.
      
@@ -393,6 +531,32 @@ protected:
      *  @note This method is used internally.
      */
     virtual CCArray* createCCArrayWithContentsOfFile(const std::string& filename);
+
+    /**
+     *  Reads file data on the background thread used by getFileDataAsync.
+     *  Subclasses whose getFileData is not safe to invoke concurrently with the main thread should override this.
+     */
+    virtual unsigned char* getFileDataOnLoadingThread(const char* pszFileName, const char* pszMode, unsigned long * pSize);
+
+    /**
+     *  Finds the mounted archive holding the specified full path, and the path of the file in the archive.
+     *  @return NULL if the full path is not within a mounted archive.
+     */
+    CCFileArchive* getArchiveForFullPath(const std::string& fullPath, std::string& archivedPath);
+
+    /** Returns the full path of the file in a mounted archive, or an empty string if no archive holds it. */
+    std::string getPathInArchives(const std::string& filename);
+
+    /**
+     *  Reads the file at the specified full path if it is within a mounted archive.
+     *  @return false if the full path is not within a mounted archive.
+     */
+    bool getFileDataFromArchives(const std::string& fullPath, unsigned char** ppBuffer, unsigned long * pSize);
+
+    /** Returns the open zip file for the specified path, opening and indexing it if needed, or NULL if it can't be opened.
+     *  Invoked with the zip file mutex locked.
+     */
+    ZipFile* getZipFile(const std::string& zipFilePath);
     
     /** Dictionary used to lookup filenames based on a key.
      *  It is used internally by the following methods:
@@ -429,6 +593,17 @@ protected:
      *  This variable is used for improving the performance of file search.
      */
     std::map<std::string, std::string> m_fullPathCache;
+
+    /**
+     *  The zip files opened by getFileDataFromZip, with the index of their central directory, by path.
+     *  They are kept open so that each read does not reopen and scan the zip file again.
+     */
+    std::map<std::string, ZipFile*> m_openZipFiles;
+
+    /**
+     *  The mounted archives, in the order they were mounted, along with their full path followed by a slash.
+     */
+    std::vector<std::pair<std::string, CCFileArchive*> > m_mountedArchives;
     
     /**
      *  The singleton pointer of CCFileUtils.
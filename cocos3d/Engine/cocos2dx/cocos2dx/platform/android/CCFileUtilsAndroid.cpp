@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include "support/zip_support/ZipUtils.h"
 #include "platform/CCCommon.h"
 #include "jni/Java_org_cocos2dx_lib_Cocos2dxHelper.h"
+#include <pthread.h>
 
 using namespace std;
 
@@ -33,6 +34,9 @@ NS_CC_BEGIN
 // record the zip on the resource path
 static ZipFile *s_pZipFile = NULL;
 
+// the zip handle used off the main thread is shared by all the loading threads
+static pthread_mutex_t s_asyncZipFileMutex = PTHREAD_MUTEX_INITIALIZER;
+
 CCFileUtils* CCFileUtils::sharedFileUtils()
 {
     if (s_sharedFileUtils == NULL)
@@ -119,6 +123,11 @@ unsigned char* CCFileUtilsAndroid::getFileDataForAsync(const char* pszFileName,
     return doGetFileData(pszFileName, pszMode, pSize, true);
 }
 
+unsigned char* CCFileUtilsAndroid::getFileDataOnLoadingThread(const char* pszFileName, const char* pszMode, unsigned long * pSize)
+{
+    return doGetFileData(pszFileName, pszMode, pSize, true);
+}
+
 unsigned char* CCFileUtilsAndroid::doGetFileData(const char* pszFileName, const char* pszMode, unsigned long * pSize, bool forAsync)
 {
     unsigned char * pData = 0;
@@ -130,11 +139,18 @@ unsigned char* CCFileUtilsAndroid::doGetFileData(const char* pszFileName, const
     
     string fullPath = fullPathForFilename(pszFileName);
     
+    if (getFileDataFromArchives(fullPath, &pData, pSize))
+    {
+        return pData;
+    }
+
     if (fullPath[0] != '/')
     {
         if (forAsync)
         {
+            pthread_mutex_lock(&s_asyncZipFileMutex);
             pData = s_pZipFile->getFileData(fullPath.c_str(), pSize, s_pZipFile->_dataThread);
+            pthread_mutex_unlock(&s_asyncZipFileMutex);
         }
         else
         {
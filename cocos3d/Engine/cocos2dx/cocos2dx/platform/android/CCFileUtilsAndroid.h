@@ -58,6 +58,9 @@ public:
      */
     unsigned char* getFileDataForAsync(const char* pszFileName, const char* pszMode, unsigned long * pSize);
     
+protected:
+    virtual unsigned char* getFileDataOnLoadingThread(const char* pszFileName, const char* pszMode, unsigned long * pSize);
+
 private:
     unsigned char* doGetFileData(const char* pszFileName, const char* pszMode, unsigned long * pSize, bool forAsync);
 };
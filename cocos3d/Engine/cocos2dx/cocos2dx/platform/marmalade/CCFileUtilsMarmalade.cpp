@@ -44,6 +44,12 @@ unsigned char* CCFileUtilsMarmalade::getFileData(const char* pszFileName, const
     
     std::string fullPath = fullPathForFilename(pszFileName);
     
+    unsigned char* pArchivedData = NULL;
+    if (getFileDataFromArchives(fullPath, &pArchivedData, pSize))
+    {
+        return pArchivedData;
+    }
+
 	s3eFile* pFile = s3eFileOpen(fullPath.c_str(), pszMode);
 	
 	if (! pFile && isPopupNotify())
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "CCGLProgram.h"
 #include "ccGLStateCache.h"
 #include "ccMacros.h"
+#include "sprite_nodes/CCAutoBatcher.h"
 #include "platform/CCFileUtils.h"
 #include "support/data_support/uthash.h"
 #include "cocoa/CCString.h"
@@ -323,6 +324,9 @@ bool CCGLProgram::link()
 
 void CCGLProgram::use()
 {
+    // whatever is about to be drawn goes after the sprites queued so far
+    CCAutoBatcher::flushShared();
+
     ccGLUseProgram(m_uProgram);
 }
 
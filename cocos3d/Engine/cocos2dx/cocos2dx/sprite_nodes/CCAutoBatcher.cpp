@@ -0,0 +1,265 @@
+/****************************************************************************
+Copyright (c) 2010-2013 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "CCAutoBatcher.h"
+#include "ccMacros.h"
+#include "ccConfig.h"
+#include "shaders/CCGLProgram.h"
+#include "shaders/CCShaderCache.h"
+#include "shaders/ccGLStateCache.h"
+#include "support/CCNotificationCenter.h"
+#include "CCEventType.h"
+#include "kazmath/GL/matrix.h"
+#include "CCGL.h"
+#include <stdlib.h>
+
+NS_CC_BEGIN
+
+static CCAutoBatcher* s_pSharedAutoBatcher = NULL;
+
+CCAutoBatcher* CCAutoBatcher::sharedAutoBatcher()
+{
+    if (! s_pSharedAutoBatcher)
+    {
+        s_pSharedAutoBatcher = new CCAutoBatcher();
+    }
+
+    return s_pSharedAutoBatcher;
+}
+
+void CCAutoBatcher::purgeSharedAutoBatcher()
+{
+    CC_SAFE_RELEASE_NULL(s_pSharedAutoBatcher);
+}
+
+void CCAutoBatcher::flushShared()
+{
+    if (s_pSharedAutoBatcher && s_pSharedAutoBatcher->m_uQuadCount > 0)
+    {
+        s_pSharedAutoBatcher->flush();
+    }
+}
+
+CCAutoBatcher::CCAutoBatcher()
+: m_bEnabled(false)
+, m_bFlushing(false)
+, m_pShaderProgram(NULL)
+, m_pQuads(NULL)
+, m_uQuadCount(0)
+, m_uTexture(0)
+{
+    m_pBuffersVBO[0] = m_pBuffersVBO[1] = 0;
+    m_tBlendFunc.src = CC_BLEND_SRC;
+    m_tBlendFunc.dst = CC_BLEND_DST;
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // listen the event when app go to foreground
+    CCNotificationCenter::sharedNotificationCenter()->addObserver(this,
+                                                           callfuncO_selector(CCAutoBatcher::listenBackToForeground),
+                                                           EVENT_COME_TO_FOREGROUND,
+                                                           NULL);
+#endif
+}
+
+CCAutoBatcher::~CCAutoBatcher()
+{
+    CCLOGINFO("cocos2d: deallocing CCAutoBatcher.");
+
+    if (m_pBuffersVBO[0])
+    {
+        glDeleteBuffers(2, m_pBuffersVBO);
+    }
+    CC_SAFE_FREE(m_pQuads);
+    CC_SAFE_RELEASE(m_pShaderProgram);
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    CCNotificationCenter::sharedNotificationCenter()->removeObserver(this, EVENT_COME_TO_FOREGROUND);
+#endif
+}
+
+void CCAutoBatcher::setEnabled(bool bEnabled)
+{
+    if (m_bEnabled == bEnabled)
+    {
+        return;
+    }
+
+    if (bEnabled)
+    {
+        if (! m_pShaderProgram)
+        {
+            m_pShaderProgram = CCShaderCache::sharedShaderCache()->programForKey(kCCShader_PositionTextureColor);
+            CC_SAFE_RETAIN(m_pShaderProgram);
+        }
+        if (! m_pQuads)
+        {
+            m_pQuads = (ccV3F_C4B_T2F_Quad*)malloc(kCCAutoBatcherCapacity * sizeof(ccV3F_C4B_T2F_Quad));
+        }
+    }
+    else
+    {
+        flush();
+    }
+
+    m_bEnabled = bEnabled;
+}
+
+void CCAutoBatcher::listenBackToForeground(CCObject *obj)
+{
+    // the buffers were lost with the GL context, and so is the content that was queued for them
+    m_pBuffersVBO[0] = m_pBuffersVBO[1] = 0;
+    m_uQuadCount = 0;
+}
+
+void CCAutoBatcher::setupBuffers()
+{
+    GLushort* pIndices = (GLushort*)malloc(kCCAutoBatcherCapacity * 6 * sizeof(GLushort));
+    for (unsigned int i = 0; i < kCCAutoBatcherCapacity; i++)
+    {
+        pIndices[i*6+0] = (GLushort)(i*4+0);
+        pIndices[i*6+1] = (GLushort)(i*4+1);
+        pIndices[i*6+2] = (GLushort)(i*4+2);
+
+        pIndices[i*6+3] = (GLushort)(i*4+3);
+        pIndices[i*6+4] = (GLushort)(i*4+2);
+        pIndices[i*6+5] = (GLushort)(i*4+1);
+    }
+
+    glGenBuffers(2, &m_pBuffersVBO[0]);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_pBuffersVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, kCCAutoBatcherCapacity * 6 * sizeof(GLushort), pIndices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    free(pIndices);
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+bool CCAutoBatcher::addQuad(const ccV3F_C4B_T2F_Quad& quad, GLuint uTexture, const ccBlendFunc& blendFunc, CCGLProgram* pProgram)
+{
+    if (! m_bEnabled || pProgram != m_pShaderProgram)
+    {
+        return false;
+    }
+
+    if (m_uQuadCount > 0
+        && (m_uQuadCount == kCCAutoBatcherCapacity || uTexture != m_uTexture
+            || blendFunc.src != m_tBlendFunc.src || blendFunc.dst != m_tBlendFunc.dst))
+    {
+        flush();
+    }
+
+    m_uTexture = uTexture;
+    m_tBlendFunc = blendFunc;
+
+    // the queued quads share the same draw call, so they are brought to world space here
+    kmMat4 matrixMV;
+    kmGLGetMatrix(KM_GL_MODELVIEW, &matrixMV);
+    const float* m = matrixMV.mat;
+
+    ccV3F_C4B_T2F_Quad& queued = m_pQuads[m_uQuadCount++];
+    queued = quad;
+
+    ccV3F_C4B_T2F* vertices = (ccV3F_C4B_T2F*)&queued;
+    for (int i = 0; i < 4; i++)
+    {
+        ccVertex3F& v = vertices[i].vertices;
+        float x = v.x, y = v.y, z = v.z;
+        v.x = m[0] * x + m[4] * y + m[8] * z + m[12];
+        v.y = m[1] * x + m[5] * y + m[9] * z + m[13];
+        v.z = m[2] * x + m[6] * y + m[10] * z + m[14];
+    }
+
+    return true;
+}
+
+void CCAutoBatcher::flush()
+{
+    // drawing uses a CCGLProgram, which would flush again
+    if (m_uQuadCount == 0 || m_bFlushing)
+    {
+        return;
+    }
+    m_bFlushing = true;
+
+    CC_PROFILER_START("CCAutoBatcher - flush");
+
+    if (! m_pBuffersVBO[0])
+    {
+        setupBuffers();
+    }
+
+    // the quads are already in world space
+    kmGLMatrixMode(KM_GL_MODELVIEW);
+    kmGLPushMatrix();
+    kmGLLoadIdentity();
+
+    m_pShaderProgram->use();
+    m_pShaderProgram->setUniformsForBuiltins();
+
+    ccGLBlendFunc(m_tBlendFunc.src, m_tBlendFunc.dst);
+    ccGLBindTexture2D(m_uTexture);
+
+#if CC_TEXTURE_ATLAS_USE_VAO
+    // the attribute pointers below must not end up in the VAO of a texture atlas
+    ccGLBindVAO(0);
+#endif
+
+#define kQuadSize sizeof(m_pQuads[0].bl)
+    glBindBuffer(GL_ARRAY_BUFFER, m_pBuffersVBO[0]);
+    // orphan the previous content, which may still be in use by the previous flush
+    glBufferData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0]) * kCCAutoBatcherCapacity, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(m_pQuads[0]) * m_uQuadCount, m_pQuads);
+
+    ccGLEnableVertexAttribs(kCCVertexAttribFlag_PosColorTex);
+
+    // vertices
+    glVertexAttribPointer(kCCVertexAttrib_Position, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(ccV3F_C4B_T2F, vertices));
+
+    // colors
+    glVertexAttribPointer(kCCVertexAttrib_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(ccV3F_C4B_T2F, colors));
+
+    // tex coords
+    glVertexAttribPointer(kCCVertexAttrib_TexCoords, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(ccV3F_C4B_T2F, texCoords));
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_pBuffersVBO[1]);
+    glDrawElements(GL_TRIANGLES, (GLsizei)m_uQuadCount * 6, GL_UNSIGNED_SHORT, 0);
+
+    // the other nodes expect client side arrays
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    kmGLPopMatrix();
+
+    CC_INCREMENT_GL_DRAWS(1);
+    CHECK_GL_ERROR_DEBUG();
+
+    CC_PROFILER_STOP("CCAutoBatcher - flush");
+
+    m_uQuadCount = 0;
+    m_bFlushing = false;
+}
+
+NS_CC_END
@@ -0,0 +1,121 @@
+/****************************************************************************
+Copyright (c) 2010-2013 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __SPRITE_CCAUTO_BATCHER_H__
+#define __SPRITE_CCAUTO_BATCHER_H__
+
+#include "ccTypes.h"
+#include "cocoa/CCObject.h"
+
+NS_CC_BEGIN
+
+class CCGLProgram;
+
+/**
+ * @addtogroup sprite_nodes
+ * @{
+ */
+
+/** the maximum number of quads drawn by a single draw call of CCAutoBatcher */
+#define kCCAutoBatcherCapacity 2048
+
+/** @brief CCAutoBatcher merges the draws of consecutive CCSprites that are not children of a CCSpriteBatchNode.
+
+While enabled, CCSprite::draw doesn't draw its quad. Instead, the quad is transformed to world space
+and queued in a buffer shared by all the sprites. The queued quads are drawn with a single draw call
+when a sprite with a different texture or blend function is drawn, or when anything else is about to be drawn.
+
+Only the sprites using the default kCCShader_PositionTextureColor shader are batched, since other shaders may
+rely on uniforms set for each node.
+
+The draw order is preserved: the queue is flushed whenever a CCGLProgram is used, which is the case
+for every other node, and by the nodes changing the GL state in another way (CCClippingNode,
+CCRenderTexture, CCGridBase, CCScrollView...). A custom node changing the GL state without using
+a CCGLProgram first must call CCAutoBatcher::flushShared() before doing so.
+
+Batching is disabled by default.
+@since v2.2.6
+*/
+class CC_DLL CCAutoBatcher : public CCObject
+{
+public:
+    /**
+     * @js ctor
+     */
+    CCAutoBatcher();
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual ~CCAutoBatcher();
+
+    /** returns the shared instance */
+    static CCAutoBatcher* sharedAutoBatcher();
+
+    /** releases the shared instance */
+    static void purgeSharedAutoBatcher();
+
+    /** draws the quads queued by the shared instance, if any. Cheap to call when nothing is queued. */
+    static void flushShared();
+
+    /** whether the sprites are batched. Disabling the batcher draws the queued quads. */
+    bool isEnabled() { return m_bEnabled; }
+    void setEnabled(bool bEnabled);
+
+    /** queues the quad of a sprite, which is transformed by the current modelview matrix.
+     @return false if the quad can't be batched, in which case the caller draws it.
+     */
+    bool addQuad(const ccV3F_C4B_T2F_Quad& quad, GLuint uTexture, const ccBlendFunc& blendFunc, CCGLProgram* pProgram);
+
+    /** draws the queued quads */
+    void flush();
+
+    /** returns the number of queued quads */
+    unsigned int getQueuedQuads() { return m_uQuadCount; }
+
+    /** listen the event that coming to foreground on Android
+     * @js NA
+     * @lua NA
+     */
+    void listenBackToForeground(CCObject *obj);
+
+private:
+    void setupBuffers();
+
+    bool                    m_bEnabled;
+    bool                    m_bFlushing;
+    CCGLProgram*            m_pShaderProgram;
+    ccV3F_C4B_T2F_Quad*     m_pQuads;
+    unsigned int            m_uQuadCount;
+    GLuint                  m_pBuffersVBO[2]; //0: vertex  1: indices
+    GLuint                  m_uTexture;
+    ccBlendFunc             m_tBlendFunc;
+};
+
+// end of sprite_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __SPRITE_CCAUTO_BATCHER_H__
@@ -25,6 +25,7 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "CCSpriteBatchNode.h"
+#include "CCAutoBatcher.h"
 #include "CCAnimation.h"
 #include "CCAnimationCache.h"
 #include "ccConfig.h"
@@ -551,37 +552,42 @@ void CCSprite::draw(void)
 
     CCAssert(!m_pobBatchNode, "If CCSprite is being rendered by CCSpriteBatchNode, CCSprite#draw SHOULD NOT be called");
 
-    CC_NODE_DRAW_SETUP();
+    // draw the quad, unless the auto batcher queues it to be drawn along with the next sprites
+    if (! CCAutoBatcher::sharedAutoBatcher()->addQuad(m_sQuad, m_pobTexture->getName(), m_sBlendFunc, getShaderProgram()))
+    {
+        CC_NODE_DRAW_SETUP();
 
-    ccGLBlendFunc( m_sBlendFunc.src, m_sBlendFunc.dst );
+        ccGLBlendFunc( m_sBlendFunc.src, m_sBlendFunc.dst );
 
-    ccGLBindTexture2D( m_pobTexture->getName() );
-    ccGLEnableVertexAttribs( kCCVertexAttribFlag_PosColorTex );
+        ccGLBindTexture2D( m_pobTexture->getName() );
+        ccGLEnableVertexAttribs( kCCVertexAttribFlag_PosColorTex );
 
 #define kQuadSize sizeof(m_sQuad.bl)
 #ifdef EMSCRIPTEN
-    long offset = 0;
-    setGLBufferData(&m_sQuad, 4 * kQuadSize, 0);
+        long offset = 0;
+        setGLBufferData(&m_sQuad, 4 * kQuadSize, 0);
 #else
-    long offset = (long)&m_sQuad;
+        long offset = (long)&m_sQuad;
 #endif // EMSCRIPTEN
 
-    // vertex
-    int diff = offsetof( ccV3F_C4B_T2F, vertices);
-    glVertexAttribPointer(kCCVertexAttrib_Position, 3, GL_FLOAT, GL_FALSE, kQuadSize, (void*) (offset + diff));
+        // vertex
+        int diff = offsetof( ccV3F_C4B_T2F, vertices);
+        glVertexAttribPointer(kCCVertexAttrib_Position, 3, GL_FLOAT, GL_FALSE, kQuadSize, (void*) (offset + diff));
 
-    // texCoods
-    diff = offsetof( ccV3F_C4B_T2F, texCoords);
-    glVertexAttribPointer(kCCVertexAttrib_TexCoords, 2, GL_FLOAT, GL_FALSE, kQuadSize, (void*)(offset + diff));
+        // texCoods
+        diff = offsetof( ccV3F_C4B_T2F, texCoords);
+        glVertexAttribPointer(kCCVertexAttrib_TexCoords, 2, GL_FLOAT, GL_FALSE, kQuadSize, (void*)(offset + diff));
 
-    // color
-    diff = offsetof( ccV3F_C4B_T2F, colors);
-    glVertexAttribPointer(kCCVertexAttrib_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (void*)(offset + diff));
+        // color
+        diff = offsetof( ccV3F_C4B_T2F, colors);
+        glVertexAttribPointer(kCCVertexAttrib_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (void*)(offset + diff));
 
 
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        CC_INCREMENT_GL_DRAWS(1);
 
-    CHECK_GL_ERROR_DEBUG();
+        CHECK_GL_ERROR_DEBUG();
+    }
 
 
 #if CC_SPRITE_DEBUG_DRAW == 1
@@ -604,8 +610,6 @@ void CCSprite::draw(void)
     ccDrawPoly(vertices, 4, true);
 #endif // CC_SPRITE_DEBUG_DRAW
 
-    CC_INCREMENT_GL_DRAWS(1);
-
     CC_PROFILER_STOP_CATEGORY(kCCProfilerCategorySprite, "CCSprite - draw");
 }
 
@@ -24,115 +24,332 @@ THE SOFTWARE.
 #include "CCUserDefault.h"
 #include "platform/CCCommon.h"
 #include "platform/CCFileUtils.h"
+#include "CCDirector.h"
+#include "CCScheduler.h"
+#include "CCEventType.h"
+#include "support/CCNotificationCenter.h"
 #include "../tinyxml2/tinyxml2.h"
+#include <map>
+#include <stdio.h>
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <windows.h>
+#endif
+
 // root name of xml
 #define USERDEFAULT_ROOT_NAME    "userDefaultRoot"
 
 #define XML_FILE_NAME "UserDefault.xml"
 
+#define BINARY_FILE_NAME "UserDefault.bin"
+
+// the binary file starts with this signature, then the version, the number of values,
+// and the key and the value of each of them, all prefixed by their length
+#define BINARY_FILE_SIGNATURE "CCUD"
+#define BINARY_FILE_VERSION 1
+
 using namespace std;
 
 NS_CC_BEGIN
 
 /**
  * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * export the map and other types in "CCUserDefault.h"
  */
 
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
+typedef map<string, string> ValueMap;
+
+static ValueMap s_values;
+static bool s_bValuesLoaded = false;
+static bool s_bValuesDirty = false;
+static bool s_bFlushPosted = false;
+static bool s_bBinaryFormatEnabled = false;
+
+static string getBinaryFilePath()
+{
+    return CCFileUtils::sharedFileUtils()->getWritablePath() + BINARY_FILE_NAME;
+}
+
+static bool loadValuesFromXML(const string& path)
+{
+    unsigned long nSize = 0;
+    const char* pXmlBuffer = (const char*)CCFileUtils::sharedFileUtils()->getFileData(path.c_str(), "rb", &nSize);
+    if (NULL == pXmlBuffer)
+    {
+        CCLOG("can not read xml file");
+        return false;
+    }
+
+    tinyxml2::XMLDocument xmlDoc;
+    xmlDoc.Parse(pXmlBuffer, nSize);
+    delete[] pXmlBuffer;
+
+    tinyxml2::XMLElement* rootNode = xmlDoc.RootElement();
+    if (NULL == rootNode)
+    {
+        CCLOG("read root node error");
+        return false;
+    }
+
+    for (tinyxml2::XMLElement* curNode = rootNode->FirstChildElement(); curNode != NULL; curNode = curNode->NextSiblingElement())
+    {
+        // the first node of a key wins, as it did when the file was searched for each key
+        if (curNode->FirstChild() && s_values.find(curNode->Value()) == s_values.end())
+        {
+            s_values[curNode->Value()] = curNode->FirstChild()->Value();
+        }
+    }
+    return true;
+}
+
+static bool saveValuesToXML(const string& path)
+{
+    tinyxml2::XMLDocument xmlDoc;
+    xmlDoc.LinkEndChild(xmlDoc.NewDeclaration(NULL));
+    tinyxml2::XMLElement* rootNode = xmlDoc.NewElement(USERDEFAULT_ROOT_NAME);
+    xmlDoc.LinkEndChild(rootNode);
+
+    for (ValueMap::const_iterator it = s_values.begin(); it != s_values.end(); ++it)
+    {
+        tinyxml2::XMLElement* node = xmlDoc.NewElement(it->first.c_str());
+        node->LinkEndChild(xmlDoc.NewText(it->second.c_str()));
+        rootNode->LinkEndChild(node);
+    }
+
+    return tinyxml2::XML_SUCCESS == xmlDoc.SaveFile(path.c_str());
+}
+
+static bool readBinaryString(const unsigned char*& pData, const unsigned char* pEnd, string& str)
+{
+    unsigned int length;
+    if (pEnd - pData < (long)sizeof(length))
+    {
+        return false;
+    }
+    memcpy(&length, pData, sizeof(length));
+    pData += sizeof(length);
+
+    if ((unsigned long)(pEnd - pData) < length)
+    {
+        return false;
+    }
+    str.assign((const char*)pData, length);
+    pData += length;
+    return true;
+}
+
+static bool loadValuesFromBinary(const string& path)
+{
+    // the file is in the writable path, and may not exist yet
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (! fp)
+    {
+        return false;
+    }
+    fseek(fp, 0, SEEK_END);
+    unsigned long nSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    unsigned char* pBuffer = new unsigned char[nSize];
+    nSize = fread(pBuffer, 1, nSize, fp);
+    fclose(fp);
+
+    bool bRet = false;
+    do
+    {
+        const unsigned char* pData = pBuffer;
+        const unsigned char* pEnd = pBuffer + nSize;
+        unsigned int header[2];
+        CC_BREAK_IF(nSize < 4 + sizeof(header) || memcmp(pData, BINARY_FILE_SIGNATURE, 4) != 0);
+        memcpy(header, pData + 4, sizeof(header));
+        CC_BREAK_IF(header[0] != BINARY_FILE_VERSION);
+        pData += 4 + sizeof(header);
+
+        ValueMap values;
+        string key;
+        unsigned int i = 0;
+        for (; i < header[1]; ++i)
+        {
+            CC_BREAK_IF(! readBinaryString(pData, pEnd, key) || ! readBinaryString(pData, pEnd, values[key]));
+        }
+        CC_BREAK_IF(i < header[1]);
+
+        s_values.swap(values);
+        bRet = true;
+    } while (0);
+
+    if (! bRet)
+    {
+        CCLOG("invalid user default file %s", path.c_str());
+    }
+    delete[] pBuffer;
+    return bRet;
+}
+
+static void writeBinaryString(FILE* fp, const string& str)
+{
+    unsigned int length = str.length();
+    fwrite(&length, sizeof(length), 1, fp);
+    fwrite(str.data(), 1, length, fp);
+}
+
+static bool saveValuesToBinary(const string& path)
+{
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (! fp)
+    {
+        return false;
+    }
+
+    unsigned int header[2] = { BINARY_FILE_VERSION, (unsigned int)s_values.size() };
+    fwrite(BINARY_FILE_SIGNATURE, 1, 4, fp);
+    fwrite(header, sizeof(header), 1, fp);
+    for (ValueMap::const_iterator it = s_values.begin(); it != s_values.end(); ++it)
+    {
+        writeBinaryString(fp, it->first);
+        writeBinaryString(fp, it->second);
+    }
+
+    bool bRet = ! ferror(fp);
+    return (fclose(fp) == 0) && bRet;
+}
+
+// replaces the file by the one that was just written, so that it is never left half written
+static bool replaceFile(const string& from, const string& to)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    if (rename(from.c_str(), to.c_str()) == 0)
+    {
+        return true;
+    }
+    // rename doesn't replace an existing file on every platform
+    remove(to.c_str());
+    return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+static void saveValues()
+{
+    if (! s_bValuesDirty)
+    {
+        return;
+    }
+
+    string path = s_bBinaryFormatEnabled ? getBinaryFilePath() : CCUserDefault::getXMLFilePath();
+    string tmpPath = path + ".tmp";
+    bool bSaved = s_bBinaryFormatEnabled ? saveValuesToBinary(tmpPath) : saveValuesToXML(tmpPath);
+    if (bSaved && replaceFile(tmpPath, path))
+    {
+        s_bValuesDirty = false;
+    }
+    else
+    {
+        CCLOG("can not save user default file %s", path.c_str());
+        remove(tmpPath.c_str());
+    }
+}
+
+static void saveValuesInCocosThread(void*)
 {
-    tinyxml2::XMLElement* curNode = NULL;
+    s_bFlushPosted = false;
+    saveValues();
+}
 
-    // check the key value
+// saves the values when the application goes to the background, where it may be killed before the next frame
+class CCUserDefaultBackgroundSaver : public CCObject
+{
+public:
+    CCUserDefaultBackgroundSaver()
+    {
+        CCNotificationCenter::sharedNotificationCenter()->addObserver(this,
+            callfuncO_selector(CCUserDefaultBackgroundSaver::listenComeToBackground),
+            EVENT_COME_TO_BACKGROUND,
+            NULL);
+    }
+
+    virtual ~CCUserDefaultBackgroundSaver()
+    {
+        CCNotificationCenter::sharedNotificationCenter()->removeObserver(this, EVENT_COME_TO_BACKGROUND);
+    }
+
+    void listenComeToBackground(CCObject *obj)
+    {
+        saveValues();
+    }
+};
+static CCUserDefaultBackgroundSaver* s_pBackgroundSaver = NULL;
+
+static void loadValues()
+{
+    if (s_bValuesLoaded)
+    {
+        return;
+    }
+    s_bValuesLoaded = true;
+
+    if (s_bBinaryFormatEnabled && loadValuesFromBinary(getBinaryFilePath()))
+    {
+        return;
+    }
+
+    if (CCUserDefault::isXMLFileExist())
+    {
+        loadValuesFromXML(CCUserDefault::getXMLFilePath());
+        // converts the xml file
+        s_bValuesDirty = s_bBinaryFormatEnabled && ! s_values.empty();
+    }
+}
+
+// the changes made during a frame are saved together at the end of the frame
+static void markValuesDirty()
+{
+    s_bValuesDirty = true;
+
+    if (! s_bFlushPosted)
+    {
+        s_bFlushPosted = true;
+        CCDirector::sharedDirector()->getScheduler()->performFunctionInCocosThread(saveValuesInCocosThread, NULL);
+    }
+
+    if (! s_pBackgroundSaver)
+    {
+        s_pBackgroundSaver = new CCUserDefaultBackgroundSaver();
+    }
+}
+
+// an empty value was saved as an empty node, which has always been read as a missing key
+static const char* getValueForKey(const char* pKey)
+{
     if (! pKey)
     {
         return NULL;
     }
 
-    do 
-    {
- 		tinyxml2::XMLDocument* xmlDoc = new tinyxml2::XMLDocument();
-		*doc = xmlDoc;
-		//CCFileData data(CCUserDefault::sharedUserDefault()->getXMLFilePath().c_str(),"rt");
-		unsigned long nSize;
-		const char* pXmlBuffer = (const char*)CCFileUtils::sharedFileUtils()->getFileData(CCUserDefault::sharedUserDefault()->getXMLFilePath().c_str(), "rb", &nSize);
-		//const char* pXmlBuffer = (const char*)data.getBuffer();
-		if(NULL == pXmlBuffer)
-		{
-			CCLOG("can not read xml file");
-			break;
-		}
-		xmlDoc->Parse(pXmlBuffer, nSize);
-        delete[] pXmlBuffer;
-		// get root node
-		*rootNode = xmlDoc->RootElement();
-		if (NULL == *rootNode)
-		{
-			CCLOG("read root node error");
-			break;
-		}
-		// find the node
-		curNode = (*rootNode)->FirstChildElement();
-		while (NULL != curNode)
-		{
-			const char* nodeName = curNode->Value();
-			if (!strcmp(nodeName, pKey))
-			{
-				break;
-			}
-
-			curNode = curNode->NextSiblingElement();
-		}
-	} while (0);
-
-	return curNode;
+    ValueMap::const_iterator it = s_values.find(pKey);
+    if (it == s_values.end() || it->second.empty())
+    {
+        return NULL;
+    }
+    return it->second.c_str();
 }
 
 static void setValueForKey(const char* pKey, const char* pValue)
 {
- 	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	// check the params
-	if (! pKey || ! pValue)
-	{
-		return;
-	}
-	// find the node
-	node = getXMLNodeForKey(pKey, &rootNode, &doc);
-	// if node exist, change the content
-	if (node)
-	{
-        if (node->FirstChild())
-        {
-            node->FirstChild()->SetValue(pValue);
-        }
-        else
-        {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
-        }
-	}
-	else
-	{
-		if (rootNode)
-		{
-			tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-			rootNode->LinkEndChild(tmpNode);
-			tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-			tmpNode->LinkEndChild(content);
-		}	
-	}
+    // check the params
+    if (! pKey || ! pValue)
+    {
+        return;
+    }
 
-    // save file and free doc
-	if (doc)
-	{
-		doc->SaveFile(CCUserDefault::sharedUserDefault()->getXMLFilePath().c_str());
-		delete doc;
-	}
+    string& value = s_values[pKey];
+    if (value != pValue)
+    {
+        value = pValue;
+        markValuesDirty();
+    }
 }
 
 /**
@@ -160,6 +377,11 @@ CCUserDefault::CCUserDefault()
 
 void CCUserDefault::purgeSharedUserDefault()
 {
+    saveValues();
+    CC_SAFE_RELEASE_NULL(s_pBackgroundSaver);
+    s_values.clear();
+    s_bValuesLoaded = false;
+
     m_spUserDefault = NULL;
 }
 
@@ -170,16 +392,7 @@ void CCUserDefault::purgeSharedUserDefault()
 
 bool CCUserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 {
-    const char* value = NULL;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
+    const char* value = getValueForKey(pKey);
 
 	bool ret = defaultValue;
 
@@ -188,8 +401,6 @@ bool CCUserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 		ret = (! strcmp(value, "true"));
 	}
 
-    if (doc) delete doc;
-
 	return ret;
 }
 
@@ -200,16 +411,7 @@ int CCUserDefault::getIntegerForKey(const char* pKey)
 
 int CCUserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 {
-	const char* value = NULL;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
+	const char* value = getValueForKey(pKey);
 
 	int ret = defaultValue;
 
@@ -218,12 +420,6 @@ int CCUserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 		ret = atoi(value);
 	}
 
-	if(doc)
-	{
-		delete doc;
-	}
-
-
 	return ret;
 }
 
@@ -246,16 +442,7 @@ double  CCUserDefault::getDoubleForKey(const char* pKey)
 
 double CCUserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
-	const char* value = NULL;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
+	const char* value = getValueForKey(pKey);
 
 	double ret = defaultValue;
 
@@ -264,8 +451,6 @@ double CCUserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 		ret = atof(value);
 	}
 
-    if (doc) delete doc;
-
 	return ret;
 }
 
@@ -276,16 +461,7 @@ std::string CCUserDefault::getStringForKey(const char* pKey)
 
 string CCUserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
-    const char* value = NULL;
-	tinyxml2::XMLElement* rootNode;
-	tinyxml2::XMLDocument* doc;
-	tinyxml2::XMLElement* node;
-	node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-	// find the node
-	if (node && node->FirstChild())
-	{
-        value = (const char*)(node->FirstChild()->Value());
-	}
+    const char* value = getValueForKey(pKey);
 
 	string ret = defaultValue;
 
@@ -294,8 +470,6 @@ string CCUserDefault::getStringForKey(const char* pKey, const std::string & defa
 		ret = string(value);
 	}
 
-    if (doc) delete doc;
-
 	return ret;
 }
 
@@ -367,7 +541,7 @@ CCUserDefault* CCUserDefault::sharedUserDefault()
 
     // only create xml file one time
     // the file exists after the program exit
-    if ((! isXMLFileExist()) && (! createXMLFile()))
+    if ((! s_bBinaryFormatEnabled) && (! isXMLFileExist()) && (! createXMLFile()))
     {
         return NULL;
     }
@@ -375,6 +549,7 @@ CCUserDefault* CCUserDefault::sharedUserDefault()
     if (! m_spUserDefault)
     {
         m_spUserDefault = new CCUserDefault();
+        loadValues();
     }
 
     return m_spUserDefault;
@@ -441,6 +616,26 @@ const string& CCUserDefault::getXMLFilePath()
 
 void CCUserDefault::flush()
 {
+    saveValues();
+}
+
+void CCUserDefault::setBinaryFormatEnabled(bool bEnabled)
+{
+    if (s_bBinaryFormatEnabled != bEnabled)
+    {
+        s_bBinaryFormatEnabled = bEnabled;
+
+        // the values are saved to the other file on the next flush
+        if (s_bValuesLoaded)
+        {
+            markValuesDirty();
+        }
+    }
+}
+
+bool CCUserDefault::isBinaryFormatEnabled()
+{
+    return s_bBinaryFormatEnabled;
 }
 
 NS_CC_END
@@ -41,6 +41,13 @@ NS_CC_BEGIN
  * 
  * It supports the following base types:
  * bool, int, float, double, string
+ *
+ * The values are read from the file once, and kept in memory. Setting a value doesn't write the file:
+ * the changes made during a frame are written together at the end of the frame, or by flush().
+ * They are also written when EVENT_COME_TO_BACKGROUND is posted. On the platforms that don't post it,
+ * call flush() in AppDelegate::applicationDidEnterBackground after setting values there, since the
+ * application may be killed in the background before the end of the frame.
+ * The file is written next to the previous one, which is then replaced, so that it is never left half written.
  */
 class CC_DLL CCUserDefault
 {
@@ -103,7 +110,8 @@ public:
     */
     void    setStringForKey(const char* pKey, const std::string & value);
     /**
-     @brief Save content to xml file
+     @brief Save the values that were changed to the file. It is done at the end of every frame anyway,
+     but values set in AppDelegate::applicationDidEnterBackground must be saved by calling it there.
      */
     void    flush();
 
@@ -112,6 +120,16 @@ public:
     const static std::string& getXMLFilePath();
     static bool isXMLFileExist();
 
+    /**
+     @brief Whether the values are saved in a compact binary file instead of the xml file, which is faster to load.
+     It should be set before the first call to sharedUserDefault(). The values of an existing xml file are
+     loaded when there is no binary file yet, and are saved to the binary file on the next flush.
+     Ignored on iOS, Mac and Android, which use the user defaults of the system.
+     @since v2.2.6
+     */
+    static void setBinaryFormatEnabled(bool bEnabled);
+    static bool isBinaryFormatEnabled();
+
 private:
     CCUserDefault();
     static bool createXMLFile();
@@ -480,6 +480,17 @@ void CCUserDefault::flush()
     [[NSUserDefaults standardUserDefaults] synchronize];
 }
 
+// the values are kept by NSUserDefaults
+void CCUserDefault::setBinaryFormatEnabled(bool bEnabled)
+{
+    CC_UNUSED_PARAM(bEnabled);
+}
+
+bool CCUserDefault::isBinaryFormatEnabled()
+{
+    return false;
+}
+
 
 NS_CC_END
 
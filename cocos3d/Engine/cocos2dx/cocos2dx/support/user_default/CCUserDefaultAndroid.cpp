@@ -435,6 +435,17 @@ void CCUserDefault::flush()
 {
 }
 
+// the values are kept by SharedPreferences
+void CCUserDefault::setBinaryFormatEnabled(bool bEnabled)
+{
+    CC_UNUSED_PARAM(bEnabled);
+}
+
+bool CCUserDefault::isBinaryFormatEnabled()
+{
+    return false;
+}
+
 NS_CC_END
 
 #endif // (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
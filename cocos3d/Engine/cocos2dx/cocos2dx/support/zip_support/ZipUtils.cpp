@@ -24,6 +24,9 @@
 #include <zlib.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <new>
 
 #include "ZipUtils.h"
 #include "ccMacros.h"
@@ -127,12 +130,15 @@ inline unsigned int ZipUtils::ccChecksumPvr(const unsigned int *data, int len)
 // Should buffer factor be 1.5 instead of 2 ?
 #define BUFFER_INC_FACTOR (2)
 
+// size of the chunks in which compressed files are read while they are inflated
+#define INFLATE_CHUNK_SIZE (64 * 1024)
+
 int ZipUtils::ccInflateMemoryWithHint(unsigned char *in, unsigned int inLength, unsigned char **out, unsigned int *outLength, unsigned int outLenghtHint)
 {
     /* ret value */
     int err = Z_OK;
     
-    int bufferSize = outLenghtHint;
+    unsigned int bufferSize = outLenghtHint > 0 ? outLenghtHint : 1024;
     *out = new unsigned char[bufferSize];
     
     z_stream d_stream; /* decompression stream */
@@ -151,7 +157,8 @@ int ZipUtils::ccInflateMemoryWithHint(unsigned char *in, unsigned int inLength,
     
     for (;;)
     {
-        err = inflate(&d_stream, Z_NO_FLUSH);
+        // inflate as much as possible in one call, which is all of it when the hint is right
+        err = inflate(&d_stream, Z_FINISH);
         
         if (err == Z_STREAM_END)
         {
@@ -169,22 +176,32 @@ int ZipUtils::ccInflateMemoryWithHint(unsigned char *in, unsigned int inLength,
         }
         
         // not enough memory ?
-        if (err != Z_STREAM_END)
+        if (d_stream.avail_out == 0)
         {
-            *out = (unsigned char*)realloc(*out, bufferSize * BUFFER_INC_FACTOR);
+            unsigned char *tmp = new (std::nothrow) unsigned char[bufferSize * BUFFER_INC_FACTOR];
             
             /* not enough memory, ouch */
-            if (! *out )
+            if (! tmp )
             {
                 CCLOG("cocos2d: ZipUtils: realloc failed");
                 inflateEnd(&d_stream);
                 return Z_MEM_ERROR;
             }
             
+            memcpy(tmp, *out, bufferSize);
+            delete [] *out;
+            *out = tmp;
+            
             d_stream.next_out = *out + bufferSize;
-            d_stream.avail_out = bufferSize;
+            d_stream.avail_out = bufferSize * (BUFFER_INC_FACTOR - 1);
             bufferSize *= BUFFER_INC_FACTOR;
         }
+        else if (d_stream.avail_in == 0)
+        {
+            // truncated stream
+            inflateEnd(&d_stream);
+            return Z_DATA_ERROR;
+        }
     }
     
     *outLength = bufferSize - d_stream.avail_out;
@@ -229,6 +246,114 @@ int ZipUtils::ccInflateMemory(unsigned char *in, unsigned int inLength, unsigned
     return ccInflateMemoryWithHint(in, inLength, out, 256 * 1024);
 }
 
+int ZipUtils::ccInflateMemoryToBuffer(const unsigned char *in, unsigned int inLength, unsigned char *out, unsigned int outLength)
+{
+    CCInflateStream stream;
+    if (!stream.init(out, outLength) || stream.inflateChunk(in, inLength) != 1)
+    {
+        CCLOG("cocos2d: ZipUtils: Incorrect zlib compressed data, or inflated data larger than %u bytes!", outLength);
+        return -1;
+    }
+    return stream.getInflatedLength();
+}
+
+int ZipUtils::ccDecompressLZ4(const unsigned char *in, unsigned int inLength, unsigned char *out, unsigned int outLength)
+{
+    const unsigned char *ip = in;
+    const unsigned char *ipEnd = in + inLength;
+    unsigned char *op = out;
+    unsigned char *opEnd = out + outLength;
+    
+    // each sequence is a token, literals, and a match copied from the output already decoded
+    while (ip < ipEnd)
+    {
+        unsigned int token = *ip++;
+        
+        unsigned int literalLength = token >> 4;
+        if (literalLength == 15)
+        {
+            unsigned int s;
+            do
+            {
+                if (ip >= ipEnd)
+                {
+                    return -1;
+                }
+                s = *ip++;
+                literalLength += s;
+            } while (s == 255);
+        }
+        if (literalLength > (unsigned int)(ipEnd - ip) || literalLength > (unsigned int)(opEnd - op))
+        {
+            return -1;
+        }
+        memcpy(op, ip, literalLength);
+        op += literalLength;
+        ip += literalLength;
+        
+        // the last sequence has no match
+        if (ip >= ipEnd)
+        {
+            break;
+        }
+        
+        if (ipEnd - ip < 2)
+        {
+            return -1;
+        }
+        unsigned int offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (unsigned int)(op - out))
+        {
+            return -1;
+        }
+        
+        unsigned int matchLength = token & 15;
+        if (matchLength == 15)
+        {
+            unsigned int s;
+            do
+            {
+                if (ip >= ipEnd)
+                {
+                    return -1;
+                }
+                s = *ip++;
+                matchLength += s;
+            } while (s == 255);
+        }
+        matchLength += 4;
+        if (matchLength > (unsigned int)(opEnd - op))
+        {
+            return -1;
+        }
+        
+        const unsigned char *match = op - offset;
+        unsigned char *matchEnd = op + matchLength;
+        if (offset >= 8 && (unsigned int)(opEnd - matchEnd) >= 8)
+        {
+            // copy eight bytes at a time, possibly past the end of the match, which is overwritten later
+            do
+            {
+                memcpy(op, match, 8);
+                op += 8;
+                match += 8;
+            } while (op < matchEnd);
+            op = matchEnd;
+        }
+        else
+        {
+            // the match overlaps the bytes being written, so it repeats a short pattern
+            while (op < matchEnd)
+            {
+                *op++ = *match++;
+            }
+        }
+    }
+    
+    return (int)(op - out);
+}
+
 int ZipUtils::ccInflateGZipFile(const char *path, unsigned char **out)
 {
     int len;
@@ -237,20 +362,40 @@ int ZipUtils::ccInflateGZipFile(const char *path, unsigned char **out)
     CCAssert(out, "");
     CCAssert(&*out, "");
     
+    /* 512k initial decompress buffer */
+    unsigned int bufferSize = 512 * 1024;
+    
+    // the last four bytes of a gzip file hold the size of the inflated data,
+    // which lets the data be inflated into a buffer of the right size at once
+    FILE *fp = fopen(path, "rb");
+    if (fp)
+    {
+        unsigned char isize[4];
+        if (fseek(fp, -4, SEEK_END) == 0 && fread(isize, 1, 4, fp) == 4)
+        {
+            unsigned int inflatedSize = isize[0] | (isize[1] << 8) | (isize[2] << 16) | ((unsigned int)isize[3] << 24);
+            if (inflatedSize > 0)
+            {
+                // one more byte, to find the end of the file in the first read
+                bufferSize = inflatedSize + 1;
+            }
+        }
+        fclose(fp);
+    }
+    
     gzFile inFile = gzopen(path, "rb");
     if( inFile == NULL ) {
         CCLOG("cocos2d: ZipUtils: error open gzip file: %s", path);
         return -1;
     }
     
-    /* 512k initial decompress buffer */
-    unsigned int bufferSize = 512 * 1024;
     unsigned int totalBufferSize = bufferSize;
     
-    *out = (unsigned char*)malloc( bufferSize );
-    if( ! out )
+    *out = new (std::nothrow) unsigned char[bufferSize];
+    if( ! *out )
     {
         CCLOG("cocos2d: ZipUtils: out of memory");
+        gzclose(inFile);
         return -1;
     }
     
@@ -259,8 +404,9 @@ int ZipUtils::ccInflateGZipFile(const char *path, unsigned char **out)
         if (len < 0)
         {
             CCLOG("cocos2d: ZipUtils: error in gzread");
-            free( *out );
+            delete [] *out;
             *out = NULL;
+            gzclose(inFile);
             return -1;
         }
         if (len == 0)
@@ -277,18 +423,21 @@ int ZipUtils::ccInflateGZipFile(const char *path, unsigned char **out)
         }
         
         bufferSize *= BUFFER_INC_FACTOR;
-        totalBufferSize += bufferSize;
-        unsigned char *tmp = (unsigned char*)realloc(*out, totalBufferSize );
+        unsigned char *tmp = new (std::nothrow) unsigned char[totalBufferSize + bufferSize];
         
         if( ! tmp )
         {
             CCLOG("cocos2d: ZipUtils: out of memory");
-            free( *out );
+            delete [] *out;
             *out = NULL;
+            gzclose(inFile);
             return -1;
         }
         
+        memcpy(tmp, *out, offset);
+        delete [] *out;
         *out = tmp;
+        totalBufferSize += bufferSize;
     }
     
     if (gzclose(inFile) != Z_OK)
@@ -299,11 +448,134 @@ int ZipUtils::ccInflateGZipFile(const char *path, unsigned char **out)
     return offset;
 }
 
+int ZipUtils::ccDecompressCCZData(const unsigned char *in, unsigned int inLength, unsigned int compression, unsigned char *out, unsigned int outLength)
+{
+    if (compression == CCZ_COMPRESSION_LZ4)
+    {
+        return ccDecompressLZ4(in, inLength, out, outLength);
+    }
+    return ccInflateMemoryToBuffer(in, inLength, out, outLength);
+}
+
+static bool isSupportedCCZCompression(unsigned int compression)
+{
+    return compression == CCZ_COMPRESSION_ZLIB || compression == CCZ_COMPRESSION_LZ4;
+}
+
+int ZipUtils::ccInflateCCZFileStreaming(const char *path, unsigned char **out)
+{
+    FILE *fp = fopen(CCFileUtils::sharedFileUtils()->fullPathForFilename(path).c_str(), "rb");
+    if (!fp)
+    {
+        return -1;
+    }
+    
+    struct CCZHeader header;
+    unsigned int version = 0;
+    unsigned int compression = 0;
+    bool isPlain = fread(&header, 1, sizeof(header), fp) == sizeof(header)
+        && header.sig[0] == 'C' && header.sig[1] == 'C' && header.sig[2] == 'Z' && header.sig[3] == '!';
+    if (isPlain)
+    {
+        version = CC_SWAP_INT16_BIG_TO_HOST( header.version );
+        compression = CC_SWAP_INT16_BIG_TO_HOST( header.compression_type );
+    }
+    if (!isPlain || version > 2 || !isSupportedCCZCompression(compression))
+    {
+        // left to the general path, which reports the problem
+        fclose(fp);
+        return -1;
+    }
+    
+    unsigned int len = CC_SWAP_INT32_BIG_TO_HOST( header.len );
+    *out = new (std::nothrow) unsigned char[len];
+    if (! *out)
+    {
+        CCLOG("cocos2d: CCZ: Failed to allocate memory for texture");
+        fclose(fp);
+        return -1;
+    }
+    
+    int ret = -1;
+    if (compression == CCZ_COMPRESSION_ZLIB)
+    {
+        // inflate each chunk as it is read, so the compressed file is never held in memory as a whole
+        CCInflateStream stream;
+        if (stream.init(*out, len))
+        {
+            unsigned char *chunk = new unsigned char[INFLATE_CHUNK_SIZE];
+            int status = 0;
+            size_t chunkLength;
+            while (status == 0 && (chunkLength = fread(chunk, 1, INFLATE_CHUNK_SIZE, fp)) > 0)
+            {
+                status = stream.inflateChunk(chunk, (unsigned int)chunkLength);
+            }
+            if (status == 1)
+            {
+                ret = stream.getInflatedLength();
+            }
+            delete [] chunk;
+        }
+    }
+    else
+    {
+        // lz4 blocks are decoded whole, which is cheap next to their reading
+        fseek(fp, 0, SEEK_END);
+        long compressedLength = ftell(fp) - (long)sizeof(header);
+        fseek(fp, sizeof(header), SEEK_SET);
+        unsigned char *compressed = new (std::nothrow) unsigned char[compressedLength];
+        if (compressed && fread(compressed, 1, compressedLength, fp) == (size_t)compressedLength)
+        {
+            ret = ccDecompressLZ4(compressed, (unsigned int)compressedLength, *out, len);
+        }
+        CC_SAFE_DELETE_ARRAY(compressed);
+    }
+    fclose(fp);
+    
+    if (ret != (int)len)
+    {
+        CCLOG("cocos2d: CCZ: Failed to uncompress data");
+        delete [] *out;
+        *out = NULL;
+        return -1;
+    }
+    return len;
+}
+
 int ZipUtils::ccInflateCCZFile(const char *path, unsigned char **out)
 {
     CCAssert(out, "");
     CCAssert(&*out, "");
     
+    *out = NULL;
+    
+    // files stored uncompressed in a mounted archive are inflated straight from the mapping
+    unsigned long mappedLen = 0;
+    const unsigned char *mapped = CCFileUtils::sharedFileUtils()->getMappedFileData(path, &mappedLen);
+    if (mapped && mappedLen > sizeof(struct CCZHeader))
+    {
+        const struct CCZHeader *header = (const struct CCZHeader*) mapped;
+        unsigned int compression = CC_SWAP_INT16_BIG_TO_HOST( header->compression_type );
+        if( header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == '!'
+            && CC_SWAP_INT16_BIG_TO_HOST( header->version ) <= 2 && isSupportedCCZCompression(compression) )
+        {
+            unsigned int len = CC_SWAP_INT32_BIG_TO_HOST( header->len );
+            *out = new (std::nothrow) unsigned char[len];
+            if (*out && ccDecompressCCZData(mapped + sizeof(*header), mappedLen - sizeof(*header), compression, *out, len) == (int)len)
+            {
+                return len;
+            }
+            CC_SAFE_DELETE_ARRAY(*out);
+        }
+    }
+    
+    // plain files are inflated while they are read
+    int streamedLen = ccInflateCCZFileStreaming(path, out);
+    if (streamedLen >= 0)
+    {
+        return streamedLen;
+    }
+    
     // load file into memory
     unsigned char* compressed = NULL;
     
@@ -331,7 +603,7 @@ int ZipUtils::ccInflateCCZFile(const char *path, unsigned char **out)
         }
         
         // verify compression format
-        if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
+        if( !isSupportedCCZCompression(CC_SWAP_INT16_BIG_TO_HOST(header->compression_type)) )
         {
             CCLOG("cocos2d: CCZ Unsupported compression method");
             delete [] compressed;
@@ -353,7 +625,7 @@ int ZipUtils::ccInflateCCZFile(const char *path, unsigned char **out)
         }
         
         // verify compression format
-        if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
+        if( !isSupportedCCZCompression(CC_SWAP_INT16_BIG_TO_HOST(header->compression_type)) )
         {
             CCLOG("cocos2d: CCZ Unsupported compression method");
             delete [] compressed;
@@ -388,7 +660,7 @@ int ZipUtils::ccInflateCCZFile(const char *path, unsigned char **out)
     
     unsigned int len = CC_SWAP_INT32_BIG_TO_HOST( header->len );
     
-    *out = (unsigned char*)malloc( len );
+    *out = new (std::nothrow) unsigned char[len];
     if(! *out )
     {
         CCLOG("cocos2d: CCZ: Failed to allocate memory for texture");
@@ -396,16 +668,15 @@ int ZipUtils::ccInflateCCZFile(const char *path, unsigned char **out)
         return -1;
     }
     
-    unsigned long destlen = len;
-    unsigned long source = (unsigned long) compressed + sizeof(*header);
-    int ret = uncompress(*out, &destlen, (Bytef*)source, fileLen - sizeof(*header) );
+    int ret = ccDecompressCCZData(compressed + sizeof(*header), fileLen - sizeof(*header),
+                                  CC_SWAP_INT16_BIG_TO_HOST( header->compression_type ), *out, len);
     
     delete [] compressed;
     
-    if( ret != Z_OK )
+    if( ret != (int)len )
     {
         CCLOG("cocos2d: CCZ: Failed to uncompress data");
-        free( *out );
+        delete [] *out;
         *out = NULL;
         return -1;
     }
@@ -413,6 +684,78 @@ int ZipUtils::ccInflateCCZFile(const char *path, unsigned char **out)
     return len;
 }
 
+// --------------------- CCInflateStream ---------------------
+
+CCInflateStream::CCInflateStream()
+: m_pStream(NULL)
+, m_bFinished(false)
+{
+}
+
+CCInflateStream::~CCInflateStream()
+{
+    if (m_pStream)
+    {
+        inflateEnd((z_stream*)m_pStream);
+        delete (z_stream*)m_pStream;
+    }
+}
+
+bool CCInflateStream::init(unsigned char *out, unsigned int outLength)
+{
+    CCAssert(m_pStream == NULL, "CCInflateStream: already initialized");
+    
+    z_stream *stream = new z_stream;
+    memset(stream, 0, sizeof(z_stream));
+    stream->next_out = out;
+    stream->avail_out = outLength;
+    
+    // accept both zlib and gzip headers
+    if (inflateInit2(stream, 15 + 32) != Z_OK)
+    {
+        delete stream;
+        return false;
+    }
+    m_pStream = stream;
+    m_bFinished = false;
+    return true;
+}
+
+int CCInflateStream::inflateChunk(const unsigned char *in, unsigned int inLength)
+{
+    z_stream *stream = (z_stream*)m_pStream;
+    if (!stream)
+    {
+        return -1;
+    }
+    if (m_bFinished)
+    {
+        return 1;
+    }
+    
+    stream->next_in = (Bytef*)in;
+    stream->avail_in = inLength;
+    
+    int err = inflate(stream, Z_NO_FLUSH);
+    if (err == Z_STREAM_END)
+    {
+        m_bFinished = true;
+        return 1;
+    }
+    if (err != Z_OK && err != Z_BUF_ERROR)
+    {
+        return -1;
+    }
+    
+    // the whole chunk is consumed unless the output buffer is full
+    return (stream->avail_in == 0) ? 0 : -1;
+}
+
+unsigned int CCInflateStream::getInflatedLength() const
+{
+    return m_pStream ? (unsigned int)((z_stream*)m_pStream)->total_out : 0;
+}
+
 void ZipUtils::ccSetPvrEncryptionKeyPart(int index, unsigned int value)
 {
     CCAssert(index >= 0, "Cocos2d: key part index cannot be less than 0");
@@ -465,6 +808,11 @@ ZipFile::ZipFile(const std::string &zipFile, const std::string &filter)
     }
 }
 
+bool ZipFile::isOpen() const
+{
+    return _data->zipFile && _dataThread->zipFile;
+}
+
 ZipFile::~ZipFile()
 {
     if (_data && _data->zipFile)
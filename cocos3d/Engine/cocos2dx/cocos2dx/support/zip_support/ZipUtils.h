@@ -50,6 +50,38 @@ namespace cocos2d
         CCZ_COMPRESSION_BZIP2,              // bzip2 format (not supported yet)
         CCZ_COMPRESSION_GZIP,               // gzip format (not supported yet)
         CCZ_COMPRESSION_NONE,               // plain (not supported yet)
+        CCZ_COMPRESSION_LZ4,                // lz4 block format. Faster to decompress than zlib, but larger.
+    };
+
+    /**
+    * Inflates a zlib or gzip stream that arrives in chunks, straight into a buffer
+    * whose size is known in advance, so that the compressed data never needs to be
+    * held in memory as a whole.
+    *
+    * @since v2.2.6
+    */
+    class CC_DLL CCInflateStream
+    {
+    public:
+        CCInflateStream();
+        ~CCInflateStream();
+
+        /** Prepares the stream to inflate into the specified buffer, which is not owned by the stream. */
+        bool init(unsigned char *out, unsigned int outLength);
+
+        /**
+        * Inflates the next chunk of the compressed stream.
+        * @returns 1 once the end of the stream has been reached, 0 if more input is needed,
+        *          or -1 if the data is invalid or does not fit in the buffer.
+        */
+        int inflateChunk(const unsigned char *in, unsigned int inLength);
+
+        /** The number of bytes inflated so far. */
+        unsigned int getInflatedLength() const;
+
+    private:
+        void *m_pStream;
+        bool m_bFinished;
     };
 
     class CC_DLL ZipUtils
@@ -78,7 +110,26 @@ namespace cocos2d
         */
         static int ccInflateMemoryWithHint(unsigned char *in, unsigned int inLength, unsigned char **out, unsigned int outLenghtHint);
 
-        /** inflates a GZip file into memory
+        /**
+        * Inflates either zlib or gzip deflated memory straight into a buffer provided by the
+        * caller, without any intermediate allocation.
+        *
+        * @returns the length of the inflated data, or -1 if the data is invalid or does not fit in the buffer.
+        *
+        * @since v2.2.6
+        */
+        static int ccInflateMemoryToBuffer(const unsigned char *in, unsigned int inLength, unsigned char *out, unsigned int outLength);
+
+        /**
+        * Decompresses an lz4 block into a buffer provided by the caller.
+        *
+        * @returns the length of the decompressed data, or -1 if the data is invalid or does not fit in the buffer.
+        *
+        * @since v2.2.6
+        */
+        static int ccDecompressLZ4(const unsigned char *in, unsigned int inLength, unsigned char *out, unsigned int outLength);
+
+        /** inflates a GZip file into memory. The inflated memory is expected to be freed by the caller with delete[].
         *
         * @returns the length of the deflated buffer
         *
@@ -86,7 +137,11 @@ namespace cocos2d
         */
         static int ccInflateGZipFile(const char *filename, unsigned char **out);
 
-        /** inflates a CCZ file into memory
+        /** inflates a CCZ file into memory. The inflated memory is expected to be freed by the caller with delete[].
+        *
+        * Files that are not encrypted are inflated while they are read, or straight from
+        * the mapped archive that holds them, rather than being read into memory first.
+        * The compression may be CCZ_COMPRESSION_ZLIB or CCZ_COMPRESSION_LZ4.
         *
         * @returns the length of the deflated buffer
         *
@@ -151,6 +206,8 @@ namespace cocos2d
                                            unsigned int outLenghtHint);
         static inline void ccDecodeEncodedPvr (unsigned int *data, int len);
         static inline unsigned int ccChecksumPvr(const unsigned int *data, int len);
+        static int ccDecompressCCZData(const unsigned char *in, unsigned int inLength, unsigned int compression, unsigned char *out, unsigned int outLength);
+        static int ccInflateCCZFileStreaming(const char *path, unsigned char **out);
 
         static unsigned int s_uEncryptedPvrKeyParts[4];
         static unsigned int s_uEncryptionKey[1024];
@@ -219,6 +276,13 @@ namespace cocos2d
         */
         unsigned char *getFileData(const std::string &fileName, unsigned long *pSize);
 
+        /**
+        * Check whether the zip file could be opened
+        *
+        * @since v2.2.6
+        */
+        bool isOpen() const;
+
     private:
         bool setFilter(const std::string &filer, ZipFilePrivate *data);
         unsigned char *getFileData(const std::string &fileName, unsigned long *pSize, ZipFilePrivate *data);
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "support/CCNotificationCenter.h"
 #include "CCEventType.h"
 #include "CCGL.h"
+#include "CCDirector.h"
 // support
 #include "CCTexture2D.h"
 #include "cocoa/CCString.h"
@@ -44,11 +45,34 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+// upload counters of the current frame, and of the last frame
+static unsigned int s_uCounterFrame = 0;
+static unsigned int s_uUploadedBytes = 0;
+static unsigned int s_uUploads = 0;
+static unsigned int s_uUploadedBytesInLastFrame = 0;
+static unsigned int s_uUploadsInLastFrame = 0;
+
+static void updateUploadCounters()
+{
+    unsigned int frame = CCDirector::sharedDirector()->getTotalFrames();
+    if (frame != s_uCounterFrame)
+    {
+        s_uUploadedBytesInLastFrame = (frame == s_uCounterFrame + 1) ? s_uUploadedBytes : 0;
+        s_uUploadsInLastFrame = (frame == s_uCounterFrame + 1) ? s_uUploads : 0;
+        s_uUploadedBytes = 0;
+        s_uUploads = 0;
+        s_uCounterFrame = frame;
+    }
+}
+
 CCTextureAtlas::CCTextureAtlas()
     :m_pIndices(NULL)
     ,m_bDirty(false)
+    ,m_uDirtyStart(0)
+    ,m_uDirtyEnd(0)
     ,m_pTexture(NULL)
     ,m_pQuads(NULL)
+    ,m_eUploadMode(kCCTextureAtlasUploadDirtyRange)
 {}
 
 CCTextureAtlas::~CCTextureAtlas()
@@ -96,7 +120,7 @@ void CCTextureAtlas::setTexture(CCTexture2D * var)
 ccV3F_C4B_T2F_Quad* CCTextureAtlas::getQuads()
 {
     //if someone accesses the quads directly, presume that changes will be made
-    m_bDirty = true;
+    setDirty(true);
     return m_pQuads;
 }
 
@@ -105,6 +129,62 @@ void CCTextureAtlas::setQuads(ccV3F_C4B_T2F_Quad *var)
     m_pQuads = var;
 }
 
+tCCTextureAtlasUploadMode CCTextureAtlas::getUploadMode()
+{
+    return m_eUploadMode;
+}
+
+void CCTextureAtlas::setUploadMode(tCCTextureAtlasUploadMode var)
+{
+    m_eUploadMode = var;
+}
+
+void CCTextureAtlas::setDirty(bool bDirty)
+{
+    if (bDirty)
+    {
+        markQuadsDirty(0, m_uCapacity);
+    }
+    else
+    {
+        m_bDirty = false;
+        m_uDirtyStart = m_uDirtyEnd = 0;
+    }
+}
+
+void CCTextureAtlas::markQuadsDirty(unsigned int index, unsigned int amount)
+{
+    unsigned int end = MIN(index + amount, m_uCapacity);
+    if (index >= end)
+    {
+        return;
+    }
+
+    if (m_bDirty)
+    {
+        m_uDirtyStart = MIN(m_uDirtyStart, index);
+        m_uDirtyEnd = MAX(m_uDirtyEnd, end);
+    }
+    else
+    {
+        m_uDirtyStart = index;
+        m_uDirtyEnd = end;
+        m_bDirty = true;
+    }
+}
+
+unsigned int CCTextureAtlas::getUploadedBytesInLastFrame()
+{
+    updateUploadCounters();
+    return s_uUploadedBytesInLastFrame;
+}
+
+unsigned int CCTextureAtlas::getUploadsInLastFrame()
+{
+    updateUploadCounters();
+    return s_uUploadsInLastFrame;
+}
+
 // TextureAtlas - alloc & init
 
 CCTextureAtlas * CCTextureAtlas::create(const char* file, unsigned int capacity)
@@ -194,7 +274,7 @@ bool CCTextureAtlas::initWithTexture(CCTexture2D *texture, unsigned int capacity
     setupVBO();
 #endif
 
-    m_bDirty = true;
+    setDirty(true);
 
     return true;
 }
@@ -208,7 +288,7 @@ void CCTextureAtlas::listenBackToForeground(CCObject *obj)
 #endif
     
     // set m_bDirty to true to force it rebinding buffer
-    m_bDirty = true;
+    setDirty(true);
 }
 
 const char* CCTextureAtlas::description()
@@ -317,7 +397,7 @@ void CCTextureAtlas::updateQuad(ccV3F_C4B_T2F_Quad *quad, unsigned int index)
     m_pQuads[index] = *quad;    
 
 
-    m_bDirty = true;
+    markQuadsDirty(index, 1);
 
 }
 
@@ -341,7 +421,7 @@ void CCTextureAtlas::insertQuad(ccV3F_C4B_T2F_Quad *quad, unsigned int index)
     m_pQuads[index] = *quad;
 
 
-    m_bDirty = true;
+    markQuadsDirty(index, m_uTotalQuads - index);
 
 }
 
@@ -366,14 +446,14 @@ void CCTextureAtlas::insertQuads(ccV3F_C4B_T2F_Quad* quads, unsigned int index,
 
     unsigned int max = index + amount;
     unsigned int j = 0;
+    markQuadsDirty(index, m_uTotalQuads - index);
+
     for (unsigned int i = index; i < max ; i++)
     {
         m_pQuads[index] = quads[j];
         index++;
         j++;
     }
-
-    m_bDirty = true;
 }
 
 void CCTextureAtlas::insertQuadFromIndex(unsigned int oldIndex, unsigned int newIndex)
@@ -402,7 +482,7 @@ void CCTextureAtlas::insertQuadFromIndex(unsigned int oldIndex, unsigned int new
     m_pQuads[newIndex] = quadsBackup;
 
 
-    m_bDirty = true;
+    markQuadsDirty(MIN(oldIndex, newIndex), MAX(oldIndex, newIndex) - MIN(oldIndex, newIndex) + 1);
 
 }
 
@@ -423,7 +503,7 @@ void CCTextureAtlas::removeQuadAtIndex(unsigned int index)
     m_uTotalQuads--;
 
 
-    m_bDirty = true;
+    markQuadsDirty(index, remaining);
 
 }
 
@@ -440,7 +520,7 @@ void CCTextureAtlas::removeQuadsAtIndex(unsigned int index, unsigned int amount)
         memmove( &m_pQuads[index], &m_pQuads[index+amount], sizeof(m_pQuads[0]) * remaining );
     }
 
-    m_bDirty = true;
+    markQuadsDirty(index, remaining);
 }
 
 void CCTextureAtlas::removeAllQuads()
@@ -517,13 +597,14 @@ bool CCTextureAtlas::resizeCapacity(unsigned int newCapacity)
     setupIndices();
     mapBuffers();
 
-    m_bDirty = true;
+    setDirty(true);
 
     return true;
 }
 
 void CCTextureAtlas::increaseTotalQuadsWith(unsigned int amount)
 {
+    markQuadsDirty(m_uTotalQuads, amount);
     m_uTotalQuads += amount;
 }
 
@@ -555,7 +636,7 @@ void CCTextureAtlas::moveQuadsFromIndex(unsigned int oldIndex, unsigned int amou
 
     free(tempQuads);
 
-    m_bDirty = true;
+    markQuadsDirty(MIN(oldIndex, newIndex), MAX(oldIndex, newIndex) - MIN(oldIndex, newIndex) + amount);
 }
 
 void CCTextureAtlas::moveQuadsFromIndex(unsigned int index, unsigned int newIndex)
@@ -563,6 +644,8 @@ void CCTextureAtlas::moveQuadsFromIndex(unsigned int index, unsigned int newInde
     CCAssert(newIndex + (m_uTotalQuads - index) <= m_uCapacity, "moveQuadsFromIndex move is out of bounds");
 
     memmove(m_pQuads + newIndex,m_pQuads + index, (m_uTotalQuads - index) * sizeof(m_pQuads[0]));
+
+    markQuadsDirty(newIndex, m_uTotalQuads - index);
 }
 
 void CCTextureAtlas::fillWithEmptyQuadsFromIndex(unsigned int index, unsigned int amount)
@@ -579,6 +662,37 @@ void CCTextureAtlas::fillWithEmptyQuadsFromIndex(unsigned int index, unsigned in
 
 // TextureAtlas - Drawing
 
+void CCTextureAtlas::uploadDirtyQuads(unsigned int usedQuads)
+{
+    // the quads after the quads in use are never drawn, and are marked again when they start being used
+    usedQuads = MIN(usedQuads, m_uCapacity);
+    unsigned int start = m_uDirtyStart;
+    unsigned int end = MIN(m_uDirtyEnd, usedQuads);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_pBuffersVBO[0]);
+
+    // Updating a part of a buffer still used by the GPU makes the driver wait for it.
+    // When all the quads are uploaded anyway, the old buffer is orphaned instead, and the driver allocates a new one.
+    if (m_eUploadMode == kCCTextureAtlasUploadStream || (start == 0 && end >= usedQuads))
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0]) * m_uCapacity, NULL, GL_DYNAMIC_DRAW);
+        start = 0;
+        end = usedQuads;
+    }
+
+    if (end > start)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0]) * start, sizeof(m_pQuads[0]) * (end - start), &m_pQuads[start]);
+
+        updateUploadCounters();
+        s_uUploadedBytes += sizeof(m_pQuads[0]) * (end - start);
+        s_uUploads++;
+    }
+
+    m_bDirty = false;
+    m_uDirtyStart = m_uDirtyEnd = 0;
+}
+
 void CCTextureAtlas::drawQuads()
 {
     this->drawNumberOfQuads(m_uTotalQuads, 0);
@@ -606,22 +720,8 @@ void CCTextureAtlas::drawNumberOfQuads(unsigned int n, unsigned int start)
     // XXX: update is done in draw... perhaps it should be done in a timer
     if (m_bDirty) 
     {
-        glBindBuffer(GL_ARRAY_BUFFER, m_pBuffersVBO[0]);
-        // option 1: subdata
-        //glBufferSubData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0])*start, sizeof(m_pQuads[0]) * n , &m_pQuads[start] );
-		
-		// option 2: data
-        //		glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * (n-start), &quads_[start], GL_DYNAMIC_DRAW);
-		
-		// option 3: orphaning + glMapBuffer
-		glBufferData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0]) * (n-start), NULL, GL_DYNAMIC_DRAW);
-		void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-		memcpy(buf, m_pQuads, sizeof(m_pQuads[0])* (n-start));
-		glUnmapBuffer(GL_ARRAY_BUFFER);
-		
+        uploadDirtyQuads(MAX(m_uTotalQuads, start + n));
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-        m_bDirty = false;
     }
 
     ccGLBindVAO(m_uVAOname);
@@ -654,8 +754,7 @@ void CCTextureAtlas::drawNumberOfQuads(unsigned int n, unsigned int start)
     // XXX: update is done in draw... perhaps it should be done in a timer
     if (m_bDirty) 
     {
-        glBufferSubData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0])*start, sizeof(m_pQuads[0]) * n , &m_pQuads[start] );
-        m_bDirty = false;
+        uploadDirtyQuads(MAX(m_uTotalQuads, start + n));
     }
 
     ccGLEnableVertexAttribs(kCCVertexAttribFlag_PosColorTex);
@@ -41,6 +41,20 @@ class CCTexture2D;
  * @{
  */
 
+/** @typedef tCCTextureAtlasUploadMode
+how the modified quads of a CCTextureAtlas are uploaded to its VBO
+@since v2.2.6
+*/
+typedef enum {
+    /** Only the range of quads modified since the last draw is uploaded. Best when few quads change at a time. */
+    kCCTextureAtlasUploadDirtyRange,
+
+    /** The VBO is orphaned and all the quads are uploaded, so that the GPU doesn't wait for the draws
+    still using the previous content. Best for atlases whose quads all change every frame, like particles.
+    */
+    kCCTextureAtlasUploadStream,
+} tCCTextureAtlasUploadMode;
+
 /** @brief A class that implements a Texture Atlas.
 Supported features:
 * The atlas file can be a PVRTC, PNG or any other format supported by Texture2D
@@ -62,6 +76,8 @@ protected:
 #endif
     GLuint              m_pBuffersVBO[2]; //0: vertex  1: indices
     bool                m_bDirty; //indicates whether or not the array buffer of the VBO needs to be updated
+    unsigned int        m_uDirtyStart; //first quad that needs to be updated
+    unsigned int        m_uDirtyEnd; //quad after the last quad that needs to be updated
 
 
     /** quantity of quads that are going to be drawn */
@@ -70,8 +86,14 @@ protected:
     CC_PROPERTY_READONLY(unsigned int, m_uCapacity, Capacity)
     /** Texture of the texture atlas */
     CC_PROPERTY(CCTexture2D *, m_pTexture, Texture)
-    /** Quads that are going to be rendered */
+    /** Quads that are going to be rendered.
+    Getting the quads marks all of them as modified. Use markQuadsDirty() after modifying only some of them through a pointer kept beforehand.
+    */
     CC_PROPERTY(ccV3F_C4B_T2F_Quad *, m_pQuads, Quads)
+    /** How the modified quads are uploaded. kCCTextureAtlasUploadDirtyRange by default
+    @since v2.2.6
+    */
+    CC_PROPERTY(tCCTextureAtlasUploadMode, m_eUploadMode, UploadMode)
 
 public:
     /**
@@ -214,12 +236,28 @@ public:
 
     /** whether or not the array buffer of the VBO needs to be updated*/
     inline bool isDirty(void) { return m_bDirty; }
-    /** specify if the array buffer of the VBO needs to be updated */
-    inline void setDirty(bool bDirty) { m_bDirty = bDirty; }
+    /** specify if the array buffer of the VBO needs to be updated. All the quads are updated */
+    void setDirty(bool bDirty);
+
+    /** marks an amount of quads from index as modified, so that only them are uploaded
+    @since v2.2.6
+    */
+    void markQuadsDirty(unsigned int index, unsigned int amount);
+
+    /** number of bytes of quads uploaded by all the texture atlases during the last frame
+    @since v2.2.6
+    */
+    static unsigned int getUploadedBytesInLastFrame();
+
+    /** number of uploads of quads by all the texture atlases during the last frame
+    @since v2.2.6
+    */
+    static unsigned int getUploadsInLastFrame();
 
 private:
     void setupIndices();
     void mapBuffers();
+    void uploadDirtyQuads(unsigned int usedQuads);
 #if CC_TEXTURE_ATLAS_USE_VAO
     void setupVBOandVAO();
 #else
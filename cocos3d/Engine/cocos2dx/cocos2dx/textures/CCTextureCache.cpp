@@ -42,6 +42,8 @@ THE SOFTWARE.
 #include <cctype>
 #include <queue>
 #include <list>
+#include <map>
+#include <vector>
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8)
 #include <pthread.h>
@@ -56,11 +58,18 @@ using namespace std;
 
 NS_CC_BEGIN
 
-typedef struct _AsyncStruct
+typedef struct _AsyncCallback
 {
-    std::string            filename;
     CCObject    *target;
     SEL_CallFuncO        selector;
+} AsyncCallback;
+
+typedef struct _AsyncStruct
+{
+    std::string            filename;
+    std::vector<AsyncCallback> callbacks;
+    int                    priority;
+    bool                   isCancelled;
 } AsyncStruct;
 
 typedef struct _ImageInfo
@@ -70,9 +79,8 @@ typedef struct _ImageInfo
     CCImage::EImageFormat imageType;
 } ImageInfo;
 
-static pthread_t s_loadingThread;
+static pthread_t s_loadingThreads[CC_TEXTURE_CACHE_MAX_ASYNC_WORKERS];
 
-static pthread_mutex_t		s_SleepMutex;
 static pthread_cond_t		s_SleepCondition;
 
 static pthread_mutex_t      s_asyncStructQueueMutex;
@@ -81,13 +89,22 @@ static pthread_mutex_t      s_ImageInfoMutex;
 #ifdef EMSCRIPTEN
 // Hack to get ASM.JS validation (no undefined symbols allowed).
 #define pthread_cond_signal(_)
+#define pthread_cond_broadcast(_)
 #endif // EMSCRIPTEN
 
 static unsigned long s_nAsyncRefCount = 0;
 
 static bool need_quit = false;
 
-static std::queue<AsyncStruct*>* s_pAsyncStructQueue = NULL;
+static unsigned int s_nAsyncWorkerCount = CC_TEXTURE_CACHE_DEFAULT_ASYNC_WORKERS;
+
+static unsigned int s_nLiveWorkers = 0;
+
+// Requests waiting to be decoded, ordered by descending priority, then by arrival.
+static std::list<AsyncStruct*>* s_pAsyncStructQueue = NULL;
+
+// Requests that are waiting or being decoded, by file name, so that repeated requests share one decode.
+static std::map<std::string, AsyncStruct*>* s_pPendingAsyncStructs = NULL;
 
 static std::queue<ImageInfo*>*   s_pImageQueue = NULL;
 
@@ -118,29 +135,41 @@ static CCImage::EImageFormat computeImageFormatType(string& filename)
     return ret;
 }
 
+// Inserts the request behind all waiting requests of the same or higher priority.
+// Must be invoked with s_asyncStructQueueMutex locked.
+static void enqueueAsyncStruct(AsyncStruct *pAsyncStruct)
+{
+    std::list<AsyncStruct*>::iterator it = s_pAsyncStructQueue->begin();
+    while (it != s_pAsyncStructQueue->end() && (*it)->priority >= pAsyncStruct->priority)
+    {
+        ++it;
+    }
+    s_pAsyncStructQueue->insert(it, pAsyncStruct);
+}
+
 static void loadImageData(AsyncStruct *pAsyncStruct)
 {
     const char *filename = pAsyncStruct->filename.c_str();
 
     // compute image type
     CCImage::EImageFormat imageType = computeImageFormatType(pAsyncStruct->filename);
+    CCImage *pImage = NULL;
     if (imageType == CCImage::kFmtUnKnown)
     {
         CCLOG("unsupported format %s",filename);
-        delete pAsyncStruct;
-        return;
     }
-        
-    // generate image            
-    CCImage *pImage = new CCImage();
-    if (pImage && !pImage->initWithImageFileThreadSafe(filename, imageType))
+    else
     {
-        CC_SAFE_RELEASE(pImage);
-        CCLOG("can not load %s", filename);
-        return;
+        // generate image
+        pImage = new CCImage();
+        if (pImage && !pImage->initWithImageFileThreadSafe(filename, imageType))
+        {
+            CC_SAFE_RELEASE_NULL(pImage);
+            CCLOG("can not load %s", filename);
+        }
     }
 
-    // generate image info
+    // generate image info, even on failure, so the main thread can release the request
     ImageInfo *pImageInfo = new ImageInfo();
     pImageInfo->asyncStruct = pAsyncStruct;
     pImageInfo->image = pImage;
@@ -157,42 +186,45 @@ static void* loadImage(void* data)
 
     while (true)
     {
-        // create autorelease pool for iOS
-        CCThread thread;
-        thread.createAutoreleasePool();
-
-        std::queue<AsyncStruct*> *pQueue = s_pAsyncStructQueue;
-        pthread_mutex_lock(&s_asyncStructQueueMutex);// get async struct from queue
-        if (pQueue->empty())
+        // get the highest priority request from the queue, skipping cancelled requests
+        pthread_mutex_lock(&s_asyncStructQueueMutex);
+        while (s_pAsyncStructQueue->empty() && !need_quit)
         {
-            pthread_mutex_unlock(&s_asyncStructQueueMutex);
-            if (need_quit) {
-                break;
-            }
-            else {
-                pthread_cond_wait(&s_SleepCondition, &s_SleepMutex);
-                continue;
-            }
+            pthread_cond_wait(&s_SleepCondition, &s_asyncStructQueueMutex);
         }
-        else
+        if (s_pAsyncStructQueue->empty())
         {
-            pAsyncStruct = pQueue->front();
-            pQueue->pop();
             pthread_mutex_unlock(&s_asyncStructQueueMutex);
-            loadImageData(pAsyncStruct);
-        }        
+            break;
+        }
+
+        pAsyncStruct = s_pAsyncStructQueue->front();
+        s_pAsyncStructQueue->pop_front();
+        pthread_mutex_unlock(&s_asyncStructQueueMutex);
+
+        // create autorelease pool for iOS, released with the objects of each decoded image
+        CCThread thread;
+        thread.createAutoreleasePool();
+
+        loadImageData(pAsyncStruct);
     }
-    
-    if( s_pAsyncStructQueue != NULL )
+
+    // the last worker to quit releases the shared queues
+    pthread_mutex_lock(&s_asyncStructQueueMutex);
+    bool isLastWorker = (--s_nLiveWorkers == 0);
+    pthread_mutex_unlock(&s_asyncStructQueueMutex);
+
+    if (isLastWorker && s_pAsyncStructQueue != NULL)
     {
         delete s_pAsyncStructQueue;
         s_pAsyncStructQueue = NULL;
+        delete s_pPendingAsyncStructs;
+        s_pPendingAsyncStructs = NULL;
         delete s_pImageQueue;
         s_pImageQueue = NULL;
 
         pthread_mutex_destroy(&s_asyncStructQueueMutex);
         pthread_mutex_destroy(&s_ImageInfoMutex);
-        pthread_mutex_destroy(&s_SleepMutex);
         pthread_cond_destroy(&s_SleepCondition);
     }
     
@@ -219,13 +251,19 @@ CCTextureCache::CCTextureCache()
     CCAssert(g_sharedTextureCache == NULL, "Attempted to allocate a second instance of a singleton.");
     
     m_pTextures = new CCDictionary();
+    m_fAsyncUploadTimeBudget = CC_TEXTURE_CACHE_DEFAULT_UPLOAD_BUDGET;
 }
 
 CCTextureCache::~CCTextureCache()
 {
     CCLOGINFO("cocos2d: deallocing CCTextureCache.");
-    need_quit = true;
-    pthread_cond_signal(&s_SleepCondition);
+    if (s_pAsyncStructQueue != NULL)
+    {
+        pthread_mutex_lock(&s_asyncStructQueueMutex);
+        need_quit = true;
+        pthread_mutex_unlock(&s_asyncStructQueueMutex);
+        pthread_cond_broadcast(&s_SleepCondition);
+    }
     CC_SAFE_RELEASE(m_pTextures);
 }
 
@@ -252,6 +290,11 @@ CCDictionary* CCTextureCache::snapshotTextures()
 }
 
 void CCTextureCache::addImageAsync(const char *path, CCObject *target, SEL_CallFuncO selector)
+{
+    addImageAsync(path, target, selector, 0);
+}
+
+void CCTextureCache::addImageAsync(const char *path, CCObject *target, SEL_CallFuncO selector, int priority)
 {
 #ifdef EMSCRIPTEN
     CCLOGWARN("Cannot load image %s asynchronously in Emscripten builds.", path);
@@ -287,44 +330,79 @@ void CCTextureCache::addImageAsync(const char *path, CCObject *target, SEL_CallF
     // lazy init
     if (s_pAsyncStructQueue == NULL)
     {             
-        s_pAsyncStructQueue = new queue<AsyncStruct*>();
+        s_pAsyncStructQueue = new list<AsyncStruct*>();
+        s_pPendingAsyncStructs = new map<std::string, AsyncStruct*>();
         s_pImageQueue = new queue<ImageInfo*>();        
         
         pthread_mutex_init(&s_asyncStructQueueMutex, NULL);
         pthread_mutex_init(&s_ImageInfoMutex, NULL);
-        pthread_mutex_init(&s_SleepMutex, NULL);
         pthread_cond_init(&s_SleepCondition, NULL);
+        need_quit = false;
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8)
-        pthread_create(&s_loadingThread, NULL, loadImage, NULL);
+        s_nLiveWorkers = s_nAsyncWorkerCount;
+        for (unsigned int i = 0; i < s_nAsyncWorkerCount; ++i)
+        {
+            pthread_create(&s_loadingThreads[i], NULL, loadImage, NULL);
+        }
 #endif
-        need_quit = false;
     }
 
-    if (0 == s_nAsyncRefCount)
+    if (target)
     {
-        CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(CCTextureCache::addImageAsyncCallBack), this, 0, false);
+        target->retain();
     }
 
-    ++s_nAsyncRefCount;
+    AsyncCallback callback;
+    callback.target = target;
+    callback.selector = selector;
 
-    if (target)
+    pthread_mutex_lock(&s_asyncStructQueueMutex);
+
+    // if the same file is already waiting or being decoded, share its result
+    std::map<std::string, AsyncStruct*>::iterator pending = s_pPendingAsyncStructs->find(fullpath);
+    if (pending != s_pPendingAsyncStructs->end())
     {
-        target->retain();
+        AsyncStruct *data = pending->second;
+        data->callbacks.push_back(callback);
+
+        // raise the priority of a request that is still waiting
+        if (priority > data->priority)
+        {
+            std::list<AsyncStruct*>::iterator it = s_pAsyncStructQueue->begin();
+            for (; it != s_pAsyncStructQueue->end() && *it != data; ++it);
+            data->priority = priority;
+            if (it != s_pAsyncStructQueue->end())
+            {
+                s_pAsyncStructQueue->erase(it);
+                enqueueAsyncStruct(data);
+            }
+        }
+        pthread_mutex_unlock(&s_asyncStructQueueMutex);
+        return;
     }
 
+    if (0 == s_nAsyncRefCount)
+    {
+        CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(CCTextureCache::addImageAsyncCallBack), this, 0, false);
+    }
+
+    ++s_nAsyncRefCount;
+
     // generate async struct
     AsyncStruct *data = new AsyncStruct();
     data->filename = fullpath.c_str();
-    data->target = target;
-    data->selector = selector;
+    data->callbacks.push_back(callback);
+    data->priority = priority;
+    data->isCancelled = false;
+    (*s_pPendingAsyncStructs)[fullpath] = data;
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8)
     // add async struct into queue
-    pthread_mutex_lock(&s_asyncStructQueueMutex);
-    s_pAsyncStructQueue->push(data);
+    enqueueAsyncStruct(data);
     pthread_mutex_unlock(&s_asyncStructQueueMutex);
     pthread_cond_signal(&s_SleepCondition);
 #else
+    pthread_mutex_unlock(&s_asyncStructQueueMutex);
     // WinRT uses an Async Task to load the image since the ThreadPool has a limited number of threads
     //std::replace( data->filename.begin(), data->filename.end(), '/', '\\'); 
     create_task([this, data] {
@@ -333,53 +411,153 @@ void CCTextureCache::addImageAsync(const char *path, CCObject *target, SEL_CallF
 #endif
 }
 
-void CCTextureCache::addImageAsyncCallBack(float dt)
+// Must be invoked with s_asyncStructQueueMutex locked.
+static void cancelAsyncStruct(AsyncStruct *pAsyncStruct)
 {
-    // the image is generated in loading thread
-    std::queue<ImageInfo*> *imagesQueue = s_pImageQueue;
+    pAsyncStruct->isCancelled = true;
+    s_pPendingAsyncStructs->erase(pAsyncStruct->filename);
 
-    pthread_mutex_lock(&s_ImageInfoMutex);
-    if (imagesQueue->empty())
+    // a request that is still waiting is simply handed to the main thread without being decoded
+    std::list<AsyncStruct*>::iterator it = s_pAsyncStructQueue->begin();
+    for (; it != s_pAsyncStructQueue->end() && *it != pAsyncStruct; ++it);
+    if (it != s_pAsyncStructQueue->end())
     {
+        s_pAsyncStructQueue->erase(it);
+
+        ImageInfo *pImageInfo = new ImageInfo();
+        pImageInfo->asyncStruct = pAsyncStruct;
+        pImageInfo->image = NULL;
+        pImageInfo->imageType = CCImage::kFmtUnKnown;
+        pthread_mutex_lock(&s_ImageInfoMutex);
+        s_pImageQueue->push(pImageInfo);
         pthread_mutex_unlock(&s_ImageInfoMutex);
     }
-    else
+}
+
+void CCTextureCache::cancelImageAsync(const char *path)
+{
+    if (s_pAsyncStructQueue == NULL || path == NULL)
+    {
+        return;
+    }
+
+    std::string fullpath = CCFileUtils::sharedFileUtils()->fullPathForFilename(path);
+
+    pthread_mutex_lock(&s_asyncStructQueueMutex);
+    std::map<std::string, AsyncStruct*>::iterator pending = s_pPendingAsyncStructs->find(fullpath);
+    if (pending != s_pPendingAsyncStructs->end())
+    {
+        cancelAsyncStruct(pending->second);
+    }
+    pthread_mutex_unlock(&s_asyncStructQueueMutex);
+}
+
+void CCTextureCache::cancelAllImageAsync()
+{
+    if (s_pAsyncStructQueue == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&s_asyncStructQueueMutex);
+    while (!s_pPendingAsyncStructs->empty())
+    {
+        cancelAsyncStruct(s_pPendingAsyncStructs->begin()->second);
+    }
+    pthread_mutex_unlock(&s_asyncStructQueueMutex);
+}
+
+void CCTextureCache::setAsyncWorkerCount(unsigned int count)
+{
+    CCAssert(s_pAsyncStructQueue == NULL, "TextureCache: the worker count must be set before the first asynchronous load");
+    s_nAsyncWorkerCount = MAX(1, MIN(count, CC_TEXTURE_CACHE_MAX_ASYNC_WORKERS));
+}
+
+unsigned int CCTextureCache::getAsyncWorkerCount()
+{
+    return s_nAsyncWorkerCount;
+}
+
+void CCTextureCache::setAsyncUploadTimeBudget(float seconds)
+{
+    m_fAsyncUploadTimeBudget = seconds;
+}
+
+float CCTextureCache::getAsyncUploadTimeBudget()
+{
+    return m_fAsyncUploadTimeBudget;
+}
+
+void CCTextureCache::addImageAsyncCallBack(float dt)
+{
+    // the images are generated in loading threads. Upload as many as fit in the time budget,
+    // but always at least one, so that loading progresses however small the budget.
+    std::queue<ImageInfo*> *imagesQueue = s_pImageQueue;
+
+    struct cc_timeval start;
+    CCTime::gettimeofdayCocos2d(&start, NULL);
+
+    while (true)
     {
+        pthread_mutex_lock(&s_ImageInfoMutex);
+        if (imagesQueue->empty())
+        {
+            pthread_mutex_unlock(&s_ImageInfoMutex);
+            break;
+        }
+
         ImageInfo *pImageInfo = imagesQueue->front();
         imagesQueue->pop();
         pthread_mutex_unlock(&s_ImageInfoMutex);
 
         AsyncStruct *pAsyncStruct = pImageInfo->asyncStruct;
         CCImage *pImage = pImageInfo->image;
-
-        CCObject *target = pAsyncStruct->target;
-        SEL_CallFuncO selector = pAsyncStruct->selector;
         const char* filename = pAsyncStruct->filename.c_str();
 
-        // generate texture in render thread
-        CCTexture2D *texture = new CCTexture2D();
+        // take the callbacks, which may still be added to until the request leaves the pending map
+        pthread_mutex_lock(&s_asyncStructQueueMutex);
+        bool isCancelled = pAsyncStruct->isCancelled;
+        if (!isCancelled)
+        {
+            s_pPendingAsyncStructs->erase(pAsyncStruct->filename);
+        }
+        std::vector<AsyncCallback> callbacks = pAsyncStruct->callbacks;
+        pthread_mutex_unlock(&s_asyncStructQueueMutex);
+
+        if (pImage && !isCancelled)
+        {
+            // generate texture in render thread
+            CCTexture2D *texture = new CCTexture2D();
 #if 0 //TODO: (CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
-        texture->initWithImage(pImage, kCCResolutioniPhone);
+            texture->initWithImage(pImage, kCCResolutioniPhone);
 #else
-        texture->initWithImage(pImage);
+            texture->initWithImage(pImage);
 #endif
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
-       // cache the texture file name
-       VolatileTexture::addImageTexture(texture, filename, pImageInfo->imageType);
+            // cache the texture file name
+            VolatileTexture::addImageTexture(texture, filename, pImageInfo->imageType);
 #endif
 
-        // cache the texture
-        m_pTextures->setObject(texture, filename);
-        texture->autorelease();
+            // cache the texture
+            m_pTextures->setObject(texture, filename);
+            texture->autorelease();
 
-        if (target && selector)
+            for (unsigned int i = 0; i < callbacks.size(); ++i)
+            {
+                if (callbacks[i].target && callbacks[i].selector)
+                {
+                    (callbacks[i].target->*callbacks[i].selector)(texture);
+                }
+            }
+        }
+
+        for (unsigned int i = 0; i < callbacks.size(); ++i)
         {
-            (target->*selector)(texture);
-            target->release();
-        }        
+            CC_SAFE_RELEASE(callbacks[i].target);
+        }
 
-        pImage->release();
+        CC_SAFE_RELEASE(pImage);
         delete pAsyncStruct;
         delete pImageInfo;
 
@@ -387,6 +565,14 @@ void CCTextureCache::addImageAsyncCallBack(float dt)
         if (0 == s_nAsyncRefCount)
         {
             CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(CCTextureCache::addImageAsyncCallBack), this);
+            break;
+        }
+
+        struct cc_timeval now;
+        CCTime::gettimeofdayCocos2d(&now, NULL);
+        if (CCTime::timersubCocos2d(&start, &now) >= m_fAsyncUploadTimeBudget * 1000.0f)
+        {
+            break;
         }
     }
 }
@@ -39,6 +39,17 @@ THE SOFTWARE.
     #include <list>
 #endif
 
+/** The maximum number of threads that decode images for CCTextureCache::addImageAsync. */
+#define CC_TEXTURE_CACHE_MAX_ASYNC_WORKERS 8
+
+/** The number of decoding threads used unless CCTextureCache::setAsyncWorkerCount is invoked. */
+#ifndef CC_TEXTURE_CACHE_DEFAULT_ASYNC_WORKERS
+#define CC_TEXTURE_CACHE_DEFAULT_ASYNC_WORKERS 2
+#endif
+
+/** The default number of seconds per frame spent uploading asynchronously loaded textures. */
+#define CC_TEXTURE_CACHE_DEFAULT_UPLOAD_BUDGET (1.0f / 240.0f)
+
 NS_CC_BEGIN
 
 class CCLock;
@@ -57,6 +68,7 @@ class CC_DLL CCTextureCache : public CCObject
 {
 protected:
     CCDictionary* m_pTextures;
+    float m_fAsyncUploadTimeBudget;
     //pthread_mutex_t                *m_pDictLock;
 
 
@@ -113,6 +125,44 @@ public:
     
     void addImageAsync(const char *path, CCObject *target, SEL_CallFuncO selector);
 
+    /* Same as addImageAsync(path, target, selector), but requests with a higher priority are decoded first.
+    * If the same file is already being loaded, it is decoded only once, the callback is added to the
+    * pending request, and the priority of that request is raised if needed.
+    * @since v2.2.6
+    * @lua NA
+    */
+    void addImageAsync(const char *path, CCObject *target, SEL_CallFuncO selector, int priority);
+
+    /** Cancels the asynchronous load of the specified file. The callbacks of the request are not invoked,
+    * and their targets are released. An image that is already being decoded is discarded once decoded.
+    * @since v2.2.6
+    * @lua NA
+    */
+    void cancelImageAsync(const char *path);
+
+    /** Cancels all pending asynchronous loads.
+    * @since v2.2.6
+    * @lua NA
+    */
+    void cancelAllImageAsync();
+
+    /** The number of seconds per frame spent uploading asynchronously decoded images to textures.
+    * At least one texture is uploaded each frame, however small the budget.
+    * Default value is CC_TEXTURE_CACHE_DEFAULT_UPLOAD_BUDGET.
+    * @since v2.2.6
+    * @lua NA
+    */
+    void setAsyncUploadTimeBudget(float seconds);
+    float getAsyncUploadTimeBudget();
+
+    /** The number of threads decoding images for addImageAsync, between 1 and CC_TEXTURE_CACHE_MAX_ASYNC_WORKERS.
+    * Must be set before the first asynchronous load. Default value is CC_TEXTURE_CACHE_DEFAULT_ASYNC_WORKERS.
+    * @since v2.2.6
+    * @lua NA
+    */
+    static void setAsyncWorkerCount(unsigned int count);
+    static unsigned int getAsyncWorkerCount();
+
     /* Returns a Texture2D object given an CGImageRef image
     * If the image was not previously loaded, it will create a new CCTexture2D object and it will return it.
     * Otherwise it will return a reference of a previously loaded image
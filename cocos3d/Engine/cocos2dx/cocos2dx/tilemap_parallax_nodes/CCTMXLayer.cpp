@@ -33,9 +33,15 @@ THE SOFTWARE.
 #include "support/CCPointExtension.h"
 #include "support/data_support/ccCArray.h"
 #include "CCDirector.h"
+#include <algorithm>
 
 NS_CC_BEGIN
 
+static unsigned int s_uDefaultChunkSize = 0;
+
+// the quads of an atlas are indexed with unsigned shorts
+#define CC_TMX_MAX_CHUNKED_QUADS    (65536 / 4)
+
 
 // CCTMXLayer - init & alloc & dealloc
 
@@ -56,6 +62,22 @@ bool CCTMXLayer::initWithTilesetInfo(CCTMXTilesetInfo *tilesetInfo, CCTMXLayerIn
     float totalNumberOfTiles = size.width * size.height;
     float capacity = totalNumberOfTiles * 0.35f + 1; // 35 percent is occupied ?
 
+    // chunked layers start with a single chunk slot, and add slots as more chunks become visible
+    unsigned int chunkSize = s_uDefaultChunkSize;
+    CCString *chunkSizeVal = (CCString*)layerInfo->getProperties()->objectForKey("cc_chunk_size");
+    if (chunkSizeVal)
+    {
+        chunkSize = (unsigned int)MAX(chunkSizeVal->intValue(), 0);
+    }
+    if (chunkSize > 0 && (size.width > chunkSize || size.height > chunkSize))
+    {
+        capacity = (float)(chunkSize * chunkSize);
+    }
+    else
+    {
+        chunkSize = 0;
+    }
+
     CCTexture2D *texture = NULL;
     if( tilesetInfo )
     {
@@ -86,7 +108,11 @@ bool CCTMXLayer::initWithTilesetInfo(CCTMXTilesetInfo *tilesetInfo, CCTMXLayerIn
         CCPoint offset = this->calculateLayerOffset(layerInfo->m_tOffset);
         this->setPosition(CC_POINT_PIXELS_TO_POINTS(offset));
 
-        m_pAtlasIndexArray = ccCArrayNew((unsigned int)totalNumberOfTiles);
+        m_uChunkSize = chunkSize;
+        if (! m_uChunkSize)
+        {
+            m_pAtlasIndexArray = ccCArrayNew((unsigned int)totalNumberOfTiles);
+        }
 
         this->setContentSize(CC_SIZE_PIXELS_TO_POINTS(CCSizeMake(m_tLayerSize.width * m_tMapTileSize.width, m_tLayerSize.height * m_tMapTileSize.height)));
 
@@ -107,6 +133,11 @@ CCTMXLayer::CCTMXLayer()
 ,m_sLayerName("")
 ,m_pReusedTile(NULL)
 ,m_pAtlasIndexArray(NULL)    
+,m_uChunkSize(0)
+,m_uChunkMargin(2)
+,m_uChunkColumns(0)
+,m_uChunkRows(0)
+,m_uChunkFrame(0)
 {}
 
 CCTMXLayer::~CCTMXLayer()
@@ -136,8 +167,25 @@ void CCTMXLayer::setTileSet(CCTMXTilesetInfo* var)
     m_pTileSet = var;
 }
 
+void CCTMXLayer::setDefaultChunkSize(unsigned int chunkSize)
+{
+    s_uDefaultChunkSize = chunkSize;
+}
+
+unsigned int CCTMXLayer::getDefaultChunkSize()
+{
+    return s_uDefaultChunkSize;
+}
+
 void CCTMXLayer::releaseMap()
 {
+    // chunks are built from the map whenever they become visible
+    if (m_uChunkSize)
+    {
+        CCLOG("cocos2d: CCTMXLayer: the map of the chunked layer %s can't be released", m_sLayerName.c_str());
+        return;
+    }
+
     if (m_pTiles)
     {
         delete [] m_pTiles;
@@ -185,7 +233,11 @@ void CCTMXLayer::setupTiles()
             // XXX: gid == 0 --> empty tile
             if (gid != 0) 
             {
-                this->appendTileForGID(gid, ccp(x, y));
+                // chunked layers build their quads when they are drawn
+                if (! m_uChunkSize)
+                {
+                    this->appendTileForGID(gid, ccp(x, y));
+                }
 
                 // Optimization: update min and max GID rendered by the layer
                 m_uMinGID = MIN(gid, m_uMinGID);
@@ -196,6 +248,16 @@ void CCTMXLayer::setupTiles()
 
     CCAssert( m_uMaxGID >= m_pTileSet->m_uFirstGid &&
         m_uMinGID >= m_pTileSet->m_uFirstGid, "TMX: Only 1 tileset per layer is supported");    
+
+    if (m_uChunkSize)
+    {
+        m_uChunkColumns = ((unsigned int)m_tLayerSize.width + m_uChunkSize - 1) / m_uChunkSize;
+        m_uChunkRows = ((unsigned int)m_tLayerSize.height + m_uChunkSize - 1) / m_uChunkSize;
+        m_slotForChunk.assign(m_uChunkColumns * m_uChunkRows, -1);
+        m_chunkForSlot.clear();
+        m_slotTileCount.clear();
+        m_slotFrame.clear();
+    }
 }
 
 // CCTMXLayer - Properties
@@ -320,7 +382,7 @@ CCSprite* CCTMXLayer::reusedTileWithRect(CCRect rect)
 CCSprite * CCTMXLayer::tileAt(const CCPoint& pos)
 {
     CCAssert(pos.x < m_tLayerSize.width && pos.y < m_tLayerSize.height && pos.x >=0 && pos.y >=0, "TMXLayer: invalid position");
-    CCAssert(m_pTiles && m_pAtlasIndexArray, "TMXLayer: the tiles map has been released");
+    CCAssert(m_pTiles && (m_pAtlasIndexArray || m_uChunkSize), "TMXLayer: the tiles map has been released");
 
     CCSprite *tile = NULL;
     unsigned int gid = this->tileGIDAt(pos);
@@ -345,8 +407,23 @@ CCSprite * CCTMXLayer::tileAt(const CCPoint& pos)
             tile->setAnchorPoint(CCPointZero);
             tile->setOpacity(m_cOpacity);
 
-            unsigned int indexForZ = atlasIndexForExistantZ(z);
-            this->addSpriteWithoutQuad(tile, indexForZ, z);
+            if (m_uChunkSize)
+            {
+                // the chunk of the tile stays loaded as long as the tile exists
+                unsigned int indexForZ = atlasIndexForChunkedPos(pos, true);
+                if (indexForZ == UINT_MAX)
+                {
+                    tile->release();
+                    return NULL;
+                }
+                m_slotTileCount[indexForZ / (m_uChunkSize * m_uChunkSize)]++;
+                this->addSpriteWithoutQuad(tile, indexForZ, z);
+            }
+            else
+            {
+                unsigned int indexForZ = atlasIndexForExistantZ(z);
+                this->addSpriteWithoutQuad(tile, indexForZ, z);
+            }
             tile->release();
         }
     }
@@ -362,7 +439,7 @@ unsigned int CCTMXLayer::tileGIDAt(const CCPoint& pos)
 unsigned int CCTMXLayer::tileGIDAt(const CCPoint& pos, ccTMXTileFlags* flags)
 {
     CCAssert(pos.x < m_tLayerSize.width && pos.y < m_tLayerSize.height && pos.x >=0 && pos.y >=0, "TMXLayer: invalid position");
-    CCAssert(m_pTiles && m_pAtlasIndexArray, "TMXLayer: the tiles map has been released");
+    CCAssert(m_pTiles && (m_pAtlasIndexArray || m_uChunkSize), "TMXLayer: the tiles map has been released");
 
     int idx = (int)(pos.x + pos.y * m_tLayerSize.width);
     // Bits on the far end of the 32-bit global tile ID are used for tile flags
@@ -505,7 +582,7 @@ void CCTMXLayer::setTileGID(unsigned int gid, const CCPoint& pos)
 void CCTMXLayer::setTileGID(unsigned int gid, const CCPoint& pos, ccTMXTileFlags flags)
 {
     CCAssert(pos.x < m_tLayerSize.width && pos.y < m_tLayerSize.height && pos.x >=0 && pos.y >=0, "TMXLayer: invalid position");
-    CCAssert(m_pTiles && m_pAtlasIndexArray, "TMXLayer: the tiles map has been released");
+    CCAssert(m_pTiles && (m_pAtlasIndexArray || m_uChunkSize), "TMXLayer: the tiles map has been released");
     CCAssert(gid == 0 || gid >= m_pTileSet->m_uFirstGid, "TMXLayer: invalid gid" );
 
     ccTMXTileFlags currentFlags;
@@ -521,7 +598,7 @@ void CCTMXLayer::setTileGID(unsigned int gid, const CCPoint& pos, ccTMXTileFlags
             removeTileAt(pos);
         }
         // empty tile. create a new one
-        else if (currentGID == 0)
+        else if (currentGID == 0 && ! m_uChunkSize)
         {
             insertTileForGID(gidAndFlags, pos);
         }
@@ -542,6 +619,16 @@ void CCTMXLayer::setTileGID(unsigned int gid, const CCPoint& pos, ccTMXTileFlags
                 }
                 m_pTiles[z] = gidAndFlags;
             } 
+            else if (m_uChunkSize)
+            {
+                // the quad is built when the chunk is loaded if it isn't yet
+                m_pTiles[z] = gidAndFlags;
+                unsigned int atlasIndex = atlasIndexForChunkedPos(pos, false);
+                if (atlasIndex != UINT_MAX)
+                {
+                    updateTileQuadForGID(gidAndFlags, pos, atlasIndex);
+                }
+            }
             else 
             {
                 updateTileForGID(gidAndFlags, pos);
@@ -567,6 +654,21 @@ void CCTMXLayer::removeChild(CCNode* node, bool cleanup)
 
     CCAssert(m_pChildren->containsObject(sprite), "Tile does not belong to TMXLayer");
 
+    // the quads of a chunk keep their place in the atlas
+    if (m_uChunkSize)
+    {
+        unsigned int atlasIndex = sprite->getAtlasIndex();
+        m_pTiles[sprite->getTag()] = 0;
+        m_slotTileCount[atlasIndex / (m_uChunkSize * m_uChunkSize)]--;
+        m_pobTextureAtlas->fillWithEmptyQuadsFromIndex(atlasIndex, 1);
+        m_pobTextureAtlas->markQuadsDirty(atlasIndex, 1);
+
+        sprite->setBatchNode(NULL);
+        m_pobDescendants->removeObject(sprite);
+        CCNode::removeChild(sprite, cleanup);
+        return;
+    }
+
     unsigned int atlasIndex = sprite->getAtlasIndex();
     unsigned int zz = (size_t)m_pAtlasIndexArray->arr[atlasIndex];
     m_pTiles[zz] = 0;
@@ -576,11 +678,30 @@ void CCTMXLayer::removeChild(CCNode* node, bool cleanup)
 void CCTMXLayer::removeTileAt(const CCPoint& pos)
 {
     CCAssert(pos.x < m_tLayerSize.width && pos.y < m_tLayerSize.height && pos.x >=0 && pos.y >=0, "TMXLayer: invalid position");
-    CCAssert(m_pTiles && m_pAtlasIndexArray, "TMXLayer: the tiles map has been released");
+    CCAssert(m_pTiles && (m_pAtlasIndexArray || m_uChunkSize), "TMXLayer: the tiles map has been released");
 
     unsigned int gid = tileGIDAt(pos);
 
-    if (gid) 
+    if (gid && m_uChunkSize)
+    {
+        unsigned int z = (unsigned int)(pos.x + pos.y * m_tLayerSize.width);
+        CCSprite *sprite = (CCSprite*)getChildByTag(z);
+        if (sprite)
+        {
+            removeChild(sprite, true);
+        }
+        else
+        {
+            m_pTiles[z] = 0;
+            unsigned int atlasIndex = atlasIndexForChunkedPos(pos, false);
+            if (atlasIndex != UINT_MAX)
+            {
+                m_pobTextureAtlas->fillWithEmptyQuadsFromIndex(atlasIndex, 1);
+                m_pobTextureAtlas->markQuadsDirty(atlasIndex, 1);
+            }
+        }
+    }
+    else if (gid) 
     {
         unsigned int z = (unsigned int)(pos.x + pos.y * m_tLayerSize.width);
         unsigned int atlasIndex = atlasIndexForExistantZ(z);
@@ -622,6 +743,285 @@ void CCTMXLayer::removeTileAt(const CCPoint& pos)
     }
 }
 
+// CCTMXLayer - chunks
+void CCTMXLayer::draw()
+{
+    if (m_uChunkSize)
+    {
+        updateVisibleChunks();
+    }
+
+    CCSpriteBatchNode::draw();
+}
+
+void CCTMXLayer::updateTileQuadForGID(unsigned int gid, const CCPoint& pos, unsigned int atlasIndex)
+{
+    CCRect rect = m_pTileSet->rectForGID(gid);
+    rect = CC_RECT_PIXELS_TO_POINTS(rect);
+
+    CCSprite *tile = reusedTileWithRect(rect);
+
+    setupTileSprite(tile, pos, gid);
+
+    tile->setAtlasIndex(atlasIndex);
+    tile->setDirty(true);
+    tile->updateTransform();
+}
+
+unsigned int CCTMXLayer::atlasIndexForChunkedPos(const CCPoint& pos, bool load)
+{
+    unsigned int x = (unsigned int)pos.x;
+    unsigned int y = (unsigned int)pos.y;
+    unsigned int chunk = (y / m_uChunkSize) * m_uChunkColumns + x / m_uChunkSize;
+
+    if (m_slotForChunk[chunk] < 0)
+    {
+        if (! load)
+        {
+            return UINT_MAX;
+        }
+
+        unsigned int slot = reusableChunkSlot();
+        if (slot == UINT_MAX)
+        {
+            return UINT_MAX;
+        }
+        loadChunk(chunk, slot);
+        sortChunkSlots();
+    }
+
+    unsigned int slot = (unsigned int)m_slotForChunk[chunk];
+    return (slot * m_uChunkSize + y % m_uChunkSize) * m_uChunkSize + x % m_uChunkSize;
+}
+
+bool CCTMXLayer::visibleTileRange(int& x0, int& y0, int& x1, int& y1)
+{
+    CCDirector *pDirector = CCDirector::sharedDirector();
+    CCPoint origin = pDirector->getVisibleOrigin();
+    CCSize size = pDirector->getVisibleSize();
+    CCPoint corners[4] = {
+        origin,
+        ccp(origin.x + size.width, origin.y),
+        ccp(origin.x, origin.y + size.height),
+        ccp(origin.x + size.width, origin.y + size.height)
+    };
+
+    // the positions of the tiles are linear in their coordinates, so the tiles
+    // covering the screen lie between the tiles of its corners
+    CCAffineTransform t = worldToNodeTransform();
+    float minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        CCPoint pixels = CC_POINT_POINTS_TO_PIXELS(CCPointApplyAffineTransform(corners[i], t));
+        float tx = 0, ty = 0;
+        switch (m_uLayerOrientation)
+        {
+        case CCTMXOrientationIso:
+            {
+                float a = pixels.x / (m_tMapTileSize.width / 2) - m_tLayerSize.width + 1;
+                float b = 2 * m_tLayerSize.height - 2 - pixels.y / (m_tMapTileSize.height / 2);
+                tx = (a + b) / 2;
+                ty = (b - a) / 2;
+            }
+            break;
+        case CCTMXOrientationHex:
+            tx = pixels.x / (m_tMapTileSize.width * 3 / 4);
+            ty = m_tLayerSize.height - pixels.y / m_tMapTileSize.height;
+            break;
+        default:
+            tx = pixels.x / m_tMapTileSize.width;
+            ty = m_tLayerSize.height - pixels.y / m_tMapTileSize.height;
+            break;
+        }
+        minX = (i == 0) ? tx : MIN(minX, tx);
+        maxX = (i == 0) ? tx : MAX(maxX, tx);
+        minY = (i == 0) ? ty : MIN(minY, ty);
+        maxY = (i == 0) ? ty : MAX(maxY, ty);
+    }
+
+    x0 = MAX((int)floorf(minX) - (int)m_uChunkMargin, 0);
+    y0 = MAX((int)floorf(minY) - (int)m_uChunkMargin, 0);
+    x1 = MIN((int)ceilf(maxX) + (int)m_uChunkMargin, (int)m_tLayerSize.width - 1);
+    y1 = MIN((int)ceilf(maxY) + (int)m_uChunkMargin, (int)m_tLayerSize.height - 1);
+    return x0 <= x1 && y0 <= y1;
+}
+
+void CCTMXLayer::updateVisibleChunks()
+{
+    int x0, y0, x1, y1;
+    ++m_uChunkFrame;
+    if (! visibleTileRange(x0, y0, x1, y1))
+    {
+        return;
+    }
+
+    unsigned int cx0 = x0 / m_uChunkSize, cx1 = x1 / m_uChunkSize;
+    unsigned int cy0 = y0 / m_uChunkSize, cy1 = y1 / m_uChunkSize;
+
+    // keep the visible chunks that are already loaded before recycling any slot
+    for (unsigned int cy = cy0; cy <= cy1; cy++)
+    {
+        for (unsigned int cx = cx0; cx <= cx1; cx++)
+        {
+            int slot = m_slotForChunk[cy * m_uChunkColumns + cx];
+            if (slot >= 0)
+            {
+                m_slotFrame[slot] = m_uChunkFrame;
+            }
+        }
+    }
+
+    bool loaded = false;
+    bool full = false;
+    for (unsigned int cy = cy0; cy <= cy1 && ! full; cy++)
+    {
+        for (unsigned int cx = cx0; cx <= cx1 && ! full; cx++)
+        {
+            unsigned int chunk = cy * m_uChunkColumns + cx;
+            if (m_slotForChunk[chunk] < 0)
+            {
+                unsigned int slot = reusableChunkSlot();
+                if (slot == UINT_MAX)
+                {
+                    // the chunks that don't fit in the atlas aren't drawn
+                    full = true;
+                    continue;
+                }
+                loadChunk(chunk, slot);
+                m_slotFrame[slot] = m_uChunkFrame;
+                loaded = true;
+            }
+        }
+    }
+
+    if (loaded)
+    {
+        sortChunkSlots();
+    }
+}
+
+unsigned int CCTMXLayer::reusableChunkSlot()
+{
+    // recycle the slot of a chunk that isn't visible anymore, and doesn't hold any tile (CCSprite)
+    unsigned int count = (unsigned int)m_chunkForSlot.size();
+    for (unsigned int slot = 0; slot < count; slot++)
+    {
+        if (m_chunkForSlot[slot] < 0 || (m_slotFrame[slot] != m_uChunkFrame && m_slotTileCount[slot] == 0))
+        {
+            return slot;
+        }
+    }
+
+    // add a slot at the end of the atlas
+    unsigned int quadsPerChunk = m_uChunkSize * m_uChunkSize;
+    unsigned int quantity = (count + 1) * quadsPerChunk;
+    CCAssert(quantity <= CC_TMX_MAX_CHUNKED_QUADS, "TMXLayer: too many visible chunks, use smaller chunks");
+    // the quads are drawn with unsigned short indices, which can't address more vertices
+    if (quantity > CC_TMX_MAX_CHUNKED_QUADS)
+    {
+        CCLOG("cocos2d: CCTMXLayer: too many visible chunks in the layer %s, use smaller chunks", m_sLayerName.c_str());
+        return UINT_MAX;
+    }
+    if (quantity > m_pobTextureAtlas->getCapacity())
+    {
+        m_pobTextureAtlas->resizeCapacity(quantity);
+    }
+    m_pobTextureAtlas->increaseTotalQuadsWith(quadsPerChunk);
+
+    m_chunkForSlot.push_back(-1);
+    m_slotTileCount.push_back(0);
+    m_slotFrame.push_back(0);
+    return count;
+}
+
+void CCTMXLayer::loadChunk(unsigned int chunk, unsigned int slot)
+{
+    int previous = m_chunkForSlot[slot];
+    if (previous >= 0)
+    {
+        m_slotForChunk[previous] = -1;
+    }
+    m_chunkForSlot[slot] = chunk;
+    m_slotForChunk[chunk] = slot;
+
+    unsigned int firstIndex = slot * m_uChunkSize * m_uChunkSize;
+    m_pobTextureAtlas->fillWithEmptyQuadsFromIndex(firstIndex, m_uChunkSize * m_uChunkSize);
+
+    unsigned int x0 = (chunk % m_uChunkColumns) * m_uChunkSize;
+    unsigned int y0 = (chunk / m_uChunkColumns) * m_uChunkSize;
+    unsigned int x1 = MIN(x0 + m_uChunkSize, (unsigned int)m_tLayerSize.width);
+    unsigned int y1 = MIN(y0 + m_uChunkSize, (unsigned int)m_tLayerSize.height);
+    for (unsigned int y = y0; y < y1; y++)
+    {
+        for (unsigned int x = x0; x < x1; x++)
+        {
+            unsigned int gid = m_pTiles[(unsigned int)(x + m_tLayerSize.width * y)];
+            if (gid != 0)
+            {
+                updateTileQuadForGID(gid, ccp(x, y), firstIndex + (y - y0) * m_uChunkSize + (x - x0));
+            }
+        }
+    }
+
+    m_pobTextureAtlas->markQuadsDirty(firstIndex, m_uChunkSize * m_uChunkSize);
+}
+
+void CCTMXLayer::sortChunkSlots()
+{
+    // the slots are kept in map order, so that the tiles are drawn in the same order as if the layer wasn't chunked
+    unsigned int count = (unsigned int)m_chunkForSlot.size();
+    std::vector< std::pair<unsigned int, unsigned int> > order(count);
+    bool sorted = true;
+    for (unsigned int slot = 0; slot < count; slot++)
+    {
+        // free slots go last
+        order[slot] = std::make_pair((unsigned int)m_chunkForSlot[slot], slot);
+        sorted = sorted && (slot == 0 || order[slot - 1].first < order[slot].first);
+    }
+    if (sorted)
+    {
+        return;
+    }
+    std::sort(order.begin(), order.end());
+
+    unsigned int quadsPerChunk = m_uChunkSize * m_uChunkSize;
+    ccV3F_C4B_T2F_Quad *quads = m_pobTextureAtlas->getQuads();
+    std::vector<ccV3F_C4B_T2F_Quad> previousQuads(quads, quads + count * quadsPerChunk);
+    std::vector<int> previousChunkForSlot(m_chunkForSlot);
+    std::vector<unsigned int> previousTileCount(m_slotTileCount);
+    std::vector<unsigned int> previousFrame(m_slotFrame);
+    std::vector<unsigned int> newSlots(count);
+
+    for (unsigned int slot = 0; slot < count; slot++)
+    {
+        unsigned int previousSlot = order[slot].second;
+        newSlots[previousSlot] = slot;
+        memcpy(quads + slot * quadsPerChunk, &previousQuads[previousSlot * quadsPerChunk], quadsPerChunk * sizeof(ccV3F_C4B_T2F_Quad));
+
+        m_chunkForSlot[slot] = previousChunkForSlot[previousSlot];
+        m_slotTileCount[slot] = previousTileCount[previousSlot];
+        m_slotFrame[slot] = previousFrame[previousSlot];
+        if (m_chunkForSlot[slot] >= 0)
+        {
+            m_slotForChunk[m_chunkForSlot[slot]] = slot;
+        }
+    }
+
+    // the tiles (CCSprite) follow their quads
+    if (m_pChildren && m_pChildren->count() > 0)
+    {
+        CCObject* pObject = NULL;
+        CCARRAY_FOREACH(m_pChildren, pObject)
+        {
+            CCSprite* pChild = (CCSprite*) pObject;
+            unsigned int ai = pChild->getAtlasIndex();
+            pChild->setAtlasIndex(newSlots[ai / quadsPerChunk] * quadsPerChunk + ai % quadsPerChunk);
+        }
+    }
+
+    m_pobTextureAtlas->setDirty(true);
+}
+
 //CCTMXLayer - obtaining positions, offset
 CCPoint CCTMXLayer::calculateLayerOffset(const CCPoint& pos)
 {
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "base_nodes/CCAtlasNode.h"
 #include "sprite_nodes/CCSpriteBatchNode.h"
 #include "CCTMXXMLParser.h"
+#include <vector>
 NS_CC_BEGIN
 
 class CCTMXMapInfo;
@@ -69,6 +70,17 @@ http://www.cocos2d-iphone.org/wiki/doku.php/prog_guide:tiled_maps
 Tiles can have tile flags for additional properties. At the moment only flip horizontal and flip vertical are used. These bit flags are defined in CCTMXXMLParser.h.
 
 @since 1.1
+
+Large layers can be split into square chunks of tiles, either for all the layers with setDefaultChunkSize(),
+or for a single layer with the "cc_chunk_size" property. The quads of a chunked layer are only built for the
+chunks that intersect the visible area of the screen, plus a margin of a few tiles, when the layer is drawn.
+The atlas holds a fixed number of chunk slots, and the slots of the chunks that scrolled out of view are
+recycled for the chunks that scroll into view, so the memory used by the layer depends on the size of the
+screen rather than on the size of the map. The tiles returned by tileAt() keep their chunk loaded.
+The atlas can't hold more than 16384 quads: the chunks that don't fit aren't drawn, and tileAt() returns NULL
+for their tiles.
+
+@since v2.2.6
 */
 
 class CC_DLL CCTMXLayer : public CCSpriteBatchNode
@@ -166,6 +178,24 @@ public:
     /** Creates the tiles */
     void setupTiles();
 
+    /** Chunked layers build the quads of their visible chunks before drawing them */
+    virtual void draw(void);
+
+    /** size of the chunks of the layer, in tiles. 0 if the layer is not chunked */
+    inline unsigned int getChunkSize() const { return m_uChunkSize; }
+
+    /** number of tiles around the visible area of the screen whose chunks are loaded ahead of time. 2 by default */
+    inline unsigned int getChunkMargin() const { return m_uChunkMargin; }
+    inline void setChunkMargin(unsigned int margin) { m_uChunkMargin = margin; }
+
+    /** size of the chunks of the layers created afterwards, in tiles. The "cc_chunk_size" property of a layer
+     overrides it. 0, the default, disables chunks. A size of 16 or 32 suits most maps.
+     @js NA
+     @lua NA
+     */
+    static void setDefaultChunkSize(unsigned int chunkSize);
+    static unsigned int getDefaultChunkSize();
+
     /** CCTMXLayer doesn't support adding a CCSprite manually.
      *  @warning addchild(z, tag); is not supported on CCTMXLayer. Instead of setTileGID.
      *  @lua NA
@@ -199,6 +229,15 @@ private:
     // index
     unsigned int atlasIndexForExistantZ(unsigned int z);
     unsigned int atlasIndexForNewZ(int z);
+
+    /* chunks */
+    void updateTileQuadForGID(unsigned int gid, const CCPoint& pos, unsigned int atlasIndex);
+    unsigned int atlasIndexForChunkedPos(const CCPoint& pos, bool load);
+    void updateVisibleChunks();
+    bool visibleTileRange(int& x0, int& y0, int& x1, int& y1);
+    unsigned int reusableChunkSlot();
+    void loadChunk(unsigned int chunk, unsigned int slot);
+    void sortChunkSlots();
 protected:
     //! name of the layer
     std::string m_sLayerName;
@@ -218,6 +257,17 @@ protected:
     
     // used for retina display
     float               m_fContentScaleFactor;            
+
+    //! Only used when the layer is chunked
+    unsigned int        m_uChunkSize;
+    unsigned int        m_uChunkMargin;
+    unsigned int        m_uChunkColumns;
+    unsigned int        m_uChunkRows;
+    unsigned int        m_uChunkFrame;
+    std::vector<int>            m_slotForChunk;     // slot of each chunk of the layer, -1 if not loaded
+    std::vector<int>            m_chunkForSlot;     // chunk loaded in each slot, in map order, -1 if free
+    std::vector<unsigned int>   m_slotTileCount;    // number of tiles (CCSprite) of each slot
+    std::vector<unsigned int>   m_slotFrame;        // last frame in which each slot was visible
 };
 
 // end of tilemap_parallax_nodes group
@@ -713,22 +713,21 @@ void CCTMXMapInfo::endElement(void *ctx, const char *name)
 
         if( pTMXMapInfo->getLayerAttribs() & (TMXLayerAttribGzip | TMXLayerAttribZlib) )
         {
-            unsigned char *deflated;
             CCSize s = layer->m_tLayerSize;
             // int sizeHint = s.width * s.height * sizeof(uint32_t);
             int sizeHint = (int)(s.width * s.height * sizeof(unsigned int));
 
-            int inflatedLen = ZipUtils::ccInflateMemoryWithHint(buffer, len, &deflated, sizeHint);
-            CCAssert(inflatedLen == sizeHint, "");
-
-            inflatedLen = (size_t)&inflatedLen; // XXX: to avoid warnings in compiler
+            // the size of the layer is known, so the tiles are inflated straight into their final buffer
+            unsigned char *deflated = new unsigned char[sizeHint];
+            int inflatedLen = ZipUtils::ccInflateMemoryToBuffer(buffer, len, deflated, sizeHint);
             
             delete [] buffer;
             buffer = NULL;
 
-            if( ! deflated ) 
+            if( inflatedLen != sizeHint ) 
             {
                 CCLOG("cocos2d: TiledMap: inflate data error");
+                delete [] deflated;
                 return;
             }
 
@@ -53,6 +53,7 @@ network/WebSocket.cpp \
 physics_nodes/CCPhysicsDebugNode.cpp \
 physics_nodes/CCPhysicsSprite.cpp \
 LocalStorage/LocalStorageAndroid.cpp \
+LocalStorage/LocalStorageCache.cpp \
 CocoStudio/Armature/CCArmature.cpp \
 CocoStudio/Armature/CCBone.cpp \
 CocoStudio/Armature/animation/CCArmatureAnimation.cpp \
@@ -68,6 +69,7 @@ CocoStudio/Armature/physics/CCColliderDetector.cpp \
 CocoStudio/Armature/utils/CCArmatureDefine.cpp \
 CocoStudio/Armature/utils/CCArmatureDataManager.cpp \
 CocoStudio/Armature/utils/CCDataReaderHelper.cpp \
+CocoStudio/Armature/utils/CCArmatureBinary.cpp \
 CocoStudio/Armature/utils/CCSpriteFrameCacheHelper.cpp \
 CocoStudio/Armature/utils/CCTransformHelp.cpp \
 CocoStudio/Armature/utils/CCTweenFunction.cpp \
@@ -24,6 +24,7 @@
 
 #include "AssetsManager.h"
 #include "cocos2d.h"
+#include "CCBReader/CCBReader.h"
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8)
 #include <curl/curl.h>
@@ -31,14 +32,18 @@
 
 #include <stdio.h>
 #include <vector>
+#include <set>
+#include <algorithm>
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32)
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/select.h>
 #include <errno.h>
 #endif
 
 #include "support/zip_support/unzip.h"
+#include <zlib.h>
 
 using namespace cocos2d;
 using namespace std;
@@ -50,6 +55,10 @@ NS_CC_EXT_BEGIN;
 #define TEMP_PACKAGE_FILE_NAME    "cocos2dx-update-temp-package.zip"
 #define BUFFER_SIZE    8192
 #define MAX_FILENAME   512
+#define MANIFEST_FILE_NAME    "manifest"
+#define STAGING_DIRECTORY_NAME    "cocos2dx-update-staging/"
+#define MAX_DOWNLOAD_ATTEMPTS    3
+#define DOWNLOAD_WAIT_INTERVAL    100
 
 // Message type
 #define ASSETSMANAGER_MESSAGE_UPDATE_SUCCEED                0
@@ -82,6 +91,7 @@ AssetsManager::AssetsManager(const char* packageUrl/* =NULL */, const char* vers
 , _curl(NULL)
 , _tid(NULL)
 , _connectionTimeout(0)
+, _maxConcurrentDownloads(4)
 , _delegate(NULL)
 {
     checkStoragePath();
@@ -163,22 +173,30 @@ void* assetsManagerDownloadAndUncompress(void *data)
     
     do
     {
-        if (self->_downloadedVersion != self->_version)
+        if (self->_manifestUrl.size() > 0)
         {
-            if (! self->downLoad()) break;
-            
-            // Record downloaded version.
-            AssetsManager::Message *msg1 = new AssetsManager::Message();
-            msg1->what = ASSETSMANAGER_MESSAGE_RECORD_DOWNLOADED_VERSION;
-            msg1->obj = self;
-            self->_schedule->sendMessage(msg1);
+            // Download the files that changed, and replace the previous ones
+            if (! self->updateWithManifest()) break;
         }
-        
-        // Uncompress zip file.
-        if (! self->uncompress())
+        else
         {
-            self->sendErrorMessage(AssetsManager::kUncompress);
-            break;
+            if (self->_downloadedVersion != self->_version)
+            {
+                if (! self->downLoad()) break;
+            
+                // Record downloaded version.
+                AssetsManager::Message *msg1 = new AssetsManager::Message();
+                msg1->what = ASSETSMANAGER_MESSAGE_RECORD_DOWNLOADED_VERSION;
+                msg1->obj = self;
+                self->_schedule->sendMessage(msg1);
+            }
+        
+            // Uncompress zip file.
+            if (! self->uncompress())
+            {
+                self->sendErrorMessage(AssetsManager::kUncompress);
+                break;
+            }
         }
         
         // Record updated version and remove downloaded zip file
@@ -202,10 +220,11 @@ void AssetsManager::update()
     if (_tid) return;
     
     // 1. Urls of package and version should be valid;
-    // 2. Package should be a zip file.
+    // 2. Package should be a zip file, unless there is a manifest.
     if (_versionFileUrl.size() == 0 ||
-        _packageUrl.size() == 0 ||
-        std::string::npos == _packageUrl.find(".zip"))
+        (_manifestUrl.size() == 0 &&
+         (_packageUrl.size() == 0 ||
+          std::string::npos == _packageUrl.find(".zip"))))
     {
         CCLOG("no version file url, or no package url, or the package is not a zip file");
         return;
@@ -388,15 +407,7 @@ static size_t downLoadPackage(void *ptr, size_t size, size_t nmemb, void *userda
 int assetsManagerProgressFunc(void *ptr, double totalToDownload, double nowDownloaded, double totalToUpLoad, double nowUpLoaded)
 {
     AssetsManager* manager = (AssetsManager*)ptr;
-    AssetsManager::Message *msg = new AssetsManager::Message();
-    msg->what = ASSETSMANAGER_MESSAGE_PROGRESS;
-    
-    ProgressMessage *progressData = new ProgressMessage();
-    progressData->percent = (int)(nowDownloaded/totalToDownload*100);
-    progressData->manager = manager;
-    msg->obj = progressData;
-    
-    manager->_schedule->sendMessage(msg);
+    manager->sendProgressMessage((int)(nowDownloaded/totalToDownload*100));
     
     CCLOG("downloading... %d%%", (int)(nowDownloaded/totalToDownload*100));
     
@@ -439,6 +450,705 @@ bool AssetsManager::downLoad()
     return true;
 }
 
+// Reads a whole file
+static bool readFile(const string& path, string& content)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (! fp)
+    {
+        return false;
+    }
+    
+    char buffer[BUFFER_SIZE];
+    size_t count;
+    content.clear();
+    while ((count = fread(buffer, 1, BUFFER_SIZE, fp)) > 0)
+    {
+        content.append(buffer, count);
+    }
+    fclose(fp);
+    return true;
+}
+
+// Returns the size of a file, or -1 if it doesn't exist
+static long getFileSize(const string& path)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (! fp)
+    {
+        return -1;
+    }
+    
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+// Computes the crc32 and the size of the content of a file
+static bool getFileCrc(const string& path, unsigned long* crc, unsigned long* size)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (! fp)
+    {
+        return false;
+    }
+    
+    unsigned char buffer[BUFFER_SIZE];
+    size_t count;
+    *crc = crc32(0L, Z_NULL, 0);
+    *size = 0;
+    while ((count = fread(buffer, 1, BUFFER_SIZE, fp)) > 0)
+    {
+        *crc = crc32(*crc, buffer, count);
+        *size += count;
+    }
+    fclose(fp);
+    return true;
+}
+
+// Uncompresses a zlib or gzip stream into a file, computing the crc32 and the size of its content
+static bool inflateFile(const string& inPath, const string& outPath, unsigned long* crc, unsigned long* size)
+{
+    FILE *in = fopen(inPath.c_str(), "rb");
+    if (! in)
+    {
+        return false;
+    }
+    FILE *out = fopen(outPath.c_str(), "wb");
+    if (! out)
+    {
+        fclose(in);
+        return false;
+    }
+    
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // accept both zlib and gzip headers
+    int error = inflateInit2(&stream, 15 + 32);
+    
+    unsigned char inBuffer[BUFFER_SIZE];
+    unsigned char outBuffer[BUFFER_SIZE];
+    *crc = crc32(0L, Z_NULL, 0);
+    *size = 0;
+    while (error == Z_OK)
+    {
+        stream.avail_in = fread(inBuffer, 1, BUFFER_SIZE, in);
+        stream.next_in = inBuffer;
+        if (stream.avail_in == 0)
+        {
+            // the stream is truncated
+            error = Z_DATA_ERROR;
+            break;
+        }
+        
+        do
+        {
+            stream.avail_out = BUFFER_SIZE;
+            stream.next_out = outBuffer;
+            error = inflate(&stream, Z_NO_FLUSH);
+            if (error != Z_OK && error != Z_STREAM_END)
+            {
+                break;
+            }
+            
+            uInt count = BUFFER_SIZE - stream.avail_out;
+            *crc = crc32(*crc, outBuffer, count);
+            *size += count;
+            if (fwrite(outBuffer, 1, count, out) != count)
+            {
+                error = Z_ERRNO;
+                break;
+            }
+        } while (stream.avail_out == 0 && error == Z_OK);
+    }
+    
+    inflateEnd(&stream);
+    fclose(in);
+    fclose(out);
+    return error == Z_STREAM_END;
+}
+
+static bool copyFile(const string& from, const string& to)
+{
+    FILE *in = fopen(from.c_str(), "rb");
+    if (! in)
+    {
+        return false;
+    }
+    FILE *out = fopen(to.c_str(), "wb");
+    if (! out)
+    {
+        fclose(in);
+        return false;
+    }
+    
+    char buffer[BUFFER_SIZE];
+    size_t count;
+    bool ok = true;
+    while (ok && (count = fread(buffer, 1, BUFFER_SIZE, in)) > 0)
+    {
+        ok = fwrite(buffer, 1, count, out) == count;
+    }
+    fclose(in);
+    return fclose(out) == 0 && ok;
+}
+
+static bool moveFile(const string& from, const string& to)
+{
+    // rename doesn't replace an existing file on windows
+    remove(to.c_str());
+    return rename(from.c_str(), to.c_str()) == 0;
+}
+
+// Returns the url of a file of the manifest, escaping each component of its path
+static string getFileUrl(CURL *curl, const string& manifestUrl, const string& path)
+{
+    string url = manifestUrl.substr(0, manifestUrl.rfind('/') + 1);
+    size_t start = 0;
+    while (start <= path.size())
+    {
+        size_t end = path.find('/', start);
+        if (end == string::npos)
+        {
+            end = path.size();
+        }
+        
+        string component = path.substr(start, end - start);
+        char *escaped = curl_easy_escape(curl, component.c_str(), component.size());
+        url.append(escaped ? escaped : component.c_str());
+        curl_free(escaped);
+        if (end < path.size())
+        {
+            url.append("/");
+        }
+        start = end + 1;
+    }
+    return url;
+}
+
+// A file of the manifest being downloaded
+struct FileDownload
+{
+    size_t index;               // index of the entry
+    CURL *curl;
+    FILE *fp;
+    string partPath;
+    unsigned long offset;       // size of the part of the file downloaded before the transfer
+    unsigned long received;     // size received by the transfer
+    int attempts;
+};
+
+static size_t downLoadFile(void *ptr, size_t size, size_t nmemb, void *userdata)
+{
+    FileDownload *download = (FileDownload*)userdata;
+    size_t written = fwrite(ptr, 1, size * nmemb, download->fp);
+    download->received += written;
+    return written;
+}
+
+bool AssetsManager::updateWithManifest()
+{
+    string stagingPath = _storagePath + STAGING_DIRECTORY_NAME;
+    
+    // A previous update may have been interrupted while it replaced the files
+    if (getFileSize(stagingPath + MANIFEST_FILE_NAME) >= 0 && ! applyStagedEntries())
+    {
+        sendErrorMessage(kCreateFile);
+        return false;
+    }
+    
+    // Download the manifest, with the connection used for the version file
+    string content;
+    CURLcode res;
+    curl_easy_setopt(_curl, CURLOPT_URL, _manifestUrl.c_str());
+    curl_easy_setopt(_curl, CURLOPT_WRITEFUNCTION, getVersionCode);
+    curl_easy_setopt(_curl, CURLOPT_WRITEDATA, &content);
+    curl_easy_setopt(_curl, CURLOPT_FAILONERROR, 1L);
+    res = curl_easy_perform(_curl);
+    curl_easy_cleanup(_curl);
+    _curl = NULL;
+    if (res != 0)
+    {
+        sendErrorMessage(kNetwork);
+        CCLOG("can not get manifest content, error code is %d", res);
+        return false;
+    }
+    
+    Manifest manifest;
+    if (! parseManifest(content, manifest))
+    {
+        sendErrorMessage(kVerification);
+        return false;
+    }
+    
+    // The current manifest lists the files that are up to date.
+    Manifest currentManifest;
+    string currentContent;
+    if (readFile(_storagePath + MANIFEST_FILE_NAME, currentContent))
+    {
+        parseManifest(currentContent, currentManifest);
+    }
+    
+    // Download the files that changed, unless they were staged by an interrupted update.
+    // The files with the same content are only downloaded once.
+    vector<ManifestEntry> entries;
+    set<string> stagedPaths;
+    for (Manifest::iterator it = manifest.begin(); it != manifest.end(); ++it)
+    {
+        const ManifestEntry& entry = it->second;
+        Manifest::iterator current = currentManifest.find(it->first);
+        if (current != currentManifest.end() && current->second.crc == entry.crc && current->second.size == entry.size)
+        {
+            continue;
+        }
+        
+        string stagedPath = getStagedPath(entry);
+        if (stagedPaths.insert(stagedPath).second && getFileSize(stagedPath) != (long)entry.size)
+        {
+            entries.push_back(entry);
+        }
+    }
+    
+    if (! createDirectory(stagingPath.c_str()))
+    {
+        sendErrorMessage(kCreateFile);
+        CCLOG("can not create directory %s", stagingPath.c_str());
+        return false;
+    }
+    
+    if (! downloadEntries(entries))
+    {
+        return false;
+    }
+    
+    // Once the manifest is staged, the update completes even if it's interrupted.
+    string tempPath = stagingPath + MANIFEST_FILE_NAME + ".tmp";
+    FILE *fp = fopen(tempPath.c_str(), "wb");
+    bool staged = fp && fwrite(content.c_str(), 1, content.size(), fp) == content.size();
+    if (fp)
+    {
+        staged = (fclose(fp) == 0) && staged;
+    }
+    if (! staged || ! moveFile(tempPath, stagingPath + MANIFEST_FILE_NAME) || ! applyStagedEntries())
+    {
+        sendErrorMessage(kCreateFile);
+        CCLOG("can not replace the files with the downloaded ones");
+        return false;
+    }
+    
+    CCLOG("succeed updating %d files with manifest %s", (int)entries.size(), _manifestUrl.c_str());
+    
+    return true;
+}
+
+bool AssetsManager::parseManifest(const string& content, Manifest& manifest)
+{
+    manifest.clear();
+    
+    size_t start = 0;
+    while (start < content.size())
+    {
+        size_t end = content.find('\n', start);
+        if (end == string::npos)
+        {
+            end = content.size();
+        }
+        string line = content.substr(start, end - start);
+        start = end + 1;
+        
+        if (line.size() > 0 && line[line.size() - 1] == '\r')
+        {
+            line.erase(line.size() - 1);
+        }
+        if (line.size() == 0 || line[0] == '#')
+        {
+            continue;
+        }
+        
+        // crc32, size, stored size and path
+        ManifestEntry entry;
+        const char *cursor = line.c_str();
+        char *next = NULL;
+        bool valid = true;
+        unsigned long *fields[] = { &entry.crc, &entry.size, &entry.storedSize };
+        for (int i = 0; i < 3 && valid; ++i)
+        {
+            *fields[i] = strtoul(cursor, &next, 16);
+            valid = (next != cursor && *next == ' ');
+            cursor = next + 1;
+        }
+        
+        // The files must stay in the storage path.
+        if (valid)
+        {
+            entry.path = cursor;
+            valid = entry.path.size() > 0 && entry.path[0] != '/' && entry.path[entry.path.size() - 1] != '/'
+                && entry.path.find('\\') == string::npos && entry.path.find(':') == string::npos
+                && ("/" + entry.path + "/").find("/../") == string::npos;
+        }
+        if (! valid)
+        {
+            CCLOG("invalid manifest line: %s", line.c_str());
+            return false;
+        }
+        
+        manifest[entry.path] = entry;
+    }
+    
+    return true;
+}
+
+bool AssetsManager::downloadEntries(const vector<ManifestEntry>& entries)
+{
+    if (entries.empty())
+    {
+        return true;
+    }
+    
+    CURLM *multi = curl_multi_init();
+    if (! multi)
+    {
+        sendErrorMessage(kNetwork);
+        CCLOG("can not init curl");
+        return false;
+    }
+    
+    double totalSize = 0;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        totalSize += entries[i].storedSize ? entries[i].storedSize : entries[i].size;
+    }
+    
+    vector<FileDownload*> downloads;
+    vector<FileDownload*> pending;  // to start, or restart after a failure
+    double completedSize = 0;
+    size_t next = 0;
+    int lastPercent = -1;
+    bool failed = false;
+    
+    while (! failed && (next < entries.size() || ! downloads.empty() || ! pending.empty()))
+    {
+        // Start the downloads, resuming the files that were partly downloaded.
+        while (! failed && downloads.size() < MAX(_maxConcurrentDownloads, 1U) && (next < entries.size() || ! pending.empty()))
+        {
+            FileDownload *download = NULL;
+            if (! pending.empty())
+            {
+                download = pending.back();
+                pending.pop_back();
+            }
+            else
+            {
+                download = new FileDownload();
+                download->index = next++;
+                download->curl = NULL;
+                download->partPath = getStagedPath(entries[download->index]) + ".part";
+                download->attempts = 0;
+            }
+            const ManifestEntry& entry = entries[download->index];
+            unsigned long storedSize = entry.storedSize ? entry.storedSize : entry.size;
+            
+            long partSize = getFileSize(download->partPath);
+            if (partSize < 0 && storedSize == 0)
+            {
+                // An empty file has nothing to download.
+                FILE *fp = fopen(download->partPath.c_str(), "wb");
+                if (fp)
+                {
+                    fclose(fp);
+                    partSize = 0;
+                }
+            }
+            download->offset = (partSize > 0 && (unsigned long)partSize <= storedSize) ? partSize : 0;
+            download->received = 0;
+            if (partSize >= 0 && download->offset == storedSize)
+            {
+                // downloaded by an interrupted update
+                completedSize += storedSize;
+                if (download->curl) curl_easy_cleanup(download->curl);
+                delete download;
+                if (! stageEntry(entry))
+                {
+                    sendErrorMessage(kVerification);
+                    failed = true;
+                }
+                continue;
+            }
+            
+            download->fp = fopen(download->partPath.c_str(), download->offset ? "ab" : "wb");
+            if (! download->curl)
+            {
+                download->curl = curl_easy_init();
+            }
+            if (! download->fp || ! download->curl)
+            {
+                sendErrorMessage(kCreateFile);
+                CCLOG("can not create file %s", download->partPath.c_str());
+                if (download->fp) fclose(download->fp);
+                if (download->curl) curl_easy_cleanup(download->curl);
+                delete download;
+                failed = true;
+                break;
+            }
+            
+            curl_easy_setopt(download->curl, CURLOPT_URL, getFileUrl(download->curl, _manifestUrl, entry.path).c_str());
+            curl_easy_setopt(download->curl, CURLOPT_SSL_VERIFYPEER, 0L);
+            curl_easy_setopt(download->curl, CURLOPT_NOSIGNAL, 1L);
+            curl_easy_setopt(download->curl, CURLOPT_FAILONERROR, 1L);
+            curl_easy_setopt(download->curl, CURLOPT_WRITEFUNCTION, downLoadFile);
+            curl_easy_setopt(download->curl, CURLOPT_WRITEDATA, download);
+            curl_easy_setopt(download->curl, CURLOPT_PRIVATE, download);
+            curl_easy_setopt(download->curl, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)download->offset);
+            if (_connectionTimeout) curl_easy_setopt(download->curl, CURLOPT_CONNECTTIMEOUT, _connectionTimeout);
+            curl_multi_add_handle(multi, download->curl);
+            downloads.push_back(download);
+        }
+        
+        if (downloads.empty())
+        {
+            continue;
+        }
+        
+        int running = 0;
+        while (CURLM_CALL_MULTI_PERFORM == curl_multi_perform(multi, &running))
+        {
+        }
+        
+        // Verify the files as soon as they are downloaded.
+        CURLMsg *message = NULL;
+        int messages = 0;
+        while ((message = curl_multi_info_read(multi, &messages)) != NULL)
+        {
+            if (message->msg != CURLMSG_DONE)
+            {
+                continue;
+            }
+            
+            FileDownload *download = NULL;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, (char**)&download);
+            CURLcode result = message->data.result;
+            curl_multi_remove_handle(multi, download->curl);
+            downloads.erase(std::find(downloads.begin(), downloads.end(), download));
+            if (download->fp)
+            {
+                fclose(download->fp);
+                download->fp = NULL;
+            }
+            
+            const ManifestEntry& entry = entries[download->index];
+            if (result == CURLE_OK)
+            {
+                completedSize += entry.storedSize ? entry.storedSize : entry.size;
+                curl_easy_cleanup(download->curl);
+                delete download;
+                if (! stageEntry(entry))
+                {
+                    sendErrorMessage(kVerification);
+                    failed = true;
+                }
+            }
+            else if (++download->attempts < MAX_DOWNLOAD_ATTEMPTS)
+            {
+                if (result == CURLE_RANGE_ERROR)
+                {
+                    // The server doesn't support ranges, the file is downloaded again from the start.
+                    remove(download->partPath.c_str());
+                }
+                CCLOG("error when download %s, error code is %d, retrying", entry.path.c_str(), result);
+                pending.push_back(download);
+            }
+            else
+            {
+                CCLOG("error when download %s, error code is %d", entry.path.c_str(), result);
+                curl_easy_cleanup(download->curl);
+                delete download;
+                sendErrorMessage(kNetwork);
+                failed = true;
+            }
+        }
+        
+        double downloadedSize = completedSize;
+        for (vector<FileDownload*>::iterator it = downloads.begin(); it != downloads.end(); ++it)
+        {
+            downloadedSize += (*it)->offset + (*it)->received;
+        }
+        for (vector<FileDownload*>::iterator it = pending.begin(); it != pending.end(); ++it)
+        {
+            downloadedSize += (*it)->offset + (*it)->received;
+        }
+        int percent = totalSize > 0 ? (int)(downloadedSize / totalSize * 100) : 100;
+        if (percent != lastPercent)
+        {
+            lastPercent = percent;
+            sendProgressMessage(percent);
+        }
+        
+        // Wait for the sockets of the downloads.
+        if (! failed && running > 0)
+        {
+            fd_set readSet, writeSet, errorSet;
+            FD_ZERO(&readSet);
+            FD_ZERO(&writeSet);
+            FD_ZERO(&errorSet);
+            int maxfd = -1;
+            long timeout = -1;
+            curl_multi_timeout(multi, &timeout);
+            if (timeout < 0 || timeout > DOWNLOAD_WAIT_INTERVAL)
+            {
+                timeout = DOWNLOAD_WAIT_INTERVAL;
+            }
+            curl_multi_fdset(multi, &readSet, &writeSet, &errorSet, &maxfd);
+            
+            struct timeval tv;
+            tv.tv_sec = timeout / 1000;
+            tv.tv_usec = (timeout % 1000) * 1000;
+            if (maxfd >= 0)
+            {
+                select(maxfd + 1, &readSet, &writeSet, &errorSet, &tv);
+            }
+            else if (timeout > 0)
+            {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+                Sleep(timeout);
+#else
+                select(0, NULL, NULL, NULL, &tv);
+#endif
+            }
+        }
+    }
+    
+    // The parts downloaded are kept, and resumed by the next update.
+    for (vector<FileDownload*>::iterator it = downloads.begin(); it != downloads.end(); ++it)
+    {
+        curl_multi_remove_handle(multi, (*it)->curl);
+        curl_easy_cleanup((*it)->curl);
+        if ((*it)->fp) fclose((*it)->fp);
+        delete *it;
+    }
+    for (vector<FileDownload*>::iterator it = pending.begin(); it != pending.end(); ++it)
+    {
+        curl_easy_cleanup((*it)->curl);
+        delete *it;
+    }
+    curl_multi_cleanup(multi);
+    
+    return ! failed;
+}
+
+bool AssetsManager::stageEntry(const ManifestEntry& entry)
+{
+    string stagedPath = getStagedPath(entry);
+    string partPath = stagedPath + ".part";
+    string tempPath = stagedPath + ".tmp";
+    
+    unsigned long crc = 0;
+    unsigned long size = 0;
+    bool ok = false;
+    if (entry.storedSize == 0)
+    {
+        ok = getFileCrc(partPath, &crc, &size) && crc == entry.crc && size == entry.size
+            && moveFile(partPath, stagedPath);
+    }
+    else
+    {
+        ok = inflateFile(partPath, tempPath, &crc, &size) && crc == entry.crc && size == entry.size
+            && moveFile(tempPath, stagedPath);
+        remove(tempPath.c_str());
+    }
+    
+    // A corrupted file is downloaded again by the next update.
+    remove(partPath.c_str());
+    if (! ok)
+    {
+        CCLOG("downloaded file %s doesn't match the manifest", entry.path.c_str());
+    }
+    return ok;
+}
+
+bool AssetsManager::applyStagedEntries()
+{
+    string stagingPath = _storagePath + STAGING_DIRECTORY_NAME;
+    string content;
+    Manifest manifest;
+    if (! readFile(stagingPath + MANIFEST_FILE_NAME, content) || ! parseManifest(content, manifest))
+    {
+        return false;
+    }
+    
+    Manifest currentManifest;
+    string currentContent;
+    if (readFile(_storagePath + MANIFEST_FILE_NAME, currentContent))
+    {
+        parseManifest(currentContent, currentManifest);
+    }
+    
+    // The files with the same content share a staged file, which is copied to all of them but the last one.
+    // The entries are always applied in the same order, so that an interrupted update can be applied again.
+    map<string, string> lastPaths;
+    for (Manifest::iterator it = manifest.begin(); it != manifest.end(); ++it)
+    {
+        lastPaths[getStagedPath(it->second)] = it->first;
+    }
+    
+    for (Manifest::iterator it = manifest.begin(); it != manifest.end(); ++it)
+    {
+        string stagedPath = getStagedPath(it->second);
+        if (getFileSize(stagedPath) < 0)
+        {
+            // The file didn't change, or was already moved.
+            continue;
+        }
+        
+        string fullPath = _storagePath + it->first;
+        if (! createParentDirectories(fullPath))
+        {
+            CCLOG("can not create directory for %s", fullPath.c_str());
+            return false;
+        }
+        
+        bool ok = (lastPaths[stagedPath] == it->first) ? moveFile(stagedPath, fullPath) : copyFile(stagedPath, fullPath);
+        if (! ok)
+        {
+            CCLOG("can not replace file %s", fullPath.c_str());
+            return false;
+        }
+    }
+    
+    // Remove the files that are not in the manifest anymore.
+    for (Manifest::iterator it = currentManifest.begin(); it != currentManifest.end(); ++it)
+    {
+        if (manifest.find(it->first) == manifest.end())
+        {
+            remove((_storagePath + it->first).c_str());
+        }
+    }
+    
+    return moveFile(stagingPath + MANIFEST_FILE_NAME, _storagePath + MANIFEST_FILE_NAME);
+}
+
+string AssetsManager::getStagedPath(const ManifestEntry& entry)
+{
+    // The staged files are named after their content.
+    char name[32];
+    sprintf(name, "%08lx-%lx", entry.crc, entry.size);
+    return _storagePath + STAGING_DIRECTORY_NAME + name;
+}
+
+bool AssetsManager::createParentDirectories(const string& path)
+{
+    size_t end = path.find('/', _storagePath.size());
+    while (end != string::npos)
+    {
+        if (! createDirectory(path.substr(0, end).c_str()))
+        {
+            return false;
+        }
+        end = path.find('/', end + 1);
+    }
+    return true;
+}
+
 const char* AssetsManager::getPackageUrl() const
 {
     return _packageUrl.c_str();
@@ -470,6 +1180,16 @@ void AssetsManager::setVersionFileUrl(const char *versionFileUrl)
     _versionFileUrl = versionFileUrl;
 }
 
+const char* AssetsManager::getManifestUrl() const
+{
+    return _manifestUrl.c_str();
+}
+
+void AssetsManager::setManifestUrl(const char *manifestUrl)
+{
+    _manifestUrl = manifestUrl;
+}
+
 string AssetsManager::getVersion()
 {
     return CCUserDefault::sharedUserDefault()->getStringForKey(KEY_OF_VERSION);
@@ -495,6 +1215,16 @@ unsigned int AssetsManager::getConnectionTimeout()
     return _connectionTimeout;
 }
 
+void AssetsManager::setMaxConcurrentDownloads(unsigned int count)
+{
+    _maxConcurrentDownloads = count;
+}
+
+unsigned int AssetsManager::getMaxConcurrentDownloads()
+{
+    return _maxConcurrentDownloads;
+}
+
 void AssetsManager::sendErrorMessage(AssetsManager::ErrorCode code)
 {
     Message *msg = new Message();
@@ -508,6 +1238,19 @@ void AssetsManager::sendErrorMessage(AssetsManager::ErrorCode code)
     _schedule->sendMessage(msg);
 }
 
+void AssetsManager::sendProgressMessage(int percent)
+{
+    Message *msg = new Message();
+    msg->what = ASSETSMANAGER_MESSAGE_PROGRESS;
+    
+    ProgressMessage *progressData = new ProgressMessage();
+    progressData->percent = percent;
+    progressData->manager = this;
+    msg->obj = progressData;
+    
+    _schedule->sendMessage(msg);
+}
+
 // Implementation of AssetsManagerHelper
 
 AssetsManager::Helper::Helper()
@@ -598,9 +1341,13 @@ void AssetsManager::Helper::handleUpdateSucceed(Message *msg)
     // Set resource search path.
     manager->setSearchPath();
     
+    // The updated files may have been found elsewhere before, or read already.
+    CCFileUtils::sharedFileUtils()->purgeCachedEntries();
+    CCBReader::purgeTemplateCache();
+    
     // Delete unloaded zip file.
     string zipfileName = manager->_storagePath + TEMP_PACKAGE_FILE_NAME;
-    if (remove(zipfileName.c_str()) != 0)
+    if (manager->_manifestUrl.size() == 0 && remove(zipfileName.c_str()) != 0)
     {
         CCLOG("can not remove downloaded zip file %s", zipfileName.c_str());
     }
@@ -31,6 +31,8 @@
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8)
 #include <string>
+#include <map>
+#include <vector>
 #include <curl/curl.h>
 #include <pthread.h>
 
@@ -42,6 +44,18 @@ class AssetsManagerDelegateProtocol;
  *  This class is used to auto update resources, such as pictures or scripts.
  *  The updated package should be a zip file. And there should be a file named
  *  version in the server, which contains version code.
+ *
+ *  Alternatively, the resources can be updated file by file with a manifest, see setManifestUrl().
+ *  Only the files that changed since the last update are downloaded, several at a time,
+ *  and an interrupted download is resumed where it stopped by the next update.
+ *  Each line of the manifest describes a file with the crc32 of its content and its size,
+ *  both in hexadecimal, the size of the zlib stream served for the file in hexadecimal,
+ *  which is 0 when the file is served uncompressed, then its path relative to the manifest:
+ *
+ *      1c291ca3 2f80 0 fonts/arial.fnt
+ *      8e3f2a10 40000 1b2c5 scripts/main.lua
+ *
+ *  Manifests are created with tools/assets-manifest/make_manifest.py.
  *  @js NA
  *  @lua NA
  */
@@ -69,6 +83,9 @@ public:
          -- ...
          */
         kUncompress,
+        /** A downloaded file doesn't match the manifest
+         */
+        kVerification,
     };
     
     /* @brief Creates a AssetsManager with new package url, version code url and storage path.
@@ -108,6 +125,16 @@ public:
      */
     void setVersionFileUrl(const char* versionFileUrl);
     
+    /* @brief Gets manifest url.
+     */
+    const char* getManifestUrl() const;
+    
+    /* @brief Sets manifest url. If set, update() downloads the files of the manifest that changed
+     *        instead of the package. The urls of the files are relative to the one of the manifest.
+     *        The new files replace the previous ones once they are all downloaded and verified.
+     */
+    void setManifestUrl(const char* manifestUrl);
+    
     /* @brief Gets current version code.
      */
     std::string getVersion();
@@ -139,6 +166,14 @@ public:
      */
     unsigned int getConnectionTimeout();
     
+    /** @brief Sets the number of files of the manifest downloaded at the same time, 4 by default
+     */
+    void setMaxConcurrentDownloads(unsigned int count);
+    
+    /** @brief Gets the number of files of the manifest downloaded at the same time
+     */
+    unsigned int getMaxConcurrentDownloads();
+    
     /* downloadAndUncompress is the entry of a new thread 
      */
     friend void* assetsManagerDownloadAndUncompress(void*);
@@ -151,6 +186,25 @@ protected:
     bool createDirectory(const char *path);
     void setSearchPath();
     void sendErrorMessage(ErrorCode code);
+    void sendProgressMessage(int percent);
+    
+    // update with a manifest
+    struct ManifestEntry
+    {
+        std::string path;
+        unsigned long crc;          // crc32 of the content
+        unsigned long size;         // size of the content
+        unsigned long storedSize;   // size of the zlib stream served, 0 if the file is served as is
+    };
+    typedef std::map<std::string, ManifestEntry> Manifest;
+    
+    bool updateWithManifest();
+    bool parseManifest(const std::string& content, Manifest& manifest);
+    bool downloadEntries(const std::vector<ManifestEntry>& entries);
+    bool stageEntry(const ManifestEntry& entry);
+    bool applyStagedEntries();
+    std::string getStagedPath(const ManifestEntry& entry);
+    bool createParentDirectories(const std::string& path);
     
 private:
     typedef struct _Message
@@ -186,6 +240,7 @@ private:
     
     std::string _packageUrl;
     std::string _versionFileUrl;
+    std::string _manifestUrl;
     
     std::string _downloadedVersion;
     
@@ -193,6 +248,7 @@ private:
     Helper *_schedule;
     pthread_t *_tid;
     unsigned int _connectionTimeout;
+    unsigned int _maxConcurrentDownloads;
     
     AssetsManagerDelegateProtocol *_delegate; // weak reference
 };
@@ -53,15 +53,104 @@ void CCBFile::setCCBFileNode(CCNode *pNode)
     CC_SAFE_RETAIN(mCCBFileNode);
 }
 
+/*************************************************************************
+ Implementation of CCBTemplate
+ *************************************************************************/
+
+CCBTemplate::CCBTemplate()
+: mData(NULL)
+, mSequencesOffset(0)
+, mJSControlled(false)
+, mCCNodeLoaderLibrary(NULL)
+{
+}
+
+CCBTemplate::~CCBTemplate()
+{
+    for (std::vector<CCNodeLoader*>::iterator it = mNodeLoaders.begin(); it != mNodeLoaders.end(); ++it)
+    {
+        (*it)->release();
+    }
+    CC_SAFE_RELEASE(mCCNodeLoaderLibrary);
+    CC_SAFE_RELEASE(mData);
+}
+
+bool CCBTemplate::initWithData(CCData *pData, std::vector<std::string>& stringCache, int sequencesOffset, bool bJSControlled)
+{
+    CC_SAFE_RETAIN(pData);
+    CC_SAFE_RELEASE(mData);
+    mData = pData;
+    mStringCache.swap(stringCache);
+    mSequencesOffset = sequencesOffset;
+    mJSControlled = bJSControlled;
+
+    return true;
+}
+
+CCData* CCBTemplate::getData()
+{
+    return mData;
+}
+
+const std::vector<std::string>& CCBTemplate::getStringCache()
+{
+    return mStringCache;
+}
+
+int CCBTemplate::getSequencesOffset()
+{
+    return mSequencesOffset;
+}
+
+bool CCBTemplate::isJSControlled()
+{
+    return mJSControlled;
+}
+
+CCNodeLoader* CCBTemplate::getNodeLoader(int nodeIndex, const std::string& className, CCNodeLoaderLibrary *pCCNodeLoaderLibrary)
+{
+    if (pCCNodeLoaderLibrary != mCCNodeLoaderLibrary)
+    {
+        // the loaders resolved with another library may not be registered in this one
+        for (std::vector<CCNodeLoader*>::iterator it = mNodeLoaders.begin(); it != mNodeLoaders.end(); ++it)
+        {
+            (*it)->release();
+        }
+        mNodeLoaders.clear();
+
+        CC_SAFE_RETAIN(pCCNodeLoaderLibrary);
+        CC_SAFE_RELEASE(mCCNodeLoaderLibrary);
+        mCCNodeLoaderLibrary = pCCNodeLoaderLibrary;
+    }
+
+    if (nodeIndex < (int)mNodeLoaders.size())
+    {
+        return mNodeLoaders[nodeIndex];
+    }
+
+    CCNodeLoader *pLoader = pCCNodeLoaderLibrary->getCCNodeLoader(className.c_str());
+    if (pLoader && nodeIndex == (int)mNodeLoaders.size())
+    {
+        pLoader->retain();
+        mNodeLoaders.push_back(pLoader);
+    }
+    return pLoader;
+}
+
 /*************************************************************************
  Implementation of CCBReader
  *************************************************************************/
 
+static CCDictionary* s_pTemplateCache = NULL;
+static bool s_bTemplateCacheEnabled = true;
+
 CCBReader::CCBReader(CCNodeLoaderLibrary * pCCNodeLoaderLibrary, CCBMemberVariableAssigner * pCCBMemberVariableAssigner, CCBSelectorResolver * pCCBSelectorResolver, CCNodeLoaderListener * pCCNodeLoaderListener) 
 : mData(NULL)
 , mBytes(NULL)
 , mCurrentByte(-1)
 , mCurrentBit(-1)
+, mTemplate(NULL)
+, mNodeIndex(0)
 , mOwner(NULL)
 , mActionManager(NULL)
 , mActionManagers(NULL)
@@ -84,6 +173,8 @@ CCBReader::CCBReader(CCBReader * pCCBReader)
 , mBytes(NULL)
 , mCurrentByte(-1)
 , mCurrentBit(-1)
+, mTemplate(NULL)
+, mNodeIndex(0)
 , mOwner(NULL)
 , mActionManager(NULL)
 , mActionManagers(NULL)
@@ -110,6 +201,8 @@ CCBReader::CCBReader()
 , mBytes(NULL)
 , mCurrentByte(-1)
 , mCurrentBit(-1)
+, mTemplate(NULL)
+, mNodeIndex(0)
 , mOwner(NULL)
 , mActionManager(NULL)
 , mActionManagers(NULL)
@@ -126,6 +219,7 @@ CCBReader::CCBReader()
 CCBReader::~CCBReader() {
     CC_SAFE_RELEASE_NULL(mOwner);
     CC_SAFE_RELEASE_NULL(mData);
+    CC_SAFE_RELEASE_NULL(mTemplate);
 
     this->mCCNodeLoaderLibrary->release();
 
@@ -241,26 +335,30 @@ CCNode* CCBReader::readNodeGraphFromFile(const char *pCCBFileName, CCObject *pOw
     }
 
     std::string strPath = CCFileUtils::sharedFileUtils()->fullPathForFilename(strCCBFileName.c_str());
-    unsigned long size = 0;
 
-    unsigned char * pBytes = CCFileUtils::sharedFileUtils()->getFileData(strPath.c_str(), "rb", &size);
-    CCData *data = new CCData(pBytes, size);
-    CC_SAFE_DELETE_ARRAY(pBytes);
+    CCBTemplate *pTemplate = templateForFile(strPath);
+    if (! pTemplate)
+    {
+        return NULL;
+    }
 
-    CCNode *ret =  this->readNodeGraphFromData(data, pOwner, parentSize);
-    
-    data->release();
-    
-    return ret;
+    return this->readNodeGraphFromTemplate(pTemplate, pOwner, parentSize);
 }
 
 CCNode* CCBReader::readNodeGraphFromData(CCData *pData, CCObject *pOwner, const CCSize &parentSize)
 {
-    mData = pData;
-    CC_SAFE_RETAIN(mData);
-    mBytes = mData->getBytes();
-    mCurrentByte = 0;
-    mCurrentBit = 0;
+    CCBTemplate *pTemplate = readTemplate(pData);
+    if (! pTemplate)
+    {
+        return NULL;
+    }
+
+    return this->readNodeGraphFromTemplate(pTemplate, pOwner, parentSize);
+}
+
+CCNode* CCBReader::readNodeGraphFromTemplate(CCBTemplate *pTemplate, CCObject *pOwner, const CCSize &parentSize)
+{
+    setTemplate(pTemplate);
     mOwner = pOwner;
     CC_SAFE_RETAIN(mOwner);
 
@@ -317,6 +415,90 @@ CCScene* CCBReader::createSceneWithNodeGraphFromFile(const char *pCCBFileName, C
     return pScene;
 }
 
+void CCBReader::purgeTemplateCache()
+{
+    CC_SAFE_RELEASE_NULL(s_pTemplateCache);
+}
+
+void CCBReader::setTemplateCacheEnabled(bool bEnabled)
+{
+    s_bTemplateCacheEnabled = bEnabled;
+    if (! bEnabled)
+    {
+        purgeTemplateCache();
+    }
+}
+
+bool CCBReader::isTemplateCacheEnabled()
+{
+    return s_bTemplateCacheEnabled;
+}
+
+CCBTemplate* CCBReader::readTemplate(CCData *pData)
+{
+    CCBTemplate *pTemplate = NULL;
+
+    mBytes = pData->getSize() > 0 ? pData->getBytes() : NULL;
+    mCurrentByte = 0;
+    mCurrentBit = 0;
+    mStringCache.clear();
+
+    if (readHeader() && readStringCache())
+    {
+        pTemplate = new CCBTemplate();
+        pTemplate->initWithData(pData, mStringCache, mCurrentByte, jsControlled);
+        pTemplate->autorelease();
+    }
+
+    mBytes = mData ? mData->getBytes() : NULL;
+    return pTemplate;
+}
+
+CCBTemplate* CCBReader::templateForFile(const std::string& fullPath)
+{
+    CCBTemplate *pTemplate = s_pTemplateCache ? (CCBTemplate*)s_pTemplateCache->objectForKey(fullPath) : NULL;
+    if (pTemplate)
+    {
+        return pTemplate;
+    }
+
+    unsigned long size = 0;
+    unsigned char * pBytes = CCFileUtils::sharedFileUtils()->getFileData(fullPath.c_str(), "rb", &size);
+    CCData *data = new CCData(pBytes, size);
+    CC_SAFE_DELETE_ARRAY(pBytes);
+
+    pTemplate = readTemplate(data);
+    data->release();
+
+    if (pTemplate && s_bTemplateCacheEnabled)
+    {
+        if (! s_pTemplateCache)
+        {
+            s_pTemplateCache = new CCDictionary();
+        }
+        s_pTemplateCache->setObject(pTemplate, fullPath);
+    }
+
+    return pTemplate;
+}
+
+void CCBReader::setTemplate(CCBTemplate *pTemplate)
+{
+    CC_SAFE_RETAIN(pTemplate);
+    CC_SAFE_RELEASE(mTemplate);
+    mTemplate = pTemplate;
+
+    CCData *pData = pTemplate ? pTemplate->getData() : NULL;
+    CC_SAFE_RETAIN(pData);
+    CC_SAFE_RELEASE(mData);
+    mData = pData;
+
+    mBytes = mData ? mData->getBytes() : NULL;
+    mCurrentByte = 0;
+    mCurrentBit = 0;
+    mNodeIndex = 0;
+}
+
 void CCBReader::cleanUpNodeGraph(CCNode *pNode)
 {
     pNode->setUserObject(NULL);
@@ -330,14 +512,25 @@ void CCBReader::cleanUpNodeGraph(CCNode *pNode)
 
 CCNode* CCBReader::readFileWithCleanUp(bool bCleanUp, CCDictionary* am)
 {
-    if (! readHeader())
+    if (mTemplate)
     {
-        return NULL;
+        // the header and the string cache were decoded with the template
+        jsControlled = mTemplate->isJSControlled();
+        mActionManager->jsControlled = jsControlled;
+        mCurrentByte = mTemplate->getSequencesOffset();
+        mCurrentBit = 0;
     }
-    
-    if (! readStringCache())
+    else
     {
-        return NULL;
+        if (! readHeader())
+        {
+            return NULL;
+        }
+        
+        if (! readStringCache())
+        {
+            return NULL;
+        }
     }
     
     if (! readSequences())
@@ -528,14 +721,15 @@ float CCBReader::readFloat() {
     }
 }
 
-std::string CCBReader::readCachedString() {
+const std::string& CCBReader::readCachedString() {
     int n = this->readInt(false);
-    return this->mStringCache[n];
+    return mTemplate ? mTemplate->getStringCache()[n] : this->mStringCache[n];
 }
 
 CCNode * CCBReader::readNodeGraph(CCNode * pParent) {
     /* Read class name. */
-    std::string className = this->readCachedString();
+    const std::string& className = this->readCachedString();
+    int nodeIndex = mNodeIndex++;
 
     std::string jsControlledName;
     
@@ -550,7 +744,9 @@ CCNode * CCBReader::readNodeGraph(CCNode * pParent) {
         memberVarAssignmentName = this->readCachedString();
     }
     
-    CCNodeLoader *ccNodeLoader = this->mCCNodeLoaderLibrary->getCCNodeLoader(className.c_str());
+    CCNodeLoader *ccNodeLoader = mTemplate
+        ? mTemplate->getNodeLoader(nodeIndex, className, this->mCCNodeLoaderLibrary)
+        : this->mCCNodeLoaderLibrary->getCCNodeLoader(className.c_str());
      
     if (! ccNodeLoader)
     {
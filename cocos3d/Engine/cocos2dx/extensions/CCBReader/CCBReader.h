@@ -166,6 +166,46 @@ class CCBAnimationManager;
 class CCData;
 class CCBKeyframe;
 
+/**
+ * @brief The decoded content of a ccbi file, shared by all the reads of that file.
+ *
+ * The file is read and its string cache is decoded once, and the node loader of each node is only
+ * looked up in the CCNodeLoaderLibrary the first time the file is read with that library.
+ * CCBReader::readNodeGraphFromFile keeps the templates of the files it reads, see CCBReader::purgeTemplateCache.
+ * @js NA
+ * @lua NA
+ */
+class CC_EX_DLL CCBTemplate : public CCObject
+{
+public:
+    CCBTemplate();
+    virtual ~CCBTemplate();
+
+    /** the template takes the content of the string cache */
+    bool initWithData(CCData *pData, std::vector<std::string>& stringCache, int sequencesOffset, bool bJSControlled);
+
+    CCData* getData();
+    const std::vector<std::string>& getStringCache();
+
+    /** the offset of the sequences, which follow the string cache */
+    int getSequencesOffset();
+    bool isJSControlled();
+
+    /** returns the loader of the node at the given index, in the order the nodes are read.
+     *  The loaders are resolved once for each library.
+     */
+    CCNodeLoader* getNodeLoader(int nodeIndex, const std::string& className, CCNodeLoaderLibrary *pCCNodeLoaderLibrary);
+
+private:
+    CCData *mData;
+    std::vector<std::string> mStringCache;
+    int mSequencesOffset;
+    bool mJSControlled;
+
+    CCNodeLoaderLibrary *mCCNodeLoaderLibrary;
+    std::vector<CCNodeLoader*> mNodeLoaders;
+};
+
 /**
  * @brief Parse CCBI file which is generated by CocosBuilder
  */
@@ -179,6 +219,8 @@ private:
     int mCurrentBit;
     
     std::vector<std::string> mStringCache;
+    CCBTemplate *mTemplate;
+    int mNodeIndex;
     std::set<std::string> mLoadedSpriteSheets;
     
     CCObject *mOwner;
@@ -264,6 +306,20 @@ public:
      *  @lua NA
      */
     CCScene* createSceneWithNodeGraphFromFile(const char *pCCBFileName, CCObject *pOwner, const CCSize &parentSize);
+    /**
+     *  Removes the templates of the files read so far. Call it when the ccbi files or the loaders
+     *  registered for their classes change.
+     *  @js NA
+     *  @lua NA
+     */
+    static void purgeTemplateCache();
+    /**
+     *  Sets whether readNodeGraphFromFile keeps the templates of the files it reads. Enabled by default.
+     *  @js NA
+     *  @lua NA
+     */
+    static void setTemplateCacheEnabled(bool bEnabled);
+    static bool isTemplateCacheEnabled();
     /**
      *  @js NA
      *  @lua NA
@@ -341,7 +397,7 @@ public:
      *  @js NA
      *  @lua NA
      */
-    std::string readCachedString();
+    const std::string& readCachedString();
     /**
      *  @js NA
      *  @lua NA
@@ -422,6 +478,10 @@ private:
     
     bool readHeader();
     bool readStringCache();
+    CCBTemplate* readTemplate(CCData *pData);
+    CCBTemplate* templateForFile(const std::string& fullPath);
+    void setTemplate(CCBTemplate *pTemplate);
+    CCNode* readNodeGraphFromTemplate(CCBTemplate *pTemplate, CCObject *pOwner, const CCSize &parentSize);
     //void readStringCacheEntry();
     CCNode* readNodeGraph();
     CCNode* readNodeGraph(CCNode * pParent);
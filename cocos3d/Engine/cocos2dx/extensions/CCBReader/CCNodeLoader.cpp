@@ -39,10 +39,13 @@ void CCNodeLoader::parseProperties(CCNode * pNode, CCNode * pParent, CCBReader *
     int numExturaProps = pCCBReader->readInt(false);
     int propertyCount = numRegularProps + numExturaProps;
 
+    // only checked again when the properties are forwarded to another node
+    CCBFile *ccbFile = dynamic_cast<CCBFile*>(pNode);
+
     for(int i = 0; i < propertyCount; i++) {
         bool isExtraProp = (i >= numRegularProps);
         int type = pCCBReader->readInt(false);
-        std::string propertyName = pCCBReader->readCachedString();
+        const std::string& propertyName = pCCBReader->readCachedString();
 
         // Check if the property can be set for this platform
         bool setProp = false;
@@ -68,12 +71,12 @@ void CCNodeLoader::parseProperties(CCNode * pNode, CCNode * pParent, CCBReader *
 // #endif
         
         // Forward properties for sub ccb files
-        if (dynamic_cast<CCBFile*>(pNode) != NULL)
+        if (ccbFile != NULL)
         {
-            CCBFile *ccbNode = (CCBFile*)pNode;
-            if (ccbNode->getCCBFileNode() && isExtraProp)
+            if (ccbFile->getCCBFileNode() && isExtraProp)
             {
-                pNode = ccbNode->getCCBFileNode();
+                pNode = ccbFile->getCCBFileNode();
+                ccbFile = dynamic_cast<CCBFile*>(pNode);
                 
                 // Skip properties that doesn't have a value to override
                 CCArray *extraPropsNames = (CCArray*)pNode->getUserObject();
@@ -873,21 +876,12 @@ CCNode * CCNodeLoader::parsePropTypeCCBFile(CCNode * pNode, CCNode * pParent, CC
     
     // Load sub file
     std::string path = CCFileUtils::sharedFileUtils()->fullPathForFilename(ccbFileName.c_str());
-    unsigned long size = 0;
-    unsigned char * pBytes = CCFileUtils::sharedFileUtils()->getFileData(path.c_str(), "rb", &size);
 
     CCBReader * ccbReader = new CCBReader(pCCBReader);
     ccbReader->autorelease();
     ccbReader->getAnimationManager()->setRootContainerSize(pParent->getContentSize());
     
-    CCData *data = new CCData(pBytes, size);
-    CC_SAFE_DELETE_ARRAY(pBytes);
-
-    data->retain();
-    ccbReader->mData = data;
-    ccbReader->mBytes = data->getBytes();
-    ccbReader->mCurrentByte = 0;
-    ccbReader->mCurrentBit = 0;
+    ccbReader->setTemplate(ccbReader->templateForFile(path));
     CC_SAFE_RETAIN(pCCBReader->mOwner);
     ccbReader->mOwner = pCCBReader->mOwner;
     
@@ -900,8 +894,6 @@ CCNode * CCNodeLoader::parsePropTypeCCBFile(CCNode * pNode, CCNode * pParent, CC
 //     ccbReader->mOwnerCallbackNames = pCCBReader->mOwnerCallbackNames;
 //     ccbReader->mOwnerCallbackNodes = pCCBReader->mOwnerCallbackNodes;
 //     ccbReader->mOwnerCallbackNodes->retain();
-
-    data->release();
     
     CCNode * ccbFileNode = ccbReader->readFileWithCleanUp(false, pCCBReader->getAnimationManagers());
     
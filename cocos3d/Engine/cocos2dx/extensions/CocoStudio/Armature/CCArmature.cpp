@@ -85,6 +85,8 @@ CCArmature::CCArmature()
     , m_bArmatureTransformDirty(true)
     , m_pBoneDic(NULL)
     , m_pTopBoneList(NULL)
+    , m_pSortedBoneList(NULL)
+    , m_bBoneListDirty(true)
     , m_pAnimation(NULL)
     , m_pTextureAtlasDic(NULL)
 {
@@ -103,6 +105,7 @@ CCArmature::~CCArmature(void)
         m_pTopBoneList->removeAllObjects();
         CC_SAFE_DELETE(m_pTopBoneList);
     }
+    CC_SAFE_RELEASE_NULL(m_pSortedBoneList);
     CC_SAFE_DELETE(m_pAnimation);
     CC_SAFE_RELEASE_NULL(m_pTextureAtlasDic);
 }
@@ -132,6 +135,11 @@ bool CCArmature::init(const char *name)
         m_pTopBoneList = new CCArray();
         m_pTopBoneList->init();
 
+        CC_SAFE_RELEASE_NULL(m_pSortedBoneList);
+        m_pSortedBoneList = new CCArray();
+        m_pSortedBoneList->init();
+        m_bBoneListDirty = true;
+
         CC_SAFE_DELETE(m_pTextureAtlasDic);
         m_pTextureAtlasDic = new CCDictionary();
 
@@ -278,6 +286,8 @@ void CCArmature::addBone(CCBone *bone, const char *parentName)
 
     m_pBoneDic->setObject(bone, bone->getName());
     addChild(bone);
+
+    m_bBoneListDirty = true;
 }
 
 
@@ -294,6 +304,8 @@ void CCArmature::removeBone(CCBone *bone, bool recursion)
     }
     m_pBoneDic->removeObjectForKey(bone->getName());
     removeChild(bone, true);
+
+    m_bBoneListDirty = true;
 }
 
 
@@ -330,6 +342,8 @@ void CCArmature::changeBoneParent(CCBone *bone, const char *parentName)
             m_pTopBoneList->addObject(bone);
         }
     }
+
+    m_bBoneListDirty = true;
 }
 
 CCDictionary *CCArmature::getBoneDic()
@@ -455,15 +469,56 @@ void CCArmature::update(float dt)
 {
     m_pAnimation->update(dt);
 
+    //! The bones of a child armature are placed by the transform of the armature, which must be known to be dirty
+    if (m_pParentBone)
+    {
+        nodeToParentTransform();
+    }
+
+    if (m_bBoneListDirty)
+    {
+        sortBones();
+    }
+
+    //! Parents come before their children, so the bones are updated in a single pass
     CCObject *object = NULL;
-    CCARRAY_FOREACH(m_pTopBoneList, object)
+    CCARRAY_FOREACH(m_pSortedBoneList, object)
     {
-        ((CCBone *)object)->update(dt);
+        ((CCBone *)object)->updateWorldTransform(dt);
+    }
+
+    CCARRAY_FOREACH(m_pSortedBoneList, object)
+    {
+        ((CCBone *)object)->setTransformDirty(false);
     }
 
     m_bArmatureTransformDirty = false;
 }
 
+void CCArmature::sortBones()
+{
+    m_pSortedBoneList->removeAllObjects();
+
+    CCObject *object = NULL;
+    CCARRAY_FOREACH(m_pTopBoneList, object)
+    {
+        addBoneToSortedList((CCBone *)object);
+    }
+
+    m_bBoneListDirty = false;
+}
+
+void CCArmature::addBoneToSortedList(CCBone *bone)
+{
+    m_pSortedBoneList->addObject(bone);
+
+    CCObject *object = NULL;
+    CCARRAY_FOREACH(bone->getChildren(), object)
+    {
+        addBoneToSortedList((CCBone *)object);
+    }
+}
+
 void CCArmature::draw()
 {
     if (m_pParentBone == NULL && m_pBatchNode == NULL)
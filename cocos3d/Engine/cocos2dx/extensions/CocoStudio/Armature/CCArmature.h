@@ -128,6 +128,11 @@ public:
 
     virtual CCAffineTransform nodeToParentTransform();
 
+    /**
+     * Mark the order in which the bones are updated to be rebuilt, after the hierarchy of the bones changed.
+     */
+    inline void setBoneListDirty() { m_bBoneListDirty = true; }
+
     virtual void onEnter();
     virtual void onExit();
 
@@ -176,6 +181,9 @@ protected:
      */
     CCBone *createBone(const char *boneName );
 
+    void sortBones();
+    void addBoneToSortedList(CCBone *bone);
+
     CC_SYNTHESIZE(CCArmatureData *, m_pArmatureData, ArmatureData);
 
     CC_SYNTHESIZE(CCBatchNode *, m_pBatchNode, BatchNode);
@@ -194,6 +202,9 @@ protected:
 
     CCArray *m_pTopBoneList;
 
+    CCArray *m_pSortedBoneList;                  //! All the bones, each one after its parent
+    bool m_bBoneListDirty;                       //! Whether or not m_pSortedBoneList must be rebuilt
+
     static std::map<int, CCArmature *> m_sArmatureIndexDic;	//! Use to save armature zorder info,
 
     ccBlendFunc m_sBlendFunc;                    
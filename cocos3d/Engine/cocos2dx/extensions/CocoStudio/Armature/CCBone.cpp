@@ -180,29 +180,61 @@ CCArmature *CCBone::getArmature()
 
 void CCBone::update(float delta)
 {
+    updateWorldTransform(delta);
+
+    CCObject *object = NULL;
+    CCARRAY_FOREACH(m_pChildren, object)
+    {
+        CCBone *childBone = (CCBone *)object;
+        childBone->update(delta);
+    }
+
+    m_bBoneTransformDirty = false;
+}
+
+void CCBone::updateWorldTransform(float delta)
+{
+    //! The position, scale, rotation or skew of the bone node was changed since the last update
+    if (m_bTransformDirty)
+    {
+        nodeToParentTransform();
+        m_bBoneTransformDirty = true;
+    }
+
     if (m_pParentBone)
         m_bBoneTransformDirty = m_bBoneTransformDirty || m_pParentBone->isTransformDirty();
 
     if (m_pArmatureParentBone && !m_bBoneTransformDirty)
     {
-        m_bBoneTransformDirty = m_pArmatureParentBone->isTransformDirty();
+        m_bBoneTransformDirty = m_pArmatureParentBone->isTransformDirty() || m_pArmature->getArmatureTransformDirty();
     }
 
     if (m_bBoneTransformDirty)
     {
+        //! m_pTweenData is left untouched, so that a bone which is only dirty because of its parent isn't combined twice
+        float x = m_pTweenData->x;
+        float y = m_pTweenData->y;
+        float scaleX = m_pTweenData->scaleX;
+        float scaleY = m_pTweenData->scaleY;
+        float skewX = m_pTweenData->skewX;
+        float skewY = m_pTweenData->skewY;
+
         if (m_fDataVersion >= VERSION_COMBINED)
         {
-            CCTransformHelp::nodeConcat(*m_pTweenData, *m_pBoneData);
-            m_pTweenData->scaleX -= 1;
-            m_pTweenData->scaleY -= 1;
+            x += m_pBoneData->x;
+            y += m_pBoneData->y;
+            scaleX += m_pBoneData->scaleX - 1;
+            scaleY += m_pBoneData->scaleY - 1;
+            skewX += m_pBoneData->skewX;
+            skewY += m_pBoneData->skewY;
         }
 
-        m_tWorldInfo->x = m_pTweenData->x + m_obPosition.x;
-        m_tWorldInfo->y = m_pTweenData->y + m_obPosition.y;
-        m_tWorldInfo->scaleX = m_pTweenData->scaleX * m_fScaleX;
-        m_tWorldInfo->scaleY = m_pTweenData->scaleY * m_fScaleY;
-        m_tWorldInfo->skewX = m_pTweenData->skewX + m_fSkewX + m_fRotationX;
-        m_tWorldInfo->skewY = m_pTweenData->skewY + m_fSkewY - m_fRotationY;
+        m_tWorldInfo->x = x + m_obPosition.x;
+        m_tWorldInfo->y = y + m_obPosition.y;
+        m_tWorldInfo->scaleX = scaleX * m_fScaleX;
+        m_tWorldInfo->scaleY = scaleY * m_fScaleY;
+        m_tWorldInfo->skewX = skewX + m_fSkewX + m_fRotationX;
+        m_tWorldInfo->skewY = skewY + m_fSkewY - m_fRotationY;
 
         if(m_pParentBone)
         {
@@ -225,15 +257,6 @@ void CCBone::update(float delta)
     }
 
     CCDisplayFactory::updateDisplay(this, delta, m_bBoneTransformDirty || m_pArmature->getArmatureTransformDirty());
-
-    CCObject *object = NULL;
-    CCARRAY_FOREACH(m_pChildren, object)
-    {
-        CCBone *childBone = (CCBone *)object;
-        childBone->update(delta);
-    }
-
-    m_bBoneTransformDirty = false;
 }
 
 void CCBone::applyParentTransform(CCBone *parent)
@@ -350,6 +373,12 @@ void CCBone::removeFromParent(bool recursion)
 void CCBone::setParentBone(CCBone *parent)
 {
     m_pParentBone = parent;
+    m_bBoneTransformDirty = true;
+
+    if (m_pArmature)
+    {
+        m_pArmature->setBoneListDirty();
+    }
 }
 
 CCBone *CCBone::getParentBone()
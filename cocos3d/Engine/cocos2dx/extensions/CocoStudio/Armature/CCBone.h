@@ -137,6 +137,12 @@ public:
 
     void update(float delta);
 
+    /**
+     * Update the transform and the display of this bone only, its parent must have been updated before.
+     * The dirty flag is not cleared, as the children of the bone read it.
+     */
+    void updateWorldTransform(float delta);
+
     void updateDisplayedColor(const ccColor3B &parentColor);
     void updateDisplayedOpacity(GLubyte parentOpacity);
 
@@ -121,13 +121,6 @@ void CCTween::play(CCMovementBoneData *movementBoneData, int durationTo, int dur
     CCFrameData *nextKeyFrame = m_pMovementBoneData->getFrameData(0);
     m_pTweenData->displayIndex = nextKeyFrame->displayIndex;
 
-    if (m_pBone->getArmature()->getArmatureData()->dataVersion >= VERSION_COMBINED)
-    {
-        CCTransformHelp::nodeSub(*m_pTweenData, *m_pBone->getBoneData());
-        m_pTweenData->scaleX += 1;
-        m_pTweenData->scaleY += 1;
-    }
-
     if (m_iRawDuration == 0 || m_pMovementBoneData->frameList.count() == 1)
     {
         m_eLoopType = SINGLE_FRAME;
@@ -364,14 +357,26 @@ CCFrameData *CCTween::tweenNodeTo(float percent, CCFrameData *node)
     }
 
 
-    node->x = m_pFrom->x + percent * m_pBetween->x;
-    node->y = m_pFrom->y + percent * m_pBetween->y;
-    node->scaleX = m_pFrom->scaleX + percent * m_pBetween->scaleX;
-    node->scaleY = m_pFrom->scaleY + percent * m_pBetween->scaleY;
-    node->skewX = m_pFrom->skewX + percent * m_pBetween->skewX;
-    node->skewY = m_pFrom->skewY + percent * m_pBetween->skewY;
+    float x = m_pFrom->x + percent * m_pBetween->x;
+    float y = m_pFrom->y + percent * m_pBetween->y;
+    float scaleX = m_pFrom->scaleX + percent * m_pBetween->scaleX;
+    float scaleY = m_pFrom->scaleY + percent * m_pBetween->scaleY;
+    float skewX = m_pFrom->skewX + percent * m_pBetween->skewX;
+    float skewY = m_pFrom->skewY + percent * m_pBetween->skewY;
 
-    m_pBone->setTransformDirty(true);
+    //! A bone which doesn't move between its key frames doesn't need its transform to be computed again
+    if (node->x != x || node->y != y || node->scaleX != scaleX || node->scaleY != scaleY
+        || node->skewX != skewX || node->skewY != skewY)
+    {
+        node->x = x;
+        node->y = y;
+        node->scaleX = scaleX;
+        node->scaleY = scaleY;
+        node->skewX = skewX;
+        node->skewY = skewY;
+
+        m_pBone->setTransformDirty(true);
+    }
 
     if (node && m_pBetween->isUseColorInfo)
     {
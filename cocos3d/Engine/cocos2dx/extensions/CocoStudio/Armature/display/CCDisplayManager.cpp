@@ -292,6 +292,12 @@ void CCDisplayManager::setCurrentDecorativeDisplay(CCDecorativeDisplay *decoDisp
         m_pDisplayRenderNode->release();
     }
 
+    if (m_pDisplayRenderNode != displayRenderNode)
+    {
+        //! the new display has not received the transform of a bone which may not move any more
+        m_pBone->setTransformDirty(true);
+    }
+
     m_pDisplayRenderNode = displayRenderNode;
 
     if(m_pDisplayRenderNode)
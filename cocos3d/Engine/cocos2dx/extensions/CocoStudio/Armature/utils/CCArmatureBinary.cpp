@@ -0,0 +1,796 @@
+/****************************************************************************
+Copyright (c) 2013 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "CCArmatureBinary.h"
+#include <stdio.h>
+#include <string.h>
+
+NS_CC_EXT_BEGIN
+
+static const unsigned int s_recordSizes[kCCArmatureBinarySectionCount] =
+{
+    sizeof(CCArmatureBinaryArmature),
+    sizeof(CCArmatureBinaryBone),
+    sizeof(CCArmatureBinaryDisplay),
+    sizeof(CCArmatureBinaryAnimation),
+    sizeof(CCArmatureBinaryMovement),
+    sizeof(CCArmatureBinaryMovementBone),
+    sizeof(CCArmatureBinaryFrame),
+    sizeof(float),
+    sizeof(CCArmatureBinaryTexture),
+    sizeof(CCArmatureBinaryContour),
+    sizeof(CCArmatureBinaryVertex),
+    sizeof(unsigned int),
+    sizeof(char)
+};
+
+
+CCArmatureBinaryReader::CCArmatureBinaryReader()
+    : m_pData(NULL)
+    , m_uSize(0)
+    , m_pHeader(NULL)
+{
+}
+
+bool CCArmatureBinaryReader::init(const unsigned char *data, unsigned long size)
+{
+    m_pData = NULL;
+    m_uSize = 0;
+    m_pHeader = NULL;
+
+    if (!data || size < sizeof(CCArmatureBinaryHeader) || ((size_t)data % 4) != 0)
+    {
+        return false;
+    }
+
+    const CCArmatureBinaryHeader *header = (const CCArmatureBinaryHeader *)data;
+    if (header->sig[0] != 'C' || header->sig[1] != 'C' || header->sig[2] != 'A' || header->sig[3] != 'B')
+    {
+        return false;
+    }
+    if (header->version != ARMATURE_BINARY_VERSION)
+    {
+        CCLOG("CCArmatureBinaryReader: unsupported version %d", header->version);
+        return false;
+    }
+
+    // the records are read in place, so every section must be aligned and lie within the data
+    for (int i = 0; i < kCCArmatureBinarySectionCount; i++)
+    {
+        const CCArmatureBinarySectionInfo &section = header->sections[i];
+        if ((section.offset % 4) != 0 || section.offset > size
+            || section.count > (size - section.offset) / s_recordSizes[i])
+        {
+            return false;
+        }
+    }
+
+    // the strings are null-terminated, and the offset 0 is the empty string
+    const CCArmatureBinarySectionInfo &strings = header->sections[kCCArmatureBinarySectionStrings];
+    if (strings.count == 0 || data[strings.offset] != 0 || data[strings.offset + strings.count - 1] != 0)
+    {
+        return false;
+    }
+
+    m_pData = data;
+    m_uSize = size;
+    m_pHeader = header;
+
+    if (!checkRecords())
+    {
+        CCLOG("CCArmatureBinaryReader: invalid record");
+        m_pData = NULL;
+        m_uSize = 0;
+        m_pHeader = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool CCArmatureBinaryReader::checkRange(CCArmatureBinarySection section, unsigned int first, unsigned int count) const
+{
+    unsigned int total = m_pHeader->sections[section].count;
+    return first <= total && count <= total - first;
+}
+
+bool CCArmatureBinaryReader::checkString(unsigned int offset) const
+{
+    return offset < m_pHeader->sections[kCCArmatureBinarySectionStrings].count;
+}
+
+bool CCArmatureBinaryReader::checkRecords() const
+{
+    const CCArmatureBinarySectionInfo *sections = m_pHeader->sections;
+
+    const CCArmatureBinaryArmature *armatures = getRecords<CCArmatureBinaryArmature>(kCCArmatureBinarySectionArmatures);
+    for (unsigned int i = 0; i < sections[kCCArmatureBinarySectionArmatures].count; i++)
+    {
+        if (!checkString(armatures[i].name))
+        {
+            return false;
+        }
+        if (!checkRange(kCCArmatureBinarySectionBones, armatures[i].firstBone, armatures[i].boneCount))
+        {
+            return false;
+        }
+    }
+
+    const CCArmatureBinaryBone *bones = getRecords<CCArmatureBinaryBone>(kCCArmatureBinarySectionBones);
+    for (unsigned int i = 0; i < sections[kCCArmatureBinarySectionBones].count; i++)
+    {
+        if (!checkString(bones[i].name) || !checkString(bones[i].parentName))
+        {
+            return false;
+        }
+        if (!checkRange(kCCArmatureBinarySectionDisplays, bones[i].firstDisplay, bones[i].displayCount))
+        {
+            return false;
+        }
+    }
+
+    const CCArmatureBinaryDisplay *displays = getRecords<CCArmatureBinaryDisplay>(kCCArmatureBinarySectionDisplays);
+    for (unsigned int i = 0; i < sections[kCCArmatureBinarySectionDisplays].count; i++)
+    {
+        if (displays[i].displayType < CS_DISPLAY_SPRITE || displays[i].displayType >= CS_DISPLAY_MAX)
+        {
+            return false;
+        }
+        if (!checkString(displays[i].displayName))
+        {
+            return false;
+        }
+    }
+
+    const CCArmatureBinaryAnimation *animations = getRecords<CCArmatureBinaryAnimation>(kCCArmatureBinarySectionAnimations);
+    for (unsigned int i = 0; i < sections[kCCArmatureBinarySectionAnimations].count; i++)
+    {
+        if (!checkString(animations[i].name))
+        {
+            return false;
+        }
+        if (!checkRange(kCCArmatureBinarySectionMovements, animations[i].firstMovement, animations[i].movementCount))
+        {
+            return false;
+        }
+    }
+
+    const CCArmatureBinaryMovement *movements = getRecords<CCArmatureBinaryMovement>(kCCArmatureBinarySectionMovements);
+    for (unsigned int i = 0; i < sections[kCCArmatureBinarySectionMovements].count; i++)
+    {
+        if (!checkString(movements[i].name))
+        {
+            return false;
+        }
+        if (!checkRange(kCCArmatureBinarySectionMovementBones, movements[i].firstMovementBone, movements[i].movementBoneCount))
+        {
+            return false;
+        }
+    }
+
+    const CCArmatureBinaryMovementBone *movementBones = getRecords<CCArmatureBinaryMovementBone>(kCCArmatureBinarySectionMovementBones);
+    for (unsigned int i = 0; i < sections[kCCArmatureBinarySectionMovementBones].count; i++)
+    {
+        if (!checkString(movementBones[i].name))
+        {
+            return false;
+        }
+        if (!checkRange(kCCArmatureBinarySectionFrames, movementBones[i].firstFrame, movementBones[i].frameCount))
+        {
+            return false;
+        }
+    }
+
+    const CCArmatureBinaryFrame *frames = getRecords<CCArmatureBinaryFrame>(kCCArmatureBinarySectionFrames);
+    for (unsigned int i = 0; i < sections[kCCArmatureBinarySectionFrames].count; i++)
+    {
+        const CCArmatureBinaryFrame &frame = frames[i];
+        if (!checkString(frame.strEvent) || !checkString(frame.strMovement)
+            || !checkString(frame.strSound) || !checkString(frame.strSoundEffect))
+        {
+            return false;
+        }
+        if (!checkRange(kCCArmatureBinarySectionEasingParams, frame.firstEasingParam, frame.easingParamCount))
+        {
+            return false;
+        }
+    }
+
+    const CCArmatureBinaryTexture *textures = getRecords<CCArmatureBinaryTexture>(kCCArmatureBinarySectionTextures);
+    for (unsigned int i = 0; i < sections[kCCArmatureBinarySectionTextures].count; i++)
+    {
+        if (!checkString(textures[i].name))
+        {
+            return false;
+        }
+        if (!checkRange(kCCArmatureBinarySectionContours, textures[i].firstContour, textures[i].contourCount))
+        {
+            return false;
+        }
+    }
+
+    const CCArmatureBinaryContour *contours = getRecords<CCArmatureBinaryContour>(kCCArmatureBinarySectionContours);
+    for (unsigned int i = 0; i < sections[kCCArmatureBinarySectionContours].count; i++)
+    {
+        if (!checkRange(kCCArmatureBinarySectionVertices, contours[i].firstVertex, contours[i].vertexCount))
+        {
+            return false;
+        }
+    }
+
+    const unsigned int *configFiles = getRecords<unsigned int>(kCCArmatureBinarySectionConfigFiles);
+    for (unsigned int i = 0; i < sections[kCCArmatureBinarySectionConfigFiles].count; i++)
+    {
+        if (!checkString(configFiles[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+unsigned int CCArmatureBinaryReader::getArmatureCount() const
+{
+    return m_pHeader ? m_pHeader->sections[kCCArmatureBinarySectionArmatures].count : 0;
+}
+
+unsigned int CCArmatureBinaryReader::getAnimationCount() const
+{
+    return m_pHeader ? m_pHeader->sections[kCCArmatureBinarySectionAnimations].count : 0;
+}
+
+unsigned int CCArmatureBinaryReader::getTextureCount() const
+{
+    return m_pHeader ? m_pHeader->sections[kCCArmatureBinarySectionTextures].count : 0;
+}
+
+unsigned int CCArmatureBinaryReader::getConfigFileCount() const
+{
+    return m_pHeader ? m_pHeader->sections[kCCArmatureBinarySectionConfigFiles].count : 0;
+}
+
+const char *CCArmatureBinaryReader::getString(unsigned int offset) const
+{
+    return (const char *)m_pData + m_pHeader->sections[kCCArmatureBinarySectionStrings].offset + offset;
+}
+
+const char *CCArmatureBinaryReader::getConfigFile(unsigned int index) const
+{
+    CCAssert(index < getConfigFileCount(), "index out of range");
+    return getString(getRecords<unsigned int>(kCCArmatureBinarySectionConfigFiles)[index]);
+}
+
+void CCArmatureBinaryReader::readNode(CCBaseData *node, const CCArmatureBinaryNode &record) const
+{
+    node->x = record.x;
+    node->y = record.y;
+    node->skewX = record.skewX;
+    node->skewY = record.skewY;
+    node->scaleX = record.scaleX;
+    node->scaleY = record.scaleY;
+    node->tweenRotate = record.tweenRotate;
+    node->zOrder = record.zOrder;
+    node->isUseColorInfo = record.isUseColorInfo != 0;
+    node->a = record.a;
+    node->r = record.r;
+    node->g = record.g;
+    node->b = record.b;
+}
+
+CCArmatureData *CCArmatureBinaryReader::createArmatureData(unsigned int index) const
+{
+    CCAssert(index < getArmatureCount(), "index out of range");
+
+    const CCArmatureBinaryArmature &armature = getRecords<CCArmatureBinaryArmature>(kCCArmatureBinarySectionArmatures)[index];
+    const CCArmatureBinaryBone *bones = getRecords<CCArmatureBinaryBone>(kCCArmatureBinarySectionBones) + armature.firstBone;
+    const CCArmatureBinaryDisplay *displays = getRecords<CCArmatureBinaryDisplay>(kCCArmatureBinarySectionDisplays);
+
+    CCArmatureData *armatureData = new CCArmatureData();
+    armatureData->init();
+    armatureData->name = getString(armature.name);
+    armatureData->dataVersion = armature.dataVersion;
+
+    for (unsigned int i = 0; i < armature.boneCount; i++)
+    {
+        const CCArmatureBinaryBone &bone = bones[i];
+
+        CCBoneData *boneData = new CCBoneData();
+        boneData->init();
+        readNode(boneData, bone.node);
+        boneData->name = getString(bone.name);
+        boneData->parentName = getString(bone.parentName);
+
+        for (unsigned int j = 0; j < bone.displayCount; j++)
+        {
+            const CCArmatureBinaryDisplay &display = displays[bone.firstDisplay + j];
+
+            CCDisplayData *displayData = NULL;
+            switch (display.displayType)
+            {
+            case CS_DISPLAY_SPRITE:
+            {
+                CCSpriteDisplayData *spriteDisplayData = new CCSpriteDisplayData();
+                readNode(&spriteDisplayData->skinData, display.skinData);
+                displayData = spriteDisplayData;
+                break;
+            }
+            case CS_DISPLAY_ARMATURE:
+                displayData = new CCArmatureDisplayData();
+                break;
+            default:
+                displayData = new CCParticleDisplayData();
+                break;
+            }
+            displayData->displayName = getString(display.displayName);
+
+            boneData->addDisplayData(displayData);
+            displayData->release();
+        }
+
+        armatureData->addBoneData(boneData);
+        boneData->release();
+    }
+
+    return armatureData;
+}
+
+CCAnimationData *CCArmatureBinaryReader::createAnimationData(unsigned int index) const
+{
+    CCAssert(index < getAnimationCount(), "index out of range");
+
+    const CCArmatureBinaryAnimation &animation = getRecords<CCArmatureBinaryAnimation>(kCCArmatureBinarySectionAnimations)[index];
+    const CCArmatureBinaryMovement *movements = getRecords<CCArmatureBinaryMovement>(kCCArmatureBinarySectionMovements) + animation.firstMovement;
+    const CCArmatureBinaryMovementBone *movementBones = getRecords<CCArmatureBinaryMovementBone>(kCCArmatureBinarySectionMovementBones);
+    const CCArmatureBinaryFrame *frames = getRecords<CCArmatureBinaryFrame>(kCCArmatureBinarySectionFrames);
+    const float *easingParams = getRecords<float>(kCCArmatureBinarySectionEasingParams);
+
+    CCAnimationData *aniData = new CCAnimationData();
+    aniData->name = getString(animation.name);
+
+    for (unsigned int i = 0; i < animation.movementCount; i++)
+    {
+        const CCArmatureBinaryMovement &movement = movements[i];
+
+        CCMovementData *movementData = new CCMovementData();
+        movementData->name = getString(movement.name);
+        movementData->duration = movement.duration;
+        movementData->scale = movement.scale;
+        movementData->durationTo = movement.durationTo;
+        movementData->durationTween = movement.durationTween;
+        movementData->loop = movement.loop != 0;
+        movementData->tweenEasing = (CCTweenType)movement.tweenEasing;
+
+        for (unsigned int j = 0; j < movement.movementBoneCount; j++)
+        {
+            const CCArmatureBinaryMovementBone &movementBone = movementBones[movement.firstMovementBone + j];
+
+            CCMovementBoneData *movBoneData = new CCMovementBoneData();
+            movBoneData->init();
+            movBoneData->name = getString(movementBone.name);
+            movBoneData->delay = movementBone.delay;
+            movBoneData->scale = movementBone.scale;
+            movBoneData->duration = movementBone.duration;
+
+            for (unsigned int k = 0; k < movementBone.frameCount; k++)
+            {
+                const CCArmatureBinaryFrame &frame = frames[movementBone.firstFrame + k];
+
+                CCFrameData *frameData = new CCFrameData();
+                readNode(frameData, frame.node);
+                frameData->frameID = frame.frameID;
+                frameData->duration = frame.duration;
+                frameData->tweenEasing = (CCTweenType)frame.tweenEasing;
+                frameData->isTween = frame.isTween != 0;
+                frameData->displayIndex = frame.displayIndex;
+                frameData->blendFunc.src = frame.blendSrc;
+                frameData->blendFunc.dst = frame.blendDst;
+                frameData->strEvent = getString(frame.strEvent);
+                frameData->strMovement = getString(frame.strMovement);
+                frameData->strSound = getString(frame.strSound);
+                frameData->strSoundEffect = getString(frame.strSoundEffect);
+
+                if (frame.easingParamCount > 0)
+                {
+                    frameData->easingParamNumber = frame.easingParamCount;
+                    frameData->easingParams = new float[frame.easingParamCount];
+                    memcpy(frameData->easingParams, easingParams + frame.firstEasingParam, frame.easingParamCount * sizeof(float));
+                }
+
+                movBoneData->addFrameData(frameData);
+                frameData->release();
+            }
+
+            movementData->addMovementBoneData(movBoneData);
+            movBoneData->release();
+        }
+
+        aniData->addMovement(movementData);
+        movementData->release();
+    }
+
+    return aniData;
+}
+
+CCTextureData *CCArmatureBinaryReader::createTextureData(unsigned int index) const
+{
+    CCAssert(index < getTextureCount(), "index out of range");
+
+    const CCArmatureBinaryTexture &texture = getRecords<CCArmatureBinaryTexture>(kCCArmatureBinarySectionTextures)[index];
+    const CCArmatureBinaryContour *contours = getRecords<CCArmatureBinaryContour>(kCCArmatureBinarySectionContours) + texture.firstContour;
+    const CCArmatureBinaryVertex *vertices = getRecords<CCArmatureBinaryVertex>(kCCArmatureBinarySectionVertices);
+
+    CCTextureData *textureData = new CCTextureData();
+    textureData->init();
+    textureData->name = getString(texture.name);
+    textureData->width = texture.width;
+    textureData->height = texture.height;
+    textureData->pivotX = texture.pivotX;
+    textureData->pivotY = texture.pivotY;
+
+    for (unsigned int i = 0; i < texture.contourCount; i++)
+    {
+        const CCArmatureBinaryContour &contour = contours[i];
+
+        CCContourData *contourData = new CCContourData();
+        contourData->init();
+
+        for (unsigned int j = 0; j < contour.vertexCount; j++)
+        {
+            const CCArmatureBinaryVertex &vertex = vertices[contour.firstVertex + j];
+            CCContourVertex2 *vertex2 = new CCContourVertex2(vertex.x, vertex.y);
+            contourData->vertexList.addObject(vertex2);
+            vertex2->release();
+        }
+
+        textureData->addContourData(contourData);
+        contourData->release();
+    }
+
+    return textureData;
+}
+
+
+CCArmatureBinaryWriter::CCArmatureBinaryWriter()
+{
+    m_armatureDatas.init();
+    m_animationDatas.init();
+    m_textureDatas.init();
+
+    // the offset 0 is the empty string
+    m_strings.push_back('\0');
+    m_stringOffsets[""] = 0;
+}
+
+CCArmatureBinaryWriter::~CCArmatureBinaryWriter()
+{
+}
+
+void CCArmatureBinaryWriter::addArmatureData(CCArmatureData *armatureData)
+{
+    m_armatureDatas.addObject(armatureData);
+}
+
+void CCArmatureBinaryWriter::addAnimationData(CCAnimationData *animationData)
+{
+    m_animationDatas.addObject(animationData);
+}
+
+void CCArmatureBinaryWriter::addTextureData(CCTextureData *textureData)
+{
+    m_textureDatas.addObject(textureData);
+}
+
+void CCArmatureBinaryWriter::addConfigFile(const char *configFile)
+{
+    m_configFiles.push_back(configFile);
+}
+
+CCArmatureData *CCArmatureBinaryWriter::getArmatureData(const char *name)
+{
+    CCObject *object = NULL;
+    CCARRAY_FOREACH(&m_armatureDatas, object)
+    {
+        CCArmatureData *armatureData = (CCArmatureData *)object;
+        if (armatureData->name.compare(name) == 0)
+        {
+            return armatureData;
+        }
+    }
+    return NULL;
+}
+
+unsigned int CCArmatureBinaryWriter::addString(const std::string &str)
+{
+    std::map<std::string, unsigned int>::iterator it = m_stringOffsets.find(str);
+    if (it != m_stringOffsets.end())
+    {
+        return it->second;
+    }
+
+    unsigned int offset = m_strings.size();
+    m_strings.append(str.c_str(), str.size() + 1);
+    m_stringOffsets[str] = offset;
+    return offset;
+}
+
+void CCArmatureBinaryWriter::writeNode(CCArmatureBinaryNode &record, CCBaseData *node)
+{
+    record.x = node->x;
+    record.y = node->y;
+    record.skewX = node->skewX;
+    record.skewY = node->skewY;
+    record.scaleX = node->scaleX;
+    record.scaleY = node->scaleY;
+    record.tweenRotate = node->tweenRotate;
+    record.zOrder = node->zOrder;
+    record.isUseColorInfo = node->isUseColorInfo ? 1 : 0;
+    record.a = node->a;
+    record.r = node->r;
+    record.g = node->g;
+    record.b = node->b;
+}
+
+template <typename T>
+static void writeSection(FILE *fp, const std::vector<T> &records)
+{
+    if (!records.empty())
+    {
+        fwrite(&records[0], sizeof(T), records.size(), fp);
+    }
+}
+
+bool CCArmatureBinaryWriter::writeToFile(const char *filePath)
+{
+    std::vector<CCArmatureBinaryArmature> armatures;
+    std::vector<CCArmatureBinaryBone> bones;
+    std::vector<CCArmatureBinaryDisplay> displays;
+    std::vector<CCArmatureBinaryAnimation> animations;
+    std::vector<CCArmatureBinaryMovement> movements;
+    std::vector<CCArmatureBinaryMovementBone> movementBones;
+    std::vector<CCArmatureBinaryFrame> frames;
+    std::vector<float> easingParams;
+    std::vector<CCArmatureBinaryTexture> textures;
+    std::vector<CCArmatureBinaryContour> contours;
+    std::vector<CCArmatureBinaryVertex> vertices;
+    std::vector<unsigned int> configFiles;
+
+    // the children of each record are written right after it, so that they are contiguous
+    CCObject *object = NULL;
+    CCARRAY_FOREACH(&m_armatureDatas, object)
+    {
+        CCArmatureData *armatureData = (CCArmatureData *)object;
+
+        CCArmatureBinaryArmature armature;
+        armature.name = addString(armatureData->name);
+        armature.dataVersion = armatureData->dataVersion;
+        armature.firstBone = bones.size();
+        armature.boneCount = 0;
+
+        CCDictionary *boneDataDic = &armatureData->boneDataDic;
+        CCDictElement *element = NULL;
+        CCDICT_FOREACH(boneDataDic, element)
+        {
+            CCBoneData *boneData = (CCBoneData *)element->getObject();
+
+            CCArmatureBinaryBone bone;
+            writeNode(bone.node, boneData);
+            bone.name = addString(boneData->name);
+            bone.parentName = addString(boneData->parentName);
+            bone.firstDisplay = displays.size();
+            bone.displayCount = boneData->displayDataList.count();
+
+            CCObject *displayObject = NULL;
+            CCARRAY_FOREACH(&boneData->displayDataList, displayObject)
+            {
+                CCDisplayData *displayData = (CCDisplayData *)displayObject;
+
+                CCArmatureBinaryDisplay display;
+                display.displayType = displayData->displayType;
+                display.displayName = addString(displayData->displayName);
+                CCBaseData skinData;
+                writeNode(display.skinData, displayData->displayType == CS_DISPLAY_SPRITE ? &((CCSpriteDisplayData *)displayData)->skinData : &skinData);
+                displays.push_back(display);
+            }
+
+            bones.push_back(bone);
+            armature.boneCount++;
+        }
+
+        armatures.push_back(armature);
+    }
+
+    CCARRAY_FOREACH(&m_animationDatas, object)
+    {
+        CCAnimationData *animationData = (CCAnimationData *)object;
+
+        CCArmatureBinaryAnimation animation;
+        animation.name = addString(animationData->name);
+        animation.firstMovement = movements.size();
+        animation.movementCount = 0;
+
+        for (unsigned int i = 0; i < animationData->movementNames.size(); i++)
+        {
+            CCMovementData *movementData = animationData->getMovement(animationData->movementNames[i].c_str());
+            if (!movementData)
+            {
+                continue;
+            }
+
+            CCArmatureBinaryMovement movement;
+            movement.name = addString(movementData->name);
+            movement.duration = movementData->duration;
+            movement.scale = movementData->scale;
+            movement.durationTo = movementData->durationTo;
+            movement.durationTween = movementData->durationTween;
+            movement.loop = movementData->loop ? 1 : 0;
+            movement.tweenEasing = movementData->tweenEasing;
+            movement.firstMovementBone = movementBones.size();
+            movement.movementBoneCount = 0;
+
+            CCDictionary *movBoneDataDic = &movementData->movBoneDataDic;
+            CCDictElement *element = NULL;
+            CCDICT_FOREACH(movBoneDataDic, element)
+            {
+                CCMovementBoneData *movBoneData = (CCMovementBoneData *)element->getObject();
+
+                CCArmatureBinaryMovementBone movementBone;
+                movementBone.name = addString(movBoneData->name);
+                movementBone.delay = movBoneData->delay;
+                movementBone.scale = movBoneData->scale;
+                movementBone.duration = movBoneData->duration;
+                movementBone.firstFrame = frames.size();
+                movementBone.frameCount = movBoneData->frameList.count();
+
+                CCObject *frameObject = NULL;
+                CCARRAY_FOREACH(&movBoneData->frameList, frameObject)
+                {
+                    CCFrameData *frameData = (CCFrameData *)frameObject;
+
+                    CCArmatureBinaryFrame frame;
+                    writeNode(frame.node, frameData);
+                    frame.frameID = frameData->frameID;
+                    frame.duration = frameData->duration;
+                    frame.tweenEasing = frameData->tweenEasing;
+                    frame.isTween = frameData->isTween ? 1 : 0;
+                    frame.displayIndex = frameData->displayIndex;
+                    frame.blendSrc = frameData->blendFunc.src;
+                    frame.blendDst = frameData->blendFunc.dst;
+                    frame.firstEasingParam = easingParams.size();
+                    frame.easingParamCount = frameData->easingParams ? frameData->easingParamNumber : 0;
+                    frame.strEvent = addString(frameData->strEvent);
+                    frame.strMovement = addString(frameData->strMovement);
+                    frame.strSound = addString(frameData->strSound);
+                    frame.strSoundEffect = addString(frameData->strSoundEffect);
+
+                    easingParams.insert(easingParams.end(), frameData->easingParams, frameData->easingParams + frame.easingParamCount);
+                    frames.push_back(frame);
+                }
+
+                movementBones.push_back(movementBone);
+                movement.movementBoneCount++;
+            }
+
+            movements.push_back(movement);
+            animation.movementCount++;
+        }
+
+        animations.push_back(animation);
+    }
+
+    CCARRAY_FOREACH(&m_textureDatas, object)
+    {
+        CCTextureData *textureData = (CCTextureData *)object;
+
+        CCArmatureBinaryTexture texture;
+        texture.name = addString(textureData->name);
+        texture.width = textureData->width;
+        texture.height = textureData->height;
+        texture.pivotX = textureData->pivotX;
+        texture.pivotY = textureData->pivotY;
+        texture.firstContour = contours.size();
+        texture.contourCount = textureData->contourDataList.count();
+
+        CCObject *contourObject = NULL;
+        CCARRAY_FOREACH(&textureData->contourDataList, contourObject)
+        {
+            CCContourData *contourData = (CCContourData *)contourObject;
+
+            CCArmatureBinaryContour contour;
+            contour.firstVertex = vertices.size();
+            contour.vertexCount = contourData->vertexList.count();
+
+            CCObject *vertexObject = NULL;
+            CCARRAY_FOREACH(&contourData->vertexList, vertexObject)
+            {
+                CCContourVertex2 *vertex2 = (CCContourVertex2 *)vertexObject;
+
+                CCArmatureBinaryVertex vertex;
+                vertex.x = vertex2->x;
+                vertex.y = vertex2->y;
+                vertices.push_back(vertex);
+            }
+
+            contours.push_back(contour);
+        }
+
+        textures.push_back(texture);
+    }
+
+    for (unsigned int i = 0; i < m_configFiles.size(); i++)
+    {
+        configFiles.push_back(addString(m_configFiles[i]));
+    }
+
+    // every record is a multiple of 4 bytes, and the strings come last, so the sections stay aligned
+    CCArmatureBinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    header.sig[0] = 'C';
+    header.sig[1] = 'C';
+    header.sig[2] = 'A';
+    header.sig[3] = 'B';
+    header.version = ARMATURE_BINARY_VERSION;
+
+    unsigned int counts[kCCArmatureBinarySectionCount] =
+    {
+        (unsigned int)armatures.size(), (unsigned int)bones.size(), (unsigned int)displays.size(), (unsigned int)animations.size(),
+        (unsigned int)movements.size(), (unsigned int)movementBones.size(), (unsigned int)frames.size(), (unsigned int)easingParams.size(),
+        (unsigned int)textures.size(), (unsigned int)contours.size(), (unsigned int)vertices.size(), (unsigned int)configFiles.size(),
+        (unsigned int)m_strings.size()
+    };
+    unsigned int offset = sizeof(header);
+    for (int i = 0; i < kCCArmatureBinarySectionCount; i++)
+    {
+        header.sections[i].offset = offset;
+        header.sections[i].count = counts[i];
+        offset += counts[i] * s_recordSizes[i];
+    }
+
+    FILE *fp = fopen(filePath, "wb");
+    if (!fp)
+    {
+        CCLOG("CCArmatureBinaryWriter: can't open %s", filePath);
+        return false;
+    }
+
+    fwrite(&header, sizeof(header), 1, fp);
+    writeSection(fp, armatures);
+    writeSection(fp, bones);
+    writeSection(fp, displays);
+    writeSection(fp, animations);
+    writeSection(fp, movements);
+    writeSection(fp, movementBones);
+    writeSection(fp, frames);
+    writeSection(fp, easingParams);
+    writeSection(fp, textures);
+    writeSection(fp, contours);
+    writeSection(fp, vertices);
+    writeSection(fp, configFiles);
+    fwrite(m_strings.data(), 1, m_strings.size(), fp);
+
+    bool success = ferror(fp) == 0;
+    fclose(fp);
+    return success;
+}
+
+NS_CC_EXT_END
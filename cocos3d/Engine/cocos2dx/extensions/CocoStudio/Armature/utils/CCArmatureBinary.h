@@ -0,0 +1,280 @@
+/****************************************************************************
+Copyright (c) 2013 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCARMATUREBINARY_H__
+#define __CCARMATUREBINARY_H__
+
+#include "CCArmatureDefine.h"
+#include "../datas/CCDatas.h"
+#include <map>
+#include <vector>
+
+NS_CC_EXT_BEGIN
+
+/*
+ * Armature binary format (.ccab)
+ *
+ * The armature, animation and texture datas of a config file, stored as flat arrays of fixed size
+ * records that are read in place, so that loading a file doesn't parse anything. All integers and
+ * floats are 4 bytes, little-endian, and every record is 4-byte aligned.
+ *
+ * A record references its children as a range of the array of their section, and its strings as
+ * an offset in the strings section, where they are null-terminated. The offset 0 is the empty string.
+ *
+ * The values are stored as they were decoded, so the position read scale and the content scale
+ * of the source file are applied when it is converted.
+ * Files are converted with CCDataReaderHelper::convertToBinary.
+ */
+
+#define ARMATURE_BINARY_VERSION 1
+
+enum CCArmatureBinarySection
+{
+    kCCArmatureBinarySectionArmatures,        //! CCArmatureBinaryArmature
+    kCCArmatureBinarySectionBones,            //! CCArmatureBinaryBone
+    kCCArmatureBinarySectionDisplays,         //! CCArmatureBinaryDisplay
+    kCCArmatureBinarySectionAnimations,       //! CCArmatureBinaryAnimation
+    kCCArmatureBinarySectionMovements,        //! CCArmatureBinaryMovement
+    kCCArmatureBinarySectionMovementBones,    //! CCArmatureBinaryMovementBone
+    kCCArmatureBinarySectionFrames,           //! CCArmatureBinaryFrame
+    kCCArmatureBinarySectionEasingParams,     //! float
+    kCCArmatureBinarySectionTextures,         //! CCArmatureBinaryTexture
+    kCCArmatureBinarySectionContours,         //! CCArmatureBinaryContour
+    kCCArmatureBinarySectionVertices,         //! CCArmatureBinaryVertex
+    kCCArmatureBinarySectionConfigFiles,      //! string offset of each config file path
+    kCCArmatureBinarySectionStrings,          //! char
+
+    kCCArmatureBinarySectionCount
+};
+
+struct CCArmatureBinarySectionInfo
+{
+    unsigned int offset;        //! offset of the first record from the start of the file
+    unsigned int count;         //! number of records
+};
+
+struct CCArmatureBinaryHeader
+{
+    unsigned char sig[4];       //! should be 'CCAB'
+    unsigned short version;     //! should be ARMATURE_BINARY_VERSION
+    unsigned short reserved;
+    CCArmatureBinarySectionInfo sections[kCCArmatureBinarySectionCount];
+};
+
+//! CCBaseData
+struct CCArmatureBinaryNode
+{
+    float x, y;
+    float skewX, skewY;
+    float scaleX, scaleY;
+    float tweenRotate;
+    int zOrder;
+    int isUseColorInfo;
+    int a, r, g, b;
+};
+
+struct CCArmatureBinaryArmature
+{
+    unsigned int name;
+    float dataVersion;
+    unsigned int firstBone;
+    unsigned int boneCount;
+};
+
+struct CCArmatureBinaryBone
+{
+    CCArmatureBinaryNode node;
+    unsigned int name;
+    unsigned int parentName;
+    unsigned int firstDisplay;
+    unsigned int displayCount;
+};
+
+struct CCArmatureBinaryDisplay
+{
+    int displayType;
+    unsigned int displayName;
+    CCArmatureBinaryNode skinData;  //! only used by CS_DISPLAY_SPRITE
+};
+
+struct CCArmatureBinaryAnimation
+{
+    unsigned int name;
+    unsigned int firstMovement;     //! in the order of CCAnimationData::movementNames
+    unsigned int movementCount;
+};
+
+struct CCArmatureBinaryMovement
+{
+    unsigned int name;
+    int duration;
+    float scale;
+    int durationTo;
+    int durationTween;
+    int loop;
+    int tweenEasing;
+    unsigned int firstMovementBone;
+    unsigned int movementBoneCount;
+};
+
+struct CCArmatureBinaryMovementBone
+{
+    unsigned int name;
+    float delay;
+    float scale;
+    float duration;
+    unsigned int firstFrame;
+    unsigned int frameCount;
+};
+
+struct CCArmatureBinaryFrame
+{
+    CCArmatureBinaryNode node;
+    int frameID;
+    int duration;
+    int tweenEasing;
+    int isTween;
+    int displayIndex;
+    unsigned int blendSrc;
+    unsigned int blendDst;
+    unsigned int firstEasingParam;
+    unsigned int easingParamCount;
+    unsigned int strEvent;
+    unsigned int strMovement;
+    unsigned int strSound;
+    unsigned int strSoundEffect;
+};
+
+struct CCArmatureBinaryTexture
+{
+    unsigned int name;
+    float width;
+    float height;
+    float pivotX;
+    float pivotY;
+    unsigned int firstContour;
+    unsigned int contourCount;
+};
+
+struct CCArmatureBinaryContour
+{
+    unsigned int firstVertex;
+    unsigned int vertexCount;
+};
+
+struct CCArmatureBinaryVertex
+{
+    float x;
+    float y;
+};
+
+/**
+ *  Reads the datas of an armature binary file in place.
+ *  The data given to init must remain valid while the reader is used.
+ *  @js NA
+ *  @lua NA
+ */
+class CC_EX_DLL CCArmatureBinaryReader
+{
+public:
+    CCArmatureBinaryReader();
+
+    /**
+     * Checks the file, and all the references between its records, so that they can be read without checks.
+     * @param data The content of the file, which must be 4-byte aligned.
+     * @return false if the data isn't a valid armature binary file.
+     */
+    bool init(const unsigned char *data, unsigned long size);
+
+    unsigned int getArmatureCount() const;
+    unsigned int getAnimationCount() const;
+    unsigned int getTextureCount() const;
+    unsigned int getConfigFileCount() const;
+
+    /**
+     * Create the datas stored at the index. As the decode functions of CCDataReaderHelper,
+     * the returned object isn't autoreleased, the caller must release it.
+     */
+    CCArmatureData *createArmatureData(unsigned int index) const;
+    CCAnimationData *createAnimationData(unsigned int index) const;
+    CCTextureData *createTextureData(unsigned int index) const;
+
+    const char *getConfigFile(unsigned int index) const;
+
+private:
+    template <typename T>
+    const T *getRecords(CCArmatureBinarySection section) const
+    {
+        return (const T *)(m_pData + m_pHeader->sections[section].offset);
+    }
+
+    bool checkRange(CCArmatureBinarySection section, unsigned int first, unsigned int count) const;
+    bool checkString(unsigned int offset) const;
+    bool checkRecords() const;
+
+    const char *getString(unsigned int offset) const;
+    void readNode(CCBaseData *node, const CCArmatureBinaryNode &record) const;
+
+    const unsigned char *m_pData;
+    unsigned long m_uSize;
+    const CCArmatureBinaryHeader *m_pHeader;
+};
+
+/**
+ *  Writes datas to an armature binary file.
+ *  @js NA
+ *  @lua NA
+ */
+class CC_EX_DLL CCArmatureBinaryWriter
+{
+public:
+    CCArmatureBinaryWriter();
+    ~CCArmatureBinaryWriter();
+
+    void addArmatureData(CCArmatureData *armatureData);
+    void addAnimationData(CCAnimationData *animationData);
+    void addTextureData(CCTextureData *textureData);
+    void addConfigFile(const char *configFile);
+
+    //! the XML decoder needs the armature of an animation
+    CCArmatureData *getArmatureData(const char *name);
+
+    bool writeToFile(const char *filePath);
+
+private:
+    unsigned int addString(const std::string &str);
+    void writeNode(CCArmatureBinaryNode &record, CCBaseData *node);
+
+    CCArray m_armatureDatas;
+    CCArray m_animationDatas;
+    CCArray m_textureDatas;
+    std::vector<std::string> m_configFiles;
+
+    std::string m_strings;
+    std::map<std::string, unsigned int> m_stringOffsets;
+};
+
+NS_CC_EXT_END
+
+#endif /*__CCARMATUREBINARY_H__*/
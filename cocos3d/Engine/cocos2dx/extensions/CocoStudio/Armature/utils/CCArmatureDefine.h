@@ -39,6 +39,12 @@ THE SOFTWARE.
 #endif // !AUTO_ADD_SPRITE_FRAME_NAME_PREFIX
 
 
+//! the number of threads decoding the files added by CCArmatureDataManager::addArmatureFileInfoAsync
+#ifndef ARMATURE_LOADING_THREAD_COUNT
+#define ARMATURE_LOADING_THREAD_COUNT 4
+#endif // !ARMATURE_LOADING_THREAD_COUNT
+
+
 #define PHYSICS_TYPE 3
 
 #if PHYSICS_TYPE == 1
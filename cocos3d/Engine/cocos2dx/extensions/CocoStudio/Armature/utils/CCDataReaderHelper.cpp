@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include "support/tinyxml2/tinyxml2.h"
 #include "CCDataReaderHelper.h"
 #include "CCArmatureDataManager.h"
+#include "CCArmatureBinary.h"
 #include "CCTransformHelp.h"
 #include "CCUtilMath.h"
 #include "CCArmatureDefine.h"
@@ -157,7 +158,8 @@ enum ConfigType
 {
     DragonBone_XML,
     CocoStudio_JSON,
-	CocoStudio_Binary
+	CocoStudio_Binary,
+    Armature_Binary
 };
 
 
@@ -186,25 +188,25 @@ typedef struct _DataInfo
     std::string    baseFilePath;
     float flashToolVersion;
     float cocoStudioVersion;
+    CCArmatureBinaryWriter *binaryWriter;    //! when converting a file, collects the datas instead of adding them
 } DataInfo;
 
 
-static pthread_t s_loadingThread;
+static pthread_t s_loadingThreads[ARMATURE_LOADING_THREAD_COUNT];
 
-static pthread_mutex_t		s_SleepMutex;
 static pthread_cond_t		s_SleepCondition;
 
 static pthread_mutex_t      s_asyncStructQueueMutex;
 static pthread_mutex_t      s_DataInfoMutex;
 
 static pthread_mutex_t      s_addDataMutex;
-static pthread_mutex_t      s_ReadFileMutex;
 
 static pthread_mutex_t      s_GetFileDataMutex;
 
 #ifdef EMSCRIPTEN
 // Hack to get ASM.JS validation (no undefined symbols allowed).
 #define pthread_cond_signal(_)
+#define pthread_cond_broadcast(_)
 #endif // EMSCRIPTEN
 
 static unsigned long s_nAsyncRefCount = 0;
@@ -215,39 +217,182 @@ static bool need_quit = false;
 static std::queue<AsyncStruct *> *s_pAsyncStructQueue = NULL;
 static std::queue<DataInfo *>   *s_pDataQueue = NULL;
 
-static void addData(AsyncStruct *pAsyncStruct)
+static void addArmatureDataToManager(CCArmatureData *armatureData, DataInfo *dataInfo)
 {
-    std::string fullPath = CCFileUtils::sharedFileUtils()->fullPathForFilename(pAsyncStruct->filename.c_str());
-    unsigned long size;
-    pthread_mutex_lock(&s_GetFileDataMutex);
-	std::string readmode = "r";
-	bool isbinary = pAsyncStruct->configType == CocoStudio_Binary;
-	if(isbinary)
-		readmode += "b";
-	unsigned char *pBytes = CCFileUtils::sharedFileUtils()->getFileData(fullPath.c_str() , readmode.c_str(), &size);
-	CCData data(pBytes, size);
+    if (dataInfo->binaryWriter)
+    {
+        dataInfo->binaryWriter->addArmatureData(armatureData);
+        return;
+    }
+
+    if (dataInfo->asyncStruct)
+    {
+        pthread_mutex_lock(&s_addDataMutex);
+    }
+    CCArmatureDataManager::sharedArmatureDataManager()->addArmatureData(armatureData->name.c_str(), armatureData, dataInfo->filename.c_str());
+    if (dataInfo->asyncStruct)
+    {
+        pthread_mutex_unlock(&s_addDataMutex);
+    }
+}
+
+static void addAnimationDataToManager(CCAnimationData *animationData, DataInfo *dataInfo)
+{
+    if (dataInfo->binaryWriter)
+    {
+        dataInfo->binaryWriter->addAnimationData(animationData);
+        return;
+    }
+
+    if (dataInfo->asyncStruct)
+    {
+        pthread_mutex_lock(&s_addDataMutex);
+    }
+    CCArmatureDataManager::sharedArmatureDataManager()->addAnimationData(animationData->name.c_str(), animationData, dataInfo->filename.c_str());
+    if (dataInfo->asyncStruct)
+    {
+        pthread_mutex_unlock(&s_addDataMutex);
+    }
+}
+
+static void addTextureDataToManager(CCTextureData *textureData, DataInfo *dataInfo)
+{
+    if (dataInfo->binaryWriter)
+    {
+        dataInfo->binaryWriter->addTextureData(textureData);
+        return;
+    }
+
+    if (dataInfo->asyncStruct)
+    {
+        pthread_mutex_lock(&s_addDataMutex);
+    }
+    CCArmatureDataManager::sharedArmatureDataManager()->addTextureData(textureData->name.c_str(), textureData, dataInfo->filename.c_str());
+    if (dataInfo->asyncStruct)
+    {
+        pthread_mutex_unlock(&s_addDataMutex);
+    }
+}
+
+static CCArmatureData *getArmatureDataFromManager(const char *name, DataInfo *dataInfo)
+{
+    if (dataInfo->binaryWriter)
+    {
+        return dataInfo->binaryWriter->getArmatureData(name);
+    }
+
+    // the other loading threads may be adding datas
+    if (dataInfo->asyncStruct)
+    {
+        pthread_mutex_lock(&s_addDataMutex);
+    }
+    CCArmatureData *armatureData = CCArmatureDataManager::sharedArmatureDataManager()->getArmatureData(name);
+    if (dataInfo->asyncStruct)
+    {
+        pthread_mutex_unlock(&s_addDataMutex);
+    }
+    return armatureData;
+}
+
+static bool isAutoLoadSpriteFile(DataInfo *dataInfo)
+{
+    if (dataInfo->binaryWriter)
+    {
+        return true;
+    }
+    return dataInfo->asyncStruct == NULL ? CCArmatureDataManager::sharedArmatureDataManager()->isAutoLoadSpriteFile() : dataInfo->asyncStruct->autoLoadSpriteFile;
+}
+
+static void addConfigFile(const char *path, DataInfo *dataInfo)
+{
+    if (dataInfo->binaryWriter)
+    {
+        dataInfo->binaryWriter->addConfigFile(path);
+        return;
+    }
+
+    std::string filePath = path;
+    filePath = filePath.erase(filePath.find_last_of("."));
+
+    if (dataInfo->asyncStruct)
+    {
+        dataInfo->configFileQueue.push(filePath);
+    }
+    else
+    {
+        std::string plistPath = filePath + ".plist";
+        std::string pngPath =  filePath + ".png";
+
+        CCArmatureDataManager::sharedArmatureDataManager()->addSpriteFrameFromFile((dataInfo->baseFilePath + plistPath).c_str(), (dataInfo->baseFilePath + pngPath).c_str(), dataInfo->filename.c_str());
+    }
+}
+
+static void addDataFromArmatureBinaryFile(const char *filePath, DataInfo *dataInfo)
+{
+    if (dataInfo->asyncStruct)
+    {
+        pthread_mutex_lock(&s_GetFileDataMutex);
+    }
+    // a file stored uncompressed in a mounted archive is read in place
+    unsigned long size = 0;
+    unsigned char *pBytes = NULL;
+    const unsigned char *pData = CCFileUtils::sharedFileUtils()->getMappedFileData(filePath, &size);
+    if (!pData)
+    {
+        std::string fullPath = CCFileUtils::sharedFileUtils()->fullPathForFilename(filePath);
+        pBytes = CCFileUtils::sharedFileUtils()->getFileData(fullPath.c_str(), "rb", &size);
+        pData = pBytes;
+    }
+    if (dataInfo->asyncStruct)
+    {
+        pthread_mutex_unlock(&s_GetFileDataMutex);
+    }
+
+    CCDataReaderHelper::addDataFromArmatureBinary(pData, size, dataInfo);
     CC_SAFE_DELETE_ARRAY(pBytes);
-	pAsyncStruct->fileContent = std::string((const char*)data.getBytes(), data.getSize());
-    pthread_mutex_unlock(&s_GetFileDataMutex);
+}
 
+static void addData(AsyncStruct *pAsyncStruct)
+{
     // generate data info
     DataInfo *pDataInfo = new DataInfo();
     pDataInfo->asyncStruct = pAsyncStruct;
     pDataInfo->filename = pAsyncStruct->filename;
     pDataInfo->baseFilePath = pAsyncStruct->baseFilePath;
+    pDataInfo->binaryWriter = NULL;
 
-    if (pAsyncStruct->configType == DragonBone_XML)
+    if (pAsyncStruct->configType == Armature_Binary)
     {
-        CCDataReaderHelper::addDataFromCache(pAsyncStruct->fileContent.c_str(), pDataInfo);
+        addDataFromArmatureBinaryFile(pAsyncStruct->filename.c_str(), pDataInfo);
     }
-    else if(pAsyncStruct->configType == CocoStudio_JSON)
+    else
     {
-        CCDataReaderHelper::addDataFromJsonCache(pAsyncStruct->fileContent.c_str(), pDataInfo);
+        unsigned long size;
+        pthread_mutex_lock(&s_GetFileDataMutex);
+        std::string fullPath = CCFileUtils::sharedFileUtils()->fullPathForFilename(pAsyncStruct->filename.c_str());
+        std::string readmode = "r";
+        bool isbinary = pAsyncStruct->configType == CocoStudio_Binary;
+        if(isbinary)
+            readmode += "b";
+        unsigned char *pBytes = CCFileUtils::sharedFileUtils()->getFileData(fullPath.c_str() , readmode.c_str(), &size);
+        CCData data(pBytes, size);
+        CC_SAFE_DELETE_ARRAY(pBytes);
+        pAsyncStruct->fileContent = std::string((const char*)data.getBytes(), data.getSize());
+        pthread_mutex_unlock(&s_GetFileDataMutex);
+
+        if (pAsyncStruct->configType == DragonBone_XML)
+        {
+            CCDataReaderHelper::addDataFromCache(pAsyncStruct->fileContent.c_str(), pDataInfo);
+        }
+        else if(pAsyncStruct->configType == CocoStudio_JSON)
+        {
+            CCDataReaderHelper::addDataFromJsonCache(pAsyncStruct->fileContent.c_str(), pDataInfo);
+        }
+        else if(isbinary)
+        {
+            CCDataReaderHelper::addDataFromBinaryCache(pAsyncStruct->fileContent.c_str(),pDataInfo);
+        }
     }
-	else if(isbinary)
-	{
-		CCDataReaderHelper::addDataFromBinaryCache(pAsyncStruct->fileContent.c_str(),pDataInfo);
-	}
 
     // put the image info into the queue
     pthread_mutex_lock(&s_DataInfoMutex);
@@ -259,53 +404,37 @@ static void *loadData(void *)
 {
     while (true)
     {
-        // create autorelease pool for iOS
-        CCThread thread;
-        thread.createAutoreleasePool();
-
-        std::queue<AsyncStruct *> *pQueue = s_pAsyncStructQueue;
-        pthread_mutex_lock(&s_asyncStructQueueMutex);// get async struct from queue
-        if (pQueue->empty())
+        // get async struct from queue, the loading threads sleep while it is empty
+        pthread_mutex_lock(&s_asyncStructQueueMutex);
+        while (s_pAsyncStructQueue->empty() && !need_quit)
         {
-            pthread_mutex_unlock(&s_asyncStructQueueMutex);
-            if (need_quit)
-            {
-                break;
-            }
-            else
-            {
-                pthread_cond_wait(&s_SleepCondition, &s_SleepMutex);
-                continue;
-            }
+            pthread_cond_wait(&s_SleepCondition, &s_asyncStructQueueMutex);
         }
-        else
+        if (need_quit)
         {
-            AsyncStruct *pAsyncStruct = pQueue->front();
-            pQueue->pop();
             pthread_mutex_unlock(&s_asyncStructQueueMutex);
-            addData(pAsyncStruct);
-       }
-    }
+            break;
+        }
+        AsyncStruct *pAsyncStruct = s_pAsyncStructQueue->front();
+        s_pAsyncStructQueue->pop();
+        pthread_mutex_unlock(&s_asyncStructQueueMutex);
 
-    if( s_pAsyncStructQueue != NULL )
-    {
-        delete s_pAsyncStructQueue;
-        s_pAsyncStructQueue = NULL;
-        delete s_pDataQueue;
-        s_pDataQueue = NULL;
+        // create autorelease pool for iOS
+        CCThread thread;
+        thread.createAutoreleasePool();
 
-        pthread_mutex_destroy(&s_asyncStructQueueMutex);
-        pthread_mutex_destroy(&s_DataInfoMutex);
-        pthread_mutex_destroy(&s_SleepMutex);
-        pthread_mutex_destroy(&s_addDataMutex);
-        pthread_mutex_destroy(&s_ReadFileMutex);
-        pthread_mutex_destroy(&s_GetFileDataMutex);
-        pthread_cond_destroy(&s_SleepCondition);
+        addData(pAsyncStruct);
     }
 
     return NULL;
 }
 
+static void deleteAsyncStruct(AsyncStruct *pAsyncStruct)
+{
+    CC_SAFE_RELEASE(pAsyncStruct->target);
+    delete pAsyncStruct;
+}
+
 
 CCDataReaderHelper *CCDataReaderHelper::sharedDataReaderHelper()
 {
@@ -337,8 +466,47 @@ void CCDataReaderHelper::purge()
 
 CCDataReaderHelper::~CCDataReaderHelper()
 {
+    if (s_pAsyncStructQueue == NULL)
+    {
+        return;
+    }
+
+    // the loading threads finish the file they are loading, and leave the others
+    pthread_mutex_lock(&s_asyncStructQueueMutex);
     need_quit = true;
-    pthread_cond_signal(&s_SleepCondition);
+    pthread_mutex_unlock(&s_asyncStructQueueMutex);
+    pthread_cond_broadcast(&s_SleepCondition);
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8)
+    for (int i = 0; i < ARMATURE_LOADING_THREAD_COUNT; i++)
+    {
+        pthread_join(s_loadingThreads[i], NULL);
+    }
+#endif
+
+    while (!s_pAsyncStructQueue->empty())
+    {
+        deleteAsyncStruct(s_pAsyncStructQueue->front());
+        s_pAsyncStructQueue->pop();
+    }
+    while (!s_pDataQueue->empty())
+    {
+        deleteAsyncStruct(s_pDataQueue->front()->asyncStruct);
+        delete s_pDataQueue->front();
+        s_pDataQueue->pop();
+    }
+    delete s_pAsyncStructQueue;
+    s_pAsyncStructQueue = NULL;
+    delete s_pDataQueue;
+    s_pDataQueue = NULL;
+    s_nAsyncRefCount = 0;
+    s_nAsyncRefTotalCount = 0;
+
+    pthread_mutex_destroy(&s_asyncStructQueueMutex);
+    pthread_mutex_destroy(&s_DataInfoMutex);
+    pthread_mutex_destroy(&s_addDataMutex);
+    pthread_mutex_destroy(&s_GetFileDataMutex);
+    pthread_cond_destroy(&s_SleepCondition);
 }
 
 void CCDataReaderHelper::addDataFromFile(const char *filePath)
@@ -373,6 +541,18 @@ void CCDataReaderHelper::addDataFromFile(const char *filePath)
     size_t startPos = filePathStr.find_last_of(".");
     std::string str = &filePathStr[startPos];
 
+    DataInfo dataInfo;
+    dataInfo.filename = filePathStr;
+    dataInfo.asyncStruct = NULL;
+    dataInfo.baseFilePath = basefilePath;
+    dataInfo.binaryWriter = NULL;
+
+    if (str.compare(".ccab") == 0)
+    {
+        addDataFromArmatureBinaryFile(filePath, &dataInfo);
+        return;
+    }
+
     unsigned long size;
     std::string fullPath = CCFileUtils::sharedFileUtils()->fullPathForFilename(filePath);
     unsigned char *pBytes = NULL;
@@ -386,12 +566,6 @@ void CCDataReaderHelper::addDataFromFile(const char *filePath)
 		pBytes = CCFileUtils::sharedFileUtils()->getFileData(fullPath.c_str() , "r", &size);
 	}
 
-
-    DataInfo dataInfo;
-    dataInfo.filename = filePathStr;
-    dataInfo.asyncStruct = NULL;
-    dataInfo.baseFilePath = basefilePath;
-
 	std::string load_str = std::string((const char*)pBytes, size);
     if (str.compare(".xml") == 0)
     {
@@ -408,6 +582,57 @@ void CCDataReaderHelper::addDataFromFile(const char *filePath)
 	CC_SAFE_DELETE_ARRAY(pBytes);
 }
 
+bool CCDataReaderHelper::convertToBinary(const char *filePath, const char *binaryFilePath)
+{
+    std::string filePathStr =  filePath;
+    size_t startPos = filePathStr.find_last_of(".");
+    if (startPos == std::string::npos)
+    {
+        return false;
+    }
+    std::string str = &filePathStr[startPos];
+
+    unsigned long size = 0;
+    std::string fullPath = CCFileUtils::sharedFileUtils()->fullPathForFilename(filePath);
+    unsigned char *pBytes = CCFileUtils::sharedFileUtils()->getFileData(fullPath.c_str(), str.compare(".csb") == 0 ? "rb" : "r", &size);
+    if (!pBytes)
+    {
+        return false;
+    }
+
+    // the datas are decoded as for loading, but collected by the writer
+    CCArmatureBinaryWriter writer;
+
+    DataInfo dataInfo;
+    dataInfo.filename = filePathStr;
+    dataInfo.asyncStruct = NULL;
+    dataInfo.baseFilePath = "";
+    dataInfo.binaryWriter = &writer;
+
+    bool supported = true;
+    std::string load_str = std::string((const char*)pBytes, size);
+    if (str.compare(".xml") == 0)
+    {
+        CCDataReaderHelper::addDataFromCache(load_str.c_str(), &dataInfo);
+    }
+    else if(str.compare(".json") == 0 || str.compare(".ExportJson") == 0)
+    {
+        CCDataReaderHelper::addDataFromJsonCache(load_str.c_str(), &dataInfo);
+    }
+    else if(str.compare(".csb") == 0)
+    {
+        CCDataReaderHelper::addDataFromBinaryCache(load_str.c_str(), &dataInfo);
+    }
+    else
+    {
+        CCLOG("CCDataReaderHelper: can't convert %s", filePath);
+        supported = false;
+    }
+    CC_SAFE_DELETE_ARRAY(pBytes);
+
+    return supported && writer.writeToFile(binaryFilePath);
+}
+
 void CCDataReaderHelper::addDataFromFileAsync(const char *imagePath, const char *plistPath, const char *filePath, CCObject *target, SEL_SCHEDULE selector)
 {
 #ifdef EMSCRIPTEN
@@ -459,15 +684,17 @@ void CCDataReaderHelper::addDataFromFileAsync(const char *imagePath, const char
 
         pthread_mutex_init(&s_asyncStructQueueMutex, NULL);
         pthread_mutex_init(&s_DataInfoMutex, NULL);
-        pthread_mutex_init(&s_SleepMutex, NULL);
         pthread_mutex_init(&s_addDataMutex, NULL);
-        pthread_mutex_init(&s_ReadFileMutex, NULL);
         pthread_mutex_init(&s_GetFileDataMutex, NULL);
         pthread_cond_init(&s_SleepCondition, NULL);
+        need_quit = false;
  #if (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8)
-        pthread_create(&s_loadingThread, NULL, loadData, NULL);
+        // the files are decoded in parallel, each by one of the loading threads
+        for (int i = 0; i < ARMATURE_LOADING_THREAD_COUNT; i++)
+        {
+            pthread_create(&s_loadingThreads[i], NULL, loadData, NULL);
+        }
 #endif
-        need_quit = false;
     }
 
     if (0 == s_nAsyncRefCount)
@@ -510,6 +737,10 @@ void CCDataReaderHelper::addDataFromFileAsync(const char *imagePath, const char
 	{
 		data->configType = CocoStudio_Binary;
 	}
+    else if (str.compare(".ccab") == 0)
+    {
+        data->configType = Armature_Binary;
+    }
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8)
     // add async struct into queue
@@ -530,16 +761,18 @@ void CCDataReaderHelper::addDataFromFileAsync(const char *imagePath, const char
 
 void CCDataReaderHelper::addDataAsyncCallBack(float dt)
 {
-    // the data is generated in loading thread
+    // the data is generated in loading threads, add all the files they have finished
     std::queue<DataInfo *> *dataQueue = s_pDataQueue;
 
-    pthread_mutex_lock(&s_DataInfoMutex);
-    if (dataQueue->empty())
-    {
-        pthread_mutex_unlock(&s_DataInfoMutex);
-    }
-    else
+    while (true)
     {
+        pthread_mutex_lock(&s_DataInfoMutex);
+        if (dataQueue->empty())
+        {
+            pthread_mutex_unlock(&s_DataInfoMutex);
+            break;
+        }
+
         DataInfo *pDataInfo = dataQueue->front();
         dataQueue->pop();
         pthread_mutex_unlock(&s_DataInfoMutex);
@@ -571,11 +804,10 @@ void CCDataReaderHelper::addDataAsyncCallBack(float dt)
         if (target && selector)
         {
             (target->*selector)((s_nAsyncRefTotalCount - s_nAsyncRefCount) / (float)s_nAsyncRefTotalCount);
-            target->release();
         }
 
 
-        delete pAsyncStruct;
+        deleteAsyncStruct(pAsyncStruct);
         delete pDataInfo;
 
         if (0 == s_nAsyncRefCount)
@@ -626,16 +858,8 @@ void CCDataReaderHelper::addDataFromCache(const char *pFileContent, DataInfo *da
     {
         CCArmatureData *armatureData = CCDataReaderHelper::decodeArmature(armatureXML, dataInfo);
 
-        if (dataInfo->asyncStruct)
-        {
-            pthread_mutex_lock(&s_addDataMutex);
-        }
-        CCArmatureDataManager::sharedArmatureDataManager()->addArmatureData(armatureData->name.c_str(), armatureData, dataInfo->filename.c_str());
+        addArmatureDataToManager(armatureData, dataInfo);
         armatureData->release();
-        if (dataInfo->asyncStruct)
-        {
-            pthread_mutex_unlock(&s_addDataMutex);
-        }
 
         armatureXML = armatureXML->NextSiblingElement(ARMATURE);
     }
@@ -649,16 +873,8 @@ void CCDataReaderHelper::addDataFromCache(const char *pFileContent, DataInfo *da
     while(animationXML)
     {
         CCAnimationData *animationData = CCDataReaderHelper::decodeAnimation(animationXML, dataInfo);
-        if (dataInfo->asyncStruct)
-        {
-            pthread_mutex_lock(&s_addDataMutex);
-        }
-        CCArmatureDataManager::sharedArmatureDataManager()->addAnimationData(animationData->name.c_str(), animationData, dataInfo->filename.c_str());
+        addAnimationDataToManager(animationData, dataInfo);
         animationData->release();
-        if (dataInfo->asyncStruct)
-        {
-            pthread_mutex_unlock(&s_addDataMutex);
-        }
         animationXML = animationXML->NextSiblingElement(ANIMATION);
     }
 
@@ -672,16 +888,8 @@ void CCDataReaderHelper::addDataFromCache(const char *pFileContent, DataInfo *da
     {
         CCTextureData *textureData = CCDataReaderHelper::decodeTexture(textureXML, dataInfo);
 
-        if (dataInfo->asyncStruct)
-        {
-            pthread_mutex_lock(&s_addDataMutex);
-        }
-        CCArmatureDataManager::sharedArmatureDataManager()->addTextureData(textureData->name.c_str(), textureData, dataInfo->filename.c_str());
+        addTextureDataToManager(textureData, dataInfo);
         textureData->release();
-        if (dataInfo->asyncStruct)
-        {
-            pthread_mutex_unlock(&s_addDataMutex);
-        }
         textureXML = textureXML->NextSiblingElement(SUB_TEXTURE);
     }
 }
@@ -805,7 +1013,7 @@ CCAnimationData *CCDataReaderHelper::decodeAnimation(tinyxml2::XMLElement *anima
 
     const char	*name = animationXML->Attribute(A_NAME);
 
-    CCArmatureData *armatureData = CCArmatureDataManager::sharedArmatureDataManager()->getArmatureData(name);
+    CCArmatureData *armatureData = getArmatureDataFromManager(name, dataInfo);
 
     aniData->name = name;
 
@@ -1317,16 +1525,8 @@ void CCDataReaderHelper::addDataFromJsonCache(const char *fileContent, DataInfo
 		const rapidjson::Value &armatureDic = DICTOOL->getSubDictionary_json(json, ARMATURE_DATA, i); 
         CCArmatureData *armatureData = decodeArmature(armatureDic, dataInfo);
 
-        if (dataInfo->asyncStruct)
-        {
-            pthread_mutex_lock(&s_addDataMutex);
-        }
-        CCArmatureDataManager::sharedArmatureDataManager()->addArmatureData(armatureData->name.c_str(), armatureData, dataInfo->filename.c_str());
+        addArmatureDataToManager(armatureData, dataInfo);
         armatureData->release();
-        if (dataInfo->asyncStruct)
-        {
-            pthread_mutex_unlock(&s_addDataMutex);
-        }
         //delete armatureDic;
     }
 
@@ -1337,16 +1537,8 @@ void CCDataReaderHelper::addDataFromJsonCache(const char *fileContent, DataInfo
 		const rapidjson::Value &animationDic = DICTOOL->getSubDictionary_json(json, ANIMATION_DATA, i);
         CCAnimationData *animationData = decodeAnimation(animationDic, dataInfo);
 
-        if (dataInfo->asyncStruct)
-        {
-            pthread_mutex_lock(&s_addDataMutex);
-        }
-        CCArmatureDataManager::sharedArmatureDataManager()->addAnimationData(animationData->name.c_str(), animationData, dataInfo->filename.c_str());
+        addAnimationDataToManager(animationData, dataInfo);
         animationData->release();
-        if (dataInfo->asyncStruct)
-        {
-            pthread_mutex_unlock(&s_addDataMutex);
-        }
     }
 
     // Decode textures
@@ -1356,22 +1548,13 @@ void CCDataReaderHelper::addDataFromJsonCache(const char *fileContent, DataInfo
         const rapidjson::Value &textureDic =  DICTOOL->getSubDictionary_json(json, TEXTURE_DATA, i); 
         CCTextureData *textureData = decodeTexture(textureDic);
 
-        if (dataInfo->asyncStruct)
-        {
-            pthread_mutex_lock(&s_addDataMutex);
-        }
-        CCArmatureDataManager::sharedArmatureDataManager()->addTextureData(textureData->name.c_str(), textureData, dataInfo->filename.c_str());
+        addTextureDataToManager(textureData, dataInfo);
         textureData->release();
-        if (dataInfo->asyncStruct)
-        {
-            pthread_mutex_unlock(&s_addDataMutex);
-        }
         //delete textureDic;
     }
 
     // Auto load sprite file
-    bool autoLoad = dataInfo->asyncStruct == NULL ? CCArmatureDataManager::sharedArmatureDataManager()->isAutoLoadSpriteFile() : dataInfo->asyncStruct->autoLoadSpriteFile;
-    if (autoLoad)
+    if (isAutoLoadSpriteFile(dataInfo))
     {
         length =  DICTOOL->getArrayCount_json(json, CONFIG_FILE_PATH); 
         for (int i = 0; i < length; i++)
@@ -1383,20 +1566,7 @@ void CCDataReaderHelper::addDataFromJsonCache(const char *fileContent, DataInfo
                 return;
             }
 
-            std::string filePath = path;
-            filePath = filePath.erase(filePath.find_last_of("."));
-
-            if (dataInfo->asyncStruct)
-            {
-                dataInfo->configFileQueue.push(filePath);
-            }
-            else
-            {
-                std::string plistPath = filePath + ".plist";
-                std::string pngPath =  filePath + ".png";
-
-                CCArmatureDataManager::sharedArmatureDataManager()->addSpriteFrameFromFile((dataInfo->baseFilePath + plistPath).c_str(), (dataInfo->baseFilePath + pngPath).c_str(), dataInfo->filename.c_str());
-            }
+            addConfigFile(path, dataInfo);
         }
     }
 }
@@ -1834,16 +2004,8 @@ void CCDataReaderHelper::addDataFromBinaryCache(const char *fileContent, DataInf
 					for (int i = 0; i < length; ++i)
 					{
 						armatureData = decodeArmature(&tCocoLoader, &pDataArray[i], dataInfo);
-						if (dataInfo->asyncStruct)
-						{
-							pthread_mutex_lock(&s_addDataMutex);
-						}
-						CCArmatureDataManager::sharedArmatureDataManager()->addArmatureData(armatureData->name.c_str(), armatureData, dataInfo->filename.c_str());
+						addArmatureDataToManager(armatureData, dataInfo);
 						armatureData->release();
-						if (dataInfo->asyncStruct)
-						{
-							pthread_mutex_unlock(&s_addDataMutex);
-						}
 					}
 				}
 				else if ( 0 == key.compare(ANIMATION_DATA))
@@ -1854,16 +2016,8 @@ void CCDataReaderHelper::addDataFromBinaryCache(const char *fileContent, DataInf
 					for (int i = 0; i < length; ++i)
 					{
 						animationData = decodeAnimation(&tCocoLoader, &pDataArray[i], dataInfo);
-						if (dataInfo->asyncStruct)
-						{
-							pthread_mutex_lock(&s_addDataMutex);
-						}
-						CCArmatureDataManager::sharedArmatureDataManager()->addAnimationData(animationData->name.c_str(), animationData, dataInfo->filename.c_str());
+						addAnimationDataToManager(animationData, dataInfo);
 						animationData->release();
-						if (dataInfo->asyncStruct)
-						{
-							pthread_mutex_unlock(&s_addDataMutex);
-						}
 					}
 				}
 				else if (key.compare(TEXTURE_DATA) == 0)
@@ -1873,22 +2027,13 @@ void CCDataReaderHelper::addDataFromBinaryCache(const char *fileContent, DataInf
 					for (int i = 0; i < length; ++i)
 					{
 						CCTextureData *textureData = decodeTexture(&tCocoLoader, &pDataArray[i]);
-						if (dataInfo->asyncStruct)
-						{
-							pthread_mutex_lock(&s_addDataMutex);
-						}
-						CCArmatureDataManager::sharedArmatureDataManager()->addTextureData(textureData->name.c_str(), textureData, dataInfo->filename.c_str());
+						addTextureDataToManager(textureData, dataInfo);
 						textureData->release();
-						if (dataInfo->asyncStruct)
-						{
-							pthread_mutex_unlock(&s_addDataMutex);
-						}
 					}
 				}
 			}
 			// Auto losprite file
-			bool autoLoad = dataInfo->asyncStruct == NULL ? CCArmatureDataManager::sharedArmatureDataManager()->isAutoLoadSpriteFile() : dataInfo->asyncStruct->autoLoadSpriteFile;
-			if (autoLoad)
+			if (isAutoLoadSpriteFile(dataInfo))
 			{
 				for (int i = 0; i < nCount; ++i)
 				{
@@ -1908,20 +2053,7 @@ void CCDataReaderHelper::addDataFromBinaryCache(const char *fileContent, DataInf
 							return;
 						}
 
-						std::string filePath = path;
-						filePath = filePath.erase(filePath.find_last_of("."));
-
-						if (dataInfo->asyncStruct)
-						{
-							dataInfo->configFileQueue.push(filePath);
-						}
-						else
-						{
-							std::string plistPath = filePath + ".plist";
-							std::string pngPath =  filePath + ".png";
-
-							CCArmatureDataManager::sharedArmatureDataManager()->addSpriteFrameFromFile((dataInfo->baseFilePath + plistPath).c_str(), (dataInfo->baseFilePath + pngPath).c_str(), dataInfo->filename.c_str());
-						}
+						addConfigFile(path, dataInfo);
 					}
 				}
 			}
@@ -2641,4 +2773,44 @@ void CCDataReaderHelper::decodeNode(CCBaseData *node, CocoLoader *pCocoLoader, s
 	}
 }
 
+void CCDataReaderHelper::addDataFromArmatureBinary(const unsigned char *data, unsigned long size, DataInfo *dataInfo)
+{
+    CCArmatureBinaryReader reader;
+    if (!reader.init(data, size))
+    {
+        CCLOG("%s is not a valid armature binary file", dataInfo->filename.c_str());
+        return;
+    }
+
+    // the records are read in place, there is nothing to parse
+    for (unsigned int i = 0; i < reader.getArmatureCount(); i++)
+    {
+        CCArmatureData *armatureData = reader.createArmatureData(i);
+        addArmatureDataToManager(armatureData, dataInfo);
+        armatureData->release();
+    }
+
+    for (unsigned int i = 0; i < reader.getAnimationCount(); i++)
+    {
+        CCAnimationData *animationData = reader.createAnimationData(i);
+        addAnimationDataToManager(animationData, dataInfo);
+        animationData->release();
+    }
+
+    for (unsigned int i = 0; i < reader.getTextureCount(); i++)
+    {
+        CCTextureData *textureData = reader.createTextureData(i);
+        addTextureDataToManager(textureData, dataInfo);
+        textureData->release();
+    }
+
+    if (isAutoLoadSpriteFile(dataInfo))
+    {
+        for (unsigned int i = 0; i < reader.getConfigFileCount(); i++)
+        {
+            addConfigFile(reader.getConfigFile(i), dataInfo);
+        }
+    }
+}
+
 NS_CC_EXT_END
@@ -62,7 +62,15 @@ public:
 public:
     ~CCDataReaderHelper();
 
+    /**
+     * Add the datas of a config file: .xml, .json, .ExportJson, .csb,
+     * or .ccab, the armature binary format which is read in place (see CCArmatureBinary.h).
+     */
     void addDataFromFile(const char *filePath);
+    /**
+     * Add the datas of a config file in one of the loading threads, which decode several files in parallel.
+     * The selector is called with the percentage of the files loaded.
+     */
     void addDataFromFileAsync(const char *imagePath, const char *plistPath, const char *filePath, CCObject *target, SEL_SCHEDULE selector);
 
     void addDataAsyncCallBack(float dt);
@@ -140,6 +148,23 @@ public:
 
 	static void decodeNode(CCBaseData *node, CocoLoader *pCocoLoader, stExpCocoNode *pCocoNode, DataInfo *dataInfo);
 
+public:
+    /**
+     * Add the datas of an armature binary file.
+     * @param data The content of the file, which must be 4-byte aligned.
+     */
+    static void addDataFromArmatureBinary(const unsigned char *data, unsigned long size, DataInfo *dataInfo = NULL);
+
+    /**
+     * Convert a .xml, .json, .ExportJson or .csb config file to the armature binary format.
+     * The position read scale is applied to the converted datas.
+     *
+     * @param filePath The config file to convert
+     * @param binaryFilePath The full path of the .ccab file to write
+     * @return false if the config file can't be read, or the binary file written
+     */
+    static bool convertToBinary(const char *filePath, const char *binaryFilePath);
+
 private:
     static std::vector<std::string> s_arrConfigFileList;
 
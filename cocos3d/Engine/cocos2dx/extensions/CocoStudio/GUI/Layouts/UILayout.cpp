@@ -253,6 +253,7 @@ void Layout::stencilClippingVisit()
     GLenum currentStencilFail = GL_KEEP;
     GLenum currentStencilPassDepthFail = GL_KEEP;
     GLenum currentStencilPassDepthPass = GL_KEEP;
+    CCAutoBatcher::flushShared();
     currentStencilEnabled = glIsEnabled(GL_STENCIL_TEST);
     glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint *)&currentStencilWriteMask);
     glGetIntegerv(GL_STENCIL_FUNC, (GLint *)&currentStencilFunc);
@@ -285,11 +286,13 @@ void Layout::stencilClippingVisit()
     kmGLPushMatrix();
     transform();
     _clippingStencil->visit();
+    CCAutoBatcher::flushShared();
     kmGLPopMatrix();
     glDepthMask(currentDepthWriteMask);
     glStencilFunc(GL_EQUAL, mask_layer_le, mask_layer_le);
     glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
     CCNode::visit();
+    CCAutoBatcher::flushShared();
     glStencilFunc(currentStencilFunc, currentStencilRef, currentStencilValueMask);
     glStencilOp(currentStencilFail, currentStencilPassDepthFail, currentStencilPassDepthPass);
     glStencilMask(currentStencilWriteMask);
@@ -303,12 +306,14 @@ void Layout::stencilClippingVisit()
 void Layout::scissorClippingVisit()
 {
     CCRect clippingRect = getClippingRect();
+    CCAutoBatcher::flushShared();
     if (_handleScissor)
     {
         glEnable(GL_SCISSOR_TEST);
     }
     CCEGLView::sharedOpenGLView()->setScissorInPoints(clippingRect.origin.x, clippingRect.origin.y, clippingRect.size.width, clippingRect.size.height);
     CCNode::visit();
+    CCAutoBatcher::flushShared();
     if (_handleScissor)
     {
         glDisable(GL_SCISSOR_TEST);
@@ -129,6 +129,11 @@ void ListView::updateInnerContainerSize()
 }
 
 void ListView::remedyLayoutParameter(Widget *item)
+{
+    remedyLayoutParameter(item, getIndex(item));
+}
+
+void ListView::remedyLayoutParameter(Widget *item, int index)
 {
     if (!item)
     {
@@ -154,7 +159,7 @@ void ListView::remedyLayoutParameter(Widget *item)
                     default:
                         break;
                 }
-                if (getIndex(item) == 0)
+                if (index == 0)
                 {
                     defaultLp->setMargin(MarginZero);
                 }
@@ -166,7 +171,7 @@ void ListView::remedyLayoutParameter(Widget *item)
             }
             else
             {
-                if (getIndex(item) == 0)
+                if (index == 0)
                 {
                     llp->setMargin(MarginZero);
                 }
@@ -209,7 +214,7 @@ void ListView::remedyLayoutParameter(Widget *item)
                     default:
                         break;
                 }
-                if (getIndex(item) == 0)
+                if (index == 0)
                 {
                     defaultLp->setMargin(MarginZero);
                 }
@@ -221,7 +226,7 @@ void ListView::remedyLayoutParameter(Widget *item)
             }
             else
             {
-                if (getIndex(item) == 0)
+                if (index == 0)
                 {
                     llp->setMargin(MarginZero);
                 }
@@ -259,7 +264,7 @@ void ListView::pushBackDefaultItem()
     }
     Widget* newItem = _model->clone();
     _items->addObject(newItem);
-    remedyLayoutParameter(newItem);
+    remedyLayoutParameter(newItem, _items->count() - 1);
     addChild(newItem);
     _refreshViewDirty = true;
 }
@@ -272,7 +277,7 @@ void ListView::insertDefaultItem(int index)
     }
     Widget* newItem = _model->clone();
     _items->insertObject(newItem, index);
-    remedyLayoutParameter(newItem);
+    remedyLayoutParameter(newItem, index);
     addChild(newItem);
     _refreshViewDirty = true;
 }
@@ -280,7 +285,7 @@ void ListView::insertDefaultItem(int index)
 void ListView::pushBackCustomItem(Widget* item)
 {
     _items->addObject(item);
-    remedyLayoutParameter(item);
+    remedyLayoutParameter(item, _items->count() - 1);
     addChild(item);
     _refreshViewDirty = true;
 }
@@ -288,7 +293,7 @@ void ListView::pushBackCustomItem(Widget* item)
 void ListView::insertCustomItem(Widget* item, int index)
 {
     _items->insertObject(item, index);
-    remedyLayoutParameter(item);
+    remedyLayoutParameter(item, index);
     addChild(item);
     _refreshViewDirty = true;
 }
@@ -396,7 +401,7 @@ void ListView::refreshView()
     {
         Widget* item = static_cast<Widget*>(arrayItems->arr[i]);
         item->setZOrder(i);
-        remedyLayoutParameter(item);
+        remedyLayoutParameter(item, i);
     }
     updateInnerContainerSize();
 }
@@ -411,6 +416,128 @@ void ListView::sortAllChildren()
     }
 }
     
+void ListView::getItemsInSight(int* start, int* end)
+{
+    ccArray* arrayItems = _items->data;
+    int length = arrayItems->num;
+    int low = 0;
+    int high = length;
+    switch (_direction)
+    {
+        case SCROLLVIEW_DIR_VERTICAL:
+        {
+            // the items go down from the top of the inner container
+            float offset = _innerContainer->getBottomInParent();
+            while (low < high)
+            {
+                int mid = low + (high - low) / 2;
+                if (static_cast<Widget*>(arrayItems->arr[mid])->getBottomInParent() + offset >= _size.height)
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+            *start = low;
+            high = length;
+            while (low < high)
+            {
+                int mid = low + (high - low) / 2;
+                if (static_cast<Widget*>(arrayItems->arr[mid])->getTopInParent() + offset > 0.0f)
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+            *end = low;
+            break;
+        }
+        case SCROLLVIEW_DIR_HORIZONTAL:
+        {
+            float offset = _innerContainer->getLeftInParent();
+            while (low < high)
+            {
+                int mid = low + (high - low) / 2;
+                if (static_cast<Widget*>(arrayItems->arr[mid])->getRightInParent() + offset <= 0.0f)
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+            *start = low;
+            high = length;
+            while (low < high)
+            {
+                int mid = low + (high - low) / 2;
+                if (static_cast<Widget*>(arrayItems->arr[mid])->getLeftInParent() + offset < _size.width)
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+            *end = low;
+            break;
+        }
+        default:
+            *start = 0;
+            *end = length;
+            break;
+    }
+}
+
+void ListView::visit()
+{
+    if (!_enabled || !isVisible() || !_clippingEnabled || _items->count() == 0)
+    {
+        ScrollView::visit();
+        return;
+    }
+    
+    // lay the items out before looking for the ones in sight
+    sortAllChildren();
+    _innerContainer->sortAllChildren();
+    
+    int start = 0;
+    int end = 0;
+    getItemsInSight(&start, &end);
+    
+    // hide the items out of sight for the time of the visit only, leaving their visibility untouched
+    ccArray* arrayItems = _items->data;
+    int length = arrayItems->num;
+    for (int i=0; i<length; i++)
+    {
+        if (i >= start && i < end)
+        {
+            continue;
+        }
+        Widget* item = static_cast<Widget*>(arrayItems->arr[i]);
+        if (item->isVisible())
+        {
+            item->setVisible(false);
+            _culledItems.push_back(item);
+        }
+    }
+    
+    ScrollView::visit();
+    
+    for (std::vector<Widget*>::iterator it = _culledItems.begin(); it != _culledItems.end(); ++it)
+    {
+        (*it)->setVisible(true);
+    }
+    _culledItems.clear();
+}
+    
 void ListView::addEventListenerListView(CCObject *target, SEL_ListViewEvent selector)
 {
     _listViewEventListener = target;
@@ -27,6 +27,7 @@
 #define __UILISTVIEW_H__
 
 #include "UIScrollView.h"
+#include <vector>
 
 NS_CC_BEGIN
 
@@ -157,6 +158,12 @@ public:
     
     virtual void sortAllChildren();
     
+    /**
+     * When clipping is enabled, only visits the items in sight, which are found
+     * by binary search since the items are laid out in order.
+     */
+    virtual void visit();
+    
     int getCurSelectedIndex() const;
     
     void addEventListenerListView(CCObject* target, SEL_ListViewEvent selector);
@@ -191,6 +198,8 @@ protected:
     virtual bool init();
     void updateInnerContainerSize();
     void remedyLayoutParameter(Widget* item);
+    void remedyLayoutParameter(Widget* item, int index);
+    void getItemsInSight(int* start, int* end);
     virtual void onSizeChanged();
     virtual Widget* createCloneInstance();
     virtual void copySpecialProperties(Widget* model);
@@ -207,6 +216,7 @@ protected:
     int _curSelectedIndex;
     bool _refreshViewDirty;
     CCArray* _items;
+    std::vector<Widget*> _culledItems;
 };
 
 }
@@ -497,6 +497,8 @@ void CCScrollView::beforeDraw()
 {
     if (m_bClippingToBounds)
     {
+        // the sprites queued so far must not be clipped
+        CCAutoBatcher::flushShared();
 		m_bScissorRestored = false;
         CCRect frame = getViewRect();
         if (CCEGLView::sharedOpenGLView()->isScissorEnabled()) {
@@ -526,6 +528,7 @@ void CCScrollView::afterDraw()
 {
     if (m_bClippingToBounds)
     {
+        CCAutoBatcher::flushShared();
         if (m_bScissorRestored) {//restore the parent's scissor rect
             CCEGLView::sharedOpenGLView()->setScissorInPoints(m_tParentScissorRect.origin.x, m_tParentScissorRect.origin.y, m_tParentScissorRect.size.width, m_tParentScissorRect.size.height);
         }
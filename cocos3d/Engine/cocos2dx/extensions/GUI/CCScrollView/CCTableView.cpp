@@ -69,6 +69,8 @@ bool CCTableView::initWithViewSize(CCSize size, CCNode* container/* = NULL*/)
 CCTableView::CCTableView()
 : m_pTouchedCell(NULL)
 , m_pIndices(NULL)
+, m_uVisibleStartIdx(CC_INVALID_INDEX)
+, m_uVisibleEndIdx(CC_INVALID_INDEX)
 , m_pCellsUsed(NULL)
 , m_pCellsFreed(NULL)
 , m_pDataSource(NULL)
@@ -125,9 +127,10 @@ void CCTableView::reloadData()
     m_pCellsUsed->release();
     m_pCellsUsed = new CCArrayForObjectSorting();
 
+    m_uVisibleStartIdx = CC_INVALID_INDEX;
     this->_updateCellPositions();
     this->_updateContentSize();
-    if (m_pDataSource->numberOfCellsInTableView(this) > 0)
+    if (this->_cellsCount() > 0)
     {
         this->scrollViewDidScroll(this);
     }
@@ -151,12 +154,15 @@ void CCTableView::updateCellAtIndex(unsigned int idx)
     {
         return;
     }
-    unsigned int uCountOfItems = m_pDataSource->numberOfCellsInTableView(this);
+    unsigned int uCountOfItems = this->_cellsCount();
     if (0 == uCountOfItems || idx > uCountOfItems-1)
     {
         return;
     }
 
+    // the cell may be out of sight, which the next scroll has to check
+    m_uVisibleStartIdx = CC_INVALID_INDEX;
+
     CCTableViewCell* cell = this->cellAtIndex(idx);
     if (cell)
     {
@@ -180,29 +186,30 @@ void CCTableView::insertCellAtIndex(unsigned  int idx)
         return;
     }
 
-    CCTableViewCell* cell = NULL;
-    int newIdx = 0;
-
-    cell = (CCTableViewCell*)m_pCellsUsed->objectWithObjectID(idx);
-    if (cell)
+    unsigned int uOldCount = this->_cellsCount();
+    if (!m_vCellsPositions.empty() && uOldCount + 1 == uCountOfItems)
     {
-        newIdx = m_pCellsUsed->indexOfSortedObject(cell);
-        for (unsigned int i=newIdx; i<m_pCellsUsed->count(); i++)
+        // only the cells after the new one move, by its size
+        const CCSize cellSize = m_pDataSource->tableCellSizeForIndex(this, idx);
+        float size = (this->getDirection() == kCCScrollViewDirectionHorizontal) ? cellSize.width : cellSize.height;
+        float position = m_vCellsPositions[idx];
+        m_vCellsPositions.insert(m_vCellsPositions.begin() + idx, position);
+        for (unsigned int i = idx + 1; i <= uCountOfItems; i++)
         {
-            cell = (CCTableViewCell*)m_pCellsUsed->objectAtIndex(i);
-            this->_setIndexForCell(cell->getIdx()+1, cell);
+            m_vCellsPositions[i] += size;
         }
     }
+    else
+    {
+        this->_updateCellPositions();
+    }
+    this->_updateContentSize();
 
- //   [m_pIndices shiftIndexesStartingAtIndex:idx by:1];
-
-    //insert a new cell
-    cell = m_pDataSource->tableCellAtIndex(this, idx);
-    this->_setIndexForCell(idx, cell);
-    this->_addCellIfNecessary(cell);
+    this->_updateCellIndexes(idx, 1);
 
-    this->_updateCellPositions();
-    this->_updateContentSize();
+    //insert the new cell if it is in sight
+    m_uVisibleStartIdx = CC_INVALID_INDEX;
+    this->_updateVisibleCells();
 }
 
 void CCTableView::removeCellAtIndex(unsigned int idx)
@@ -212,33 +219,69 @@ void CCTableView::removeCellAtIndex(unsigned int idx)
         return;
     }
 
-    unsigned int uCountOfItems = m_pDataSource->numberOfCellsInTableView(this);
-    if (0 == uCountOfItems || idx > uCountOfItems-1)
+    unsigned int uOldCount = this->_cellsCount();
+    if (idx >= uOldCount)
     {
         return;
     }
 
-    unsigned int newIdx = 0;
-
+    //remove first
     CCTableViewCell* cell = this->cellAtIndex(idx);
-    if (!cell)
+    if (cell)
     {
-        return;
+        this->_moveCellOutOfSight(cell);
+    }
+
+    unsigned int uCountOfItems = m_pDataSource->numberOfCellsInTableView(this);
+    if (uCountOfItems + 1 == uOldCount)
+    {
+        // only the cells after the removed one move, by its size
+        float size = m_vCellsPositions[idx + 1] - m_vCellsPositions[idx];
+        m_vCellsPositions.erase(m_vCellsPositions.begin() + idx + 1);
+        for (unsigned int i = idx + 1; i <= uCountOfItems; i++)
+        {
+            m_vCellsPositions[i] -= size;
+        }
+    }
+    else
+    {
+        this->_updateCellPositions();
     }
+    this->_updateContentSize();
 
-    newIdx = m_pCellsUsed->indexOfSortedObject(cell);
+    this->_updateCellIndexes(idx + 1, -1);
 
-    //remove first
-    this->_moveCellOutOfSight(cell);
+    //fill the room left by the removed cell
+    m_uVisibleStartIdx = CC_INVALID_INDEX;
+    this->_updateVisibleCells();
+}
 
-    m_pIndices->erase(idx);
-    this->_updateCellPositions();
-//    [m_pIndices shiftIndexesStartingAtIndex:idx+1 by:-1];
-    for (unsigned int i=m_pCellsUsed->count()-1; i > newIdx; i--)
+void CCTableView::updateCellSizeAtIndex(unsigned int idx)
+{
+    unsigned int uCountOfItems = this->_cellsCount();
+    if (idx >= uCountOfItems)
     {
-        cell = (CCTableViewCell*)m_pCellsUsed->objectAtIndex(i);
-        this->_setIndexForCell(cell->getIdx()-1, cell);
+        return;
+    }
+
+    const CCSize cellSize = m_pDataSource->tableCellSizeForIndex(this, idx);
+    float size = (this->getDirection() == kCCScrollViewDirectionHorizontal) ? cellSize.width : cellSize.height;
+    float delta = size - (m_vCellsPositions[idx + 1] - m_vCellsPositions[idx]);
+    if (delta == 0.0f)
+    {
+        return;
     }
+
+    for (unsigned int i = idx + 1; i <= uCountOfItems; i++)
+    {
+        m_vCellsPositions[i] += delta;
+    }
+    this->_updateContentSize();
+
+    this->_updateCellIndexes(idx, 0);
+
+    m_uVisibleStartIdx = CC_INVALID_INDEX;
+    this->_updateVisibleCells();
 }
 
 CCTableViewCell *CCTableView::dequeueCell()
@@ -256,6 +299,24 @@ CCTableViewCell *CCTableView::dequeueCell()
     return cell;
 }
 
+CCTableViewCell *CCTableView::dequeueCell(const char* identifier)
+{
+    const char* reuseIdentifier = identifier ? identifier : "";
+    unsigned int count = m_pCellsFreed->count();
+    for (unsigned int i = 0; i < count; i++)
+    {
+        CCTableViewCell* cell = (CCTableViewCell*)m_pCellsFreed->objectAtIndex(i);
+        if (cell->getReuseIdentifier() == reuseIdentifier)
+        {
+            cell->retain();
+            m_pCellsFreed->removeObjectAtIndex(i);
+            cell->autorelease();
+            return cell;
+        }
+    }
+    return NULL;
+}
+
 void CCTableView::_addCellIfNecessary(CCTableViewCell * cell)
 {
     if (cell->getParent() != this->getContainer())
@@ -270,7 +331,7 @@ void CCTableView::_addCellIfNecessary(CCTableViewCell * cell)
 void CCTableView::_updateContentSize()
 {
     CCSize size = CCSizeZero;
-    unsigned int cellsCount = m_pDataSource->numberOfCellsInTableView(this);
+    unsigned int cellsCount = this->_cellsCount();
 
     if (cellsCount > 0)
     {
@@ -308,10 +369,13 @@ CCPoint CCTableView::_offsetFromIndex(unsigned int index)
 {
     CCPoint offset = this->__offsetFromIndex(index);
 
-    const CCSize cellSize = m_pDataSource->tableCellSizeForIndex(this, index);
     if (m_eVordering == kCCTableViewFillTopDown)
     {
-        offset.y = this->getContainer()->getContentSize().height - offset.y - cellSize.height;
+        // the positions only hold the heights of the cells when they are laid out vertically
+        float cellHeight = (this->getDirection() == kCCScrollViewDirectionHorizontal)
+            ? m_pDataSource->tableCellSizeForIndex(this, index).height
+            : m_vCellsPositions[index + 1] - m_vCellsPositions[index];
+        offset.y = this->getContainer()->getContentSize().height - offset.y - cellHeight;
     }
     return offset;
 }
@@ -337,7 +401,7 @@ CCPoint CCTableView::__offsetFromIndex(unsigned int index)
 unsigned int CCTableView::_indexFromOffset(CCPoint offset)
 {
     int index = 0;
-    const int maxIdx = m_pDataSource->numberOfCellsInTableView(this)-1;
+    const int maxIdx = this->_cellsCount()-1;
 
     if (m_eVordering == kCCTableViewFillTopDown)
     {
@@ -359,7 +423,7 @@ unsigned int CCTableView::_indexFromOffset(CCPoint offset)
 int CCTableView::__indexFromOffset(CCPoint offset)
 {
     int low = 0;
-    int high = m_pDataSource->numberOfCellsInTableView(this) - 1;
+    int high = this->_cellsCount() - 1;
     float search;
     switch (this->getDirection())
     {
@@ -448,10 +512,27 @@ void CCTableView::_updateCellPositions() {
 
 }
 
+void CCTableView::_updateCellIndexes(unsigned int fromIdx, int shift)
+{
+    // the cells before fromIdx move too when the cells are filled top down, since the container resized
+    m_pIndices->clear();
+    CCObject* pObj = NULL;
+    CCARRAY_FOREACH(m_pCellsUsed, pObj)
+    {
+        CCTableViewCell* cell = (CCTableViewCell*)pObj;
+        unsigned int idx = cell->getIdx();
+        if (idx >= fromIdx)
+        {
+            idx += shift;
+        }
+        this->_setIndexForCell(idx, cell);
+        m_pIndices->insert(idx);
+    }
+}
+
 void CCTableView::scrollViewDidScroll(CCScrollView* view)
 {
-    unsigned int uCountOfItems = m_pDataSource->numberOfCellsInTableView(this);
-    if (0 == uCountOfItems)
+    if (0 == this->_cellsCount())
     {
         return;
     }
@@ -460,6 +541,17 @@ void CCTableView::scrollViewDidScroll(CCScrollView* view)
         m_pTableViewDelegate->scrollViewDidScroll(this);
     }
 
+    this->_updateVisibleCells();
+}
+
+void CCTableView::_updateVisibleCells()
+{
+    unsigned int uCountOfItems = this->_cellsCount();
+    if (0 == uCountOfItems)
+    {
+        return;
+    }
+
     unsigned int startIdx = 0, endIdx = 0, idx = 0, maxIdx = 0;
     CCPoint offset = ccpMult(this->getContentOffset(), -1);
     maxIdx = MAX(uCountOfItems-1, 0);
@@ -490,6 +582,12 @@ void CCTableView::scrollViewDidScroll(CCScrollView* view)
 		endIdx = uCountOfItems - 1;
 	}
 
+    // most scroll events don't bring a new cell in sight
+    if (startIdx == m_uVisibleStartIdx && endIdx == m_uVisibleEndIdx)
+    {
+        return;
+    }
+
 #if 0 // For Testing.
     CCObject* pObj;
     int i = 0;
@@ -559,6 +657,9 @@ void CCTableView::scrollViewDidScroll(CCScrollView* view)
         }
         this->updateCellAtIndex(i);
     }
+
+    m_uVisibleStartIdx = startIdx;
+    m_uVisibleEndIdx = endIdx;
 }
 
 void CCTableView::ccTouchEnded(CCTouch *pTouch, CCEvent *pEvent)
@@ -195,17 +195,24 @@ public:
      */
     void updateCellAtIndex(unsigned int idx);
     /**
-     * Inserts a new cell at a given index
+     * Inserts a new cell at a given index. The data source must already hold the new cell.
      *
      * @param idx location to insert
      */
     void insertCellAtIndex(unsigned int idx);
     /**
-     * Removes a cell at a given index
+     * Removes a cell at a given index. The data source must no longer hold the cell.
      *
      * @param idx index to find a cell
      */
     void removeCellAtIndex(unsigned int idx);
+    /**
+     * Updates the size of the cell at a given index, moving the cells after it.
+     * Much cheaper than reloadData when a single cell changes its size.
+     *
+     * @param idx index of the cell whose size changed
+     */
+    void updateCellSizeAtIndex(unsigned int idx);
     /**
      * reloads data from data source.  the view will be refreshed.
      */
@@ -216,6 +223,13 @@ public:
      * @return free cell
      */
     CCTableViewCell *dequeueCell();
+    /**
+     * Dequeues a free cell with the given reuse identifier if available. nil if not.
+     *
+     * @param identifier the reuse identifier of the cell
+     * @return free cell
+     */
+    CCTableViewCell *dequeueCell(const char* identifier);
 
     /**
      * Returns an existing cell at a given index. Returns nil if a cell is nonexistent at the moment of query.
@@ -248,9 +262,15 @@ protected:
     std::set<unsigned int>* m_pIndices;
 
     /**
-     * vector with all cell positions
+     * vector with all cell positions, plus the end of the last cell.
+     * The size of a cell is the difference between two consecutive positions.
      */
     std::vector<float> m_vCellsPositions;
+    /**
+     * range of the indexes in sight at the last update of the cells
+     */
+    unsigned int m_uVisibleStartIdx;
+    unsigned int m_uVisibleEndIdx;
     //NSMutableIndexSet *indices_;
     /**
      * cells that are currently in the table
@@ -281,6 +301,9 @@ protected:
     void _addCellIfNecessary(CCTableViewCell * cell);
 
     void _updateCellPositions();
+    void _updateVisibleCells();
+    void _updateCellIndexes(unsigned int fromIdx, int shift);
+    unsigned int _cellsCount() { return m_vCellsPositions.empty() ? 0 : (unsigned int)m_vCellsPositions.size() - 1; }
 public:
     void _updateContentSize();
     
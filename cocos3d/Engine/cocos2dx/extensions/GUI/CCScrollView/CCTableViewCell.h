@@ -28,6 +28,7 @@
 
 #include "base_nodes/CCNode.h"
 #include "CCSorting.h"
+#include <string>
 
 NS_CC_EXT_BEGIN
 
@@ -51,8 +52,16 @@ public:
 
     void setObjectID(unsigned int uIdx);
     unsigned int getObjectID();
+
+    /**
+     * The identifier of the kind of cell, shared by the cells built from the same template.
+     * A freed cell is only returned by CCTableView::dequeueCell(identifier) for its own identifier.
+     */
+    const std::string& getReuseIdentifier() { return m_strReuseIdentifier; }
+    void setReuseIdentifier(const char* identifier) { m_strReuseIdentifier = identifier ? identifier : ""; }
 private:
     unsigned int m_uIdx;
+    std::string m_strReuseIdentifier;
 };
 
 NS_CC_EXT_END
@@ -36,6 +36,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <sqlite3.h>
+#include "LocalStorageCache.h"
 
 static int _initialized = 0;
 static sqlite3 *_db;
@@ -44,9 +45,6 @@ static sqlite3_stmt *_stmt_remove;
 static sqlite3_stmt *_stmt_update;
 
 
-static void localStorageLazyInit();
-static void localStorageCreateTable();
-
 static void localStorageCreateTable()
 {
 	const char *sql_createtable = "CREATE TABLE IF NOT EXISTS data(key TEXT PRIMARY KEY,value TEXT);";
@@ -70,6 +68,11 @@ void localStorageInit( const char *fullpath)
 		else
 			ret = sqlite3_open(fullpath, &_db);
 
+		// with a write-ahead log, a commit appends to the log instead of rewriting the database and its journal,
+		// and is only synced at checkpoints. A commit may be lost on power failure, but the database can't be corrupted.
+		if (fullpath)
+			sqlite3_exec(_db, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;", NULL, NULL, NULL);
+
 		localStorageCreateTable();
 
 		// SELECT
@@ -90,12 +93,15 @@ void localStorageInit( const char *fullpath)
 		}
 		
 		_initialized = 1;
+		localStorageCacheInit();
 	}
 }
 
 void localStorageFree()
 {
 	if( _initialized ) {
+		localStorageCacheFree();
+
 		sqlite3_finalize(_stmt_select);
 		sqlite3_finalize(_stmt_remove);
 		sqlite3_finalize(_stmt_update);		
@@ -106,53 +112,47 @@ void localStorageFree()
 	}
 }
 
-/** sets an item in the LS */
-void localStorageSetItem( const char *key, const char *value)
-{
-	assert( _initialized );
-	
-	int ok = sqlite3_bind_text(_stmt_update, 1, key, -1, SQLITE_TRANSIENT);
-	ok |= sqlite3_bind_text(_stmt_update, 2, value, -1, SQLITE_TRANSIENT);
-
-	ok |= sqlite3_step(_stmt_update);
-	
-	ok |= sqlite3_reset(_stmt_update);
-	
-	if( ok != SQLITE_OK && ok != SQLITE_DONE)
-		printf("Error in localStorage.setItem()\n");
-}
-
-/** gets an item from the LS */
-const char* localStorageGetItem( const char *key )
+void localStorageReadItem( const char *key, LocalStorageItem &item )
 {
-	assert( _initialized );
-
 	int ok = sqlite3_reset(_stmt_select);
 
 	ok |= sqlite3_bind_text(_stmt_select, 1, key, -1, SQLITE_TRANSIENT);
-	ok |= sqlite3_step(_stmt_select);
-	const unsigned char *ret = sqlite3_column_text(_stmt_select, 0);
-	
+	int step = sqlite3_step(_stmt_select);
+	ok |= step;
+	const unsigned char *ret = (step == SQLITE_ROW) ? sqlite3_column_text(_stmt_select, 0) : NULL;
 
 	if( ok != SQLITE_OK && ok != SQLITE_DONE && ok != SQLITE_ROW)
 		printf("Error in localStorage.getItem()\n");
 
-	return (const char*)ret;
+	item.exists = (ret != NULL);
+	item.value = ret ? (const char*)ret : "";
+	sqlite3_reset(_stmt_select);
 }
 
-/** removes an item from the LS */
-void localStorageRemoveItem( const char *key )
+bool localStorageWriteItems( const LocalStorageItems &items )
 {
-	assert( _initialized );
-
-	int ok = sqlite3_bind_text(_stmt_remove, 1, key, -1, SQLITE_TRANSIENT);
-	
-	ok |= sqlite3_step(_stmt_remove);
-	
-	ok |= sqlite3_reset(_stmt_remove);
+	if (sqlite3_exec(_db, "BEGIN;", NULL, NULL, NULL) != SQLITE_OK)
+		return false;
+
+	bool ok = true;
+	for (LocalStorageItems::const_iterator it = items.begin(); ok && it != items.end(); ++it)
+	{
+		sqlite3_stmt *stmt = it->second.exists ? _stmt_update : _stmt_remove;
+
+		ok = sqlite3_bind_text(stmt, 1, it->first.c_str(), -1, SQLITE_STATIC) == SQLITE_OK;
+		if (ok && it->second.exists)
+			ok = sqlite3_bind_text(stmt, 2, it->second.value.c_str(), -1, SQLITE_STATIC) == SQLITE_OK;
+		if (ok)
+			ok = sqlite3_step(stmt) == SQLITE_DONE;
+		sqlite3_reset(stmt);
+	}
 
-	if( ok != SQLITE_OK && ok != SQLITE_DONE)
-		printf("Error in localStorage.removeItem()\n");
+	// a batch is written entirely or not at all
+	if (ok)
+		ok = sqlite3_exec(_db, "COMMIT;", NULL, NULL, NULL) == SQLITE_OK;
+	if (!ok)
+		sqlite3_exec(_db, "ROLLBACK;", NULL, NULL, NULL);
+	return ok;
 }
 
 #endif // #if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
@@ -49,4 +49,28 @@ CC_EX_DLL const char* localStorageGetItem( const char *key );
 /** removes an item from the LS */
 CC_EX_DLL void localStorageRemoveItem( const char *key );
 
+/** starts a transaction. The items set until the matching localStorageCommitTransaction are written at once,
+    which is much faster than writing them one by one. Transactions can be nested. */
+CC_EX_DLL void localStorageBeginTransaction();
+
+/** commits the transaction started by the matching localStorageBeginTransaction */
+CC_EX_DLL void localStorageCommitTransaction();
+
+/** sets how long the items set may wait before being written, in seconds. The items set in the meantime
+    are written at once, at the latest when the application goes to the background.
+    0, the default, writes each item when it is set. */
+CC_EX_DLL void localStorageSetFlushInterval( float interval );
+
+/** writes the items waiting to be written. On the platforms that don't post EVENT_COME_TO_BACKGROUND,
+    call it in AppDelegate::applicationDidEnterBackground when a flush interval is set.
+    If the write fails, none of the items is written, and they are written again by the next flush. */
+CC_EX_DLL void localStorageFlush();
+
+/** sets several items in the LS at once. The items with a NULL value are removed. */
+CC_EX_DLL void localStorageSetItems( const char **keys, const char **values, int count );
+
+/** gets several items from the LS at once, as localStorageGetItem does.
+    The values remain valid until their item is set or removed. */
+CC_EX_DLL void localStorageGetItems( const char **keys, const char **values, int count );
+
 #endif // __JSB_LOCALSTORAGE_H
@@ -38,6 +38,8 @@
 #include <string>
 #include "jni.h"
 #include "jni/JniHelper.h"
+#include "LocalStorage.h"
+#include "LocalStorageCache.h"
 
 USING_NS_CC;
 static int _initialized = 0;
@@ -70,6 +72,7 @@ void localStorageInit( const char *fullpath)
 	            t.env->DeleteLocalRef(t.classID);
                 if (ret) {
                     _initialized = 1;
+                    localStorageCacheInit();
                 }
 	        }
 		
@@ -79,6 +82,7 @@ void localStorageInit( const char *fullpath)
 void localStorageFree()
 {
 	if( _initialized ) {
+		localStorageCacheFree();
 		
 		JniMethodInfo t;
         
@@ -92,53 +96,53 @@ void localStorageFree()
 	}
 }
 
-/** sets an item in the LS */
-void localStorageSetItem( const char *key, const char *value)
+void localStorageReadItem( const char *key, LocalStorageItem &item )
 {
-	assert( _initialized );
-	
     JniMethodInfo t;
-
-    if (JniHelper::getStaticMethodInfo(t, "org/cocos2dx/lib/Cocos2dxLocalStorage", "setItem", "(Ljava/lang/String;Ljava/lang/String;)V")) {
-        jstring jkey = t.env->NewStringUTF(key);
-        jstring jvalue = t.env->NewStringUTF(value);
-        t.env->CallStaticVoidMethod(t.classID, t.methodID, jkey, jvalue);
-        t.env->DeleteLocalRef(jkey);
-        t.env->DeleteLocalRef(jvalue);
-        t.env->DeleteLocalRef(t.classID);
-    }
-}
-
-/** gets an item from the LS */
-const char* localStorageGetItem( const char *key )
-{
-	assert( _initialized );
-    JniMethodInfo t;
-    CCString* pStr = NULL;
+    // Cocos2dxLocalStorage.getItem returns an empty string for the items that don't exist
+    item.exists = true;
     if (JniHelper::getStaticMethodInfo(t, "org/cocos2dx/lib/Cocos2dxLocalStorage", "getItem", "(Ljava/lang/String;)Ljava/lang/String;")) {
         jstring jkey = t.env->NewStringUTF(key);
         jstring ret = (jstring)t.env->CallStaticObjectMethod(t.classID, t.methodID, jkey);
-        pStr = CCString::create(JniHelper::jstring2string(ret));
+        item.value = JniHelper::jstring2string(ret);
         t.env->DeleteLocalRef(ret);
         t.env->DeleteLocalRef(jkey);
         t.env->DeleteLocalRef(t.classID);
     }
-    return pStr ? pStr->getCString() : NULL;
 }
 
-/** removes an item from the LS */
-void localStorageRemoveItem( const char *key )
+// the items are written by a single call, which writes them in a single transaction
+bool localStorageWriteItems( const LocalStorageItems &items )
 {
-	assert( _initialized );
     JniMethodInfo t;
+    jboolean ret = JNI_FALSE;
+
+    if (JniHelper::getStaticMethodInfo(t, "org/cocos2dx/lib/Cocos2dxLocalStorage", "setItems", "([Ljava/lang/String;[Ljava/lang/String;)Z")) {
+        jclass jstringClass = t.env->FindClass("java/lang/String");
+        jobjectArray jkeys = t.env->NewObjectArray(items.size(), jstringClass, NULL);
+        jobjectArray jvalues = t.env->NewObjectArray(items.size(), jstringClass, NULL);
+
+        int i = 0;
+        for (LocalStorageItems::const_iterator it = items.begin(); it != items.end(); ++it, ++i) {
+            jstring jkey = t.env->NewStringUTF(it->first.c_str());
+            t.env->SetObjectArrayElement(jkeys, i, jkey);
+            t.env->DeleteLocalRef(jkey);
+            // a null value removes the item
+            if (it->second.exists) {
+                jstring jvalue = t.env->NewStringUTF(it->second.value.c_str());
+                t.env->SetObjectArrayElement(jvalues, i, jvalue);
+                t.env->DeleteLocalRef(jvalue);
+            }
+        }
 
-    if (JniHelper::getStaticMethodInfo(t, "org/cocos2dx/lib/Cocos2dxLocalStorage", "removeItem", "(Ljava/lang/String;)V")) {
-        jstring jkey = t.env->NewStringUTF(key);
-        t.env->CallStaticVoidMethod(t.classID, t.methodID, jkey);
-        t.env->DeleteLocalRef(jkey);
+        ret = t.env->CallStaticBooleanMethod(t.classID, t.methodID, jkeys, jvalues);
+        t.env->DeleteLocalRef(jkeys);
+        t.env->DeleteLocalRef(jvalues);
+        t.env->DeleteLocalRef(jstringClass);
         t.env->DeleteLocalRef(t.classID);
     }
 
+    return ret == JNI_TRUE;
 }
 
 #endif // #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
@@ -0,0 +1,215 @@
+/*
+
+ Copyright (c) 2012 - Zynga Inc.
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+
+ */
+
+/*
+ The read cache and the batched writes of the Local Storage, shared by its backends.
+ */
+
+#include "cocos2d.h"
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_TIZEN)
+
+#include <stdio.h>
+#include <assert.h>
+#include "LocalStorage.h"
+#include "LocalStorageCache.h"
+
+USING_NS_CC;
+
+static int _initialized = 0;
+
+// the items read or written so far
+static LocalStorageItems _cache;
+
+// the items that are not written yet
+static LocalStorageItems _pending;
+static int _transactionDepth = 0;
+static float _flushInterval = 0;
+
+// writes the pending items on a timer, and when the application goes to the background
+class LocalStorageFlusher : public CCObject
+{
+public:
+	LocalStorageFlusher()
+	{
+		CCNotificationCenter::sharedNotificationCenter()->addObserver(this,
+			callfuncO_selector(LocalStorageFlusher::listenComeToBackground),
+			EVENT_COME_TO_BACKGROUND,
+			NULL);
+	}
+
+	virtual ~LocalStorageFlusher()
+	{
+		CCNotificationCenter::sharedNotificationCenter()->removeObserver(this, EVENT_COME_TO_BACKGROUND);
+	}
+
+	void schedule(float interval)
+	{
+		CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(LocalStorageFlusher::flush), this);
+		if (interval > 0)
+			CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(LocalStorageFlusher::flush), this, interval, false);
+	}
+
+	void flush(float dt)
+	{
+		localStorageFlush();
+	}
+
+	void listenComeToBackground(CCObject *obj)
+	{
+		localStorageFlush();
+	}
+};
+static LocalStorageFlusher *_flusher = NULL;
+
+// writes the pending items in a single transaction. They are kept pending if it fails, and written again by the next flush.
+static void localStorageWritePending()
+{
+	if (_pending.empty())
+		return;
+
+	if (localStorageWriteItems(_pending))
+		_pending.clear();
+	else
+		printf("Error in localStorage.flush(), the items will be written again by the next flush\n");
+}
+
+// writes an item now, or marks it as pending when writes are batched
+static void localStorageWriteItem( const char *key, const char *value )
+{
+	LocalStorageItem item;
+	item.exists = (value != NULL);
+	item.value = value ? value : "";
+	_cache[key] = item;
+	_pending[key] = item;
+
+	if (_transactionDepth == 0 && _flushInterval <= 0)
+		localStorageWritePending();
+}
+
+void localStorageCacheInit()
+{
+	_initialized = 1;
+}
+
+void localStorageCacheFree()
+{
+	if( _initialized ) {
+		_transactionDepth = 0;
+		localStorageWritePending();
+		_pending.clear();
+		_cache.clear();
+
+		_initialized = 0;
+	}
+}
+
+/** sets an item in the LS */
+void localStorageSetItem( const char *key, const char *value)
+{
+	assert( _initialized );
+
+	localStorageWriteItem(key, value);
+}
+
+/** gets an item from the LS */
+const char* localStorageGetItem( const char *key )
+{
+	assert( _initialized );
+
+	LocalStorageItems::iterator it = _cache.find(key);
+	if (it == _cache.end())
+	{
+		LocalStorageItem item;
+		localStorageReadItem(key, item);
+		it = _cache.insert(std::make_pair(std::string(key), item)).first;
+	}
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+	// Cocos2dxLocalStorage.getItem returns an empty string for the items that don't exist
+	return it->second.value.c_str();
+#else
+	return it->second.exists ? it->second.value.c_str() : NULL;
+#endif
+}
+
+/** removes an item from the LS */
+void localStorageRemoveItem( const char *key )
+{
+	assert( _initialized );
+
+	localStorageWriteItem(key, NULL);
+}
+
+void localStorageBeginTransaction()
+{
+	assert( _initialized );
+
+	_transactionDepth++;
+}
+
+void localStorageCommitTransaction()
+{
+	assert( _initialized && _transactionDepth > 0 );
+
+	if (_transactionDepth > 0 && --_transactionDepth == 0)
+		localStorageWritePending();
+}
+
+void localStorageSetFlushInterval( float interval )
+{
+	_flushInterval = interval;
+
+	if (interval > 0 && !_flusher)
+		_flusher = new LocalStorageFlusher();
+	if (_flusher)
+		_flusher->schedule(interval);
+
+	if (interval <= 0 && _initialized && _transactionDepth == 0)
+		localStorageWritePending();
+}
+
+void localStorageFlush()
+{
+	// the items set in a transaction are only written once it is committed
+	if (_initialized && _transactionDepth == 0)
+		localStorageWritePending();
+}
+
+void localStorageSetItems( const char **keys, const char **values, int count )
+{
+	localStorageBeginTransaction();
+	for (int i = 0; i < count; i++)
+		localStorageWriteItem(keys[i], values[i]);
+	localStorageCommitTransaction();
+}
+
+void localStorageGetItems( const char **keys, const char **values, int count )
+{
+	// the values are pointers to the cache, which the following reads don't invalidate
+	for (int i = 0; i < count; i++)
+		values[i] = localStorageGetItem(keys[i]);
+}
+
+#endif // #if (CC_TARGET_PLATFORM != CC_PLATFORM_TIZEN)
@@ -0,0 +1,59 @@
+/*
+
+Copyright (c) 2012 - Zynga Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+/*
+ The read cache and the batched writes of the Local Storage, shared by its backends.
+ Each backend implements localStorageReadItem and localStorageWriteItems, and calls
+ localStorageCacheInit and localStorageCacheFree from localStorageInit and localStorageFree.
+ */
+
+#ifndef __JSB_LOCALSTORAGECACHE_H
+#define __JSB_LOCALSTORAGECACHE_H
+
+#include <string>
+#include <map>
+
+/** an item read or written so far. An item that doesn't exist is cached too. */
+struct LocalStorageItem
+{
+	bool exists;
+	std::string value;
+};
+
+typedef std::map<std::string, LocalStorageItem> LocalStorageItems;
+
+/** marks the LS as initialized, once the backend has opened the database */
+void localStorageCacheInit();
+
+/** writes the pending items and clears the cache, before the backend closes the database */
+void localStorageCacheFree();
+
+/** reads an item from the database. Implemented by the backend. */
+void localStorageReadItem( const char *key, LocalStorageItem &item );
+
+/** writes the items in a single transaction, removing the ones that don't exist. Implemented by the backend.
+    Returns false if the transaction was rolled back, and the items will be written again by the next flush. */
+bool localStorageWriteItems( const LocalStorageItems &items );
+
+#endif // __JSB_LOCALSTORAGECACHE_H
@@ -37,10 +37,19 @@ typedef void* THREAD_VOID;
 #endif
 
 #include <errno.h>
-#include <queue>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <algorithm>
+#include <map>
 
 #include "curl/curl.h"
 
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <sys/select.h>
+#include <unistd.h>
+#endif
+
 NS_CC_EXT_BEGIN
 
 static pthread_t        s_networkThread;
@@ -58,12 +67,18 @@ typedef int int32_t;
 
 static bool need_quit = false;
 
-static CCArray* s_requestQueue = NULL;
+static CCArray* s_requestQueue = NULL;   // sorted by decreasing priority
 static CCArray* s_responseQueue = NULL;
 
 static CCHttpClient *s_pHttpClient = NULL; // pointer to singleton
 
-static char s_errorBuffer[CURL_ERROR_SIZE];
+// The longest time the network thread waits on the sockets of its transfers, in milliseconds.
+// It bounds the delay before a request sent during a transfer is started, or a transfer is cancelled.
+static const long kHttpWaitInterval = 20;
+
+// The easy handles kept for the next transfers, at most the number of transfers made at the same time
+static std::vector<CURL*> s_idleHandles;
+static int s_maxConnections = 0;
 
 typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *stream);
 
@@ -93,299 +108,467 @@ static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream
     return sizes;
 }
 
+// Callback function used by libcurl for write response data to the storage file
+static size_t writeFile(void *ptr, size_t size, size_t nmemb, void *stream)
+{
+    return fwrite(ptr, 1, size * nmemb, (FILE*)stream);
+}
 
-static int processGetTask(CCHttpRequest *request, write_callback callback, void *stream, int32_t *errorCode, write_callback headerCallback, void *headerStream);
-static int processPostTask(CCHttpRequest *request, write_callback callback, void *stream, int32_t *errorCode, write_callback headerCallback, void *headerStream);
-static int processPutTask(CCHttpRequest *request, write_callback callback, void *stream, int32_t *errorCode, write_callback headerCallback, void *headerStream);
-static int processDeleteTask(CCHttpRequest *request, write_callback callback, void *stream, int32_t *errorCode, write_callback headerCallback, void *headerStream);
-// int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
+// Returns the host of an url along with its port, which identifies the connections that can be reused
+static std::string getHost(const char *url)
+{
+    const char *begin = strstr(url, "://");
+    begin = begin ? begin + 3 : url;
+    const char *end = begin + strcspn(begin, "/?#");
 
+    // skip the user info
+    for (const char *p = begin; p < end; ++p)
+    {
+        if (*p == '@')
+        {
+            begin = p + 1;
+        }
+    }
 
-// Worker thread
-static THREAD_VOID networkThread(THREAD_VOID)
-{    
-    CCHttpRequest *request = NULL;
-    
-    while (true) 
+    std::string host(begin, end);
+    for (std::string::iterator it = host.begin(); it != host.end(); ++it)
     {
-        if (need_quit)
+        *it = tolower(*it);
+    }
+    return host;
+}
+
+/** A request transferred by the network thread */
+class HttpTransfer
+{
+public:
+    HttpTransfer(CCHttpRequest *request, const std::string& host)
+        : m_handle(NULL)
+        , m_headers(NULL)
+        , m_file(NULL)
+        , m_host(host)
+    {
+        // Create a HttpResponse object, the default setting is http access failed
+        m_response = new CCHttpResponse(request);
+
+        // the request is retained by HttpRespose constructor, so release the reference taken by send,
+        // and once the queue releases it only HttpResponse holds it.
+
+        m_errorBuffer[0] = '\0';
+    }
+
+    ~HttpTransfer()
+    {
+        if (m_handle)
         {
-            break;
+            if (!need_quit && (int)s_idleHandles.size() < s_maxConnections)
+            {
+                curl_easy_reset(m_handle);
+                s_idleHandles.push_back(m_handle);
+            }
+            else
+            {
+                curl_easy_cleanup(m_handle);
+            }
         }
-        
-        // step 1: send http request if the requestQueue isn't empty
-        request = NULL;
-        
-        pthread_mutex_lock(&s_requestQueueMutex); //Get request task from queue
-        if (0 != s_requestQueue->count())
+        /* free the linked list for header data */
+        if (m_headers)
+            curl_slist_free_all(m_headers);
+        if (m_file)
+            fclose(m_file);
+        CC_SAFE_RELEASE(m_response);
+    }
+
+    template <class T>
+    bool setOption(CURLoption option, T data)
+    {
+        return CURLE_OK == curl_easy_setopt(m_handle, option, data);
+    }
+
+    /**
+     * @brief Inits CURL instance for the request of the response
+     */
+    bool init()
+    {
+        if (s_idleHandles.empty())
         {
-            request = dynamic_cast<CCHttpRequest*>(s_requestQueue->objectAtIndex(0));
-            s_requestQueue->removeObjectAtIndex(0);  
-            // request's refcount = 1 here
+            m_handle = curl_easy_init();
         }
-        pthread_mutex_unlock(&s_requestQueueMutex);
-        
-        if (NULL == request)
+        else
         {
-        	// Wait for http request tasks from main thread
-        	pthread_cond_wait(&s_SleepCondition, &s_SleepMutex);
-            continue;
+            m_handle = s_idleHandles.back();
+            s_idleHandles.pop_back();
         }
-        
-        // step 2: libcurl sync access
-        
-        // Create a HttpResponse object, the default setting is http access failed
-        CCHttpResponse *response = new CCHttpResponse(request);
-        
-        // request's refcount = 2 here, it's retained by HttpRespose constructor
-        request->release();
-        // ok, refcount = 1 now, only HttpResponse hold it.
-        
-        int32_t responseCode = -1;
-        int retValue = 0;
+        if (!m_handle)
+            return false;
+
+        CCHttpRequest *request = m_response->getHttpRequest();
+        if (!setOption(CURLOPT_ERRORBUFFER, m_errorBuffer)
+            || !setOption(CURLOPT_TIMEOUT, CCHttpClient::getInstance()->getTimeoutForRead())
+            || !setOption(CURLOPT_CONNECTTIMEOUT, CCHttpClient::getInstance()->getTimeoutForConnect()))
+            return false;
+        setOption(CURLOPT_SSL_VERIFYPEER, 0L);
+        setOption(CURLOPT_SSL_VERIFYHOST, 0L);
+
+        // FIXED #3224: The subthread of CCHttpClient interrupts main thread if timeout comes.
+        // Document is here: http://curl.haxx.se/libcurl/c/curl_easy_setopt.html#CURLOPTNOSIGNAL 
+        setOption(CURLOPT_NOSIGNAL, 1L);
+
+#if LIBCURL_VERSION_NUM >= 0x071900
+        // keep the idle connections of the cache alive
+        setOption(CURLOPT_TCP_KEEPALIVE, 1L);
+#endif
+
+        /* get custom header data (if set) */
+       	std::vector<std::string> headers=request->getHeaders();
+        if(!headers.empty())
+        {
+            /* append custom headers one by one */
+            for (std::vector<std::string>::iterator it = headers.begin(); it != headers.end(); ++it)
+                m_headers = curl_slist_append(m_headers,it->c_str());
+            /* set custom headers for curl */
+            if (!setOption(CURLOPT_HTTPHEADER, m_headers))
+                return false;
+        }
+
+        bool ok;
+        if (request->getStoragePath()[0] != '\0')
+        {
+            m_file = fopen(request->getStoragePath(), "wb");
+            if (!m_file)
+            {
+                std::string error = std::string("Can't open ") + request->getStoragePath();
+                strncpy(m_errorBuffer, error.c_str(), CURL_ERROR_SIZE - 1);
+                m_errorBuffer[CURL_ERROR_SIZE - 1] = '\0';
+                return false;
+            }
+            ok = setOption(CURLOPT_WRITEFUNCTION, writeFile)
+                && setOption(CURLOPT_WRITEDATA, m_file);
+        }
+        else
+        {
+            ok = setOption(CURLOPT_WRITEFUNCTION, writeData)
+                && setOption(CURLOPT_WRITEDATA, m_response->getResponseData());
+        }
+
+        ok = ok && setOption(CURLOPT_URL, request->getUrl())
+                && setOption(CURLOPT_HEADERFUNCTION, writeHeaderData)
+                && setOption(CURLOPT_HEADERDATA, m_response->getResponseHeader())
+                && setOption(CURLOPT_PRIVATE, this);
 
-        // Process the request -> get response packet
         switch (request->getRequestType())
         {
             case CCHttpRequest::kHttpGet: // HTTP GET
-                retValue = processGetTask(request,
-                                          writeData, 
-                                          response->getResponseData(), 
-                                          &responseCode,
-                                          writeHeaderData,
-                                          response->getResponseHeader());
-                break;
-            
+                return ok && setOption(CURLOPT_FOLLOWLOCATION, true);
+
             case CCHttpRequest::kHttpPost: // HTTP POST
-                retValue = processPostTask(request,
-                                           writeData, 
-                                           response->getResponseData(), 
-                                           &responseCode,
-                                           writeHeaderData,
-                                           response->getResponseHeader());
-                break;
+                return ok && setOption(CURLOPT_POST, 1)
+                    && setOption(CURLOPT_POSTFIELDS, request->getRequestData())
+                    && setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize());
 
             case CCHttpRequest::kHttpPut:
-                retValue = processPutTask(request,
-                                          writeData,
-                                          response->getResponseData(),
-                                          &responseCode,
-                                          writeHeaderData,
-                                          response->getResponseHeader());
-                break;
+                return ok && setOption(CURLOPT_CUSTOMREQUEST, "PUT")
+                    && setOption(CURLOPT_POSTFIELDS, request->getRequestData())
+                    && setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize());
 
             case CCHttpRequest::kHttpDelete:
-                retValue = processDeleteTask(request,
-                                             writeData,
-                                             response->getResponseData(),
-                                             &responseCode,
-                                             writeHeaderData,
-                                             response->getResponseHeader());
-                break;
-            
+                return ok && setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
+                    && setOption(CURLOPT_FOLLOWLOCATION, true);
+
             default:
-                CCAssert(true, "CCHttpClient: unkown request type, only GET and POSt are supported");
-                break;
+                CCAssert(false, "CCHttpClient: unkown request type, only GET, POST, PUT and DELETE are supported");
+                return false;
         }
-                
-        // write data to HttpResponse
-        response->setResponseCode(responseCode);
-        
-        if (retValue != 0) 
+    }
+
+    /**
+     * @brief Writes the result of the transfer to its response, and queues the response for the main thread
+     * @param succeed Whether curl completed the transfer
+     */
+    void finish(bool succeed, const char *error = NULL)
+    {
+        long responseCode = -1;
+        if (succeed)
         {
-            response->setSucceed(false);
-            response->setErrorBuffer(s_errorBuffer);
+            succeed = CURLE_OK == curl_easy_getinfo(m_handle, CURLINFO_RESPONSE_CODE, &responseCode)
+                && responseCode == 200;
         }
-        else
+
+        if (m_file)
         {
-            response->setSucceed(true);
+            fclose(m_file);
+            m_file = NULL;
+            if (!succeed)
+            {
+                remove(m_response->getHttpRequest()->getStoragePath());
+            }
         }
 
-        
-        // add response packet into queue
+        // write data to HttpResponse
+        m_response->setResponseCode((int)responseCode);
+        m_response->setSucceed(succeed);
+        if (!succeed)
+        {
+            m_response->setErrorBuffer(error ? error : m_errorBuffer);
+        }
+
+        // add response packet into queue, which holds the only reference to it from now on, so that
+        // the network thread doesn't touch its refcount while the main thread dispatches it
         pthread_mutex_lock(&s_responseQueueMutex);
-        s_responseQueue->addObject(response);
+        s_responseQueue->addObject(m_response);
+        m_response->release();
+        m_response = NULL;
         pthread_mutex_unlock(&s_responseQueueMutex);
-        
+
         // resume dispatcher selector
         CCDirector::sharedDirector()->getScheduler()->resumeTarget(CCHttpClient::getInstance());
     }
-    
-    // cleanup: if worker thread received quit signal, clean up un-completed request queue
-    pthread_mutex_lock(&s_requestQueueMutex);
-    s_requestQueue->removeAllObjects();
-    pthread_mutex_unlock(&s_requestQueueMutex);
-    s_asyncRequestCount -= s_requestQueue->count();
-    
-    if (s_requestQueue != NULL) {
-        
-        pthread_mutex_destroy(&s_requestQueueMutex);
-        pthread_mutex_destroy(&s_responseQueueMutex);
-        
-        pthread_mutex_destroy(&s_SleepMutex);
-        pthread_cond_destroy(&s_SleepCondition);
 
-        s_requestQueue->release();
-        s_requestQueue = NULL;
-        s_responseQueue->release();
-        s_responseQueue = NULL;
-    }
+    CURL *m_handle;
+    curl_slist *m_headers;
+    FILE *m_file;
+    CCHttpResponse *m_response;
+    /// Host of the request, along with its port
+    std::string m_host;
+    char m_errorBuffer[CURL_ERROR_SIZE];
+};
 
-    pthread_exit(NULL);
-    
-    return THREAD_RETURN;
+// The running transfers and their number by host, only accessed by the network thread
+static std::vector<HttpTransfer*> s_transfers;
+static std::map<std::string, int> s_hostTransfers;
 
+static void removeTransfer(CURLM *multi, HttpTransfer *transfer)
+{
+    curl_multi_remove_handle(multi, transfer->m_handle);
+    s_transfers.erase(std::find(s_transfers.begin(), s_transfers.end(), transfer));
+    --s_hostTransfers[transfer->m_host];
+    delete transfer;
 }
 
-//Configure curl's timeout property
-static bool configureCURL(CURL *handle)
+// Starts the waiting requests by priority, as long as there are connections left for their host,
+// and aborts the transfers that were cancelled
+static void startTransfers(CURLM *multi)
 {
-    if (!handle) {
-        return false;
+    std::vector<HttpTransfer*> started;
+    std::vector<HttpTransfer*> cancelled;
+    std::vector<HttpTransfer*> cancelledRequests;
+
+    int maxConnections = MAX(CCHttpClient::getInstance()->getMaxConnections(), 1);
+    if (maxConnections != s_maxConnections)
+    {
+        // the connection cache holds a connection for each transfer made at the same time
+        s_maxConnections = maxConnections;
+        curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, (long)maxConnections);
     }
-    
-    int32_t code;
-    code = curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, s_errorBuffer);
-    if (code != CURLE_OK) {
-        return false;
+    int maxConnectionsPerHost = MAX(CCHttpClient::getInstance()->getMaxConnectionsPerHost(), 1);
+
+    pthread_mutex_lock(&s_requestQueueMutex);
+    for (std::vector<HttpTransfer*>::iterator it = s_transfers.begin(); it != s_transfers.end(); ++it)
+    {
+        if ((*it)->m_response->getHttpRequest()->isCancelled())
+        {
+            cancelled.push_back(*it);
+        }
     }
-    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT, CCHttpClient::getInstance()->getTimeoutForRead());
-    if (code != CURLE_OK) {
-        return false;
+
+    unsigned int i = 0;
+    while (i < s_requestQueue->count())
+    {
+        CCHttpRequest *request = (CCHttpRequest*)s_requestQueue->objectAtIndex(i);
+        if (request->isCancelled())
+        {
+            // the response retains the request before the queue releases it
+            cancelledRequests.push_back(new HttpTransfer(request, std::string()));
+            s_requestQueue->removeObjectAtIndex(i);
+            continue;
+        }
+        if ((int)(s_transfers.size() + started.size()) >= s_maxConnections)
+        {
+            ++i;
+            continue;
+        }
+
+        std::string host = getHost(request->getUrl());
+        int &hostTransfers = s_hostTransfers[host];
+        if (hostTransfers >= maxConnectionsPerHost)
+        {
+            ++i;
+            continue;
+        }
+
+        ++hostTransfers;
+        started.push_back(new HttpTransfer(request, host));
+        s_requestQueue->removeObjectAtIndex(i);
     }
-    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, CCHttpClient::getInstance()->getTimeoutForConnect());
-    if (code != CURLE_OK) {
-        return false;
+    pthread_mutex_unlock(&s_requestQueueMutex);
+
+    for (std::vector<HttpTransfer*>::iterator it = cancelled.begin(); it != cancelled.end(); ++it)
+    {
+        (*it)->finish(false, "Cancelled");
+        removeTransfer(multi, *it);
     }
-    curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0L);
-    curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0L);
 
-    // FIXED #3224: The subthread of CCHttpClient interrupts main thread if timeout comes.
-    // Document is here: http://curl.haxx.se/libcurl/c/curl_easy_setopt.html#CURLOPTNOSIGNAL 
-    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    for (std::vector<HttpTransfer*>::iterator it = cancelledRequests.begin(); it != cancelledRequests.end(); ++it)
+    {
+        (*it)->finish(false, "Cancelled");
+        delete *it;
+    }
 
-    return true;
+    for (std::vector<HttpTransfer*>::iterator it = started.begin(); it != started.end(); ++it)
+    {
+        HttpTransfer *transfer = *it;
+        if (transfer->init() && CURLM_OK == curl_multi_add_handle(multi, transfer->m_handle))
+        {
+            s_transfers.push_back(transfer);
+        }
+        else
+        {
+            transfer->finish(false);
+            --s_hostTransfers[transfer->m_host];
+            delete transfer;
+        }
+    }
 }
 
-class CURLRaii
+// Waits for the sockets of the transfers, or for the time curl needs to wait before going on
+static void waitTransfers(CURLM *multi)
 {
-    /// Instance of CURL
-    CURL *m_curl;
-    /// Keeps custom header data
-    curl_slist *m_headers;
-public:
-    CURLRaii()
-        : m_curl(curl_easy_init())
-        , m_headers(NULL)
+    long timeout = -1;
+    curl_multi_timeout(multi, &timeout);
+    if (timeout == 0)
     {
+        return;
     }
-
-    ~CURLRaii()
+    if (timeout < 0 || timeout > kHttpWaitInterval)
     {
-        if (m_curl)
-            curl_easy_cleanup(m_curl);
-        /* free the linked list for header data */
-        if (m_headers)
-            curl_slist_free_all(m_headers);
+        timeout = kHttpWaitInterval;
     }
 
-    template <class T>
-    bool setOption(CURLoption option, T data)
+    fd_set readSet, writeSet, errorSet;
+    FD_ZERO(&readSet);
+    FD_ZERO(&writeSet);
+    FD_ZERO(&errorSet);
+    int maxfd = -1;
+    curl_multi_fdset(multi, &readSet, &writeSet, &errorSet, &maxfd);
+
+    if (maxfd < 0)
     {
-        return CURLE_OK == curl_easy_setopt(m_curl, option, data);
+        // curl is resolving a host or waiting before a retry, and has no socket to wait for
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WP8) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+        Sleep(timeout);
+#else
+        usleep(timeout * 1000);
+#endif
+        return;
     }
 
-    /**
-     * @brief Inits CURL instance for common usage
-     * @param request Null not allowed
-     * @param callback Response write callback
-     * @param stream Response write stream
-     */
-    bool init(CCHttpRequest *request, write_callback callback, void *stream, write_callback headerCallback, void *headerStream)
-    {
-        if (!m_curl)
-            return false;
-        if (!configureCURL(m_curl))
-            return false;
+    struct timeval tv;
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+    select(maxfd + 1, &readSet, &writeSet, &errorSet, &tv);
+}
 
-        /* get custom header data (if set) */
-       	std::vector<std::string> headers=request->getHeaders();
-        if(!headers.empty())
+// Worker thread
+static THREAD_VOID networkThread(THREAD_VOID)
+{
+    // the transfers of a multi handle share its connection cache and DNS cache, so the connections
+    // are kept alive and reused by the following requests to the same host
+    CURLM *multi = curl_multi_init();
+    s_maxConnections = 0;
+
+    while (true) 
+    {
+        if (need_quit)
         {
-            /* append custom headers one by one */
-            for (std::vector<std::string>::iterator it = headers.begin(); it != headers.end(); ++it)
-                m_headers = curl_slist_append(m_headers,it->c_str());
-            /* set custom headers for curl */
-            if (!setOption(CURLOPT_HTTPHEADER, m_headers))
-                return false;
+            break;
         }
+        
+        // step 1: start the requests sent by the main thread
+        startTransfers(multi);
 
-        return setOption(CURLOPT_URL, request->getUrl())
-                && setOption(CURLOPT_WRITEFUNCTION, callback)
-                && setOption(CURLOPT_WRITEDATA, stream)
-                && setOption(CURLOPT_HEADERFUNCTION, headerCallback)
-                && setOption(CURLOPT_HEADERDATA, headerStream);
+        if (s_transfers.empty())
+        {
+            // Wait for http request tasks from main thread
+            pthread_mutex_lock(&s_SleepMutex);
+            pthread_mutex_lock(&s_requestQueueMutex);
+            bool idle = (0 == s_requestQueue->count());
+            pthread_mutex_unlock(&s_requestQueueMutex);
+            if (idle && !need_quit)
+            {
+                pthread_cond_wait(&s_SleepCondition, &s_SleepMutex);
+            }
+            pthread_mutex_unlock(&s_SleepMutex);
+            continue;
+        }
         
+        // step 2: libcurl async access
+        int running = 0;
+        while (CURLM_CALL_MULTI_PERFORM == curl_multi_perform(multi, &running))
+        {
+        }
+
+        CURLMsg *message = NULL;
+        int messages = 0;
+        while ((message = curl_multi_info_read(multi, &messages)) != NULL)
+        {
+            if (message->msg != CURLMSG_DONE)
+            {
+                continue;
+            }
+
+            HttpTransfer *transfer = NULL;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, (char**)&transfer);
+            transfer->finish(CURLE_OK == message->data.result);
+            removeTransfer(multi, transfer);
+        }
+
+        if (running > 0)
+        {
+            waitTransfers(multi);
+        }
+    }
+    
+    // cleanup: if worker thread received quit signal, clean up un-completed transfers and request queue
+    while (!s_transfers.empty())
+    {
+        removeTransfer(multi, s_transfers.back());
+    }
+    for (std::vector<CURL*>::iterator it = s_idleHandles.begin(); it != s_idleHandles.end(); ++it)
+    {
+        curl_easy_cleanup(*it);
     }
+    s_idleHandles.clear();
+    curl_multi_cleanup(multi);
 
-    /// @param responseCode Null not allowed
-    bool perform(int *responseCode)
+    pthread_mutex_lock(&s_requestQueueMutex);
+    CCObject *pObj = NULL;
+    CCARRAY_FOREACH(s_requestQueue, pObj)
     {
-        if (CURLE_OK != curl_easy_perform(m_curl))
-            return false;
-        CURLcode code = curl_easy_getinfo(m_curl, CURLINFO_RESPONSE_CODE, responseCode);
-        if (code != CURLE_OK || *responseCode != 200)
-            return false;
+        // the request is retained by send
+        pObj->release();
+    }
+    s_asyncRequestCount -= s_requestQueue->count();
+    s_requestQueue->removeAllObjects();
+    pthread_mutex_unlock(&s_requestQueueMutex);
+    
+    if (s_requestQueue != NULL) {
         
-        // Get some mor data.
+        pthread_mutex_destroy(&s_requestQueueMutex);
+        pthread_mutex_destroy(&s_responseQueueMutex);
         
-        return true;
-    }
-};
-
-//Process Get Request
-static int processGetTask(CCHttpRequest *request, write_callback callback, void *stream, int32_t *responseCode, write_callback headerCallback, void *headerStream)
-{
-    CURLRaii curl;
-    bool ok = curl.init(request, callback, stream, headerCallback, headerStream)
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
+        pthread_mutex_destroy(&s_SleepMutex);
+        pthread_cond_destroy(&s_SleepCondition);
 
-//Process POST Request
-static int processPostTask(CCHttpRequest *request, write_callback callback, void *stream, int32_t *responseCode, write_callback headerCallback, void *headerStream)
-{
-    CURLRaii curl;
-    bool ok = curl.init(request, callback, stream, headerCallback, headerStream)
-            && curl.setOption(CURLOPT_POST, 1)
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
+        s_requestQueue->release();
+        s_requestQueue = NULL;
+        s_responseQueue->release();
+        s_responseQueue = NULL;
+    }
 
-//Process PUT Request
-static int processPutTask(CCHttpRequest *request, write_callback callback, void *stream, int32_t *responseCode, write_callback headerCallback, void *headerStream)
-{
-    CURLRaii curl;
-    bool ok = curl.init(request, callback, stream, headerCallback, headerStream)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
+    pthread_exit(NULL);
+    
+    return THREAD_RETURN;
 
-//Process DELETE Request
-static int processDeleteTask(CCHttpRequest *request, write_callback callback, void *stream, int32_t *responseCode, write_callback headerCallback, void *headerStream)
-{
-    CURLRaii curl;
-    bool ok = curl.init(request, callback, stream, headerCallback, headerStream)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
 }
 
 // HttpClient implementation
@@ -408,6 +591,8 @@ void CCHttpClient::destroyInstance()
 CCHttpClient::CCHttpClient()
 : _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConnectionsPerHost(4)
+, _maxConnections(16)
 {
     CCDirector::sharedDirector()->getScheduler()->scheduleSelector(
                     schedule_selector(CCHttpClient::dispatchResponseCallbacks), this, 0, false);
@@ -419,7 +604,9 @@ CCHttpClient::~CCHttpClient()
     need_quit = true;
     
     if (s_requestQueue != NULL) {
+        pthread_mutex_lock(&s_SleepMutex);
     	pthread_cond_signal(&s_SleepCondition);
+        pthread_mutex_unlock(&s_SleepMutex);
     }
     
     s_pHttpClient = NULL;
@@ -444,6 +631,9 @@ bool CCHttpClient::lazyInitThreadSemphore()
         pthread_mutex_init(&s_SleepMutex, NULL);
         pthread_cond_init(&s_SleepCondition, NULL);
 
+        // curl_multi_init doesn't initialize curl, which isn't thread safe
+        curl_global_init(CURL_GLOBAL_ALL);
+
         need_quit = false;
         pthread_create(&s_networkThread, NULL, networkThread, NULL);
         pthread_detach(s_networkThread);
@@ -471,11 +661,36 @@ void CCHttpClient::send(CCHttpRequest* request)
     request->retain();
         
     pthread_mutex_lock(&s_requestQueueMutex);
-    s_requestQueue->addObject(request);
+    // keep the queue sorted by decreasing priority, and in sending order within the same priority
+    unsigned int index = s_requestQueue->count();
+    while (index > 0 && ((CCHttpRequest*)s_requestQueue->objectAtIndex(index - 1))->getPriority() < request->getPriority())
+    {
+        --index;
+    }
+    s_requestQueue->insertObject(request, index);
     pthread_mutex_unlock(&s_requestQueueMutex);
     
     // Notify thread start to work
+    pthread_mutex_lock(&s_SleepMutex);
+    pthread_cond_signal(&s_SleepCondition);
+    pthread_mutex_unlock(&s_SleepMutex);
+}
+
+void CCHttpClient::cancel(CCHttpRequest* request)
+{
+    if (!request || s_requestQueue == NULL)
+    {
+        return;
+    }
+
+    // the network thread aborts the request, and its response is released without calling the callback
+    pthread_mutex_lock(&s_requestQueueMutex);
+    request->_cancelled = true;
+    pthread_mutex_unlock(&s_requestQueueMutex);
+
+    pthread_mutex_lock(&s_SleepMutex);
     pthread_cond_signal(&s_SleepCondition);
+    pthread_mutex_unlock(&s_SleepMutex);
 }
 
 // Poll and notify main thread if responses exists in queue
@@ -483,30 +698,32 @@ void CCHttpClient::dispatchResponseCallbacks(float delta)
 {
     // CCLog("CCHttpClient::dispatchResponseCallbacks is running");
     
-    CCHttpResponse* response = NULL;
+    // the transfers complete concurrently, so all the responses received since the last frame are dispatched
+    CCArray* responses = NULL;
     
     pthread_mutex_lock(&s_responseQueueMutex);
     if (s_responseQueue->count())
     {
-        response = dynamic_cast<CCHttpResponse*>(s_responseQueue->objectAtIndex(0));
-        s_responseQueue->removeObjectAtIndex(0);
+        responses = CCArray::createWithCapacity(s_responseQueue->count());
+        responses->addObjectsFromArray(s_responseQueue);
+        s_responseQueue->removeAllObjects();
     }
     pthread_mutex_unlock(&s_responseQueueMutex);
     
-    if (response)
+    CCObject* pObj = NULL;
+    CCARRAY_FOREACH(responses, pObj)
     {
+        CCHttpResponse* response = (CCHttpResponse*)pObj;
         --s_asyncRequestCount;
         
         CCHttpRequest *request = response->getHttpRequest();
         CCObject *pTarget = request->getTarget();
         SEL_HttpResponse pSelector = request->getSelector();
 
-        if (pTarget && pSelector) 
+        if (pTarget && pSelector && !request->isCancelled()) 
         {
             (pTarget->*pSelector)(this, response);
         }
-        
-        response->release();
     }
     
     if (0 == s_asyncRequestCount) 
@@ -42,6 +42,9 @@ NS_CC_EXT_BEGIN
 
 /** @brief Singleton that handles asynchrounous http requests
  * Once the request completed, a callback will issued in main thread when it provided during make request
+ *
+ * The requests are made concurrently by a single network thread. Connections are kept alive and reused
+ * by the following requests to the same host, as are the results of the DNS lookups.
  * @js NA
  * @lua NA
  */
@@ -61,6 +64,37 @@ public:
      * @return NULL
      */
     void send(CCHttpRequest* request);
+
+    /**
+     * Cancel a request that was sent. Its transfer is aborted if it started, and its callback won't be called.
+     * @param request a CCHttpRequest object passed to send
+     */
+    void cancel(CCHttpRequest* request);
+
+    /**
+     * Change the maximum number of transfers made at the same time with a single host.
+     * The other requests to that host wait for one of them to complete, and reuse its connection.
+     * @param value default is 4
+     */
+    inline void setMaxConnectionsPerHost(int value) {_maxConnectionsPerHost = value;};
+
+    /**
+     * Get the maximum number of transfers made at the same time with a single host
+     * @return int
+     */
+    inline int getMaxConnectionsPerHost() {return _maxConnectionsPerHost;};
+
+    /**
+     * Change the maximum number of transfers made at the same time
+     * @param value default is 16
+     */
+    inline void setMaxConnections(int value) {_maxConnections = value;};
+
+    /**
+     * Get the maximum number of transfers made at the same time
+     * @return int
+     */
+    inline int getMaxConnections() {return _maxConnections;};
   
     
     /**
@@ -108,6 +142,8 @@ private:
 private:
     int _timeoutForConnect;
     int _timeoutForRead;
+    int _maxConnectionsPerHost;
+    int _maxConnections;
     
     // std::string reqId;
 };
@@ -71,6 +71,9 @@ public:
         _pTarget = NULL;
         _pSelector = NULL;
         _pUserData = NULL;
+        _priority = 0;
+        _storagePath.clear();
+        _cancelled = false;
     };
     
     /** Destructor */
@@ -217,6 +220,39 @@ public:
    		return _headers;
    	}
 
+    /** Option field. Requests waiting for a connection are sent by decreasing priority,
+        and in the order they were sent within the same priority. The default priority is 0.
+     */
+    inline void setPriority(int priority)
+    {
+        _priority = priority;
+    }
+    /** Get back the priority */
+    inline int getPriority()
+    {
+        return _priority;
+    }
+
+    /** Option field. If set, the response body is written to the file at this full path while it is
+        received, instead of being kept in memory. HttpResponse->getResponseData() is then empty.
+        The file is removed if the request fails.
+     */
+    inline void setStoragePath(const char* path)
+    {
+        _storagePath = path;
+    }
+    /** Get back the storage path, empty if the response is kept in memory */
+    inline const char* getStoragePath()
+    {
+        return _storagePath.c_str();
+    }
+
+    /** Whether the request was cancelled with CCHttpClient::cancel(). The callback of a cancelled request isn't called. */
+    inline bool isCancelled()
+    {
+        return _cancelled;
+    }
+
 
 protected:
     // properties
@@ -228,6 +264,11 @@ protected:
     SEL_HttpResponse            _pSelector;      /// callback function, e.g. MyLayer::onHttpResponse(CCHttpClient *sender, CCHttpResponse * response)
     void*                       _pUserData;      /// You can add your customed data here 
     std::vector<std::string>    _headers;		      /// custom http headers
+    int                         _priority;       /// requests with a higher priority are sent first
+    std::string                 _storagePath;    /// if not empty, the response body is written to this file
+    bool                        _cancelled;      /// set by CCHttpClient::cancel
+
+    friend class CCHttpClient;
 };
 
 NS_CC_EXT_END
@@ -25,7 +25,7 @@
 
 #include <spine/CCSkeleton.h>
 #include <spine/spine-cocos2dx.h>
-#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 && _MSC_VER >= 1800) // Visual Studio 2013
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 && _MSC_VER >= 1800) // Visual Studio 2013
 #include <algorithm>
 #endif
 
@@ -59,18 +59,31 @@ void CCSkeleton::initialize () {
 	debugBones = false;
 	timeScale = 1;
 
+	quads = 0;
+	quadStates = 0;
+	dirtyStart = dirtyEnd = 0;
+	buffersVBO[0] = buffersVBO[1] = 0;
+
 	blendFunc.src = GL_ONE;
 	blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
 	setOpacityModifyRGB(true);
 
 	setShaderProgram(CCShaderCache::sharedShaderCache()->programForKey(kCCShader_PositionTextureColor));
 	scheduleUpdate();
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+	CCNotificationCenter::sharedNotificationCenter()->addObserver(this, callfuncO_selector(CCSkeleton::listenBackToForeground),
+		EVENT_COME_TO_FOREGROUND, NULL);
+#endif
 }
 
 void CCSkeleton::setSkeletonData (SkeletonData *skeletonData, bool ownsSkeletonData) {
 	skeleton = Skeleton_create(skeletonData);
 	rootBone = skeleton->bones[0];
 	this->ownsSkeletonData = ownsSkeletonData;	
+
+	quads = (ccV3F_C4B_T2F_Quad*)calloc(skeleton->slotCount, sizeof(ccV3F_C4B_T2F_Quad));
+	quadStates = (QuadState*)calloc(skeleton->slotCount, sizeof(QuadState));
 }
 
 CCSkeleton::CCSkeleton () {
@@ -114,6 +127,14 @@ CCSkeleton::~CCSkeleton () {
 	if (ownsSkeletonData) SkeletonData_dispose(skeleton->data);
 	if (atlas) Atlas_dispose(atlas);
 	Skeleton_dispose(skeleton);
+
+	if (buffersVBO[0]) glDeleteBuffers(2, buffersVBO);
+	free(quads);
+	free(quadStates);
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+	CCNotificationCenter::sharedNotificationCenter()->removeObserver(this, EVENT_COME_TO_FOREGROUND);
+#endif
 }
 
 void CCSkeleton::update (float deltaTime) {
@@ -121,9 +142,6 @@ void CCSkeleton::update (float deltaTime) {
 }
 
 void CCSkeleton::draw () {
-	CC_NODE_DRAW_SETUP();
-
-	ccGLBlendFunc(blendFunc.src, blendFunc.dst);
 	ccColor3B color = getColor();
 	skeleton->r = color.r / (float)255;
 	skeleton->g = color.g / (float)255;
@@ -135,33 +153,27 @@ void CCSkeleton::draw () {
 		skeleton->b *= skeleton->a;
 	}
 
-	CCTextureAtlas* textureAtlas = 0;
-	ccV3F_C4B_T2F_Quad quad;
-	quad.tl.vertices.z = 0;
-	quad.tr.vertices.z = 0;
-	quad.bl.vertices.z = 0;
-	quad.br.vertices.z = 0;
 	for (int i = 0, n = skeleton->slotCount; i < n; i++) {
-		Slot* slot = skeleton->slots[i];
-		if (!slot->attachment || slot->attachment->type != ATTACHMENT_REGION) continue;
-		RegionAttachment* attachment = (RegionAttachment*)slot->attachment;
-		CCTextureAtlas* regionTextureAtlas = getTextureAtlas(attachment);
-		if (regionTextureAtlas != textureAtlas) {
-			if (textureAtlas) {
-				textureAtlas->drawQuads();
-				textureAtlas->removeAllQuads();
-			}
+		if (updateQuad(i)) {
+			dirtyStart = min(dirtyStart, i);
+			dirtyEnd = max(dirtyEnd, i + 1);
 		}
-		textureAtlas = regionTextureAtlas;
-		if (textureAtlas->getCapacity() == textureAtlas->getTotalQuads() &&
-			!textureAtlas->resizeCapacity(textureAtlas->getCapacity() * 2)) return;
-		RegionAttachment_updateQuad(attachment, slot, &quad, premultipliedAlpha);
-		textureAtlas->updateQuad(&quad, textureAtlas->getTotalQuads());
 	}
-	if (textureAtlas) {
-		textureAtlas->drawQuads();
-		textureAtlas->removeAllQuads();
+
+	// All the quads use the same shader, so either all of them are queued to the batcher or none is.
+	bool batched = false;
+	CCAutoBatcher* batcher = CCAutoBatcher::sharedAutoBatcher();
+	if (batcher->isEnabled()) {
+		batched = true;
+		for (int i = 0, n = skeleton->slotCount; i < n; i++) {
+			if (!quadStates[i].texture) continue;
+			if (!batcher->addQuad(quads[i], quadStates[i].texture, blendFunc, getShaderProgram())) {
+				batched = false;
+				break;
+			}
+		}
 	}
+	if (!batched) drawQuads();
 
 	if (debugSlots) {
 		// Slots.
@@ -202,6 +214,137 @@ void CCSkeleton::draw () {
 	}
 }
 
+bool CCSkeleton::updateQuad (int index) {
+	Slot* slot = skeleton->slots[index];
+	QuadState* state = quadStates + index;
+
+	Attachment* attachment = slot->attachment && slot->attachment->type == ATTACHMENT_REGION ? slot->attachment : 0;
+	if (!attachment) {
+		if (!state->attachment) return false;
+		// A hidden slot keeps its place in the buffer, as a quad which doesn't draw anything.
+		memset(quads + index, 0, sizeof(ccV3F_C4B_T2F_Quad));
+		memset(state, 0, sizeof(QuadState));
+		return true;
+	}
+
+	Bone* bone = slot->bone;
+	float r = skeleton->r * slot->r, g = skeleton->g * slot->g, b = skeleton->b * slot->b, a = skeleton->a * slot->a;
+	if (state->attachment == attachment && state->m00 == bone->m00 && state->m01 == bone->m01 && state->m10 == bone->m10
+		&& state->m11 == bone->m11 && state->worldX == bone->worldX && state->worldY == bone->worldY && state->x == skeleton->x
+		&& state->y == skeleton->y && state->r == r && state->g == g && state->b == b && state->a == a) return false;
+
+	state->attachment = attachment;
+	state->m00 = bone->m00;
+	state->m01 = bone->m01;
+	state->m10 = bone->m10;
+	state->m11 = bone->m11;
+	state->worldX = bone->worldX;
+	state->worldY = bone->worldY;
+	state->x = skeleton->x;
+	state->y = skeleton->y;
+	state->r = r;
+	state->g = g;
+	state->b = b;
+	state->a = a;
+	state->texture = getTextureAtlas((RegionAttachment*)attachment)->getTexture()->getName();
+	RegionAttachment_updateQuad((RegionAttachment*)attachment, slot, quads + index, premultipliedAlpha);
+	return true;
+}
+
+void CCSkeleton::invalidateQuads () {
+	if (!quads) return;
+	memset(quads, 0, skeleton->slotCount * sizeof(ccV3F_C4B_T2F_Quad));
+	memset(quadStates, 0, skeleton->slotCount * sizeof(QuadState));
+	dirtyStart = 0;
+	dirtyEnd = skeleton->slotCount;
+}
+
+void CCSkeleton::setupBuffers () {
+	int n = skeleton->slotCount;
+	GLushort* indices = (GLushort*)malloc(n * 6 * sizeof(GLushort));
+	for (int i = 0; i < n; i++) {
+		indices[i * 6 + 0] = (GLushort)(i * 4 + 0);
+		indices[i * 6 + 1] = (GLushort)(i * 4 + 1);
+		indices[i * 6 + 2] = (GLushort)(i * 4 + 2);
+		indices[i * 6 + 3] = (GLushort)(i * 4 + 3);
+		indices[i * 6 + 4] = (GLushort)(i * 4 + 2);
+		indices[i * 6 + 5] = (GLushort)(i * 4 + 1);
+	}
+
+	glGenBuffers(2, buffersVBO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffersVBO[0]);
+	glBufferData(GL_ARRAY_BUFFER, n * sizeof(ccV3F_C4B_T2F_Quad), quads, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffersVBO[1]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, n * 6 * sizeof(GLushort), indices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	free(indices);
+	dirtyStart = n;
+	dirtyEnd = 0;
+
+	CHECK_GL_ERROR_DEBUG();
+}
+
+void CCSkeleton::drawQuads () {
+	int n = skeleton->slotCount;
+	if (!n) return;
+
+	CC_NODE_DRAW_SETUP();
+	ccGLBlendFunc(blendFunc.src, blendFunc.dst);
+
+	if (!buffersVBO[0]) setupBuffers();
+
+#if CC_TEXTURE_ATLAS_USE_VAO
+	// The attribute pointers below must not end up in the VAO of a texture atlas.
+	ccGLBindVAO(0);
+#endif
+
+	glBindBuffer(GL_ARRAY_BUFFER, buffersVBO[0]);
+	if (dirtyStart < dirtyEnd) {
+		glBufferSubData(GL_ARRAY_BUFFER, dirtyStart * sizeof(ccV3F_C4B_T2F_Quad), (dirtyEnd - dirtyStart) * sizeof(ccV3F_C4B_T2F_Quad), quads + dirtyStart);
+		dirtyStart = n;
+		dirtyEnd = 0;
+	}
+
+	ccGLEnableVertexAttribs(kCCVertexAttribFlag_PosColorTex);
+#define kQuadSize sizeof(quads[0].bl)
+	glVertexAttribPointer(kCCVertexAttrib_Position, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*)offsetof(ccV3F_C4B_T2F, vertices));
+	glVertexAttribPointer(kCCVertexAttrib_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*)offsetof(ccV3F_C4B_T2F, colors));
+	glVertexAttribPointer(kCCVertexAttrib_TexCoords, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*)offsetof(ccV3F_C4B_T2F, texCoords));
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffersVBO[1]);
+
+	// One draw call for each run of slots using the same atlas page. Hidden slots don't break a run.
+	GLuint runTexture = 0;
+	int runStart = 0, runEnd = 0;
+	for (int i = 0; i <= n; i++) {
+		GLuint texture = i < n ? quadStates[i].texture : 0;
+		if (i < n && !texture) continue;
+		if (texture != runTexture || i == n) {
+			if (runEnd > runStart) {
+				ccGLBindTexture2D(runTexture);
+				glDrawElements(GL_TRIANGLES, (GLsizei)(runEnd - runStart) * 6, GL_UNSIGNED_SHORT, (GLvoid*)(runStart * 6 * sizeof(GLushort)));
+				CC_INCREMENT_GL_DRAWS(1);
+			}
+			runTexture = texture;
+			runStart = i;
+		}
+		runEnd = i + 1;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	CHECK_GL_ERROR_DEBUG();
+}
+
+void CCSkeleton::listenBackToForeground (CCObject* obj) {
+	// The buffers were lost with the GL context.
+	buffersVBO[0] = buffersVBO[1] = 0;
+}
+
 CCTextureAtlas* CCSkeleton::getTextureAtlas (RegionAttachment* regionAttachment) const {
 	return (CCTextureAtlas*)((AtlasRegion*)regionAttachment->rendererObject)->page->rendererObject;
 }
@@ -284,6 +427,7 @@ void CCSkeleton::setBlendFunc (ccBlendFunc blendFunc) {
 
 void CCSkeleton::setOpacityModifyRGB (bool value) {
 	premultipliedAlpha = value;
+	invalidateQuads();
 }
 
 bool CCSkeleton::isOpacityModifyRGB () {
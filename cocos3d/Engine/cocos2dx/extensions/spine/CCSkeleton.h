@@ -33,6 +33,11 @@ namespace cocos2d { namespace extension {
 
 /**
 Draws a skeleton.
+
+The quad of each slot is kept from one frame to the next in a vertex buffer, and is only computed and uploaded again
+when the bone, attachment or color of the slot changed. Consecutive slots using the same atlas page are drawn with a
+single draw call. While the CCAutoBatcher is enabled, the quads are queued to it instead, so that the skeletons sharing
+an atlas page are drawn together.
 */
 class CC_EX_DLL CCSkeleton: public cocos2d::CCNodeRGBA, public cocos2d::CCBlendProtocol {
 public:
@@ -84,15 +89,35 @@ public:
 	virtual void setOpacityModifyRGB (bool value);
 	virtual bool isOpacityModifyRGB ();
 
+	/* Listens the event that coming to foreground on Android, to recreate the vertex buffer. */
+	void listenBackToForeground (cocos2d::CCObject* obj);
+
 protected:
 	CCSkeleton ();
 	void setSkeletonData (SkeletonData* skeletonData, bool ownsSkeletonData);
 	cocos2d::CCTextureAtlas* getTextureAtlas (RegionAttachment* regionAttachment) const;
 
 private:
+	/* What the quad of a slot was computed from. */
+	struct QuadState {
+		Attachment* attachment;
+		float m00, m01, m10, m11, worldX, worldY;
+		float x, y;
+		float r, g, b, a;
+		GLuint texture;
+	};
+
 	bool ownsSkeletonData;
 	Atlas* atlas;
+	cocos2d::ccV3F_C4B_T2F_Quad* quads; /* One for each slot, hidden slots have a degenerate quad. */
+	QuadState* quadStates;
+	int dirtyStart, dirtyEnd; /* The range of quads to upload to the vertex buffer. */
+	GLuint buffersVBO[2]; /* 0: vertex  1: indices */
 	void initialize ();
+	bool updateQuad (int index);
+	void invalidateQuads ();
+	void setupBuffers ();
+	void drawQuads ();
 };
 
 }} // namespace cocos2d { namespace extension {
@@ -26,10 +26,17 @@
 #include <spine/CCSkeletonAnimation.h>
 #include <spine/extension.h>
 #include <spine/spine-cocos2dx.h>
-#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 && _MSC_VER >= 1800) // Visual Studio 2013
+#include <limits.h>
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 && _MSC_VER >= 1800) // Visual Studio 2013
 #include <algorithm>
 #endif
 
+// Threads are not available on WinRT and WP8, where the skeletons are updated one after the other.
+#if CC_SKELETON_UPDATE_THREADS > 0 && !defined(EMSCRIPTEN) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT) && (CC_TARGET_PLATFORM != CC_PLATFORM_WP8)
+#define CC_SKELETON_USE_UPDATE_THREADS 1
+#include <pthread.h>
+#endif
+
 USING_NS_CC;
 using std::min;
 using std::max;
@@ -37,6 +44,175 @@ using std::vector;
 
 namespace cocos2d { namespace extension {
 
+// --- Parallel update.
+
+typedef struct {
+	CCSkeletonAnimation* skeleton;
+	float deltaTime;
+} SkeletonUpdate;
+
+static bool s_parallelUpdate = false;
+static vector<SkeletonUpdate> s_queuedUpdates;
+
+#if CC_SKELETON_USE_UPDATE_THREADS
+static pthread_t s_updateThreads[CC_SKELETON_UPDATE_THREADS];
+static pthread_mutex_t s_updateMutex;
+static pthread_cond_t s_workCondition;
+static pthread_cond_t s_doneCondition;
+static bool s_threadsStarted = false;
+static bool s_quitThreads = false;
+
+/* The batch being updated, guarded by s_updateMutex. */
+static unsigned int s_batch = 0;
+static SkeletonUpdate* s_updates = 0;
+static int s_updateCount = 0;
+static int s_nextUpdate = 0;
+static int s_doneUpdates = 0;
+static int s_chunkSize = 1;
+
+/* Takes chunks of the batch until none is left. Called with s_updateMutex locked. */
+static void runUpdates () {
+	while (s_nextUpdate < s_updateCount) {
+		SkeletonUpdate* updates = s_updates;
+		int start = s_nextUpdate;
+		int end = min(start + s_chunkSize, s_updateCount);
+		s_nextUpdate = end;
+
+		pthread_mutex_unlock(&s_updateMutex);
+		for (int i = start; i < end; i++)
+			updates[i].skeleton->updateAnimation(updates[i].deltaTime);
+		pthread_mutex_lock(&s_updateMutex);
+
+		s_doneUpdates += end - start;
+		if (s_doneUpdates == s_updateCount) pthread_cond_signal(&s_doneCondition);
+	}
+}
+
+static void* updateThread (void* data) {
+	unsigned int batch = 0;
+	pthread_mutex_lock(&s_updateMutex);
+	while (true) {
+		while (batch == s_batch && !s_quitThreads)
+			pthread_cond_wait(&s_workCondition, &s_updateMutex);
+		if (s_quitThreads) break;
+		batch = s_batch;
+		runUpdates();
+	}
+	pthread_mutex_unlock(&s_updateMutex);
+	return 0;
+}
+
+static void startThreads () {
+	pthread_mutex_init(&s_updateMutex, 0);
+	pthread_cond_init(&s_workCondition, 0);
+	pthread_cond_init(&s_doneCondition, 0);
+	s_quitThreads = false;
+	for (int i = 0; i < CC_SKELETON_UPDATE_THREADS; i++)
+		pthread_create(&s_updateThreads[i], 0, updateThread, 0);
+	s_threadsStarted = true;
+}
+
+static void stopThreads () {
+	if (!s_threadsStarted) return;
+	pthread_mutex_lock(&s_updateMutex);
+	s_quitThreads = true;
+	pthread_cond_broadcast(&s_workCondition);
+	pthread_mutex_unlock(&s_updateMutex);
+	for (int i = 0; i < CC_SKELETON_UPDATE_THREADS; i++)
+		pthread_join(s_updateThreads[i], 0);
+	pthread_mutex_destroy(&s_updateMutex);
+	pthread_cond_destroy(&s_workCondition);
+	pthread_cond_destroy(&s_doneCondition);
+	s_threadsStarted = false;
+}
+
+static void updateInParallel (SkeletonUpdate* updates, int count) {
+	if (!s_threadsStarted) startThreads();
+
+	pthread_mutex_lock(&s_updateMutex);
+	s_updates = updates;
+	s_updateCount = count;
+	s_nextUpdate = 0;
+	s_doneUpdates = 0;
+	// Several chunks for each thread, so that a thread given the heavier skeletons doesn't hold back the others.
+	s_chunkSize = max(1, count / ((CC_SKELETON_UPDATE_THREADS + 1) * 4));
+	s_batch++;
+	pthread_cond_broadcast(&s_workCondition);
+
+	runUpdates();
+	while (s_doneUpdates < s_updateCount)
+		pthread_cond_wait(&s_doneCondition, &s_updateMutex);
+
+	s_updates = 0;
+	s_updateCount = 0;
+	pthread_mutex_unlock(&s_updateMutex);
+}
+#else
+static void updateInParallel (SkeletonUpdate* updates, int count) {
+	for (int i = 0; i < count; i++)
+		updates[i].skeleton->updateAnimation(updates[i].deltaTime);
+}
+
+static void stopThreads () {
+}
+#endif
+
+/* Updates the queued skeletons. Scheduled after all the other updates while the parallel update is enabled. */
+class SkeletonUpdateQueue: public CCObject {
+public:
+	static void flush () {
+		if (s_queuedUpdates.empty()) return;
+		// The queue retains the skeletons until they are updated.
+		vector<SkeletonUpdate> updates;
+		updates.swap(s_queuedUpdates);
+		updateInParallel(&updates[0], (int)updates.size());
+		for (vector<SkeletonUpdate>::iterator iter = updates.begin(); iter != updates.end(); ++iter)
+			iter->skeleton->release();
+	}
+
+	virtual void update (float deltaTime) {
+		flush();
+	}
+};
+
+static SkeletonUpdateQueue* s_updateQueue = 0;
+
+void CCSkeletonAnimation::updateSkeletons (CCSkeletonAnimation** skeletons, int count, float deltaTime) {
+	if (count <= 0) return;
+	if (count == 1) {
+		skeletons[0]->updateAnimation(deltaTime);
+		return;
+	}
+	vector<SkeletonUpdate> updates(count);
+	for (int i = 0; i < count; i++) {
+		updates[i].skeleton = skeletons[i];
+		updates[i].deltaTime = deltaTime;
+	}
+	updateInParallel(&updates[0], count);
+}
+
+void CCSkeletonAnimation::setParallelUpdate (bool enabled) {
+	if (s_parallelUpdate == enabled) return;
+	s_parallelUpdate = enabled;
+
+	CCScheduler* scheduler = CCDirector::sharedDirector()->getScheduler();
+	if (enabled) {
+		s_updateQueue = new SkeletonUpdateQueue();
+		scheduler->scheduleUpdateForTarget(s_updateQueue, INT_MAX, false);
+	} else {
+		SkeletonUpdateQueue::flush();
+		scheduler->unscheduleUpdateForTarget(s_updateQueue);
+		CC_SAFE_RELEASE_NULL(s_updateQueue);
+		stopThreads();
+	}
+}
+
+bool CCSkeletonAnimation::isParallelUpdate () {
+	return s_parallelUpdate;
+}
+
+// ---
+
 CCSkeletonAnimation* CCSkeletonAnimation::createWithData (SkeletonData* skeletonData) {
 	CCSkeletonAnimation* node = new CCSkeletonAnimation(skeletonData);
 	node->autorelease();
@@ -79,6 +255,22 @@ CCSkeletonAnimation::~CCSkeletonAnimation () {
 }
 
 void CCSkeletonAnimation::update (float deltaTime) {
+	if (s_parallelUpdate) {
+		SkeletonUpdate update = {this, deltaTime};
+		s_queuedUpdates.push_back(update);
+		retain();
+		return;
+	}
+	updateAnimation(deltaTime);
+}
+
+void CCSkeletonAnimation::draw () {
+	// A skeleton queued after the batch ran, by an update scheduled after it, must not be drawn with its previous pose.
+	SkeletonUpdateQueue::flush();
+	super::draw();
+}
+
+void CCSkeletonAnimation::updateAnimation (float deltaTime) {
 	super::update(deltaTime);
 
 	deltaTime *= timeScale;
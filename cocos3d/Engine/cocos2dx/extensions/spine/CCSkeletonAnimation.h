@@ -30,6 +30,11 @@
 #include <spine/CCSkeleton.h>
 #include "cocos2d.h"
 
+/* The number of threads updating skeletons along with the main thread, see CCSkeletonAnimation::updateSkeletons. */
+#ifndef CC_SKELETON_UPDATE_THREADS
+#define CC_SKELETON_UPDATE_THREADS 3
+#endif
+
 namespace cocos2d { namespace extension {
 
 /**
@@ -50,6 +55,20 @@ public:
 	virtual ~CCSkeletonAnimation ();
 
 	virtual void update (float deltaTime);
+	virtual void draw ();
+
+	/* Applies the animation states and updates the world transform, which is what update does when the parallel update is disabled. */
+	void updateAnimation (float deltaTime);
+
+	/* Updates the given skeletons with updateAnimation, spread over CC_SKELETON_UPDATE_THREADS worker threads and the calling
+	 * thread. Skeletons don't share mutable state while they are updated, but a skeleton must not appear twice. Returns once all
+	 * the skeletons are updated. */
+	static void updateSkeletons (CCSkeletonAnimation** skeletons, int count, float deltaTime);
+
+	/* When enabled, update only queues the skeleton. All the skeletons queued in a frame are updated together with
+	 * updateSkeletons, after the other scheduled updates and before the scene is drawn. Disabled by default. */
+	static void setParallelUpdate (bool enabled);
+	static bool isParallelUpdate ();
 
 	void addAnimationState (AnimationStateData* stateData = 0);
 	void setAnimationStateData (AnimationStateData* stateData, int stateIndex = 0);
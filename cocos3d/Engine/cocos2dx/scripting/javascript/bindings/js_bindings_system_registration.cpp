@@ -24,11 +24,120 @@
 
 #include "js_bindings_config.h"
 #include "js_bindings_core.h"
+#include "js_manual_conversions.h"
 #include "LocalStorage.h"
 #include "cocos2d.h"
 
 // system
 #include "js_bindings_system_functions.h"
+#include <vector>
+
+// Arguments: 
+// Ret value: void
+static JSBool JSB_localStorageBeginTransaction(JSContext *cx, uint32_t argc, jsval *vp) {
+	JSB_PRECONDITION2( argc == 0, cx, JS_FALSE, "Invalid number of arguments" );
+
+	localStorageBeginTransaction();
+	JS_SET_RVAL(cx, vp, JSVAL_VOID);
+	return JS_TRUE;
+}
+
+// Arguments: 
+// Ret value: void
+static JSBool JSB_localStorageCommitTransaction(JSContext *cx, uint32_t argc, jsval *vp) {
+	JSB_PRECONDITION2( argc == 0, cx, JS_FALSE, "Invalid number of arguments" );
+
+	localStorageCommitTransaction();
+	JS_SET_RVAL(cx, vp, JSVAL_VOID);
+	return JS_TRUE;
+}
+
+// Arguments: 
+// Ret value: void
+static JSBool JSB_localStorageFlush(JSContext *cx, uint32_t argc, jsval *vp) {
+	JSB_PRECONDITION2( argc == 0, cx, JS_FALSE, "Invalid number of arguments" );
+
+	localStorageFlush();
+	JS_SET_RVAL(cx, vp, JSVAL_VOID);
+	return JS_TRUE;
+}
+
+// Arguments: double
+// Ret value: void
+static JSBool JSB_localStorageSetFlushInterval(JSContext *cx, uint32_t argc, jsval *vp) {
+	JSB_PRECONDITION2( argc == 1, cx, JS_FALSE, "Invalid number of arguments" );
+	jsval *argvp = JS_ARGV(cx,vp);
+	double arg0;
+
+	JSBool ok = JS_ValueToNumber( cx, *argvp++, &arg0 );
+	JSB_PRECONDITION2(ok, cx, JS_FALSE, "Error processing arguments");
+
+	localStorageSetFlushInterval((float)arg0);
+	JS_SET_RVAL(cx, vp, JSVAL_VOID);
+	return JS_TRUE;
+}
+
+// converts an array of strings. null and undefined elements are converted to NULL when allowed.
+static JSBool jsval_to_charptr_vector( JSContext *cx, jsval v, std::vector<const char*> &ret, bool allowNull )
+{
+	JSObject *jsobj;
+	JSBool ok = v.isObject() && JS_ValueToObject( cx, v, &jsobj );
+	JSB_PRECONDITION2( ok && jsobj && JS_IsArrayObject( cx, jsobj ), cx, JS_FALSE, "Object must be an array");
+
+	uint32_t len = 0;
+	JS_GetArrayLength(cx, jsobj, &len);
+	ret.resize(len);
+	for( uint32_t i=0; i< len;i++ ) {
+		jsval value;
+		ok = JS_GetElement(cx, jsobj, i, &value);
+		if (ok && allowNull && value.isNullOrUndefined())
+			ret[i] = NULL;
+		else
+			ok = ok && jsval_to_charptr( cx, value, &ret[i] );
+		JSB_PRECONDITION2(ok, cx, JS_FALSE, "Error processing arguments");
+	}
+	return JS_TRUE;
+}
+
+// Arguments: Array of String, Array of String
+// Ret value: void
+static JSBool JSB_localStorageSetItems(JSContext *cx, uint32_t argc, jsval *vp) {
+	JSB_PRECONDITION2( argc == 2, cx, JS_FALSE, "Invalid number of arguments" );
+	jsval *argvp = JS_ARGV(cx,vp);
+	std::vector<const char*> keys, values;
+
+	JSBool ok = jsval_to_charptr_vector( cx, *argvp++, keys, false );
+	ok = ok && jsval_to_charptr_vector( cx, *argvp++, values, true );
+	JSB_PRECONDITION2(ok && keys.size() == values.size(), cx, JS_FALSE, "Error processing arguments");
+
+	if (!keys.empty())
+		localStorageSetItems(&keys[0], &values[0], (int)keys.size());
+	JS_SET_RVAL(cx, vp, JSVAL_VOID);
+	return JS_TRUE;
+}
+
+// Arguments: Array of String
+// Ret value: Array of String, with null for the items that don't exist
+static JSBool JSB_localStorageGetItems(JSContext *cx, uint32_t argc, jsval *vp) {
+	JSB_PRECONDITION2( argc == 1, cx, JS_FALSE, "Invalid number of arguments" );
+	jsval *argvp = JS_ARGV(cx,vp);
+	std::vector<const char*> keys;
+
+	JSBool ok = jsval_to_charptr_vector( cx, *argvp++, keys, false );
+	JSB_PRECONDITION2(ok, cx, JS_FALSE, "Error processing arguments");
+
+	std::vector<const char*> values(keys.size());
+	if (!keys.empty())
+		localStorageGetItems(&keys[0], &values[0], (int)keys.size());
+
+	JSObject *jsretArr = JS_NewArrayObject(cx, 0, NULL);
+	for (uint32_t i = 0; i < values.size(); i++) {
+		jsval element = values[i] ? charptr_to_jsval( cx, values[i] ) : JSVAL_NULL;
+		JS_SetElement(cx, jsretArr, i, &element);
+	}
+	JS_SET_RVAL(cx, vp, OBJECT_TO_JSVAL(jsretArr));
+	return JS_TRUE;
+}
 
 
 void jsb_register_system( JSContext *_cx, JSObject *object)
@@ -49,6 +158,12 @@ void jsb_register_system( JSContext *_cx, JSObject *object)
 	// sys.localStorage functions
 	JSObject *system = ls;
 #include "js_bindings_system_functions_registration.h"
+	JS_DefineFunction(_cx, system, "beginTransaction", JSB_localStorageBeginTransaction, 0, JSPROP_READONLY | JSPROP_PERMANENT | JSPROP_ENUMERATE );
+	JS_DefineFunction(_cx, system, "commitTransaction", JSB_localStorageCommitTransaction, 0, JSPROP_READONLY | JSPROP_PERMANENT | JSPROP_ENUMERATE );
+	JS_DefineFunction(_cx, system, "flush", JSB_localStorageFlush, 0, JSPROP_READONLY | JSPROP_PERMANENT | JSPROP_ENUMERATE );
+	JS_DefineFunction(_cx, system, "setFlushInterval", JSB_localStorageSetFlushInterval, 1, JSPROP_READONLY | JSPROP_PERMANENT | JSPROP_ENUMERATE );
+	JS_DefineFunction(_cx, system, "setItems", JSB_localStorageSetItems, 2, JSPROP_READONLY | JSPROP_PERMANENT | JSPROP_ENUMERATE );
+	JS_DefineFunction(_cx, system, "getItems", JSB_localStorageGetItems, 1, JSPROP_READONLY | JSPROP_PERMANENT | JSPROP_ENUMERATE );
 	
 	
 	// Init DB with full path
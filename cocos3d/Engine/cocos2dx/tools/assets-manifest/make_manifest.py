@@ -0,0 +1,89 @@
+#!/usr/bin/python
+# make_manifest.py
+# Prepare a resource directory to be served to AssetsManager::setManifestUrl
+# Copyright (c) 2014 cocos2d-x.org
+
+# The output directory holds the file named 'manifest', and each resource file at the same path,
+# compressed with zlib unless that doesn't make it smaller. Each line of the manifest is:
+#   crc32 of the content, size of the content, size of the zlib stream or 0, path
+# with the numbers in hexadecimal. See extensions/AssetsManager/AssetsManager.h.
+
+from __future__ import print_function
+
+import sys
+import os, os.path
+import zlib
+import time
+from optparse import OptionParser
+
+# files that are already compressed gain nothing from being compressed again
+STORED_EXTENSIONS = ['.png', '.jpg', '.jpeg', '.webp', '.pvr', '.ccz', '.pkm', '.mp3', '.ogg', '.m4a', '.zip']
+
+def collectFiles(root):
+    files = []
+    for dirpath, dirnames, filenames in os.walk(root):
+        dirnames.sort()
+        for filename in sorted(filenames):
+            if filename.startswith('.'):
+                continue
+            fullpath = os.path.join(dirpath, filename)
+            files.append((os.path.relpath(fullpath, root).replace(os.sep, '/'), fullpath))
+    return files
+
+def makeManifest(root, output, compress, minRatio, verbose):
+    lines = []
+    total = 0
+    for (path, fullpath) in collectFiles(root):
+        if path == 'manifest':
+            print('skipping %s, which is the name of the manifest' % fullpath)
+            continue
+        with open(fullpath, 'rb') as f:
+            content = f.read()
+
+        stored = content
+        stored_size = 0
+        if compress and os.path.splitext(path)[1].lower() not in STORED_EXTENSIONS and len(content) > 0:
+            compressed = zlib.compress(content, 9)
+            if len(compressed) <= len(content) * minRatio:
+                stored = compressed
+                stored_size = len(compressed)
+
+        outpath = os.path.join(output, path.replace('/', os.sep))
+        if not os.path.isdir(os.path.dirname(outpath)):
+            os.makedirs(os.path.dirname(outpath))
+        with open(outpath, 'wb') as f:
+            f.write(stored)
+
+        lines.append('%08x %x %x %s\n' % (zlib.crc32(content) & 0xFFFFFFFF, len(content), stored_size, path))
+        total += len(stored)
+        if verbose:
+            print('%s: %d -> %d bytes' % (path, len(content), len(stored)))
+
+    with open(os.path.join(output, 'manifest'), 'w') as f:
+        f.writelines(lines)
+
+    return (len(lines), total)
+
+def main():
+    parser = OptionParser(usage='usage: %prog [options] RESOURCE_DIR OUTPUT_DIR')
+    parser.add_option('-n', '--no-compression', dest='compress', action='store_false', default=True,
+                      help='serve all the files uncompressed')
+    parser.add_option('-r', '--min-ratio', dest='min_ratio', type='float', default=0.9,
+                      help='files are only served compressed if that makes them smaller than this ratio [default: %default]')
+    parser.add_option('-v', '--verbose', dest='verbose', action='store_true', default=False,
+                      help='print the size of each file')
+    (options, args) = parser.parse_args()
+    if len(args) != 2 or not os.path.isdir(args[0]):
+        parser.print_help()
+        return 1
+    if os.path.abspath(args[0]) == os.path.abspath(args[1]):
+        print('the output directory must differ from the resource directory')
+        return 1
+
+    start = time.time()
+    (count, size) = makeManifest(args[0], args[1], options.compress, options.min_ratio, options.verbose)
+    print('wrote the manifest of %d files (%d bytes to serve) into %s in %.2fs' % (count, size, args[1], time.time() - start))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,116 @@
+#!/usr/bin/python
+# serve_assets.py
+# Serve a directory prepared by make_manifest.py over http, to test AssetsManager locally
+# Copyright (c) 2014 cocos2d-x.org
+
+# Unlike SimpleHTTPServer, ranges are supported, so that the downloads can be resumed, and
+# the connections are kept alive. The transfers can be slowed down, or interrupted, to test
+# how an application behaves on a bad network.
+
+from __future__ import print_function
+
+import sys
+import os, os.path
+import re
+import time
+from optparse import OptionParser
+
+try:
+    from http.server import BaseHTTPRequestHandler, HTTPServer
+    from socketserver import ThreadingMixIn
+    from urllib.parse import unquote
+except ImportError:
+    from BaseHTTPServer import BaseHTTPRequestHandler, HTTPServer
+    from SocketServer import ThreadingMixIn
+    from urllib import unquote
+
+CHUNK_SIZE = 16384
+
+class ThreadingHTTPServer(ThreadingMixIn, HTTPServer):
+    daemon_threads = True
+
+class AssetsHandler(BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+
+    def log_message(self, format, *args):
+        if self.server.options.verbose:
+            BaseHTTPRequestHandler.log_message(self, format, *args)
+
+    def sendError(self, code):
+        self.send_response(code)
+        self.send_header('Content-Length', '0')
+        self.end_headers()
+
+    def do_GET(self):
+        options = self.server.options
+        path = os.path.normpath(unquote(self.path.split('?')[0]).lstrip('/'))
+        fullpath = os.path.join(self.server.root, path)
+        if path.startswith('..') or os.path.isabs(path) or not os.path.isfile(fullpath):
+            return self.sendError(404)
+
+        size = os.path.getsize(fullpath)
+        start = 0
+        end = size - 1
+        match = re.match(r'bytes=(\d*)-(\d*)$', self.headers.get('Range', '')) if not options.no_ranges else None
+        if match and match.group(1):
+            start = int(match.group(1))
+            if match.group(2):
+                end = min(int(match.group(2)), size - 1)
+            if start >= size:
+                self.send_response(416)
+                self.send_header('Content-Range', 'bytes */%d' % size)
+                self.send_header('Content-Length', '0')
+                self.end_headers()
+                return
+            self.send_response(206)
+            self.send_header('Content-Range', 'bytes %d-%d/%d' % (start, end, size))
+        else:
+            self.send_response(200)
+        self.send_header('Content-Length', str(end - start + 1))
+        self.send_header('Accept-Ranges', 'none' if options.no_ranges else 'bytes')
+        self.end_headers()
+
+        # an interrupted transfer closes the connection once the limit is sent
+        remaining = end - start + 1
+        limit = options.interrupt_after if options.interrupt_after > 0 else remaining
+        with open(fullpath, 'rb') as f:
+            f.seek(start)
+            while remaining > 0 and limit > 0:
+                chunk = f.read(min(CHUNK_SIZE, remaining, limit))
+                self.wfile.write(chunk)
+                remaining -= len(chunk)
+                limit -= len(chunk)
+                if options.rate > 0:
+                    time.sleep(float(len(chunk)) / (options.rate * 1024))
+        if remaining > 0:
+            self.close_connection = True
+
+def main():
+    parser = OptionParser(usage='usage: %prog [options] DIRECTORY')
+    parser.add_option('-p', '--port', dest='port', type='int', default=8000,
+                      help='port to listen to [default: %default]')
+    parser.add_option('-r', '--rate', dest='rate', type='float', default=0,
+                      help='limit the rate of each transfer, in KB/s')
+    parser.add_option('-i', '--interrupt-after', dest='interrupt_after', type='int', default=0,
+                      help='close the connection after sending this number of bytes of a file')
+    parser.add_option('-n', '--no-ranges', dest='no_ranges', action='store_true', default=False,
+                      help='ignore the ranges, and always send the whole files')
+    parser.add_option('-v', '--verbose', dest='verbose', action='store_true', default=False,
+                      help='log the requests')
+    (options, args) = parser.parse_args()
+    if len(args) != 1 or not os.path.isdir(args[0]):
+        parser.print_help()
+        return 1
+
+    server = ThreadingHTTPServer(('127.0.0.1', options.port), AssetsHandler)
+    server.root = os.path.abspath(args[0])
+    server.options = options
+    print('serving %s on http://127.0.0.1:%d/' % (server.root, options.port))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
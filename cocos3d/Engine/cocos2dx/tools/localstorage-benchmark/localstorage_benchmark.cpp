@@ -0,0 +1,168 @@
+/****************************************************************************
+Copyright (c) 2014 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+/*
+ Measures the writes per second of the Local Storage with a file database.
+
+ "before" writes each item in its own transaction with a rollback journal, as the Local Storage did
+ before its writes were batched. The other runs use the Local Storage, which uses a write-ahead log.
+
+ Build it on linux once libcocos2d.so is built, from this directory:
+
+   g++ -O2 -DLINUX -I../../cocos2dx -I../../cocos2dx/include -I../../cocos2dx/kazmath/include \
+       -I../../cocos2dx/platform/linux -I../../extensions -I../../extensions/LocalStorage \
+       localstorage_benchmark.cpp ../../extensions/LocalStorage/LocalStorage.cpp \
+       ../../extensions/LocalStorage/LocalStorageCache.cpp \
+       -L../../lib/linux/release -lcocos2d -lsqlite3 -lpthread -o localstorage_benchmark
+
+ Usage: localstorage_benchmark [database path] [number of items]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+#include <unistd.h>
+#include <sqlite3.h>
+#include "LocalStorage.h"
+
+static double now()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void removeDatabase(const std::string& path)
+{
+    unlink(path.c_str());
+    unlink((path + "-journal").c_str());
+    unlink((path + "-wal").c_str());
+    unlink((path + "-shm").c_str());
+}
+
+static void report(const char* name, int count, double seconds)
+{
+    printf("%-32s %10.0f writes/s\n", name, count / seconds);
+}
+
+// writes each item in its own transaction, with the default rollback journal
+static double writeOneByOneWithoutBatching(const std::string& path, const std::vector<std::string>& keys)
+{
+    removeDatabase(path);
+    sqlite3 *db;
+    sqlite3_stmt *stmt;
+    sqlite3_open(path.c_str(), &db);
+    sqlite3_exec(db, "CREATE TABLE IF NOT EXISTS data(key TEXT PRIMARY KEY,value TEXT);", NULL, NULL, NULL);
+    sqlite3_prepare_v2(db, "REPLACE INTO data (key, value) VALUES (?,?);", -1, &stmt, NULL);
+
+    double start = now();
+    for (unsigned int i = 0; i < keys.size(); i++)
+    {
+        sqlite3_bind_text(stmt, 1, keys[i].c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, "value", -1, SQLITE_STATIC);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    double seconds = now() - start;
+
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return seconds;
+}
+
+static double writeOneByOne(const std::string& path, const std::vector<std::string>& keys)
+{
+    removeDatabase(path);
+    localStorageInit(path.c_str());
+
+    double start = now();
+    for (unsigned int i = 0; i < keys.size(); i++)
+        localStorageSetItem(keys[i].c_str(), "value");
+    double seconds = now() - start;
+
+    localStorageFree();
+    return seconds;
+}
+
+static double writeInBatches(const std::string& path, const std::vector<std::string>& keys, int batchSize)
+{
+    removeDatabase(path);
+    localStorageInit(path.c_str());
+
+    std::vector<const char*> batchKeys(batchSize);
+    std::vector<const char*> batchValues(batchSize, "value");
+    double start = now();
+    for (unsigned int i = 0; i < keys.size(); i += batchSize)
+    {
+        int count = 0;
+        for (; count < batchSize && i + count < keys.size(); count++)
+            batchKeys[count] = keys[i + count].c_str();
+        localStorageSetItems(&batchKeys[0], &batchValues[0], count);
+    }
+    double seconds = now() - start;
+
+    localStorageFree();
+    return seconds;
+}
+
+static double writeInOneTransaction(const std::string& path, const std::vector<std::string>& keys)
+{
+    removeDatabase(path);
+    localStorageInit(path.c_str());
+
+    double start = now();
+    localStorageBeginTransaction();
+    for (unsigned int i = 0; i < keys.size(); i++)
+        localStorageSetItem(keys[i].c_str(), "value");
+    localStorageCommitTransaction();
+    double seconds = now() - start;
+
+    localStorageFree();
+    return seconds;
+}
+
+int main(int argc, char** argv)
+{
+    std::string path = argc > 1 ? argv[1] : "localstorage_benchmark.sqlite";
+    int count = argc > 2 ? atoi(argv[2]) : 500;
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < count; i++)
+    {
+        char key[32];
+        sprintf(key, "key%d", i);
+        keys.push_back(key);
+    }
+
+    printf("%d distinct keys, database %s\n", count, path.c_str());
+    report("before, setItem one by one", count, writeOneByOneWithoutBatching(path, keys));
+    report("after, setItem one by one", count, writeOneByOne(path, keys));
+    report("after, setItems of 100 items", count, writeInBatches(path, keys, 100));
+    report("after, one transaction", count, writeInOneTransaction(path, keys));
+
+    removeDatabase(path);
+    return 0;
+}
@@ -0,0 +1,61 @@
+# lz4block.py
+# Minimal lz4 block compressor, matching ZipUtils::ccDecompressLZ4
+# Copyright (c) 2014 cocos2d-x.org
+
+MIN_MATCH = 4
+# the last match must start 12 bytes before the end, and the last 5 bytes are always literals
+MATCH_START_LIMIT = 12
+LAST_LITERALS = 5
+MAX_OFFSET = 65535
+
+def _writeLength(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+def _writeSequence(out, literals, offset, matchLength):
+    literalLength = len(literals)
+    token = min(literalLength, 15) << 4
+    if matchLength:
+        token |= min(matchLength - MIN_MATCH, 15)
+    out.append(token)
+    if literalLength >= 15:
+        _writeLength(out, literalLength - 15)
+    out += literals
+    if matchLength:
+        out.append(offset & 0xFF)
+        out.append(offset >> 8)
+        if matchLength - MIN_MATCH >= 15:
+            _writeLength(out, matchLength - MIN_MATCH - 15)
+
+def compress(data):
+    src = bytes(data)
+    n = len(src)
+    out = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+    while i < n - MATCH_START_LIMIT:
+        key = src[i:i + MIN_MATCH]
+        candidate = table.get(key)
+        table[key] = i
+        if candidate is None or i - candidate > MAX_OFFSET:
+            i += 1
+            continue
+
+        length = MIN_MATCH
+        maxLength = n - LAST_LITERALS - i
+        while length < maxLength and src[candidate + length] == src[i + length]:
+            length += 1
+
+        _writeSequence(out, src[anchor:i], i - candidate, length)
+        end = i + length
+        # index a few positions inside the match, which helps repetitive data
+        for j in range(i + 1, min(end, n - MATCH_START_LIMIT), 2):
+            table[src[j:j + MIN_MATCH]] = j
+        i = end
+        anchor = i
+
+    _writeSequence(out, src[anchor:], 0, 0)
+    return bytes(out)
@@ -0,0 +1,44 @@
+#!/usr/bin/python
+# make_ccz.py
+# Compress a file, typically a .pvr texture, into a CCZ file read by ZipUtils::ccInflateCCZFile
+# Copyright (c) 2014 cocos2d-x.org
+
+from __future__ import print_function
+
+import sys
+import struct
+import zlib
+from optparse import OptionParser
+
+import lz4block
+
+CCZ_COMPRESSION_ZLIB = 0
+CCZ_COMPRESSION_LZ4 = 4
+
+def main():
+    parser = OptionParser(usage='usage: %prog [options] INPUT OUTPUT.ccz')
+    parser.add_option('-c', '--compression', dest='compression', default='zlib',
+                      help='zlib, or lz4 which is larger but faster to load [default: %default]')
+    (options, args) = parser.parse_args()
+    if len(args) != 2 or options.compression not in ('zlib', 'lz4'):
+        parser.print_help()
+        return 1
+
+    with open(args[0], 'rb') as f:
+        content = f.read()
+
+    if options.compression == 'lz4':
+        (compression, compressed) = (CCZ_COMPRESSION_LZ4, lz4block.compress(content))
+    else:
+        (compression, compressed) = (CCZ_COMPRESSION_ZLIB, zlib.compress(content, 9))
+
+    # the CCZ header is big-endian: signature, compression, version, reserved, size
+    with open(args[1], 'wb') as f:
+        f.write(struct.pack('>4sHHII', b'CCZ!', compression, 2, 0, len(content)))
+        f.write(compressed)
+
+    print('%s: %d -> %d bytes' % (args[1], len(content), len(compressed) + 16))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,130 @@
+#!/usr/bin/python
+# pack_archive.py
+# Pack a resource directory into an archive that can be mounted with CCFileUtils::mountArchive
+# Copyright (c) 2014 cocos2d-x.org
+
+# Archive layout, all integers little-endian:
+#   header  : 'CCPK', version (u16), reserved (u16), entry count (u32), entry table offset (u32)
+#   data    : the stored content of each file, aligned on 16 bytes
+#   names   : the paths of the files, relative to the packed directory, with '/' separators
+#   entries : hash (u32), name offset (u32), name length (u16), compression (u16),
+#             data offset (u32), stored size (u32), size (u32), sorted by hash
+# The hash is the 32-bit FNV-1a of the path. See cocos2dx/platform/CCFileArchive.h.
+
+from __future__ import print_function
+
+import sys
+import os, os.path
+import struct
+import zlib
+import time
+from optparse import OptionParser
+
+import lz4block
+
+COMPRESSION_NONE = 0
+COMPRESSION_ZLIB = 1
+COMPRESSION_LZ4 = 2
+
+# files that are already compressed gain nothing from being compressed again,
+# and are kept uncompressed so that they can be read in place from the mapped archive
+STORED_EXTENSIONS = ['.png', '.jpg', '.jpeg', '.webp', '.pvr', '.ccz', '.pkm', '.mp3', '.ogg', '.m4a', '.zip']
+
+HEADER_FORMAT = '<4sHHII'
+ENTRY_FORMAT = '<IIHHIII'
+DATA_ALIGNMENT = 16
+
+def hashPath(path):
+    h = 2166136261
+    for c in bytearray(path):
+        h ^= c
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+def collectFiles(root):
+    files = []
+    for dirpath, dirnames, filenames in os.walk(root):
+        dirnames.sort()
+        for filename in sorted(filenames):
+            if filename.startswith('.'):
+                continue
+            fullpath = os.path.join(dirpath, filename)
+            files.append((os.path.relpath(fullpath, root).replace(os.sep, '/'), fullpath))
+    return files
+
+def storeFile(content, extension, compression, minRatio):
+    if compression == COMPRESSION_NONE or extension in STORED_EXTENSIONS or len(content) == 0:
+        return (COMPRESSION_NONE, content)
+    if compression == COMPRESSION_LZ4:
+        compressed = lz4block.compress(content)
+    else:
+        compressed = zlib.compress(content, 9)
+    if len(compressed) > len(content) * minRatio:
+        return (COMPRESSION_NONE, content)
+    return (compression, compressed)
+
+def packArchive(root, output, compression, minRatio, verbose):
+    files = collectFiles(root)
+
+    header_size = struct.calcsize(HEADER_FORMAT)
+    data = bytearray()
+    names = bytearray()
+    entries = []
+    for (path, fullpath) in files:
+        with open(fullpath, 'rb') as f:
+            content = f.read()
+        (stored_compression, stored) = storeFile(content, os.path.splitext(path)[1].lower(), compression, minRatio)
+
+        padding = (-(header_size + len(data))) % DATA_ALIGNMENT
+        data += b'\0' * padding
+        data_offset = header_size + len(data)
+        data += stored
+
+        name = path.encode('utf-8')
+        entries.append([hashPath(name), len(names), len(name), stored_compression, data_offset, len(stored), len(content)])
+        names += name
+
+        if verbose:
+            print('%s: %d -> %d bytes' % (path, len(content), len(stored)))
+
+    names_offset = header_size + len(data)
+    names += b'\0' * ((-(names_offset + len(names))) % 4)
+    entries_offset = names_offset + len(names)
+    for entry in entries:
+        entry[1] += names_offset
+    entries.sort(key=lambda entry: entry[0])
+
+    with open(output, 'wb') as f:
+        f.write(struct.pack(HEADER_FORMAT, b'CCPK', 1, 0, len(entries), entries_offset))
+        f.write(data)
+        f.write(names)
+        for entry in entries:
+            f.write(struct.pack(ENTRY_FORMAT, *entry))
+
+    return (len(entries), entries_offset + len(entries) * struct.calcsize(ENTRY_FORMAT))
+
+def main():
+    parser = OptionParser(usage='usage: %prog [options] RESOURCE_DIR OUTPUT_ARCHIVE')
+    parser.add_option('-c', '--compression', dest='compression', default='zlib',
+                      help='compression of the files that are not already compressed: none, zlib, or lz4 which is larger but faster to load [default: %default]')
+    parser.add_option('-r', '--min-ratio', dest='min_ratio', type='float', default=0.9,
+                      help='files are only stored compressed if that makes them smaller than this ratio [default: %default]')
+    parser.add_option('-v', '--verbose', dest='verbose', action='store_true', default=False,
+                      help='print the size of each packed file')
+    (options, args) = parser.parse_args()
+    if len(args) != 2 or not os.path.isdir(args[0]):
+        parser.print_help()
+        return 1
+
+    compressions = {'none': COMPRESSION_NONE, 'zlib': COMPRESSION_ZLIB, 'lz4': COMPRESSION_LZ4}
+    if options.compression not in compressions:
+        print('unknown compression: %s' % options.compression)
+        return 1
+
+    start = time.time()
+    (count, size) = packArchive(args[0], args[1], compressions[options.compression], options.min_ratio, options.verbose)
+    print('packed %d files into %s (%d bytes) in %.2fs' % (count, args[1], size, time.time() - start))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
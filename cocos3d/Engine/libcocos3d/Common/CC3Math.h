@@ -222,6 +222,63 @@ static inline bool isInRange( int x, int low, int high )
 	return  x >= low && x <= high;
 }
 
+/**
+ * Returns the IEEE 754 half-precision representation of the specified float value.
+ *
+ * Values too large to be represented are converted to infinity, and values too small
+ * are flushed to zero. Within the representable range, the relative error is below 2^-11.
+ */
+static inline unsigned short CC3HalfFloatFromFloat( float value )
+{
+	union { float f; unsigned int u; } bits;
+	bits.f = value;
+	unsigned int sign = (bits.u >> 16) & 0x8000;
+	int exponent = (int)((bits.u >> 23) & 0xFF) - 127 + 15;
+	unsigned int mantissa = bits.u & 0x007FFFFF;
+
+	if (((bits.u >> 23) & 0xFF) == 0xFF)			// Infinity or NaN
+		return (unsigned short)(sign | 0x7C00 | (mantissa ? 0x0200 : 0));
+	if (exponent >= 0x1F)							// Overflow to infinity
+		return (unsigned short)(sign | 0x7C00);
+	if (exponent <= 0)								// Denormalized or zero
+	{
+		if (exponent < -10) 
+			return (unsigned short)sign;
+		mantissa |= 0x00800000;
+		unsigned int shift = (unsigned int)(14 - exponent);
+		unsigned int halfMantissa = mantissa >> shift;
+		if ((mantissa >> (shift - 1)) & 1) halfMantissa++;		// Round to nearest
+		return (unsigned short)(sign | halfMantissa);
+	}
+	unsigned int half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+	if (mantissa & 0x00001000) half++;				// Round to nearest, carrying into the exponent
+	return (unsigned short)half;
+}
+
+/** Returns the float value of the specified IEEE 754 half-precision value. */
+static inline float CC3FloatFromHalfFloat( unsigned short half )
+{
+	unsigned int sign = ((unsigned int)half & 0x8000) << 16;
+	unsigned int exponent = (half >> 10) & 0x1F;
+	unsigned int mantissa = half & 0x03FF;
+	union { float f; unsigned int u; } bits;
+
+	if (exponent == 0x1F)							// Infinity or NaN
+	{
+		bits.u = sign | 0x7F800000 | (mantissa << 13);
+	}
+	else if (exponent == 0)							// Denormalized or zero
+	{
+		float value = mantissa * (1.0f / 16777216.0f);	// mantissa * 2^-24
+		return sign ? -value : value;
+	}
+	else
+	{
+		bits.u = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+	}
+	return bits.f;
+}
+
 
 NS_COCOS3D_END
 
@@ -36,6 +36,9 @@
 #include <unistd.h>
 #include <sys/time.h>
 #endif
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+#include <mach/mach_time.h>
+#endif
 
 NS_COCOS3D_BEGIN
 
@@ -85,4 +88,30 @@ unsigned long CC3Platform::getCurrentMilliseconds()
 #endif
 }
 
+unsigned long long CC3Platform::getCurrentMicroseconds()
+{
+#if defined(_WIN32)
+	static LARGE_INTEGER frequency = { 0 };
+	if ( frequency.QuadPart == 0 )
+		QueryPerformanceFrequency( &frequency );
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter( &counter );
+	return (unsigned long long)((counter.QuadPart / frequency.QuadPart) * 1000000 + 
+								((counter.QuadPart % frequency.QuadPart) * 1000000) / frequency.QuadPart);
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+	static mach_timebase_info_data_t timebase = { 0, 0 };
+	if ( timebase.denom == 0 )
+		mach_timebase_info( &timebase );
+
+	return (mach_absolute_time() * timebase.numer / timebase.denom) / 1000;
+#else
+	struct timespec now;
+	if ( clock_gettime( CLOCK_MONOTONIC, &now ) )
+		return 0;
+
+	return (unsigned long long)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#endif
+}
+
 NS_COCOS3D_END
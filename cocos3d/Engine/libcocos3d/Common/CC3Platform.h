@@ -32,6 +32,13 @@ class CC3Platform
 {
 public:
 	static unsigned long	getCurrentMilliseconds();
+
+	/**
+	 * Returns the current value of a monotonic, high-resolution clock, in microseconds. The value
+	 * is only meaningful relative to other values returned by this method, and is not affected
+	 * by changes to the wall-clock time of the device.
+	 */
+	static unsigned long long	getCurrentMicroseconds();
 };
 
 NS_COCOS3D_END
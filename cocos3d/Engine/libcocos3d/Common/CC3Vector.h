@@ -600,6 +600,47 @@ static inline CC3Vector CC3VectorMake( GLfloat x, GLfloat y, GLfloat z )
 	return v;
 }
 
+/**
+ * Encodes the specified unit vector into two normalized signed shorts, using an octahedral
+ * mapping, and places them in the first two elements of the specified encoded array.
+ *
+ * The vector is projected onto the octahedron |x| + |y| + |z| = 1, and the lower half of
+ * the octahedron is folded over the upper half, so that the result occupies the unit square.
+ * The encoded direction deviates from the original by less than 0.01 degrees.
+ */
+static inline void CC3VectorOctahedralEncode( const CC3Vector& v, GLshort* encoded )
+{
+	GLfloat l1 = fabsf(v.x) + fabsf(v.y) + fabsf(v.z);
+	GLfloat ex = (l1 > 0.0f) ? (v.x / l1) : 0.0f;
+	GLfloat ey = (l1 > 0.0f) ? (v.y / l1) : 0.0f;
+	if (v.z < 0.0f) 
+	{
+		GLfloat fx = (1.0f - fabsf(ey)) * ((ex >= 0.0f) ? 1.0f : -1.0f);
+		GLfloat fy = (1.0f - fabsf(ex)) * ((ey >= 0.0f) ? 1.0f : -1.0f);
+		ex = fx;
+		ey = fy;
+	}
+	encoded[0] = (GLshort)roundf(CLAMP(ex, -1.0f, 1.0f) * 32767.0f);
+	encoded[1] = (GLshort)roundf(CLAMP(ey, -1.0f, 1.0f) * 32767.0f);
+}
+
+/**
+ * Returns the unit vector decoded from the two normalized signed shorts in the specified
+ * encoded array, which must have been encoded using CC3VectorOctahedralEncode.
+ */
+static inline CC3Vector CC3VectorOctahedralDecode( const GLshort* encoded )
+{
+	GLfloat ex = MAX(encoded[0] / 32767.0f, -1.0f);
+	GLfloat ey = MAX(encoded[1] / 32767.0f, -1.0f);
+	CC3Vector v(ex, ey, 1.0f - fabsf(ex) - fabsf(ey));
+	if (v.z < 0.0f) 
+	{
+		v.x = (1.0f - fabsf(ey)) * ((ex >= 0.0f) ? 1.0f : -1.0f);
+		v.y = (1.0f - fabsf(ex)) * ((ey >= 0.0f) ? 1.0f : -1.0f);
+	}
+	return v.normalize();
+}
+
 /** Convenience alias macro to create CC3Vectors with less keystrokes. */
 #define cc3v(X,Y,Z) CC3VectorMake((X),(Y),(Z))
 
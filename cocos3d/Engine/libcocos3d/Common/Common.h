@@ -82,13 +82,25 @@ USING_NS_CC_EXT;
 #define CC3_ERROR( format, ... )		cocos3d::CLoggers::sharedLoggers()->logMessage( cocos3d::CC3_LOG_ERROR, format, ##__VA_ARGS__ )
 #define CC3_WARNING( format, ... )		cocos3d::CLoggers::sharedLoggers()->logMessage( cocos3d::CC3_LOG_WARNING, format, ##__VA_ARGS__ )
 #define CC3_TAG( tag, format, ... )		cocos3d::CLoggers::sharedLoggers()->logMessage( cocos3d::CC3_LOG_INFO, tag format, ##__VA_ARGS__ )
+#define CC3_TRACE_RATE_LIMITED( maxPerSecond, format, ... )		CC3_LOG_RATE_LIMITED( cocos3d::CC3_LOG_INFO, maxPerSecond, format, ##__VA_ARGS__ )
+#define CC3_WARNING_RATE_LIMITED( maxPerSecond, format, ... )	CC3_LOG_RATE_LIMITED( cocos3d::CC3_LOG_WARNING, maxPerSecond, format, ##__VA_ARGS__ )
 #else
 #define CC3_TRACE( format, ... )		
 #define CC3_ERROR( format, ... )		
 #define CC3_WARNING( format, ... )	
 #define CC3_TAG( tag, format, ... )	
+#define CC3_TRACE_RATE_LIMITED( maxPerSecond, format, ... )	
+#define CC3_WARNING_RATE_LIMITED( maxPerSecond, format, ... )	
 #endif
 
+/** Logs a message at the specified level, from a call site that logs at most maxPerSecond messages per second. */
+#define CC3_LOG_RATE_LIMITED( level, maxPerSecond, format, ... )												\
+	do {																										\
+		static cocos3d::CC3LogCallSite _cc3LogCallSite = { 0, 0, 0 };											\
+		if ( cocos3d::CLoggers::sharedLoggers()->shouldLogFromCallSite( _cc3LogCallSite, level, maxPerSecond ) )	\
+			cocos3d::CLoggers::sharedLoggers()->logMessage( level, format, ##__VA_ARGS__ );					\
+	} while (0)
+
 /************************************************************************/
 
 /************************************************************************/
@@ -24,6 +24,11 @@
  * http://en.wikipedia.org/wiki/MIT_License
  */
 #include "cocos3d.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 NS_COCOS3D_BEGIN
 
@@ -37,40 +42,108 @@ static const char* logLevels[] =
 	"UNKNOWN",
 };
 
+/** The severity of each CC3LogLevel, since the enumeration is not ordered by severity. */
+static const int logSeverities[] =
+{
+	0,		// CC3_LOG_INFO
+	2,		// CC3_LOG_ERROR
+	1,		// CC3_LOG_WARNING
+	3,		// CC3_LOG_MAX
+};
+
+#ifdef _WIN32
+static inline bool CC3LogCompareAndSwap( volatile unsigned int* value, unsigned int expected, unsigned int desired )
+{
+	return (unsigned int)InterlockedCompareExchange( (volatile LONG*)value, (LONG)desired, (LONG)expected ) == expected;
+}
+#define CC3LogMemoryBarrier()		MemoryBarrier()
+#define CC3LogSleep( ms )			Sleep( ms )
+#else
+static inline bool CC3LogCompareAndSwap( volatile unsigned int* value, unsigned int expected, unsigned int desired )
+{
+	return __sync_bool_compare_and_swap( value, expected, desired );
+}
+#define CC3LogMemoryBarrier()		__sync_synchronize()
+#define CC3LogSleep( ms )			usleep( (ms) * 1000 )
+#endif
+
+static inline int CC3LogSeverity( int level )
+{
+	return logSeverities[(level >= 0 && level <= CC3_LOG_MAX) ? level : CC3_LOG_MAX];
+}
+
 CLoggers::CLoggers()
 {
 	m_bShowSystemTime = true;
+	m_minimumLevel = CC3_LOG_INFO;
+	m_isAsynchronous = false;
+	m_shouldStopDraining = false;
+	m_queue = NULL;
+	m_enqueuePosition = 0;
+	m_dequeuePosition = 0;
+	m_droppedCount = 0;
+	pthread_mutex_init( &m_drainMutex, NULL );
+	pthread_cond_init( &m_drainedCondition, NULL );
 }
 
 CLoggers::~CLoggers()
 {
-
+	setIsAsynchronous( false );
+	CC_SAFE_DELETE_ARRAY( m_queue );
+	pthread_cond_destroy( &m_drainedCondition );
+	pthread_mutex_destroy( &m_drainMutex );
 }
 
 void CLoggers::logMessage( int level, const char* format, ... )
 {
-	char buffer[512];  // large buffers
-	GetVarargs(buffer, 512, format);
-	std::string prefix = "";
-	if ( m_bShowSystemTime )
-		prefix = "[" + CC3String::getSystemTime() + "]";
+	// Discard unwanted messages before paying for formatting
+	if ( !isLevelEnabled( level ) )
+		return;
 
-	prefix += level <= CC3_LOG_MAX ? logLevels[level] : logLevels[CC3_LOG_MAX];
-	prefix += ":";
+	char buffer[kCC3LogMessageLength];  // large buffers
+	GetVarargs(buffer, kCC3LogMessageLength, format);
 
-	for( unsigned int i = 0; i < m_allLogger.size(); i++ )
+	if ( m_isAsynchronous )
+		enqueueMessage( level, buffer );
+	else
+		dispatchMessage( level, time( NULL ), buffer );
+}
+
+void CLoggers::logMessageDirectly( int level, const std::string& msg )
+{
+	if ( !isLevelEnabled( level ) )
+		return;
+
+	if ( !m_isAsynchronous )
 	{
-		m_allLogger[i]->logMessage( prefix + buffer );
+		dispatchMessage( level, time( NULL ), msg.c_str() );
+		return;
 	}
+
+	// Long messages, such as shader source code, are queued in several records
+	char buffer[kCC3LogMessageLength];
+	size_t chunkLength = kCC3LogMessageLength - 1;
+	size_t pos = 0;
+	do
+	{
+		size_t len = msg.copy( buffer, chunkLength, pos );
+		buffer[len] = 0;
+		enqueueMessage( level, buffer );
+		pos += len;
+	} while ( pos < msg.length() );
 }
 
-void CLoggers::logMessageDirectly( int level, const std::string& msg )
+void CLoggers::dispatchMessage( int level, time_t logTime, const char* msg )
 {
 	std::string prefix = "";
 	if ( m_bShowSystemTime )
-		prefix = "[" + CC3String::getSystemTime() + "]";
+	{
+		char szTime[128] = { 0 };
+		strftime( szTime, 128, "%Y/%m/%d %H:%M:%S", localtime( &logTime ) );
+		prefix = "[" + std::string( szTime ) + "]";
+	}
 
-	prefix += level <= CC3_LOG_MAX ? logLevels[level] : logLevels[CC3_LOG_MAX];
+	prefix += (level >= 0 && level <= CC3_LOG_MAX) ? logLevels[level] : logLevels[CC3_LOG_MAX];
 	prefix += ":";
 
 	for( unsigned int i = 0; i < m_allLogger.size(); i++ )
@@ -79,6 +152,125 @@ void CLoggers::logMessageDirectly( int level, const std::string& msg )
 	}
 }
 
+/**
+ * Claims the next slot of the queue and copies the message into it. Each slot carries a sequence
+ * number that tells producers whether the slot is free for the current lap around the queue, and
+ * tells the consumer whether the slot has been completely written.
+ */
+void CLoggers::enqueueMessage( int level, const char* msg )
+{
+	unsigned int pos = m_enqueuePosition;
+	for (;;)
+	{
+		CC3LogRecord& record = m_queue[pos & (kCC3LogQueueCapacity - 1)];
+		int diff = (int)(record.sequence - pos);
+		if ( diff == 0 )
+		{
+			if ( CC3LogCompareAndSwap( &m_enqueuePosition, pos, pos + 1 ) )
+			{
+				record.level = level;
+				record.time = time( NULL );
+				strncpy( record.message, msg, kCC3LogMessageLength - 1 );
+				record.message[kCC3LogMessageLength - 1] = 0;
+
+				CC3LogMemoryBarrier();		// Publish the content before the sequence
+				record.sequence = pos + 1;
+				return;
+			}
+		}
+		else if ( diff < 0 )
+		{
+			// The queue is full. Drop the message, rather than block the logging thread.
+			unsigned int dropped;
+			do { dropped = m_droppedCount; } while ( !CC3LogCompareAndSwap( &m_droppedCount, dropped, dropped + 1 ) );
+			return;
+		}
+		pos = m_enqueuePosition;
+	}
+}
+
+bool CLoggers::drainQueue()
+{
+	bool didDrain = false;
+	for (;;)
+	{
+		unsigned int pos = m_dequeuePosition;
+		CC3LogRecord& record = m_queue[pos & (kCC3LogQueueCapacity - 1)];
+		if ( (int)(record.sequence - (pos + 1)) < 0 )
+			break;
+
+		CC3LogMemoryBarrier();		// Read the content only after the sequence
+		dispatchMessage( record.level, record.time, record.message );
+
+		CC3LogMemoryBarrier();		// Release the slot to producers on their next lap
+		record.sequence = pos + kCC3LogQueueCapacity;
+		m_dequeuePosition = pos + 1;
+		didDrain = true;
+	}
+
+	unsigned int dropped = m_droppedCount;
+	if ( dropped && CC3LogCompareAndSwap( &m_droppedCount, dropped, 0 ) )
+	{
+		char buffer[kCC3LogMessageLength];
+		sprintf( buffer, "%u log messages were dropped because the log queue was full", dropped );
+		dispatchMessage( CC3_LOG_WARNING, time( NULL ), buffer );
+	}
+
+	return didDrain;
+}
+
+/**
+ * Wakes the threads waiting in flush(). The positions of the queue have already been updated,
+ * and taking the mutex ensures that a thread that found the queue not empty is already waiting.
+ */
+void CLoggers::signalDrained()
+{
+	pthread_mutex_lock( &m_drainMutex );
+	pthread_cond_broadcast( &m_drainedCondition );
+	pthread_mutex_unlock( &m_drainMutex );
+}
+
+void* CLoggers::drainThreadMain( void* pLoggers )
+{
+	CLoggers* loggers = (CLoggers*)pLoggers;
+	while ( !loggers->m_shouldStopDraining )
+	{
+		if ( loggers->drainQueue() )
+			loggers->signalDrained();
+		else
+			CC3LogSleep( kCC3LogDrainInterval );
+	}
+
+	loggers->drainQueue();
+	return NULL;
+}
+
+void CLoggers::startDrainThread()
+{
+	// The queue is retained until this instance is deleted, in case a thread
+	// is still writing to it when asynchronous logging is turned off.
+	if ( !m_queue )
+		m_queue = new CC3LogRecord[kCC3LogQueueCapacity];
+
+	for (unsigned int i = 0; i < kCC3LogQueueCapacity; i++)
+		m_queue[i].sequence = i;
+	m_enqueuePosition = 0;
+	m_dequeuePosition = 0;
+	m_droppedCount = 0;
+	m_shouldStopDraining = false;
+
+	CC3LogMemoryBarrier();
+	pthread_create( &m_drainThread, NULL, &CLoggers::drainThreadMain, this );
+}
+
+void CLoggers::stopDrainThread()
+{
+	m_shouldStopDraining = true;
+	pthread_join( m_drainThread, NULL );
+	drainQueue();		// Anything queued while the thread was stopping
+	signalDrained();	// Releases flush(), which returns once logging is synchronous
+}
+
 void CLoggers::addLogger( CLogDelegate* pLogger )
 {
 	m_allLogger.push_back( pLogger );
@@ -94,4 +286,76 @@ bool CLoggers::isShowTime()
 	return m_bShowSystemTime;
 }
 
+int CLoggers::getMinimumLevel()
+{
+	return m_minimumLevel;
+}
+
+void CLoggers::setMinimumLevel( int level )
+{
+	m_minimumLevel = level;
+}
+
+bool CLoggers::isLevelEnabled( int level )
+{
+	return CC3LogSeverity( level ) >= CC3LogSeverity( m_minimumLevel );
+}
+
+bool CLoggers::isAsynchronous()
+{
+	return m_isAsynchronous;
+}
+
+void CLoggers::setIsAsynchronous( bool isAsynchronous )
+{
+	if ( isAsynchronous == m_isAsynchronous )
+		return;
+
+	if ( isAsynchronous )
+	{
+		startDrainThread();
+		m_isAsynchronous = true;
+	}
+	else
+	{
+		m_isAsynchronous = false;
+		stopDrainThread();
+	}
+}
+
+void CLoggers::flush()
+{
+	pthread_mutex_lock( &m_drainMutex );
+	while ( m_isAsynchronous && m_dequeuePosition != m_enqueuePosition )
+		pthread_cond_wait( &m_drainedCondition, &m_drainMutex );
+	pthread_mutex_unlock( &m_drainMutex );
+}
+
+bool CLoggers::shouldLogFromCallSite( CC3LogCallSite& callSite, int level, unsigned int maxPerSecond )
+{
+	if ( !isLevelEnabled( level ) )
+		return false;
+
+	unsigned long now = CC3Platform::getCurrentMilliseconds();
+	if ( callSite.windowStart == 0 || (now - callSite.windowStart) >= 1000 )
+	{
+		callSite.windowStart = now;
+		callSite.windowCount = 0;
+	}
+
+	if ( callSite.windowCount >= maxPerSecond )
+	{
+		callSite.suppressedCount++;
+		return false;
+	}
+
+	callSite.windowCount++;
+	if ( callSite.suppressedCount )
+	{
+		logMessage( level, "%u similar messages were suppressed", callSite.suppressedCount );
+		callSite.suppressedCount = 0;
+	}
+	return true;
+}
+
 NS_COCOS3D_END
@@ -25,6 +25,7 @@
  */
 #ifndef _CCL_CC3_LOGGERS_H_
 #define _CCL_CC3_LOGGERS_H_
+#include <pthread.h>
 
 NS_COCOS3D_BEGIN
 
@@ -36,7 +37,48 @@ enum CC3LogLevel
 	CC3_LOG_MAX,
 };
 
+/** The maximum length of a formatted log message, including the terminating null. */
+#define kCC3LogMessageLength		512
+
+/** The number of log records held by the asynchronous log queue. Must be a power of two. */
+#define kCC3LogQueueCapacity		1024
+
+/** The interval at which the background log thread checks for new records, in milliseconds. */
+#define kCC3LogDrainInterval		5
+
+/** The state of a rate-limited logging call site. See the CC3_TRACE_RATE_LIMITED macro. */
+typedef struct
+{
+	unsigned long		windowStart;		/**< The start of the current one-second window, in milliseconds. */
+	unsigned int		windowCount;		/**< The number of messages logged during the current window. */
+	unsigned int		suppressedCount;	/**< The number of messages suppressed since the last message logged. */
+} CC3LogCallSite;
+
+/** A single formatted message waiting in the asynchronous log queue. */
+typedef struct
+{
+	volatile unsigned int	sequence;		/**< Coordinates producers and the consumer of this slot. */
+	int						level;			/**< The CC3LogLevel of the message. */
+	time_t					time;			/**< The time at which the message was logged. */
+	char					message[kCC3LogMessageLength];
+} CC3LogRecord;
+
 class CLogDelegate;
+
+/**
+ * CLoggers formats log messages and passes them to each registered CLogDelegate.
+ *
+ * Messages whose level is less severe than the minimumLevel property are discarded before
+ * they are formatted. In order of increasing severity, the levels are CC3_LOG_INFO,
+ * CC3_LOG_WARNING and CC3_LOG_ERROR.
+ *
+ * By default, log delegates are invoked on the thread that logs each message. When the
+ * isAsynchronous property is enabled, each formatted message is instead placed in a bounded
+ * queue, which any number of threads can write to without taking a lock, and a background
+ * thread passes the queued messages to the log delegates, in order. If the queue is full,
+ * the message is dropped, and the number of dropped messages is reported once space is
+ * available. Log delegates must therefore be safe to invoke from the background thread.
+ */
 class CLoggers
 {
 public:
@@ -52,10 +94,64 @@ public:
 	void				setShowTime( bool showTime );
 	bool				isShowTime();
 
+	/**
+	 * The least severe level of message that is logged. Messages of less severe levels are
+	 * discarded before they are formatted. The initial value of this property is CC3_LOG_INFO.
+	 */
+	int					getMinimumLevel();
+	void				setMinimumLevel( int level );
+
+	/** Returns whether messages of the specified level are logged. */
+	bool				isLevelEnabled( int level );
+
+	/**
+	 * Indicates whether log delegates are invoked from a background thread, instead of from the
+	 * thread that logs each message. Disabling this property flushes any queued messages.
+	 *
+	 * The log delegates must all be added before this property is enabled. The initial value
+	 * of this property is NO.
+	 */
+	bool				isAsynchronous();
+	void				setIsAsynchronous( bool isAsynchronous );
+
+	/** Waits until all queued messages have been passed to the log delegates. */
+	void				flush();
+
+	/**
+	 * Returns whether a message from the call site with the specified state should be logged,
+	 * allowing at most the specified number of messages per second from that call site. When
+	 * logging resumes after messages have been suppressed, the number of suppressed messages
+	 * is logged first. Usually, the application will use the rate-limited logging macros,
+	 * such as CC3_TRACE_RATE_LIMITED, instead of invoking this method directly.
+	 *
+	 * The call site state is not guarded against concurrent access, so the count of messages
+	 * from a call site used by several threads at once is approximate.
+	 */
+	bool				shouldLogFromCallSite( CC3LogCallSite& callSite, int level, unsigned int maxPerSecond );
+
+protected:
+	void				dispatchMessage( int level, time_t logTime, const char* msg );
+	void				enqueueMessage( int level, const char* msg );
+	bool				drainQueue();
+	void				signalDrained();
+	void				startDrainThread();
+	void				stopDrainThread();
+	static void*		drainThreadMain( void* pLoggers );
+
 private:
 	typedef std::vector<CLogDelegate*> Loggers;
 	Loggers				m_allLogger;
 	bool				m_bShowSystemTime;
+	int					m_minimumLevel;
+	volatile bool		m_isAsynchronous;
+	volatile bool		m_shouldStopDraining;
+	pthread_t			m_drainThread;
+	pthread_mutex_t		m_drainMutex;			// Guards the waits for m_drainedCondition
+	pthread_cond_t		m_drainedCondition;		// Signaled whenever the drain thread has emptied the queue
+	CC3LogRecord*		m_queue;
+	volatile unsigned int	m_enqueuePosition;
+	volatile unsigned int	m_dequeuePosition;
+	volatile unsigned int	m_droppedCount;
 };
 
 NS_COCOS3D_END
@@ -46,10 +46,14 @@ CC3Texture::CC3Texture()
 {
 	m_textureID = 0;
 	m_ccTexture = NULL;
+	m_isStreamed = false;
 }
 
 CC3Texture::~CC3Texture()
 {
+	if ( m_isStreamed )
+		CC3TextureStreamer::sharedTextureStreamer()->removeTexture( this );
+
 	remove();
 	deleteGLTexture();
 	CC_SAFE_RELEASE( m_ccTexture ); 
@@ -492,6 +496,10 @@ void CC3Texture::drawWithVisitor( CC3NodeDrawingVisitor* visitor )
 	gl->enableTexturing( true, target, tuIdx );
 	gl->bindTexture( getTextureID(), target, tuIdx );
 
+	CC3Texture* tex = getTexture();
+	if ( tex->isStreamed() )
+		CC3TextureStreamer::sharedTextureStreamer()->textureWasDrawn( tex, visitor );
+
 	bindTextureParametersAt( tuIdx, gl );
 	bindTextureEnvironmentWithVisitor( visitor );
 
@@ -567,6 +575,9 @@ bool CC3Texture::loadTarget( GLenum target, const std::string& filePath )
 
 bool CC3Texture::loadFromFile( const std::string& filePath )
 {
+	if ( isTexture2D() && CC3TextureStreamer::isStreamingEnabled() )
+		return CC3TextureStreamer::sharedTextureStreamer()->loadTextureFromFile( this, filePath );
+
 	bool wasLoaded = loadTarget( getTextureTarget(), filePath );
 	if (wasLoaded && shouldGenerateMipmaps()) 
 		generateMipmap();
@@ -576,6 +587,29 @@ bool CC3Texture::loadFromFile( const std::string& filePath )
 	return wasLoaded;
 }
 
+bool CC3Texture::isStreamed()
+{
+	return m_isStreamed;
+}
+
+void CC3Texture::setIsStreamed( bool isStreamed )
+{
+	m_isStreamed = isStreamed;
+}
+
+/** The GL texture is re-specified at the size of the content, so any existing mipmap must be regenerated. */
+void CC3Texture::bindStreamedContent( CC3CCTexture* texContent )
+{
+	m_hasMipmap = false;
+	markTextureParametersDirty();
+
+	bindTextureContent( texContent, getTextureTarget() );
+	if ( shouldGenerateMipmaps() )
+		generateMipmap();
+
+	checkGLDebugLabel();
+}
+
 void CC3Texture::checkTextureOrientation( CC3CCTexture* texContent )
 {
 	bool flipHorz = shouldFlipHorizontallyOnLoad();
@@ -1368,6 +1402,53 @@ void CC3Texture2DContent::deleteImageData()
 	CC_SAFE_FREE( m_imageData );
 }
 
+bool CC3Texture2DContent::downsample( GLuint levels )
+{
+	if ( levels == 0 )
+		return true;
+
+	if ( !m_imageData || getPixelGLType() != GL_UNSIGNED_BYTE )
+		return false;
+
+	GLuint bytesPerPixel = getBytesPerPixel();
+	GLuint srcWidth = (GLuint)getPixelWidth();
+	GLuint srcHeight = (GLuint)getPixelHeight();
+
+	for ( GLuint lvl = 0; lvl < levels && (srcWidth > 1 || srcHeight > 1); lvl++ )
+	{
+		GLuint dstWidth = MAX(srcWidth / 2, 1);
+		GLuint dstHeight = MAX(srcHeight / 2, 1);
+		GLuint srcStride = srcWidth * bytesPerPixel;
+
+		// Reduce in place. Each destination pixel is written after its source pixels have been read.
+		GLubyte* pixels = (GLubyte*)m_imageData;
+		GLubyte* dst = pixels;
+		for ( GLuint row = 0; row < dstHeight; row++ )
+		{
+			const GLubyte* srcRow0 = pixels + (row * 2) * srcStride;
+			const GLubyte* srcRow1 = (srcHeight > 1) ? (srcRow0 + srcStride) : srcRow0;
+			for ( GLuint col = 0; col < dstWidth; col++ )
+			{
+				GLuint c0 = (col * 2) * bytesPerPixel;
+				GLuint c1 = (srcWidth > 1) ? (c0 + bytesPerPixel) : c0;
+				for ( GLuint b = 0; b < bytesPerPixel; b++ )
+					*dst++ = (GLubyte)((srcRow0[c0 + b] + srcRow0[c1 + b] + srcRow1[c0 + b] + srcRow1[c1 + b] + 2) >> 2);
+			}
+		}
+
+		srcWidth = dstWidth;
+		srcHeight = dstHeight;
+	}
+
+	m_uPixelsWide = srcWidth;
+	m_uPixelsHigh = srcHeight;
+	m_tContentSize = CCSizeMake( (float)srcWidth, (float)srcHeight );
+	m_fMaxS = 1.0f;
+	m_fMaxT = 1.0f;
+
+	return true;
+}
+
 bool CC3Texture2DContent::initWithSize( const CC3IntSize& size, const ccColor4B& color )
 {
 	if ( initWithSize( size, GL_RGBA, GL_UNSIGNED_BYTE ) ) 
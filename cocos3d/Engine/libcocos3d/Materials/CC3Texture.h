@@ -1295,6 +1295,21 @@ public:
 	 */
 	virtual void			cacheCCTexture2D();
 
+	/**
+	 * Indicates whether the mip chain of this texture is being managed by the shared CC3TextureStreamer.
+	 *
+	 * When this property is YES, the size property reflects the size of the finest mip level currently
+	 * held in GL memory. See the notes for CC3TextureStreamer for more information.
+	 */
+	virtual bool			isStreamed();
+	virtual void			setIsStreamed( bool isStreamed );
+
+	/**
+	 * Replaces the GL content of this texture with the specified content, and regenerates the mipmap
+	 * if needed. This is used by CC3TextureStreamer to change the mip levels held in GL memory.
+	 */
+	virtual void			bindStreamedContent( CC3CCTexture* texContent );
+
 protected:
 	virtual bool			loadTarget( GLenum target, const std::string& filePath );
 	virtual bool			loadFromFile( const std::string& filePath );
@@ -1319,6 +1334,7 @@ protected:
 	bool					m_shouldFlipHorizontallyOnLoad : 1;
 	bool					m_hasAlpha : 1;
 	bool					m_hasPremultipliedAlpha : 1;
+	bool					m_isStreamed : 1;
 };
 
 /**
@@ -1940,6 +1956,15 @@ public:
 	 */
 	void					deleteImageData();
 
+	/**
+	 * Reduces the image content of this texture in main memory by the specified number of mip
+	 * levels, halving the width and height for each level, by averaging each 2x2 block of pixels.
+	 *
+	 * Only content whose pixel type is GL_UNSIGNED_BYTE can be reduced. Returns whether the
+	 * content was reduced. This is used by CC3TextureStreamer to load partial mip chains.
+	 */
+	bool					downsample( GLuint levels );
+
 	/**
 	 * Initializes this instance with content loaded from the specified file.
 	 *
@@ -0,0 +1,452 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#include "cocos3d.h"
+
+NS_COCOS3D_BEGIN
+
+static CC3TextureStreamer* _sharedTextureStreamer = NULL;
+static bool _isStreamingEnabled = false;
+
+CC3TextureStreamer::CC3TextureStreamer()
+{
+	m_byteBudget = kCC3TextureStreamerDefaultByteBudget;
+	m_residentBytes = 0;
+	m_initialDimension = kCC3TextureStreamerDefaultInitialDimension;
+	m_maxChangesPerFrame = kCC3TextureStreamerDefaultMaxChangesPerFrame;
+	m_frameCount = 0;
+	m_mipBias = 0.0f;
+}
+
+CC3TextureStreamer::~CC3TextureStreamer()
+{
+	for ( CC3TextureResidencies::iterator it = m_residencies.begin(); it != m_residencies.end(); ++it )
+		it->first->setIsStreamed( false );
+
+	m_residencies.clear();
+	pthread_mutex_destroy( &m_mutex );
+}
+
+void CC3TextureStreamer::init()
+{
+	// Recursive, because the locked methods invoke each other
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init( &attr );
+	pthread_mutexattr_settype( &attr, PTHREAD_MUTEX_RECURSIVE );
+	pthread_mutex_init( &m_mutex, &attr );
+	pthread_mutexattr_destroy( &attr );
+}
+
+/** Locks the mutex of a streamer for the lifetime of this object. */
+class CC3TextureStreamerLock
+{
+public:
+	CC3TextureStreamerLock( pthread_mutex_t* mutex ) : m_mutex( mutex )	{ pthread_mutex_lock( m_mutex ); }
+	~CC3TextureStreamerLock()											{ pthread_mutex_unlock( m_mutex ); }
+
+protected:
+	pthread_mutex_t*			m_mutex;
+};
+
+CC3TextureStreamer* CC3TextureStreamer::sharedTextureStreamer()
+{
+	if ( !_sharedTextureStreamer )
+	{
+		_sharedTextureStreamer = new CC3TextureStreamer;		// retained
+		_sharedTextureStreamer->init();
+	}
+
+	return _sharedTextureStreamer;
+}
+
+void CC3TextureStreamer::purge()
+{
+	CC_SAFE_RELEASE_NULL( _sharedTextureStreamer );
+}
+
+bool CC3TextureStreamer::isStreamingEnabled()
+{
+	return _isStreamingEnabled;
+}
+
+void CC3TextureStreamer::setIsStreamingEnabled( bool isEnabled )
+{
+	// Create the shared streamer now, rather than from the first texture loaded, possibly by a background thread
+	if ( isEnabled )
+		sharedTextureStreamer();
+
+	_isStreamingEnabled = isEnabled;
+}
+
+GLuint CC3TextureStreamer::getByteBudget()
+{
+	return m_byteBudget;
+}
+
+void CC3TextureStreamer::setByteBudget( GLuint byteBudget )
+{
+	CC3TextureStreamerLock lock( &m_mutex );
+	m_byteBudget = byteBudget;
+}
+
+GLuint CC3TextureStreamer::getInitialDimension()
+{
+	return m_initialDimension;
+}
+
+void CC3TextureStreamer::setInitialDimension( GLuint dimension )
+{
+	CC3TextureStreamerLock lock( &m_mutex );
+	m_initialDimension = MAX(dimension, 1);
+}
+
+GLuint CC3TextureStreamer::getMaxChangesPerFrame()
+{
+	return m_maxChangesPerFrame;
+}
+
+void CC3TextureStreamer::setMaxChangesPerFrame( GLuint maxChanges )
+{
+	m_maxChangesPerFrame = maxChanges;
+}
+
+GLfloat CC3TextureStreamer::getMipBias()
+{
+	return m_mipBias;
+}
+
+void CC3TextureStreamer::setMipBias( GLfloat bias )
+{
+	m_mipBias = bias;
+}
+
+/** Returns the number of bytes occupied by the mip chain of the residency, starting at the specified level. */
+GLuint CC3TextureStreamer::getBytesOfResidency( const CC3TextureResidency& residency, GLuint level )
+{
+	GLuint byteCount = 0;
+	for ( GLuint lvl = level; lvl < residency.levelCount; lvl++ )
+	{
+		GLuint w = MAX((GLuint)residency.fullSize.width >> lvl, 1);
+		GLuint h = MAX((GLuint)residency.fullSize.height >> lvl, 1);
+		byteCount += w * h * residency.bytesPerPixel;
+		if ( !CC3Texture::shouldGenerateMipmaps() )
+			break;		// Only the base level is resident
+	}
+	return byteCount;
+}
+
+bool CC3TextureStreamer::loadTextureFromFile( CC3Texture* texture, const std::string& filePath )
+{
+	if ( texture->getName().empty() )
+		texture->setName( CC3Texture::textureNameFromFilePath( filePath ) );
+
+	CC3Texture2DContent* content = new CC3Texture2DContent;
+	if ( !content->initFromFile( filePath ) )
+	{
+		content->release();
+		CC3_TRACE( "CC3TextureStreamer could not load texture from file %s", filePath.c_str() );
+		return false;
+	}
+
+	CC3IntSize fullSize = CC3IntSizeMake( (GLint)content->getPixelsWide(), (GLint)content->getPixelsHigh() );
+	bool isStreamable = texture->isTexture2D()
+		&& content->getPixelGLType() == GL_UNSIGNED_BYTE
+		&& (GLuint)fullSize.width == CCNextPOT(fullSize.width)
+		&& (GLuint)fullSize.height == CCNextPOT(fullSize.height);
+
+	if ( !isStreamable )
+	{
+		// Load the complete texture, as if streaming was not enabled
+		texture->bindStreamedContent( content );
+		content->release();
+		return true;
+	}
+
+	// The file has been decoded without holding the lock, which may be held while the scene is drawn
+	CC3TextureStreamerLock lock( &m_mutex );
+
+	CC3TextureResidency residency;
+	residency.filePath = filePath;
+	residency.fullSize = fullSize;
+	residency.bytesPerPixel = content->getBytesPerPixel();
+	residency.levelCount = 1;
+	while ( (fullSize.width >> residency.levelCount) || (fullSize.height >> residency.levelCount) )
+		residency.levelCount++;
+
+	residency.minimumLevel = 0;
+	while ( residency.minimumLevel < residency.levelCount - 1
+		&& MAX(fullSize.width >> residency.minimumLevel, fullSize.height >> residency.minimumLevel) > (GLint)m_initialDimension )
+		residency.minimumLevel++;
+
+	residency.residentLevel = residency.minimumLevel;
+	residency.requestedLevel = residency.minimumLevel;
+	residency.lastDrawnFrame = m_frameCount;
+
+	// Reuse the content just decoded, rather than decoding the file a second time
+	content->downsample( residency.residentLevel );
+	texture->bindStreamedContent( content );
+	content->release();
+
+	removeTexture( texture );
+	m_residencies[texture] = residency;
+	m_residentBytes += getBytesOfResidency( residency, residency.residentLevel );
+	texture->setIsStreamed( true );
+
+	CC3_TRACE( "CC3TextureStreamer streaming %s from level %d of %d (%d x %d)", filePath.c_str(),
+		residency.residentLevel, residency.levelCount, fullSize.width, fullSize.height );
+	return true;
+}
+
+void CC3TextureStreamer::removeTexture( CC3Texture* texture )
+{
+	CC3TextureStreamerLock lock( &m_mutex );
+	CC3TextureResidencies::iterator it = m_residencies.find( texture );
+	if ( it == m_residencies.end() )
+		return;
+
+	m_residentBytes -= getBytesOfResidency( it->second, it->second.residentLevel );
+	m_residencies.erase( it );
+}
+
+/**
+ * Estimates the finest mip level needed to draw the mesh node currently being visited,
+ * by comparing the projected screen size of the node's global bounding box with the
+ * size of the complete texture.
+ */
+GLuint CC3TextureStreamer::levelNeededBy( const CC3TextureResidency& residency, CC3NodeDrawingVisitor* visitor )
+{
+	CC3Camera* cam = visitor->getCamera();
+	CC3MeshNode* aNode = visitor->getCurrentMeshNode();
+	if ( !cam || !aNode || cam->isUsingParallelProjection() )
+		return 0;
+
+	CC3Box gbb = aNode->getGlobalBoundingBox();
+	if ( gbb.isNull() )
+		return 0;
+
+	GLfloat nodeExtent = gbb.getSize().length();
+	GLfloat camDist = cam->getGlobalLocation().distance( gbb.getCenter() );
+	if ( camDist <= nodeExtent )
+		return 0;		// Camera is very close to, or inside, the node
+
+	CC3Viewport vp = cam->getViewport();
+	GLfloat vpExtent = (GLfloat)MAX(vp.w, vp.h);
+	GLfloat halfFOV = CC3DegToRad( cam->getEffectiveFieldOfView() ) * 0.5f;
+	GLfloat screenExtent = (nodeExtent * vpExtent) / (2.0f * camDist * tanf(halfFOV));
+	if ( screenExtent < 1.0f )
+		return residency.levelCount - 1;
+
+	GLfloat texExtent = (GLfloat)MAX(residency.fullSize.width, residency.fullSize.height);
+	GLint level = (GLint)floorf( log2f(texExtent / screenExtent) + m_mipBias );
+	return (GLuint)CLAMP(level, 0, (GLint)residency.levelCount - 1);
+}
+
+void CC3TextureStreamer::textureWasDrawn( CC3Texture* texture, CC3NodeDrawingVisitor* visitor )
+{
+	CC3TextureStreamerLock lock( &m_mutex );
+	CC3TextureResidencies::iterator it = m_residencies.find( texture );
+	if ( it == m_residencies.end() )
+		return;
+
+	CC3TextureResidency& residency = it->second;
+	GLuint level = levelNeededBy( residency, visitor );
+
+	// The first draw in a frame replaces the previous request. Later draws can only refine it.
+	if ( residency.lastDrawnFrame != m_frameCount )
+		residency.requestedLevel = level;
+	else
+		residency.requestedLevel = MIN(residency.requestedLevel, level);
+
+	residency.lastDrawnFrame = m_frameCount;
+}
+
+/** Decodes the texture file again, and re-specifies the GL texture starting at the specified level. */
+bool CC3TextureStreamer::loadTextureLevel( CC3Texture* texture, CC3TextureResidency& residency, GLuint level )
+{
+	CC3Texture2DContent* content = new CC3Texture2DContent;
+	if ( !content->initFromFile( residency.filePath ) )
+	{
+		content->release();
+		CC3_WARNING( "CC3TextureStreamer could not reload texture from file %s", residency.filePath.c_str() );
+		return false;
+	}
+
+	content->downsample( level );
+	texture->bindStreamedContent( content );
+	content->release();
+
+	m_residentBytes -= getBytesOfResidency( residency, residency.residentLevel );
+	residency.residentLevel = level;
+	m_residentBytes += getBytesOfResidency( residency, residency.residentLevel );
+	return true;
+}
+
+/**
+ * Evicts the finest levels of the least-recently-drawn textures until the specified number of
+ * bytes can be added without exceeding the budget. Textures drawn during the current frame, and
+ * the requesting texture, are not evicted. Returns whether enough memory was freed.
+ */
+bool CC3TextureStreamer::evictForBytes( GLuint bytesNeeded, CC3Texture* requestingTexture, GLuint& changeCount )
+{
+	while ( m_residentBytes + bytesNeeded > m_byteBudget )
+	{
+		if ( changeCount >= m_maxChangesPerFrame )
+			return false;
+
+		CC3TextureResidencies::iterator victim = m_residencies.end();
+		for ( CC3TextureResidencies::iterator it = m_residencies.begin(); it != m_residencies.end(); ++it )
+		{
+			CC3TextureResidency& residency = it->second;
+			if ( it->first == requestingTexture || residency.lastDrawnFrame == m_frameCount )
+				continue;
+			if ( residency.residentLevel >= residency.minimumLevel )
+				continue;
+			if ( victim == m_residencies.end() || residency.lastDrawnFrame < victim->second.lastDrawnFrame )
+				victim = it;
+		}
+
+		if ( victim == m_residencies.end() )
+			return false;
+
+		// Drop the victim to the level it last asked for, but by at least one level
+		CC3TextureResidency& residency = victim->second;
+		GLuint level = MAX(residency.residentLevel + 1, residency.requestedLevel);
+		level = MIN(level, residency.minimumLevel);
+		if ( !loadTextureLevel( victim->first, residency, level ) )
+			return false;
+
+		changeCount++;
+	}
+
+	return true;
+}
+
+void CC3TextureStreamer::processFrame()
+{
+	CC3TextureStreamerLock lock( &m_mutex );
+	GLuint changeCount = 0;
+
+	// Promote the textures drawn this frame that need finer levels, finest requests first
+	while ( changeCount < m_maxChangesPerFrame )
+	{
+		CC3TextureResidencies::iterator best = m_residencies.end();
+		GLuint bestGain = 0;
+		for ( CC3TextureResidencies::iterator it = m_residencies.begin(); it != m_residencies.end(); ++it )
+		{
+			CC3TextureResidency& residency = it->second;
+			if ( residency.lastDrawnFrame != m_frameCount || residency.requestedLevel >= residency.residentLevel )
+				continue;
+
+			GLuint gain = residency.residentLevel - residency.requestedLevel;
+			if ( gain > bestGain )
+			{
+				best = it;
+				bestGain = gain;
+			}
+		}
+
+		if ( best == m_residencies.end() )
+			break;
+
+		CC3TextureResidency& residency = best->second;
+		GLuint extraBytes = getBytesOfResidency( residency, residency.requestedLevel )
+			- getBytesOfResidency( residency, residency.residentLevel );
+
+		if ( !evictForBytes( extraBytes, best->first, changeCount ) || changeCount >= m_maxChangesPerFrame )
+		{
+			// Can't make room this frame. Stop asking until the texture is drawn again.
+			residency.requestedLevel = residency.residentLevel;
+			break;
+		}
+
+		if ( loadTextureLevel( best->first, residency, residency.requestedLevel ) )
+			changeCount++;
+		else
+			residency.requestedLevel = residency.residentLevel;
+	}
+
+	// If the budget has been lowered, give back memory held by textures that are not being drawn
+	evictForBytes( 0, NULL, changeCount );
+
+	m_frameCount++;
+}
+
+GLuint CC3TextureStreamer::getResidentBytes()
+{
+	CC3TextureStreamerLock lock( &m_mutex );
+	return m_residentBytes;
+}
+
+GLuint CC3TextureStreamer::getResidentBytesOfTexture( CC3Texture* texture )
+{
+	CC3TextureStreamerLock lock( &m_mutex );
+	CC3TextureResidencies::iterator it = m_residencies.find( texture );
+	if ( it == m_residencies.end() )
+		return 0;
+
+	return getBytesOfResidency( it->second, it->second.residentLevel );
+}
+
+GLuint CC3TextureStreamer::getResidentLevelOfTexture( CC3Texture* texture )
+{
+	CC3TextureStreamerLock lock( &m_mutex );
+	CC3TextureResidencies::iterator it = m_residencies.find( texture );
+	return (it != m_residencies.end()) ? it->second.residentLevel : 0;
+}
+
+CC3IntSize CC3TextureStreamer::getFullSizeOfTexture( CC3Texture* texture )
+{
+	CC3TextureStreamerLock lock( &m_mutex );
+	CC3TextureResidencies::iterator it = m_residencies.find( texture );
+	return (it != m_residencies.end()) ? it->second.fullSize : texture->getSize();
+}
+
+bool CC3TextureStreamer::isStreamingTexture( CC3Texture* texture )
+{
+	CC3TextureStreamerLock lock( &m_mutex );
+	return m_residencies.find( texture ) != m_residencies.end();
+}
+
+std::string CC3TextureStreamer::residencyDescription()
+{
+	CC3TextureStreamerLock lock( &m_mutex );
+	std::string desc = CC3String::stringWithFormat( (char*)"CC3TextureStreamer %d textures, %d of %d bytes resident",
+		(int)m_residencies.size(), m_residentBytes, m_byteBudget );
+
+	for ( CC3TextureResidencies::iterator it = m_residencies.begin(); it != m_residencies.end(); ++it )
+	{
+		CC3TextureResidency& residency = it->second;
+		desc += CC3String::stringWithFormat( (char*)"\n\t%s: level %d of %d (%d x %d), requested %d, %d bytes, last drawn in frame %d",
+			it->first->getName().c_str(), residency.residentLevel, residency.levelCount,
+			MAX(residency.fullSize.width >> residency.residentLevel, 1),
+			MAX(residency.fullSize.height >> residency.residentLevel, 1),
+			residency.requestedLevel, getBytesOfResidency( residency, residency.residentLevel ),
+			residency.lastDrawnFrame );
+	}
+
+	return desc;
+}
+
+NS_COCOS3D_END
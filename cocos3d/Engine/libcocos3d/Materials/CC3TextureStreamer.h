@@ -0,0 +1,213 @@
+/*
+ * Cocos3D-X 1.0.0
+ * Copyright (c) 2014-2015 Jason Wang
+ * http://www.cocos3dx.org/
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * http://en.wikipedia.org/wiki/MIT_License
+ */
+#ifndef _CC3_TEXTURE_STREAMER_H_
+#define _CC3_TEXTURE_STREAMER_H_
+#include <pthread.h>
+
+NS_COCOS3D_BEGIN
+
+/** The streaming state of a single texture managed by CC3TextureStreamer. */
+typedef struct
+{
+	std::string		filePath;			/**< The file from which the texture content is reloaded. */
+	CC3IntSize		fullSize;			/**< The size of mip level zero of the complete texture. */
+	GLuint			bytesPerPixel;		/**< The number of bytes used by each texel. */
+	GLuint			levelCount;			/**< The number of levels in the complete mip chain. */
+	GLuint			residentLevel;		/**< The finest mip level currently held in GL memory. */
+	GLuint			minimumLevel;		/**< The coarsest level the texture is ever reduced to. */
+	GLuint			requestedLevel;		/**< The finest mip level requested during the latest frame. */
+	GLuint			lastDrawnFrame;		/**< The frame in which the texture was last drawn. */
+} CC3TextureResidency;
+
+/**
+ * CC3TextureStreamer keeps the GL memory consumed by 2D textures within a byte budget,
+ * by holding only the part of each mip chain that is actually needed to draw the scene.
+ *
+ * While streaming is enabled (see the class-side isStreamingEnabled property), textures loaded
+ * from files are not uploaded at full resolution. Instead, each texture starts at the first mip
+ * level whose dimensions are no larger than the initialDimension property. Whenever the texture
+ * is drawn, the streamer estimates the screen-space texel density required by the mesh node being
+ * drawn, from the projected size of the node's global bounding box, and records the finest mip
+ * level needed. Once per frame, the processFrame method promotes textures to the finer levels
+ * they have requested, evicting the finest mip levels of the least-recently-drawn textures when
+ * needed to stay within the byteBudget.
+ *
+ * Since OpenGL ES 2.0 does not support restricting the base level of a texture, changing the
+ * residency of a texture re-specifies the GL texture at the size of the new finest level, by
+ * decoding the texture file again and reducing it on the CPU. As a result, the size property of
+ * a streamed CC3Texture reflects its resident size. Use the getFullSizeOfTexture method to
+ * retrieve the size of the complete texture.
+ *
+ * Only 2D textures, whose dimensions are a power-of-two, and whose texels are made of unsigned
+ * bytes, are streamed. All other textures are loaded in full, and are not tracked by the streamer.
+ *
+ * Textures may be loaded by a CC3Backgrounder while the scene is being drawn, so the residencies
+ * are guarded by a mutex. The shared streamer is created when streaming is enabled.
+ */
+class CC3Texture;
+class CC3NodeDrawingVisitor;
+class CC3TextureStreamer : public CCObject
+{
+public:
+	CC3TextureStreamer();
+	~CC3TextureStreamer();
+
+	/** Initializes the mutex guarding the residencies. */
+	void						init();
+
+	/**
+	 * The maximum number of bytes of GL memory that streamed textures may occupy.
+	 *
+	 * Textures are never reduced below their minimum level, so the budget may be exceeded if
+	 * it is too small to hold the minimum levels of all loaded textures.
+	 *
+	 * The initial value of this property is kCC3TextureStreamerDefaultByteBudget.
+	 */
+	GLuint						getByteBudget();
+	void						setByteBudget( GLuint byteBudget );
+
+	/**
+	 * Textures loaded while streaming is enabled start at the first mip level whose width
+	 * and height are no larger than the value of this property. This also determines the
+	 * coarsest level to which a texture will be reduced under memory pressure.
+	 *
+	 * The initial value of this property is kCC3TextureStreamerDefaultInitialDimension.
+	 */
+	GLuint						getInitialDimension();
+	void						setInitialDimension( GLuint dimension );
+
+	/**
+	 * The maximum number of textures whose residency is changed during a single frame.
+	 *
+	 * Each residency change decodes the texture file and uploads it to the GL engine, so
+	 * keeping this value low spreads the cost of streaming across frames.
+	 *
+	 * The initial value of this property is kCC3TextureStreamerDefaultMaxChangesPerFrame.
+	 */
+	GLuint						getMaxChangesPerFrame();
+	void						setMaxChangesPerFrame( GLuint maxChanges );
+
+	/**
+	 * A bias added to the mip level estimated from the screen-space texel density.
+	 *
+	 * Positive values request coarser levels than the estimate, saving memory at the cost of
+	 * sharpness. Negative values request finer levels. The initial value of this property is zero.
+	 */
+	GLfloat						getMipBias();
+	void						setMipBias( GLfloat bias );
+
+	/**
+	 * Loads the specified texture from the specified file, starting at the initial streaming level.
+	 *
+	 * If the texture cannot be streamed, it is loaded in full, and is not tracked by this streamer.
+	 * Returns whether the texture was successfully loaded.
+	 *
+	 * This method is invoked automatically from CC3Texture::loadFromFile while streaming is enabled.
+	 */
+	bool						loadTextureFromFile( CC3Texture* texture, const std::string& filePath );
+
+	/** Stops tracking the specified texture. Invoked automatically when a streamed texture is deallocated. */
+	void						removeTexture( CC3Texture* texture );
+
+	/**
+	 * Notifies this streamer that the specified texture is being drawn by the specified visitor,
+	 * and records the mip level needed to draw the mesh node currently being visited.
+	 *
+	 * This method is invoked automatically when a streamed texture is drawn.
+	 */
+	void						textureWasDrawn( CC3Texture* texture, CC3NodeDrawingVisitor* visitor );
+
+	/**
+	 * Promotes textures to the mip levels requested during the current frame, evicting the finest
+	 * levels of the least-recently-drawn textures to remain within the byte budget.
+	 *
+	 * This method is invoked automatically by CC3Scene once the scene has been drawn.
+	 */
+	void						processFrame();
+
+	/** Returns the total number of bytes of GL memory occupied by all streamed textures. */
+	GLuint						getResidentBytes();
+
+	/** Returns the number of bytes of GL memory occupied by the specified texture, or zero if it is not streamed. */
+	GLuint						getResidentBytesOfTexture( CC3Texture* texture );
+
+	/** Returns the finest mip level of the specified texture that is held in GL memory. */
+	GLuint						getResidentLevelOfTexture( CC3Texture* texture );
+
+	/** Returns the size of mip level zero of the specified texture. */
+	CC3IntSize					getFullSizeOfTexture( CC3Texture* texture );
+
+	/** Returns whether the specified texture is being managed by this streamer. */
+	bool						isStreamingTexture( CC3Texture* texture );
+
+	/** Returns a description of the residency of each streamed texture, for logging. */
+	std::string					residencyDescription();
+
+	/**
+	 * Indicates whether textures loaded from files should be streamed.
+	 *
+	 * The value of this property affects all textures loaded while that value is in effect.
+	 * The initial value of this property is NO.
+	 */
+	static bool					isStreamingEnabled();
+	static void					setIsStreamingEnabled( bool isEnabled );
+
+	/** Returns the singleton streamer instance. */
+	static CC3TextureStreamer*	sharedTextureStreamer();
+
+	/** Releases the singleton streamer instance. */
+	static void					purge();
+
+protected:
+	GLuint						getBytesOfResidency( const CC3TextureResidency& residency, GLuint level );
+	GLuint						levelNeededBy( const CC3TextureResidency& residency, CC3NodeDrawingVisitor* visitor );
+	bool						loadTextureLevel( CC3Texture* texture, CC3TextureResidency& residency, GLuint level );
+	bool						evictForBytes( GLuint bytesNeeded, CC3Texture* requestingTexture, GLuint& changeCount );
+
+protected:
+	typedef std::map<CC3Texture*, CC3TextureResidency> CC3TextureResidencies;
+	pthread_mutex_t				m_mutex;				// Recursive, guards the members below
+	CC3TextureResidencies		m_residencies;
+	GLuint						m_byteBudget;
+	GLuint						m_residentBytes;
+	GLuint						m_initialDimension;
+	GLuint						m_maxChangesPerFrame;
+	GLuint						m_frameCount;
+	GLfloat						m_mipBias;
+};
+
+/** The default value of the byteBudget property of CC3TextureStreamer. */
+#define kCC3TextureStreamerDefaultByteBudget		(64 * 1024 * 1024)
+
+/** The default value of the initialDimension property of CC3TextureStreamer. */
+#define kCC3TextureStreamerDefaultInitialDimension	64
+
+/** The default value of the maxChangesPerFrame property of CC3TextureStreamer. */
+#define kCC3TextureStreamerDefaultMaxChangesPerFrame	2
+
+NS_COCOS3D_END
+
+#endif
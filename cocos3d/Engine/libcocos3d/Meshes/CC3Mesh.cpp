@@ -899,8 +899,10 @@ void CC3Mesh::copyVertices( GLuint vtxCount, GLuint srcIdx, CC3Mesh* srcMesh, GL
 {
 	// If both meshes have the same interleaved content,
 	// the copying can be optimized to a memory copy.
+	// Compressed content is encoded relative to each mesh, and cannot be copied directly.
 	if ((getVertexContentTypes() == srcMesh->getVertexContentTypes()) &&
 		getVertexStride() == srcMesh->getVertexStride() &&
+		!hasCompressedVertexContent() && !srcMesh->hasCompressedVertexContent() &&
 		(shouldInterleaveVertices() && srcMesh->shouldInterleaveVertices())) 
 	{
 		CC3_TRACE("using optimized memory copy");
@@ -926,7 +928,11 @@ void CC3Mesh::copyVertexAt( GLuint srcIdx, CC3Mesh* srcMesh, GLuint dstIdx )
 	if (hasVertexColors()) 
 		setVertexColor4F( srcMesh->getVertexColor4FAt( srcIdx ), dstIdx );
 	if (hasVertexBoneWeights()) 
-		setVertexBoneWeights( srcMesh->getVertexBoneWeightsAt( srcIdx ), dstIdx );
+	{
+		GLuint boneCount = getVertexBoneCount();
+		for (GLuint i = 0; i < boneCount; i++) 
+			setVertexWeight( srcMesh->getVertexWeightForBoneInfluence( i, srcIdx ), i, dstIdx );
+	}
 	if (hasVertexBoneIndices()) 
 		setVertexBoneIndices( srcMesh->getVertexBoneIndicesAt( srcIdx ), dstIdx );
 	if (hasVertexPointSizes()) 
@@ -1359,6 +1365,261 @@ GLuint CC3Mesh::findFirst( GLuint maxHitCount, CC3MeshIntersection* intersection
 	return hitIdx;
 }
 
+/** Returns whether the platform supports vertex attributes containing half-float components. */
+static bool CC3SupportsHalfFloatVertexContent()
+{
+#if CC3_OGLES_2
+	return CCConfiguration::sharedConfiguration()->checkForGLExtension( "GL_OES_vertex_half_float" );
+#else
+	return CCConfiguration::sharedConfiguration()->checkForGLExtension( "GL_ARB_half_float_vertex" );
+#endif
+}
+
+bool CC3Mesh::compressVertexContent()
+{
+	GLuint vtxCount = getVertexCount();
+	if ( !m_vertexLocations || vtxCount == 0 || !m_vertexLocations->getVertices() )
+		return false;
+
+	if ( !m_shouldInterleaveVertices || isUsingGLBuffers() )
+	{
+		CC3_WARNING( "CC3Mesh %s can only compress interleaved vertex content before GL buffers are created", getName().c_str() );
+		return false;
+	}
+
+	// Locations, normals and tangents are only compressed when the default vertex shader will decode them
+	bool shouldCompressGeometry = (m_vertexLocations->getElementType() == GL_FLOAT &&
+								   m_vertexLocations->getElementSize() >= 3 &&
+								   !hasVertexBoneWeights() && !hasVertexPointSizes());
+	bool shouldCompressNormals = (shouldCompressGeometry && m_vertexNormals &&
+								  m_vertexNormals->getElementType() == GL_FLOAT);
+	bool shouldCompressTangents = (shouldCompressGeometry && m_vertexTangents &&
+								   m_vertexTangents->getElementType() == GL_FLOAT);
+	bool shouldCompressWeights = (m_vertexBoneWeights && m_vertexBoneWeights->getElementType() == GL_FLOAT);
+
+	// Texture coordinates that are not compressed are copied verbatim into the new layout.
+	std::vector<CC3VertexTextureCoordinates*> texCoordArrays;
+	std::vector<CC3VertexArray*> copiedArrays;
+	bool canUseHalfFloats = CC3SupportsHalfFloatVertexContent();
+	GLuint tcCount = getTextureCoordinatesArrayCount();
+	for (GLuint tcIdx = 0; tcIdx < tcCount; tcIdx++) 
+	{
+		CC3VertexTextureCoordinates* vtxTexCoords = getTextureCoordinatesForTextureUnit( tcIdx );
+		if ( canUseHalfFloats && vtxTexCoords->getElementType() == GL_FLOAT && vtxTexCoords->getElementSize() == 2 )
+			texCoordArrays.push_back( vtxTexCoords );
+		else
+			copiedArrays.push_back( vtxTexCoords );
+	}
+
+	if ( !(shouldCompressGeometry || shouldCompressWeights || !texCoordArrays.empty()) )
+		return false;
+
+	// Collect the remaining vertex arrays whose content will be copied verbatim.
+	if ( !shouldCompressGeometry ) copiedArrays.push_back( m_vertexLocations );
+	if ( m_vertexNormals && !shouldCompressNormals ) copiedArrays.push_back( m_vertexNormals );
+	if ( m_vertexTangents && !shouldCompressTangents ) copiedArrays.push_back( m_vertexTangents );
+	if ( m_vertexBitangents ) copiedArrays.push_back( m_vertexBitangents );
+	if ( m_vertexColors ) copiedArrays.push_back( m_vertexColors );
+	if ( m_vertexBoneWeights && !shouldCompressWeights ) copiedArrays.push_back( m_vertexBoneWeights );
+	if ( m_vertexBoneIndices ) copiedArrays.push_back( m_vertexBoneIndices );
+	if ( m_vertexPointSizes ) copiedArrays.push_back( m_vertexPointSizes );
+
+	// Extract the current content, since the interleaved layout is about to change.
+	CC3Box quantizationBox = getBoundingBox();
+	GLuint boneCount = getVertexBoneCount();
+	std::vector<CC3Vector> locations, normals, tangents;
+	std::vector<ccTex2F> texCoords;
+	std::vector<GLfloat> weights;
+	std::vector< std::vector<GLubyte> > copiedContent( copiedArrays.size() );
+
+	for (GLuint vtxIdx = 0; vtxIdx < vtxCount; vtxIdx++) 
+	{
+		if ( shouldCompressGeometry ) locations.push_back( m_vertexLocations->getLocationAt( vtxIdx ) );
+		if ( shouldCompressNormals ) normals.push_back( m_vertexNormals->getNormalAt( vtxIdx ) );
+		if ( shouldCompressTangents ) tangents.push_back( m_vertexTangents->getTangentAt( vtxIdx ) );
+		for (GLuint tcIdx = 0; tcIdx < texCoordArrays.size(); tcIdx++)
+			texCoords.push_back( texCoordArrays[tcIdx]->getTexCoord2FAt( vtxIdx ) );
+		if ( shouldCompressWeights )
+			for (GLuint boneIdx = 0; boneIdx < boneCount; boneIdx++)
+				weights.push_back( m_vertexBoneWeights->getWeightForBoneInfluence( boneIdx, vtxIdx ) );
+
+		for (GLuint vaIdx = 0; vaIdx < copiedArrays.size(); vaIdx++) 
+		{
+			GLubyte* elem = (GLubyte*)copiedArrays[vaIdx]->getAddressOfElement( vtxIdx );
+			copiedContent[vaIdx].insert( copiedContent[vaIdx].end(), elem, elem + copiedArrays[vaIdx]->getElementLength() );
+		}
+	}
+
+	// Release the current content, switch to the compressed element formats,
+	// and allocate content for the new, narrower, interleaved layout.
+	GLuint vtxCapacity = MAX(getAllocatedVertexCapacity(), vtxCount);
+	setAllocatedVertexCapacity( 0 );
+
+	if ( shouldCompressGeometry )
+	{
+		// Pad to four components to keep the following vertex content four-byte aligned.
+		m_vertexLocations->setQuantizationBox( quantizationBox );
+		m_vertexLocations->setElementType( GL_UNSIGNED_SHORT );
+		m_vertexLocations->setElementSize( 4 );
+		m_vertexLocations->setShouldNormalizeContent( true );
+	}
+	if ( shouldCompressNormals )
+	{
+		m_vertexNormals->setElementType( GL_SHORT );
+		m_vertexNormals->setElementSize( 2 );
+		m_vertexNormals->setShouldNormalizeContent( true );
+	}
+	if ( shouldCompressTangents )
+	{
+		m_vertexTangents->setElementType( GL_SHORT );
+		m_vertexTangents->setElementSize( 2 );
+		m_vertexTangents->setShouldNormalizeContent( true );
+	}
+	for (GLuint tcIdx = 0; tcIdx < texCoordArrays.size(); tcIdx++)
+		texCoordArrays[tcIdx]->setElementType( GL_HALF_FLOAT );
+	if ( shouldCompressWeights )
+	{
+		m_vertexBoneWeights->setElementType( GL_UNSIGNED_BYTE );
+		m_vertexBoneWeights->setShouldNormalizeContent( true );
+	}
+
+	updateVertexStride();
+	setAllocatedVertexCapacity( vtxCapacity );
+	setVertexCount( vtxCount );
+
+	// Write the content back in the new formats
+	for (GLuint vtxIdx = 0; vtxIdx < vtxCount; vtxIdx++) 
+	{
+		if ( shouldCompressGeometry ) m_vertexLocations->setLocation( locations[vtxIdx], vtxIdx );
+		if ( shouldCompressNormals ) m_vertexNormals->setNormal( normals[vtxIdx], vtxIdx );
+		if ( shouldCompressTangents ) m_vertexTangents->setTangent( tangents[vtxIdx], vtxIdx );
+		for (GLuint tcIdx = 0; tcIdx < texCoordArrays.size(); tcIdx++)
+			texCoordArrays[tcIdx]->setTexCoord2F( texCoords[(vtxIdx * texCoordArrays.size()) + tcIdx], vtxIdx );
+		if ( shouldCompressWeights )
+			for (GLuint boneIdx = 0; boneIdx < boneCount; boneIdx++)
+				m_vertexBoneWeights->setWeight( weights[(vtxIdx * boneCount) + boneIdx], boneIdx, vtxIdx );
+
+		for (GLuint vaIdx = 0; vaIdx < copiedArrays.size(); vaIdx++) 
+		{
+			GLuint elemLen = copiedArrays[vaIdx]->getElementLength();
+			memcpy( copiedArrays[vaIdx]->getAddressOfElement( vtxIdx ), &copiedContent[vaIdx][vtxIdx * elemLen], elemLen );
+		}
+	}
+	m_vertexLocations->markBoundaryDirty();
+
+	CC3_TRACE( "CC3Mesh %s compressed vertex content to %d bytes per vertex", 
+		getName().c_str(), m_vertexLocations->getVertexStride() );
+	return true;
+}
+
+bool CC3Mesh::hasCompressedVertexContent()
+{
+	return m_vertexLocations && m_vertexLocations->isQuantized();
+}
+
+GLfloat CC3Mesh::getAverageCacheMissRatio()
+{
+	if ( !m_vertexIndices || !m_vertexIndices->getVertices() )
+		return 0.0f;
+
+	return m_vertexIndices->getAverageCacheMissRatio( 0, getVertexIndexCount(), kCC3VertexCacheSize );
+}
+
+bool CC3Mesh::optimizeTriangleOrder( GLuint vtxStart, GLuint vtxCount, bool shouldReduceOverdraw )
+{
+	if ( !m_vertexIndices || !m_vertexLocations || getDrawingMode() != GL_TRIANGLES ||
+		 !m_vertexIndices->getVertices() || !m_vertexLocations->getVertices() || isUsingGLBuffers() )
+		return false;
+
+	m_vertexIndices->optimizeForVertexCache( vtxStart, vtxCount, kCC3VertexCacheSize );
+	if ( shouldReduceOverdraw )
+		m_vertexIndices->optimizeForOverdraw( vtxStart, vtxCount, m_vertexLocations, kCC3VertexCacheSize );
+
+	return true;
+}
+
+bool CC3Mesh::optimizeVertexFetchOrder()
+{
+	GLuint vtxCount = getVertexCount();
+	GLuint idxCount = getVertexIndexCount();
+	if ( !m_vertexIndices || !m_vertexLocations || vtxCount == 0 ||
+		 !m_vertexIndices->getVertices() || !m_vertexLocations->getVertices() || isUsingGLBuffers() )
+		return false;
+
+	// Assign each vertex its new position, in order of first reference by the indices
+	std::vector<GLint> newPositions( vtxCount, -1 );
+	GLint nextPos = 0;
+	for (GLuint i = 0; i < idxCount; i++)
+	{
+		GLuint vIdx = m_vertexIndices->getIndexAt( i );
+		if ( vIdx < vtxCount && newPositions[vIdx] < 0 )
+			newPositions[vIdx] = nextPos++;
+	}
+	for (GLuint vIdx = 0; vIdx < vtxCount; vIdx++)
+	{
+		if ( newPositions[vIdx] < 0 )
+			newPositions[vIdx] = nextPos++;
+	}
+
+	// Interleaved content is moved as a whole through the vertex locations
+	std::vector<CC3VertexArray*> vertexArrays;
+	vertexArrays.push_back( m_vertexLocations );
+	if ( !m_shouldInterleaveVertices )
+	{
+		if ( m_vertexNormals ) vertexArrays.push_back( m_vertexNormals );
+		if ( m_vertexTangents ) vertexArrays.push_back( m_vertexTangents );
+		if ( m_vertexBitangents ) vertexArrays.push_back( m_vertexBitangents );
+		if ( m_vertexColors ) vertexArrays.push_back( m_vertexColors );
+		if ( m_vertexBoneIndices ) vertexArrays.push_back( m_vertexBoneIndices );
+		if ( m_vertexBoneWeights ) vertexArrays.push_back( m_vertexBoneWeights );
+		if ( m_vertexPointSizes ) vertexArrays.push_back( m_vertexPointSizes );
+		GLuint tcCount = getTextureCoordinatesArrayCount();
+		for (GLuint tcIdx = 0; tcIdx < tcCount; tcIdx++)
+			vertexArrays.push_back( getTextureCoordinatesForTextureUnit( tcIdx ) );
+	}
+
+	for (GLuint vaIdx = 0; vaIdx < vertexArrays.size(); vaIdx++)
+	{
+		CC3VertexArray* va = vertexArrays[vaIdx];
+		GLubyte* content = (GLubyte*)va->getVertices();
+		if ( !content )
+		{
+			CC3_WARNING( "CC3Mesh %s cannot reorder %s, because its content has been released", 
+				getName().c_str(), va->getName().c_str() );
+			continue;
+		}
+
+		GLuint stride = va->getVertexStride();
+		std::vector<GLubyte> oldContent( content, content + (vtxCount * stride) );
+		for (GLuint vIdx = 0; vIdx < vtxCount; vIdx++)
+			memcpy( content + (newPositions[vIdx] * stride), &oldContent[vIdx * stride], stride );
+	}
+
+	for (GLuint i = 0; i < idxCount; i++)
+	{
+		GLuint vIdx = m_vertexIndices->getIndexAt( i );
+		if ( vIdx < vtxCount )
+			m_vertexIndices->setIndex( newPositions[vIdx], i );
+	}
+
+	return true;
+}
+
+bool CC3Mesh::optimizeVertexOrder( bool shouldReduceOverdraw )
+{
+	CC3_TRACE( "CC3Mesh %s has an ACMR of %.3f before vertex order optimization", 
+		getName().c_str(), getAverageCacheMissRatio() );
+
+	if ( !optimizeTriangleOrder( 0, getVertexIndexCount(), shouldReduceOverdraw ) )
+		return false;
+
+	optimizeVertexFetchOrder();
+
+	CC3_TRACE( "CC3Mesh %s has an ACMR of %.3f after vertex order optimization", 
+		getName().c_str(), getAverageCacheMissRatio() );
+	return true;
+}
+
 /**
  * If the interleavesVertices property is set to NO, creates GL vertex buffer objects for all
  * vertex arrays used by this mesh by invoking createGLBuffer on each contained vertex array.
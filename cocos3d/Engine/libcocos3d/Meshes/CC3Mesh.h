@@ -1437,6 +1437,95 @@ public:
 	GLuint						findFirst( GLuint maxHitCount, CC3MeshIntersection* intersections, 
 		const CC3Ray& aRay, bool acceptBackFaces, bool acceptBehind );
 
+	/**
+	 * Re-encodes the vertex content of this mesh into more compact formats, to reduce the memory
+	 * and bandwidth consumed by each vertex. The vertex content is converted as follows:
+	 *   - Locations are quantized to normalized GL_UNSIGNED_SHORT components, relative to the
+	 *     bounding box of the mesh, with an error of no more than 1/131070 of the box size.
+	 *   - Normals and tangents are octahedral-encoded into two normalized GL_SHORT components,
+	 *     with an angular error of less than 0.01 degrees.
+	 *   - Texture coordinates are converted to GL_HALF_FLOAT, if the platform supports half-float
+	 *     vertex attributes, with a relative error of less than 2^-11.
+	 *   - Bone weights are converted to normalized GL_UNSIGNED_BYTE values, with an error of
+	 *     no more than 1/510.
+	 *
+	 * Locations, normals and tangents are decoded by the CC3TexturableCompressed.vsh vertex shader,
+	 * which is selected automatically by the default shader matcher for compressed meshes. Because
+	 * the vertex shaders used for skinning, point sprites and clip-space drawing expect uncompressed
+	 * locations and normals, locations, normals and tangents are left unchanged in meshes that contain
+	 * bone weights or point sizes. Texture coordinates and bone weights require no special shader
+	 * support, and are compressed in all meshes. Vertex colors, bitangents, bone indices and point
+	 * sizes are not changed.
+	 *
+	 * The vertex content accessor methods of this mesh continue to work after compression, and
+	 * convert to and from the compressed formats automatically. However, since locations are held
+	 * relative to the bounding box of the mesh at the time of compression, locations subsequently
+	 * set outside that box will be clamped to it.
+	 *
+	 * This method must be invoked while the vertex content is interleaved and held in application
+	 * memory, before the createGLBuffers method is invoked, and before the shaders of any mesh node
+	 * using this mesh have been selected. Returns whether any vertex content was compressed.
+	 */
+	bool						compressVertexContent();
+
+	/**
+	 * Returns whether the vertex locations of this mesh have been quantized by the
+	 * compressVertexContent method, and therefore require a decoding vertex shader.
+	 */
+	bool						hasCompressedVertexContent();
+
+	/**
+	 * Returns the average cache miss ratio (ACMR) of this mesh, which is the average number of
+	 * vertices that the GL engine must transform for each triangle drawn, when using a FIFO
+	 * post-transform vertex cache of kCC3VertexCacheSize vertices.
+	 *
+	 * Returns zero if this mesh is not drawn as indexed triangles, or if the vertex indices
+	 * are no longer held in application memory.
+	 */
+	GLfloat						getAverageCacheMissRatio();
+
+	/**
+	 * Reorders the triangles within the specified range of vertex indices to improve the hit rate
+	 * of the GL post-transform vertex cache, and, if shouldReduceOverdraw is YES, then reorders
+	 * clusters of those triangles to reduce overdraw.
+	 *
+	 * The vtxStart and vtxCount parameters are specified in terms of vertex indices. Triangles are
+	 * never moved outside the specified range, which allows skinned meshes to be optimized one skin
+	 * section at a time. See the optimizeForVertexCache and optimizeForOverdraw methods of
+	 * CC3VertexIndices for more information.
+	 *
+	 * Returns whether the triangles were reordered. This method has no effect if this mesh is not
+	 * drawn as indexed triangles, or if the vertex content is no longer held in application memory.
+	 */
+	bool						optimizeTriangleOrder( GLuint vtxStart, GLuint vtxCount, bool shouldReduceOverdraw );
+
+	/**
+	 * Reorders the vertex content of this mesh into the order in which the vertices are first
+	 * referenced by the vertex indices, and updates the vertex indices to match, so that the
+	 * GL engine fetches vertex content from memory sequentially. Vertices that are not referenced
+	 * by any index are moved to the end of the vertex content.
+	 *
+	 * This method should be invoked after the triangles have been reordered by the
+	 * optimizeTriangleOrder method. Returns whether the vertex content was reordered.
+	 */
+	bool						optimizeVertexFetchOrder();
+
+	/**
+	 * Optimizes the order of the triangles of this mesh for the GL post-transform vertex cache
+	 * and, optionally, to reduce overdraw, then reorders the vertex content for sequential fetching,
+	 * by invoking the optimizeTriangleOrder and optimizeVertexFetchOrder methods across all vertex
+	 * indices of this mesh. The average cache miss ratio before and after optimization is logged.
+	 *
+	 * Since triangles may be moved anywhere in the mesh, this method must not be used on meshes that
+	 * are drawn in separately-indexed sections, such as the skin sections of a skinned mesh. Use the
+	 * optimizeVertexOrder method of CC3MeshNode instead, which handles skinned meshes correctly.
+	 *
+	 * This method must be invoked while the vertex content is held in application memory, before
+	 * the createGLBuffers method is invoked, and before any faces of this mesh are cached.
+	 * Returns whether any content was reordered.
+	 */
+	bool						optimizeVertexOrder( bool shouldReduceOverdraw );
+
 	/**
 	 * Convenience method to create GL buffers for all vertex arrays used by this mesh.
 	 *
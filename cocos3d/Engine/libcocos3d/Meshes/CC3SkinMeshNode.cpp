@@ -308,6 +308,26 @@ void CC3SkinMeshNode::drawMeshWithVisitor( CC3NodeDrawingVisitor* visitor )
 	gl->enableMatrixPalette( false );		// We are finished with the matrix pallete so disable it.
 }
 
+void CC3SkinMeshNode::optimizeVertexOrder( bool shouldReduceOverdraw )
+{
+	if ( m_pMesh )
+	{
+		bool wasReordered = false;
+		CCObject* pObj = NULL;
+		CCARRAY_FOREACH( m_skinSections, pObj )
+		{
+			CC3SkinSection* ss = (CC3SkinSection*)pObj;
+			wasReordered |= m_pMesh->optimizeTriangleOrder( ss->getVertexStart(), ss->getVertexCount(), shouldReduceOverdraw );
+		}
+
+		if ( wasReordered )
+			m_pMesh->optimizeVertexFetchOrder();
+	}
+
+	// Skip the CC3MeshNode implementation, which would reorder triangles across skin sections
+	CC3Node::optimizeVertexOrder( shouldReduceOverdraw );
+}
+
 void CC3SkinMeshNode::addShadowVolumesForLight( CC3Light* aLight )
 {
 	super::addShadowVolumesForLight( aLight );
@@ -174,6 +174,12 @@ public:
 	void						markTransformDirty();
 	void						addShadowVolumesForLight( CC3Light* aLight );
 
+	/**
+	 * Overridden to reorder triangles only within each skin section, since each skin section
+	 * draws a fixed range of the vertex indices of the mesh, using its own set of bones.
+	 */
+	void						optimizeVertexOrder( bool shouldReduceOverdraw );
+
 	/**
 	 * Returns a spherical bounding volume that will be sized to encompass the vertices of the
 	 * skin mesh in its bind pose. A sphere is used because for many bone-rigged characters, 
@@ -42,25 +42,34 @@ CC3VertexBoneWeights* CC3VertexBoneWeights::vertexArray()
 
 GLfloat CC3VertexBoneWeights::getWeightForBoneInfluence( GLuint influenceIndex, GLuint vtxIndex )
 {
+	if ( m_elementType == GL_UNSIGNED_BYTE )
+		return ((GLubyte*)getAddressOfElement(vtxIndex))[influenceIndex] * kCC3OneOver255;
+
 	return getBoneWeightsAt(vtxIndex)[influenceIndex];
 }
 
 void CC3VertexBoneWeights::setWeight( GLfloat weight, GLuint influenceIndex, GLuint vtxIndex )
 {
+	if ( m_elementType == GL_UNSIGNED_BYTE )
+	{
+		((GLubyte*)getAddressOfElement(vtxIndex))[influenceIndex] = (GLubyte)roundf(CLAMP(weight, 0.0f, 1.0f) * kCC3MaxGLubyte);
+		return;
+	}
+
 	getBoneWeightsAt(vtxIndex)[influenceIndex] = weight;
 }
 
 GLfloat* CC3VertexBoneWeights::getBoneWeightsAt( GLuint vtxIndex )
 {
+	CCAssert(m_elementType == GL_FLOAT, "CC3VertexBoneWeights getBoneWeightsAt requires GL_FLOAT weights. Use getWeightForBoneInfluence instead.");
 	return (GLfloat*)getAddressOfElement(vtxIndex); 
 }
 
 void CC3VertexBoneWeights::setBoneWeights( GLfloat* weights, GLuint vtxIndex )
 {
-	GLfloat* vtxWeights = getBoneWeightsAt(vtxIndex);
 	GLint numWts = getElementSize();
 	for (int i = 0; i < numWts; i++) 
-		vtxWeights[i] = weights[i];
+		setWeight( weights[i], i, vtxIndex );
 }
 
 std::string CC3VertexBoneWeights::getNameSuffix()
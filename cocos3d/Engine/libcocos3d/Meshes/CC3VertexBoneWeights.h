@@ -66,6 +66,8 @@ public:
 	 *
 	 * If the releaseRedundantContent method has been invoked and the underlying
 	 * vertex content has been released, this method will raise an assertion exception.
+	 *
+	 * If the weights are held as normalized GL_UNSIGNED_BYTE values, they are converted to floats.
 	 */
 	GLfloat						getWeightForBoneInfluence( GLuint influenceIndex, GLuint vtxIndex );
 
@@ -99,6 +101,10 @@ public:
 	 *
 	 * If the releaseRedundantContent method has been invoked and the underlying
 	 * vertex content has been released, this method will raise an assertion exception.
+	 *
+	 * The weights are returned in place, and so this method is only available while the weights
+	 * are held as GL_FLOAT. If the weights have been compressed to normalized GL_UNSIGNED_BYTE
+	 * values by the CC3Mesh compressVertexContent method, use getWeightForBoneInfluence instead.
 	 */
 	GLfloat*					getBoneWeightsAt( GLuint vtxIndex );
 
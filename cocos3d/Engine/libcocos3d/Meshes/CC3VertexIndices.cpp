@@ -28,6 +28,7 @@
  * http://en.wikipedia.org/wiki/MIT_License
  */
 #include "cocos3d.h"
+#include <algorithm>
 
 NS_COCOS3D_BEGIN
 
@@ -80,6 +81,320 @@ CC3FaceIndices CC3VertexIndices::getFaceIndicesAt( GLuint faceIndex )
 							  getIndexAt(idxIndices.vertices[2]));
 }
 
+/** Returns one more than the largest vertex index referenced by the specified range of indices. */
+static GLuint CC3VertexIndicesReferencedVertexCount( CC3VertexIndices* indices, GLuint vtxStart, GLuint vtxCount )
+{
+	GLuint refCount = 0;
+	for (GLuint i = 0; i < vtxCount; i++)
+		refCount = MAX(refCount, indices->getIndexAt(vtxStart + i) + 1);
+	return refCount;
+}
+
+GLfloat CC3VertexIndices::getAverageCacheMissRatio( GLuint vtxStart, GLuint vtxCount, GLuint cacheSize )
+{
+	GLuint triCount = vtxCount / 3;
+	if ( m_drawingMode != GL_TRIANGLES || triCount == 0 || !m_vertices )
+		return 0.0f;
+
+	// A vertex is in the FIFO cache if fewer than cacheSize misses have occurred since it was loaded.
+	std::vector<GLint> loadedAtMiss( CC3VertexIndicesReferencedVertexCount( this, vtxStart, vtxCount ), -1 );
+	GLint missCount = 0;
+	for (GLuint i = 0; i < triCount * 3; i++)
+	{
+		GLuint vIdx = getIndexAt(vtxStart + i);
+		if ( loadedAtMiss[vIdx] < 0 || (missCount - loadedAtMiss[vIdx]) >= (GLint)cacheSize )
+			loadedAtMiss[vIdx] = missCount++;
+	}
+	return (GLfloat)missCount / (GLfloat)triCount;
+}
+
+/** Scoring constants of the Forsyth vertex cache optimization. */
+#define kCC3ForsythCacheDecayPower			1.5f
+#define kCC3ForsythLastTriangleScore		0.75f
+#define kCC3ForsythValenceBoostScale		2.0f
+#define kCC3ForsythValenceBoostPower		0.5f
+
+/**
+ * Returns the score of a vertex at the specified position in the simulated LRU cache
+ * (or -1 if not cached), and used by the specified number of triangles not yet emitted.
+ */
+static GLfloat CC3ForsythVertexScore( GLint cachePosition, GLuint remainingValence, GLuint cacheSize )
+{
+	if ( remainingValence == 0 )
+		return -1.0f;		// No triangles left to draw with this vertex
+
+	GLfloat score = 0.0f;
+	if ( cachePosition >= 0 )
+	{
+		// The vertices of the last triangle drawn get a fixed score, to avoid favouring
+		// strip-like ordering, which is poor for caches larger than a few vertices.
+		if ( cachePosition < 3 )
+			score = kCC3ForsythLastTriangleScore;
+		else
+			score = powf( 1.0f - (GLfloat)(cachePosition - 3) / (GLfloat)(cacheSize - 3), kCC3ForsythCacheDecayPower );
+	}
+
+	// Boost vertices with few triangles remaining, to finish them off and avoid leaving lone triangles behind
+	score += kCC3ForsythValenceBoostScale * powf( (GLfloat)remainingValence, -kCC3ForsythValenceBoostPower );
+	return score;
+}
+
+void CC3VertexIndices::optimizeForVertexCache( GLuint vtxStart, GLuint vtxCount, GLuint cacheSize )
+{
+	GLuint triCount = vtxCount / 3;
+	if ( m_drawingMode != GL_TRIANGLES || triCount < 2 || !m_vertices )
+		return;
+
+	cacheSize = MAX(cacheSize, 4);
+	GLuint refCount = CC3VertexIndicesReferencedVertexCount( this, vtxStart, triCount * 3 );
+
+	// Build the list of triangles that use each vertex, packed into a single array
+	std::vector<GLuint> triVertices( triCount * 3 );
+	std::vector<GLuint> valences( refCount, 0 );
+	for (GLuint i = 0; i < triCount * 3; i++)
+	{
+		triVertices[i] = getIndexAt(vtxStart + i);
+		valences[triVertices[i]]++;
+	}
+
+	std::vector<GLuint> adjacencyStarts( refCount + 1, 0 );
+	for (GLuint vIdx = 0; vIdx < refCount; vIdx++)
+		adjacencyStarts[vIdx + 1] = adjacencyStarts[vIdx] + valences[vIdx];
+
+	std::vector<GLuint> adjacentTris( triCount * 3 );
+	std::vector<GLuint> fillCounts( refCount, 0 );
+	for (GLuint i = 0; i < triCount * 3; i++)
+	{
+		GLuint vIdx = triVertices[i];
+		adjacentTris[adjacencyStarts[vIdx] + fillCounts[vIdx]++] = i / 3;
+	}
+
+	// Initial scores
+	std::vector<GLint> cachePositions( refCount, -1 );
+	std::vector<GLfloat> vertexScores( refCount );
+	for (GLuint vIdx = 0; vIdx < refCount; vIdx++)
+		vertexScores[vIdx] = CC3ForsythVertexScore( -1, valences[vIdx], cacheSize );
+
+	std::vector<GLfloat> triScores( triCount );
+	std::vector<bool> wasEmitted( triCount, false );
+	GLint bestTri = 0;
+	for (GLuint tIdx = 0; tIdx < triCount; tIdx++)
+	{
+		triScores[tIdx] = vertexScores[triVertices[tIdx * 3]] + 
+						  vertexScores[triVertices[tIdx * 3 + 1]] + 
+						  vertexScores[triVertices[tIdx * 3 + 2]];
+		if ( triScores[tIdx] > triScores[bestTri] )
+			bestTri = tIdx;
+	}
+
+	std::vector<GLuint> cache, newCache;
+	cache.reserve( cacheSize + 3 );
+	newCache.reserve( cacheSize + 3 );
+	GLuint nextUnemittedTri = 0;
+
+	for (GLuint emitCount = 0; emitCount < triCount; emitCount++)
+	{
+		// If no cached vertex has any triangles left, continue with the first triangle not yet drawn
+		if ( bestTri < 0 )
+		{
+			while ( wasEmitted[nextUnemittedTri] )
+				nextUnemittedTri++;
+			bestTri = nextUnemittedTri;
+		}
+
+		// Emit the triangle, remove it from the adjacency of its vertices, and
+		// move its vertices to the front of the cache
+		wasEmitted[bestTri] = true;
+		newCache.clear();
+		for (GLuint k = 0; k < 3; k++)
+		{
+			GLuint vIdx = triVertices[bestTri * 3 + k];
+			setIndex( vIdx, vtxStart + (emitCount * 3) + k );
+
+			GLuint* adjTris = &adjacentTris[adjacencyStarts[vIdx]];
+			for (GLuint aIdx = 0; aIdx < valences[vIdx]; aIdx++)
+			{
+				if ( adjTris[aIdx] == (GLuint)bestTri )
+				{
+					adjTris[aIdx] = adjTris[--valences[vIdx]];
+					break;
+				}
+			}
+			if ( std::find( newCache.begin(), newCache.end(), vIdx ) == newCache.end() )
+				newCache.push_back( vIdx );
+		}
+		GLuint triVtxCount = (GLuint)newCache.size();
+		for (GLuint cIdx = 0; cIdx < cache.size(); cIdx++)
+		{
+			if ( std::find( newCache.begin(), newCache.begin() + triVtxCount, cache[cIdx] ) == newCache.begin() + triVtxCount )
+				newCache.push_back( cache[cIdx] );
+		}
+
+		// Rescore every vertex whose cache position or valence changed, including any vertices
+		// that just fell out of the cache, and propagate the change to their remaining triangles.
+		for (GLuint cIdx = 0; cIdx < newCache.size(); cIdx++)
+		{
+			GLuint vIdx = newCache[cIdx];
+			cachePositions[vIdx] = (cIdx < cacheSize) ? (GLint)cIdx : -1;
+			GLfloat newScore = CC3ForsythVertexScore( cachePositions[vIdx], valences[vIdx], cacheSize );
+			GLfloat scoreDelta = newScore - vertexScores[vIdx];
+			vertexScores[vIdx] = newScore;
+
+			GLuint* adjTris = &adjacentTris[adjacencyStarts[vIdx]];
+			for (GLuint aIdx = 0; aIdx < valences[vIdx]; aIdx++)
+				triScores[adjTris[aIdx]] += scoreDelta;
+		}
+		if ( newCache.size() > cacheSize )
+			newCache.resize( cacheSize );
+		cache.swap( newCache );
+
+		// The next triangle is the best scoring triangle that uses a cached vertex
+		bestTri = -1;
+		GLfloat bestScore = -1.0f;
+		for (GLuint cIdx = 0; cIdx < cache.size(); cIdx++)
+		{
+			GLuint vIdx = cache[cIdx];
+			GLuint* adjTris = &adjacentTris[adjacencyStarts[vIdx]];
+			for (GLuint aIdx = 0; aIdx < valences[vIdx]; aIdx++)
+			{
+				if ( triScores[adjTris[aIdx]] > bestScore )
+				{
+					bestScore = triScores[adjTris[aIdx]];
+					bestTri = adjTris[aIdx];
+				}
+			}
+		}
+	}
+}
+
+/** The cache miss ratio, relative to that of the complete range, below which an overdraw cluster may end. */
+#define kCC3OverdrawClusterMissRatioThreshold	1.05f
+
+/** A contiguous run of triangles that is moved as a unit when ordering triangles to reduce overdraw. */
+typedef struct
+{
+	GLuint		firstTri;		/**< The index of the first triangle in the cluster. */
+	GLuint		triCount;		/**< The number of triangles in the cluster. */
+	GLfloat		sortKey;		/**< Clusters with larger keys are drawn first. */
+} CC3OverdrawCluster;
+
+static bool CC3OverdrawClusterDrawsBefore( const CC3OverdrawCluster& c1, const CC3OverdrawCluster& c2 )
+{
+	return c1.sortKey > c2.sortKey;
+}
+
+void CC3VertexIndices::optimizeForOverdraw( GLuint vtxStart, GLuint vtxCount, 
+										    CC3VertexLocations* vertexLocations, GLuint cacheSize )
+{
+	GLuint triCount = vtxCount / 3;
+	if ( m_drawingMode != GL_TRIANGLES || triCount < 2 || !m_vertices || !vertexLocations )
+		return;
+
+	GLfloat overallRatio = getAverageCacheMissRatio( vtxStart, triCount * 3, cacheSize );
+	GLfloat clusterThreshold = overallRatio * kCC3OverdrawClusterMissRatioThreshold;
+
+	// Split the triangles into clusters. Each cluster starts with a flushed cache, and ends where
+	// the cache is naturally flushed (a triangle missing on all three vertices), or as soon as
+	// the miss ratio within the cluster comes within the threshold of the overall ratio.
+	std::vector<GLint> loadedAtMiss( CC3VertexIndicesReferencedVertexCount( this, vtxStart, triCount * 3 ), -1 );
+	std::vector<CC3OverdrawCluster> clusters;
+	CC3OverdrawCluster cluster = { 0, 0, 0.0f };
+	GLint missCount = 0;
+	GLint clusterMissCount = 0;
+	for (GLuint tIdx = 0; tIdx < triCount; tIdx++)
+	{
+		GLuint triMisses = 0;
+		for (GLuint k = 0; k < 3; k++)
+		{
+			GLuint vIdx = getIndexAt(vtxStart + (tIdx * 3) + k);
+			if ( loadedAtMiss[vIdx] < 0 || (missCount - loadedAtMiss[vIdx]) >= (GLint)cacheSize )
+			{
+				loadedAtMiss[vIdx] = missCount++;
+				triMisses++;
+			}
+		}
+
+		if ( triMisses == 3 && cluster.triCount > 0 )
+		{
+			clusters.push_back( cluster );
+			cluster.firstTri = tIdx;
+			cluster.triCount = 0;
+			clusterMissCount = 0;
+		}
+
+		cluster.triCount++;
+		clusterMissCount += triMisses;
+
+		if ( (GLfloat)clusterMissCount / (GLfloat)cluster.triCount <= clusterThreshold )
+		{
+			clusters.push_back( cluster );
+			cluster.firstTri = tIdx + 1;
+			cluster.triCount = 0;
+			clusterMissCount = 0;
+			missCount += cacheSize;			// Flush the simulated cache for the next cluster
+		}
+	}
+	if ( cluster.triCount > 0 )
+		clusters.push_back( cluster );
+
+	if ( clusters.size() < 2 )
+		return;
+
+	// Determine the area-weighted center and normal of each cluster, and the center of the mesh
+	std::vector<CC3Vector> clusterCenters( clusters.size() );
+	std::vector<CC3Vector> clusterNormals( clusters.size() );
+	CC3Vector meshCenter = CC3Vector::kCC3VectorZero;
+	GLfloat meshArea = 0.0f;
+	for (GLuint cIdx = 0; cIdx < clusters.size(); cIdx++)
+	{
+		CC3Vector center = CC3Vector::kCC3VectorZero;
+		CC3Vector normal = CC3Vector::kCC3VectorZero;
+		GLfloat area = 0.0f;
+		for (GLuint tIdx = clusters[cIdx].firstTri; tIdx < clusters[cIdx].firstTri + clusters[cIdx].triCount; tIdx++)
+		{
+			GLuint idxPos = vtxStart + (tIdx * 3);
+			CC3Vector v0 = vertexLocations->getLocationAt( getIndexAt(idxPos) );
+			CC3Vector v1 = vertexLocations->getLocationAt( getIndexAt(idxPos + 1) );
+			CC3Vector v2 = vertexLocations->getLocationAt( getIndexAt(idxPos + 2) );
+			CC3Vector triNormal = (v1 - v0).cross( v2 - v0 );
+			GLfloat triArea = triNormal.length();
+			center += (v0 + v1 + v2) * (triArea / 3.0f);
+			normal += triNormal;
+			area += triArea;
+		}
+		meshCenter += center;
+		meshArea += area;
+		clusterCenters[cIdx] = (area > 0.0f) ? (center / area) : center;
+		clusterNormals[cIdx] = normal;
+	}
+	if ( meshArea > 0.0f )
+		meshCenter /= meshArea;
+
+	// Clusters that face outward from the mesh center are the most likely to occlude other clusters
+	for (GLuint cIdx = 0; cIdx < clusters.size(); cIdx++)
+	{
+		GLfloat normalLen = clusterNormals[cIdx].length();
+		clusters[cIdx].sortKey = (normalLen > 0.0f) 
+									? (clusterCenters[cIdx] - meshCenter).dot( clusterNormals[cIdx] / normalLen ) 
+									: 0.0f;
+	}
+	std::stable_sort( clusters.begin(), clusters.end(), CC3OverdrawClusterDrawsBefore );
+
+	// Rewrite the indices in cluster order
+	std::vector<GLuint> oldIndices( triCount * 3 );
+	for (GLuint i = 0; i < triCount * 3; i++)
+		oldIndices[i] = getIndexAt(vtxStart + i);
+
+	GLuint idxPos = vtxStart;
+	for (GLuint cIdx = 0; cIdx < clusters.size(); cIdx++)
+	{
+		GLuint firstIdx = clusters[cIdx].firstTri * 3;
+		GLuint endIdx = firstIdx + (clusters[cIdx].triCount * 3);
+		for (GLuint i = firstIdx; i < endIdx; i++)
+			setIndex( oldIndices[i], idxPos++ );
+	}
+}
+
 /** Vertex indices are not part of vertex content. */
 void CC3VertexIndices::bindContent( GLvoid* pointer, GLint vaIdx, CC3NodeDrawingVisitor* visitor )
 {
@@ -97,6 +97,53 @@ public:
 	 */
 	CC3FaceIndices				getFaceIndicesAt( GLuint faceIndex );
 
+	/**
+	 * Returns the average cache miss ratio (ACMR) of the triangles drawn by the specified range of
+	 * indices, by simulating a post-transform vertex cache holding the specified number of vertices,
+	 * using a first-in-first-out replacement policy, as found in most mobile GPUs.
+	 *
+	 * The returned value is the number of vertices that must be transformed for each triangle drawn.
+	 * It ranges from 3.0, when no vertex is ever found in the cache, to a theoretical minimum of
+	 * about 0.5 for a very large regular grid of triangles.
+	 *
+	 * The vtxStart and vtxCount parameters are specified in terms of indices, not triangles.
+	 * This method returns zero if the drawingMode property is not GL_TRIANGLES.
+	 */
+	GLfloat						getAverageCacheMissRatio( GLuint vtxStart, GLuint vtxCount, GLuint cacheSize );
+
+	/**
+	 * Reorders the triangles in the specified range of indices to improve the hit rate of the GL
+	 * post-transform vertex cache, using Tom Forsyth's linear-speed vertex cache optimization.
+	 *
+	 * Triangles are emitted greedily, always choosing the triangle whose vertices score highest,
+	 * based on how recently each vertex was used, within a simulated cache of the specified size,
+	 * and on how many triangles still refer to each vertex. The algorithm is not sensitive to the
+	 * exact size of the GPU cache, and the default kCC3VertexCacheSize is suitable for most GPUs.
+	 *
+	 * The set of triangles, and the winding of each triangle, is not changed. Only the order in
+	 * which the triangles are drawn changes. The vtxStart and vtxCount parameters are specified in
+	 * terms of indices, not triangles. This method has no effect if the drawingMode property is not
+	 * GL_TRIANGLES, or if the index content has been released from application memory.
+	 */
+	void						optimizeForVertexCache( GLuint vtxStart, GLuint vtxCount, GLuint cacheSize );
+
+	/**
+	 * Reorders clusters of triangles in the specified range of indices to reduce overdraw, using the
+	 * linear clustering of the Tipsify algorithm, while retaining most of the vertex cache locality
+	 * established by a previous invocation of the optimizeForVertexCache method.
+	 *
+	 * The triangles are split into contiguous clusters, at points where the simulated vertex cache
+	 * is flushed, or where the cache miss ratio of the cluster is already close to that of the
+	 * complete range. The clusters are then sorted so that clusters facing away from the center
+	 * of the specified vertex locations are drawn first, since such clusters are more likely to
+	 * occlude the others, allowing the GPU to reject occluded fragments early.
+	 *
+	 * The vtxStart and vtxCount parameters are specified in terms of indices, not triangles.
+	 * This method has no effect if the drawingMode property is not GL_TRIANGLES.
+	 */
+	void						optimizeForOverdraw( GLuint vtxStart, GLuint vtxCount, 
+													 CC3VertexLocations* vertexLocations, GLuint cacheSize );
+
 	/**
 	 * Convenience method to populate this index array from the specified run-length
 	 * encoded array.
@@ -196,6 +243,12 @@ public:
 	GLenum						defaultSemantic();
 };
 
+/**
+ * The number of vertices held in the simulated post-transform vertex cache used when optimizing
+ * index order, and when measuring the average cache miss ratio of vertex indices.
+ */
+#define kCC3VertexCacheSize			32
+
 NS_COCOS3D_END
 
 #endif
@@ -62,6 +62,22 @@ void CC3VertexLocations::verticesWereChanged()
 		markBoundaryDirty(); 
 }
 
+bool CC3VertexLocations::isQuantized()
+{
+	return m_elementType == GL_UNSIGNED_SHORT;
+}
+
+CC3Box CC3VertexLocations::getQuantizationBox()
+{
+	return m_quantizationBox;
+}
+
+void CC3VertexLocations::setQuantizationBox( const CC3Box& box )
+{
+	m_quantizationBox = box;
+	markBoundaryDirty();
+}
+
 void CC3VertexLocations::setVertexCount( GLuint count )
 {
 	super::setVertexCount( count );
@@ -75,6 +91,7 @@ void CC3VertexLocations::populateFrom( CC3VertexLocations* another )
 	super::populateFrom( another );
 
 	m_firstVertex = another->m_firstVertex;
+	m_quantizationBox = another->m_quantizationBox;
 	m_boundingBox = another->getBoundingBox();
 	m_centerOfGeometry = another->getCenterOfGeometry();
 	m_radius = another->getRadius();
@@ -93,6 +110,16 @@ CCObject* CC3VertexLocations::copyWithZone( CCZone* zone )
 
 CC3Vector CC3VertexLocations::getLocationAt( GLuint index )
 {
+	if ( isQuantized() )
+	{
+		GLushort* q = (GLushort*)getAddressOfElement(index);
+		CC3Vector qMin = m_quantizationBox.minimum;
+		CC3Vector qSize = m_quantizationBox.getSize();
+		return CC3Vector(qMin.x + qSize.x * (q[0] / (GLfloat)kCC3MaxGLushort),
+						 qMin.y + qSize.y * (q[1] / (GLfloat)kCC3MaxGLushort),
+						 (m_elementSize > 2) ? (qMin.z + qSize.z * (q[2] / (GLfloat)kCC3MaxGLushort)) : 0.0f);
+	}
+
 	CC3Vector loc = *(CC3Vector*)getAddressOfElement(index);
 	switch (m_elementSize) 
 	{
@@ -112,6 +139,22 @@ void CC3VertexLocations::setLocation( const CC3Vector& aLocation, GLuint index )
 		return;
 
 	GLvoid* elemAddr = getAddressOfElement(index);
+	if ( isQuantized() )
+	{
+		GLushort* q = (GLushort*)elemAddr;
+		CC3Vector qMin = m_quantizationBox.minimum;
+		CC3Vector qSize = m_quantizationBox.getSize();
+		GLfloat qLoc[3] = { aLocation.x - qMin.x, aLocation.y - qMin.y, aLocation.z - qMin.z };
+		GLfloat qLen[3] = { qSize.x, qSize.y, qSize.z };
+		for (GLint i = 0; i < m_elementSize; i++)
+		{
+			GLfloat frac = (i < 3 && qLen[i] > 0.0f) ? CLAMP(qLoc[i] / qLen[i], 0.0f, 1.0f) : 0.0f;
+			q[i] = (GLushort)roundf(frac * kCC3MaxGLushort);
+		}
+		markBoundaryDirty();
+		return;
+	}
+
 	switch (m_elementSize) {
 		case 2:		// Just store X & Y
 			*(CCPoint*)elemAddr = *(CCPoint*)&aLocation;
@@ -129,6 +172,9 @@ void CC3VertexLocations::setLocation( const CC3Vector& aLocation, GLuint index )
 
 CC3Vector4 CC3VertexLocations::getHomogeneousLocationAt( GLuint index )
 {
+	if ( isQuantized() )
+		return CC3Vector4().fromLocation( getLocationAt(index) );
+
 	CC3Vector4 hLoc = *(CC3Vector4*)getAddressOfElement(index);
 	switch (m_elementSize) {
 		case 2:
@@ -144,6 +190,12 @@ CC3Vector4 CC3VertexLocations::getHomogeneousLocationAt( GLuint index )
 
 void CC3VertexLocations::setHomogeneousLocation( const CC3Vector4& aLocation, GLuint index )
 {
+	if ( isQuantized() )
+	{
+		setLocation( aLocation.cc3Vector(), index );
+		return;
+	}
+
 	GLvoid* elemAddr = getAddressOfElement(index);
 	switch (m_elementSize) {
 		case 2:		// Just store X & Y
@@ -218,7 +270,17 @@ void CC3VertexLocations::buildBoundingBox()
 {
 	// If we don't have vertices, but do have a non-zero vertexCount, raise an assertion
 	CCAssert( !( !m_vertices && m_vertexCount ), "CC3VertexLocations bounding box requested after vertex data have been released");
-	CCAssert(m_elementType == GL_FLOAT, "CC3VertexLocations must have elementType GLFLOAT to build the bounding box");
+	CCAssert(m_elementType == GL_FLOAT || isQuantized(), "CC3VertexLocations must have elementType GLFLOAT to build the bounding box");
+
+	// Quantized locations are decoded by the shader relative to the bounding box,
+	// so the bounding box must remain the box used to quantize them.
+	if ( isQuantized() )
+	{
+		m_boundingBox = m_quantizationBox;
+		m_centerOfGeometry = m_boundingBox.getCenter();
+		m_boundaryIsDirty = false;
+		return;
+	}
 
 	CC3Vector vl, vlMin, vlMax;
 	vl = (m_vertexCount > 0) ?  getLocationAt(0) : CC3Vector::kCC3VectorZero;
@@ -244,7 +306,7 @@ void CC3VertexLocations::buildBoundingBox()
  */
 void CC3VertexLocations::calcRadius()
 {
-	CCAssert(m_elementType == GL_FLOAT, "CC3VertexLocations must have elementType GLFLOAT to calculate mesh radius");
+	CCAssert(m_elementType == GL_FLOAT || isQuantized(), "CC3VertexLocations must have elementType GLFLOAT to calculate mesh radius");
 
 	CC3Vector cog = getCenterOfGeometry();		// Will measure it if necessary
 	if (m_vertices && m_vertexCount) 
@@ -308,6 +370,7 @@ void CC3VertexLocations::initWithTag( GLuint aTag, const std::string& aName )
 		m_firstVertex = 0;
 		m_centerOfGeometry = CC3Vector::kCC3VectorZero;
 		m_boundingBox = CC3Box::kCC3BoxZero;
+		m_quantizationBox = CC3Box::kCC3BoxZero;
 		m_radius = 0.0;
 		markBoundaryDirty();
 	}
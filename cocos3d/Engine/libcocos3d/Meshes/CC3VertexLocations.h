@@ -76,6 +76,28 @@ public:
 	/** Marks the boundary, including bounding box and radius, as dirty, and need of recalculation. */
 	void						markBoundaryDirty();
 
+	/**
+	 * Indicates whether the locations in this array are quantized, and held as normalized
+	 * GL_UNSIGNED_SHORT components, relative to the quantizationBox.
+	 *
+	 * Quantized locations are decoded in the vertex shader using the bounding box uniforms,
+	 * and are established by the CC3Mesh compressVertexContent method.
+	 */
+	bool						isQuantized();
+
+	/**
+	 * The box within which quantized locations are held. Each component of a quantized location
+	 * is stored as the fraction of the distance across this box, in 16 bits.
+	 *
+	 * While the locations are quantized, the boundingBox property returns this box, so that the
+	 * bounding box uniforms used by the shader to decode the locations match the encoding.
+	 * Locations set outside this box are clamped to it.
+	 *
+	 * Setting this property does not re-encode any locations that are already quantized.
+	 */
+	CC3Box						getQuantizationBox();
+	void						setQuantizationBox( const CC3Box& box );
+
 	/**
 	 * Returns the location element at the specified index in the underlying vertex content.
 	 *
@@ -85,6 +107,8 @@ public:
 	 * This implementation takes into consideration the elementSize property. If the value
 	 * of the elementSize property is 2, the returned vector will contain zero in the Z component.
 	 *
+	 * If this array is quantized, the location is decoded relative to the quantizationBox.
+	 *
 	 * If the releaseRedundantContent method has been invoked and the underlying
 	 * vertex content has been released, this method will raise an assertion exception.
 	 */
@@ -102,6 +126,8 @@ public:
 	 * ignored. If the value of the elementSize property is 4, the specified vector will
 	 * be converted to a 4D vector, with the W component set to one, before storing.
 	 * 
+	 * If this array is quantized, the location is clamped to the quantizationBox and encoded.
+	 *
 	 * If the new vertex location changes the bounding box of this instance, and this
 	 * instance is being used by any mesh nodes, be sure to invoke the markBoundingVolumeDirty
 	 * method on all mesh nodes that use this vertex array, to ensure that the boundingVolume
@@ -281,6 +307,7 @@ protected:
 	GLuint						m_firstVertex;
 	CC3Box						m_boundingBox;
 	CC3Vector					m_centerOfGeometry;
+	CC3Box						m_quantizationBox;
 	GLfloat						m_radius;
 	bool						m_boundaryIsDirty : 1;
 	bool						m_radiusIsDirty : 1;
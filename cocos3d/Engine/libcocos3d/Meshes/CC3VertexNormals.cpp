@@ -49,13 +49,27 @@ CC3VertexNormals* CC3VertexNormals::vertexArrayWithName( const std::string& aNam
 	return normals;
 }
 
+bool CC3VertexNormals::isOctahedralEncoded()
+{
+	return m_elementType == GL_SHORT && m_elementSize == 2;
+}
+
 CC3Vector CC3VertexNormals::getNormalAt( GLuint index )
 {
+	if ( isOctahedralEncoded() )
+		return CC3VectorOctahedralDecode( (GLshort*)getAddressOfElement(index) );
+
 	return *(CC3Vector*)getAddressOfElement(index); 
 }
 
 void CC3VertexNormals::setNormal( const CC3Vector& aNormal, GLuint index )
 {
+	if ( isOctahedralEncoded() )
+	{
+		CC3VectorOctahedralEncode( aNormal, (GLshort*)getAddressOfElement(index) );
+		return;
+	}
+
 	*(CC3Vector*)getAddressOfElement(index) = aNormal;
 }
 
@@ -64,6 +78,12 @@ void CC3VertexNormals::flipNormals()
 	GLuint vtxCnt = getVertexCount();
 	for (GLuint vtxIdx = 0; vtxIdx < vtxCnt; vtxIdx++) 
 	{
+		if ( isOctahedralEncoded() )
+		{
+			setNormal( getNormalAt(vtxIdx).negate(), vtxIdx );
+			continue;
+		}
+
 		CC3Vector* pn = (CC3Vector*)getAddressOfElement(vtxIdx);
 		*pn = (*pn).negate();
 	}
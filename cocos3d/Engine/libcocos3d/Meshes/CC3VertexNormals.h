@@ -38,6 +38,15 @@ class CC3VertexNormals : public CC3VertexArray
 public:
 	static CC3VertexNormals*	vertexArray();
 	static CC3VertexNormals*	vertexArrayWithName( const std::string& aName );
+	/**
+	 * Indicates whether the normals in this array are octahedral-encoded, and held as two normalized
+	 * GL_SHORT components, instead of three GL_FLOAT components.
+	 *
+	 * Octahedral-encoded normals are decoded in the vertex shader, and are established by the
+	 * CC3Mesh compressVertexContent method.
+	 */
+	bool						isOctahedralEncoded();
+
 	/**
 	 * Returns the normal element at the specified index in the underlying vertex content.
 	 *
@@ -46,6 +55,8 @@ public:
 	 *
 	 * If the releaseRedundantContent method has been invoked and the underlying
 	 * vertex content has been released, this method will raise an assertion exception.
+	 *
+	 * If the normals are octahedral-encoded, the normal is decoded to a unit vector.
 	 */
 	CC3Vector					getNormalAt( GLuint index );
 
@@ -58,6 +69,8 @@ public:
 	 *
 	 * If the releaseRedundantContent method has been invoked and the underlying
 	 * vertex content has been released, this method will raise an assertion exception.
+	 *
+	 * If the normals are octahedral-encoded, the normal is normalized and encoded.
 	 */
 	void						setNormal( const CC3Vector& aNormal, GLuint index );
 
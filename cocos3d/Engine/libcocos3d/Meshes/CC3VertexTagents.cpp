@@ -40,13 +40,27 @@ CC3VertexTangents* CC3VertexTangents::vertexArray()
 	return tangents;
 }
 
+bool CC3VertexTangents::isOctahedralEncoded()
+{
+	return m_elementType == GL_SHORT && m_elementSize == 2;
+}
+
 CC3Vector CC3VertexTangents::getTangentAt( GLuint index )
 {
+	if ( isOctahedralEncoded() )
+		return CC3VectorOctahedralDecode( (GLshort*)getAddressOfElement(index) );
+
 	return *(CC3Vector*)getAddressOfElement(index); 
 }
 
 void CC3VertexTangents::setTangent( const CC3Vector& aTangent, GLuint index )
 {
+	if ( isOctahedralEncoded() )
+	{
+		CC3VectorOctahedralEncode( aTangent, (GLshort*)getAddressOfElement(index) );
+		return;
+	}
+
 	*(CC3Vector*)getAddressOfElement(index) = aTangent;
 }
 
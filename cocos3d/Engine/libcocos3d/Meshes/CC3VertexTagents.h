@@ -37,6 +37,15 @@ class CC3VertexTangents : public CC3VertexArray
 {
 public:
 	static CC3VertexTangents*	vertexArray();
+	/**
+	 * Indicates whether the tangents in this array are octahedral-encoded, and held as two normalized
+	 * GL_SHORT components, instead of three GL_FLOAT components.
+	 *
+	 * Octahedral-encoded tangents are decoded in the vertex shader, and are established by the
+	 * CC3Mesh compressVertexContent method.
+	 */
+	bool						isOctahedralEncoded();
+
 	/**
 	 * Returns the tangent element at the specified index in the underlying vertex content.
 	 *
@@ -45,6 +54,8 @@ public:
 	 *
 	 * If the releaseRedundantContent method has been invoked and the underlying
 	 * vertex content has been released, this method will raise an assertion exception.
+	 *
+	 * If the tangents are octahedral-encoded, the tangent is decoded to a unit vector.
 	 */
 	CC3Vector					getTangentAt( GLuint index );
 
@@ -57,6 +68,8 @@ public:
 	 *
 	 * If the releaseRedundantContent method has been invoked and the underlying
 	 * vertex content has been released, this method will raise an assertion exception.
+	 *
+	 * If the tangents are octahedral-encoded, the tangent is normalized and encoded.
 	 */
 	void						setTangent( const CC3Vector& aTangent, GLuint index );
 
@@ -119,13 +119,33 @@ void CC3VertexTextureCoordinates::setDefaultExpectsVerticallyFlippedTextures( bo
 	_defaultExpectsVerticallyFlippedTextures = expectsFlipped;
 }
 
+bool CC3VertexTextureCoordinates::hasHalfFloatContent()
+{
+	return m_elementType == GL_HALF_FLOAT;
+}
+
 ccTex2F CC3VertexTextureCoordinates::getTexCoord2FAt( GLuint index )
 {
+	if ( hasHalfFloatContent() )
+	{
+		GLushort* halfTC = (GLushort*)getAddressOfElement(index);
+		ccTex2F tc = { CC3FloatFromHalfFloat(halfTC[0]), CC3FloatFromHalfFloat(halfTC[1]) };
+		return tc;
+	}
+
 	return *(ccTex2F*)getAddressOfElement(index); 
 }
 
 void CC3VertexTextureCoordinates::setTexCoord2F( const ccTex2F& aTex2F, GLuint index )
 {
+	if ( hasHalfFloatContent() )
+	{
+		GLushort* halfTC = (GLushort*)getAddressOfElement(index);
+		halfTC[0] = CC3HalfFloatFromFloat(aTex2F.u);
+		halfTC[1] = CC3HalfFloatFromFloat(aTex2F.v);
+		return;
+	}
+
 	*(ccTex2F*)getAddressOfElement(index) = aTex2F;
 }
 
@@ -159,19 +179,20 @@ void CC3VertexTextureCoordinates::alignWithTextureRectangle( const CCRect& newRe
 	// consideration the mapSize and the new texture rectangle.
 	for (GLuint i = 0; i < m_vertexCount; i++) 
 	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
+		ccTex2F tc = getTexCoord2FAt(i);
 		
-		GLfloat origU = ((ptc->u / mw) - ox) / ow;			// Revert to original value
-		ptc->u = (nx + (origU * nw)) * mw;					// Calc new value
+		GLfloat origU = ((tc.u / mw) - ox) / ow;			// Revert to original value
+		tc.u = (nx + (origU * nw)) * mw;					// Calc new value
 		
 		// Take into consideration whether the texture is flipped.
 		if (m_expectsVerticallyFlippedTextures) {
-			GLfloat origV = (1.0f - (ptc->v / mh) - oy) / oh;	// Revert to original value
-			ptc->v = (1.0f - (ny + (origV * nh))) * mh;			// Calc new value
+			GLfloat origV = (1.0f - (tc.v / mh) - oy) / oh;	// Revert to original value
+			tc.v = (1.0f - (ny + (origV * nh))) * mh;			// Calc new value
 		} else {
-			GLfloat origV = (((ptc->v - hx) / mh) - oy) / oh;	// Revert to original value
-			ptc->v = (ny + (origV * nh)) * mh + hx;				// Calc new value
+			GLfloat origV = (((tc.v - hx) / mh) - oy) / oh;	// Revert to original value
+			tc.v = (ny + (origV * nh)) * mh + hx;				// Calc new value
 		}
+		setTexCoord2F(tc, i);
 	}
 	updateGLBuffer();
 }
@@ -197,9 +218,10 @@ void CC3VertexTextureCoordinates::alignWithTextureCoverage( const CCSize& texCov
 	
 	for (GLuint i = 0; i < m_vertexCount; i++) 
 	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
-		ptc->u *= mapRatio.width;
-		ptc->v = (ptc->v - currVertXln) * mapRatio.height + newVertXln;
+		ccTex2F tc = getTexCoord2FAt(i);
+		tc.u *= mapRatio.width;
+		tc.v = (tc.v - currVertXln) * mapRatio.height + newVertXln;
+		setTexCoord2F(tc, i);
 	}
 	m_mapSize = texCoverage;	// Remember what we've set the map size to
 
@@ -217,9 +239,10 @@ void CC3VertexTextureCoordinates::alignWithInvertedTextureCoverage( const CCSize
 	
 	for (GLuint i = 0; i < m_vertexCount; i++) 
 	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement( i );
-		ptc->u *= mapRatio.width;
-		ptc->v = texCoverage.height - (ptc->v * mapRatio.height);
+		ccTex2F tc = getTexCoord2FAt( i );
+		tc.u *= mapRatio.width;
+		tc.v = texCoverage.height - (tc.v * mapRatio.height);
+		setTexCoord2F(tc, i);
 	}
 
 	// Remember that we've flipped and what we've set the map size to
@@ -255,14 +278,15 @@ void CC3VertexTextureCoordinates::flipVertically()
 	GLfloat maxV = -kCC3MaxGLfloat;
 	for (GLuint i = 0; i < m_vertexCount; i++) 
 	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
-		minV = MIN(ptc->v, minV);
-		maxV = MAX(ptc->v, maxV);
+		ccTex2F tc = getTexCoord2FAt(i);
+		minV = MIN(tc.v, minV);
+		maxV = MAX(tc.v, maxV);
 	}
 	for (GLuint i = 0; i < m_vertexCount; i++) 
 	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
-		ptc->v = minV + maxV - ptc->v;
+		ccTex2F tc = getTexCoord2FAt(i);
+		tc.v = minV + maxV - tc.v;
+		setTexCoord2F(tc, i);
 	}
 	updateGLBuffer();
 }
@@ -273,14 +297,15 @@ void CC3VertexTextureCoordinates::flipHorizontally()
 	GLfloat maxU = -kCC3MaxGLfloat;
 	for (GLuint i = 0; i < m_vertexCount; i++) 
 	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
-		minU = MIN(ptc->u, minU);
-		maxU = MAX(ptc->u, maxU);
+		ccTex2F tc = getTexCoord2FAt(i);
+		minU = MIN(tc.u, minU);
+		maxU = MAX(tc.u, maxU);
 	}
 	for (GLuint i = 0; i < m_vertexCount; i++) 
 	{
-		ccTex2F* ptc = (ccTex2F*)getAddressOfElement(i);
-		ptc->u = minU + maxU - ptc->u;
+		ccTex2F tc = getTexCoord2FAt(i);
+		tc.u = minU + maxU - tc.u;
+		setTexCoord2F(tc, i);
 	}
 
 	updateGLBuffer();
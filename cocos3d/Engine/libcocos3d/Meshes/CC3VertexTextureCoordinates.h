@@ -69,6 +69,15 @@ class CC3VertexTextureCoordinates : public CC3VertexArray
 public:
 	static CC3VertexTextureCoordinates* vertexArray();
 	static CC3VertexTextureCoordinates* vertexArrayWithName( const std::string& aName );
+	/**
+	 * Indicates whether the texture coordinates in this array are held as GL_HALF_FLOAT components.
+	 *
+	 * Half-float texture coordinates are converted to floats by the GL engine when read by the
+	 * shader, and are established by the CC3Mesh compressVertexContent method. The accessor and
+	 * alignment methods of this class convert to and from half-floats automatically.
+	 */
+	bool						hasHalfFloatContent();
+
 	/**
 	 * Returns the texture coordinate element at the specified index in the underlying vertex content.
 	 *
@@ -783,6 +783,22 @@ void CC3MeshNode::createGLBuffers()
 	super::createGLBuffers();
 }
 
+void CC3MeshNode::compressVertexContent()
+{
+	if ( m_pMesh )
+		m_pMesh->compressVertexContent();
+
+	super::compressVertexContent();
+}
+
+void CC3MeshNode::optimizeVertexOrder( bool shouldReduceOverdraw )
+{
+	if ( m_pMesh )
+		m_pMesh->optimizeVertexOrder( shouldReduceOverdraw );
+
+	super::optimizeVertexOrder( shouldReduceOverdraw );
+}
+
 void CC3MeshNode::deleteGLBuffers()
 {
 	if ( m_pMesh )
@@ -2481,6 +2481,8 @@ public:
 	virtual void				initWithTag( GLuint aTag, const std::string& aName );
 	virtual void				populateFrom( CC3MeshNode* another );
 	virtual void				createGLBuffers();
+	virtual void				compressVertexContent();
+	virtual void				optimizeVertexOrder( bool shouldReduceOverdraw );
 	virtual void				deleteGLBuffers();
 	virtual void				releaseRedundantContent();
 	virtual void				retainVertexContent();
@@ -1843,6 +1843,32 @@ void CC3Node::createGLBuffers()
 	}
 }
 
+void CC3Node::compressVertexContent()
+{
+	CCObject* object;
+	CCARRAY_FOREACH( m_pChildren, object )
+	{
+		CC3Node* child = (CC3Node*)object;
+		if ( child )
+		{
+			child->compressVertexContent();
+		}
+	}
+}
+
+void CC3Node::optimizeVertexOrder( bool shouldReduceOverdraw )
+{
+	CCObject* object;
+	CCARRAY_FOREACH( m_pChildren, object )
+	{
+		CC3Node* child = (CC3Node*)object;
+		if ( child )
+		{
+			child->optimizeVertexOrder( shouldReduceOverdraw );
+		}
+	}
+}
+
 void CC3Node::deleteGLBuffers()
 {
 	CCObject* object;
@@ -1697,6 +1697,36 @@ public:
 	 */
 	virtual void				createGLBuffers();
 
+	/**
+	 * Re-encodes the vertex content of the meshes of all descendant nodes into more compact formats,
+	 * to reduce vertex memory and bandwidth. Default behaviour is to invoke the same method on all
+	 * child nodes. Mesh node subclasses will override to compress the vertex content of their mesh.
+	 *
+	 * Invoking this method is optional and is not performed automatically. If used, it should be
+	 * invoked once, after the vertex content has been loaded, and before both the createGLBuffers
+	 * and selectShaders methods are invoked.
+	 *
+	 * See the notes of the CC3Mesh compressVertexContent method for more information about the
+	 * formats used, and the precision retained.
+	 */
+	virtual void				compressVertexContent();
+
+	/**
+	 * Reorders the triangles and vertices of the meshes of all descendant nodes to improve the hit
+	 * rate of the GL post-transform vertex cache and the locality of vertex fetches, and, if
+	 * shouldReduceOverdraw is YES, reorders clusters of triangles to reduce overdraw. Default
+	 * behaviour is to invoke the same method on all child nodes. Mesh node subclasses will
+	 * override to optimize their mesh.
+	 *
+	 * Invoking this method is optional and is performed automatically only for POD resources
+	 * loaded while the CC3PODResource shouldOptimizeVertexOrder property is enabled. If used, it
+	 * should be invoked once, after the vertex content has been loaded, and before the
+	 * createGLBuffers and releaseRedundantContent methods are invoked.
+	 *
+	 * See the notes of the CC3Mesh optimizeVertexOrder method for more information.
+	 */
+	virtual void				optimizeVertexOrder( bool shouldReduceOverdraw );
+
 	/**
 	 * Deletes any OpenGL buffers that were created by any descendant nodes via a prior invocation
 	 * of createGLBuffers. If the descendant nodes also retained the vertex content locally, drawing
@@ -185,7 +185,10 @@ bool CC3NodeDrawingVisitor::processChildrenOf( CC3Node* aNode )
 	bool currSVC = m_shouldVisitChildren;
 	
 	m_shouldVisitChildren = false;	// Don't delve into node hierarchy if using sequencer
-	m_drawingSequencer->visitNodesWithNodeVisitor( this );
+	{
+		CC3_PROFILE_SCOPE( "CC3NodeSequencer::visitNodes" );
+		m_drawingSequencer->visitNodesWithNodeVisitor( this );
+	}
 	
 	// Restore current node and whether children should be visited
 	m_shouldVisitChildren = currSVC;
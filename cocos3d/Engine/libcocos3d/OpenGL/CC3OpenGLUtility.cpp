@@ -456,6 +456,7 @@ size_t CC3GLElementTypeSize(GLenum dataType)
 		case GL_BOOL_VEC4: return sizeof(GLint) * 4;	// Uses glUniform4i or glUniform4f
 			
 		case GL_FLOAT: return sizeof(GLfloat);
+		case GL_HALF_FLOAT: return sizeof(GLushort);
 		case GL_FLOAT_VEC2: return sizeof(GLfloat) * 2;
 		case GL_FLOAT_VEC3: return sizeof(GLfloat) * 3;
 		case GL_FLOAT_VEC4: return sizeof(GLfloat) * 4;
@@ -314,6 +314,13 @@ NS_COCOS3D_BEGIN
 #define GL_PROJECTION                     0x1701
 #endif
 
+
+// Vertex content symbolic constants
+
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT                     0x140B
+#endif
+
 #endif	// CC3_OGL
 
 NS_COCOS3D_END
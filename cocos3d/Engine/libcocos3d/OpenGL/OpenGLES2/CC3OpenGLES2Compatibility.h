@@ -325,6 +325,13 @@ NS_COCOS3D_BEGIN
 #endif
 
 
+// Vertex content symbolic constants
+
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT                     0x8D61		// GL_HALF_FLOAT_OES
+#endif
+
+
 // Android compatibility
 
 #if APPORTABLE
@@ -71,6 +71,8 @@ bool CC3Resource::loadFromFile( const std::string& filePath )
 
 	CC3_TRACE("[rez]--------------------------------------------------");
 	CC3_TRACE("[rez]Loading resource from file '%s'", absFilePath.c_str());
+
+	CC3_PROFILE_SCOPE( "CC3Resource::loadFromFile" );
 	
 	if ( m_sName.c_str() ) 
 		setName( resourceNameFromFilePath( absFilePath ) );
@@ -275,6 +275,8 @@ void CC3Layer::drawSceneWithVisitor( CC3NodeDrawingVisitor* visitor )
 /** Drawing under Cocos2D 3.0 and before. */
 void CC3Layer::draw()
 {
+	// Draw the 2D sprites queued so far before the 3D scene changes the GL state
+	CCAutoBatcher::flushShared();
 	drawSceneWithVisitor( getCC3Scene()->getViewDrawingVisitor() ); 
 }
 
@@ -240,6 +240,8 @@ bool CC3NodeSequencer::remove( CC3Node* aNode, CC3NodeSequencerVisitor* visitor
 
 bool CC3NodeSequencer::updateSequenceWithVisitor( CC3NodeSequencerVisitor* visitor )
 {
+	CC3_PROFILE_SCOPE( "CC3NodeSequencer::updateSequence" );
+
 	identifyMisplacedNodesWithVisitor( visitor );
 	if (visitor->hasMisplacedNodes()) 
 	{
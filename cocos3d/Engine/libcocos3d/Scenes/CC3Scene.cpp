@@ -437,6 +437,8 @@ void CC3Scene::updateScene( float dt )
 	if( !isRunning() )
 		return;
 
+	CC3_PROFILE_SCOPE( "CC3Scene::updateScene" );
+
 	// Clamp the specified interval to a range defined by the minimum and maximum
 	// update intervals. If the maximum update interval limit is zero or negative,
 	// its value is ignored, and the dt value is not limited to a maximum value.
@@ -449,7 +451,10 @@ void CC3Scene::updateScene( float dt )
 	m_pTouchedNodePicker->dispatchPickedNode();
 	
 	m_pUpdateVisitor->setDeltaTime( m_deltaFrameTime );
-	m_pUpdateVisitor->visit( this );
+	{
+		CC3_PROFILE_SCOPE( "CC3Scene::updateNodes" );
+		m_pUpdateVisitor->visit( this );
+	}
 	
 	updateCamera( m_deltaFrameTime );
 	updateBillboards( m_deltaFrameTime );
@@ -490,6 +495,8 @@ void CC3Scene::updateCamera( float dt )
 /** Template method to update shadows cast by the lights. */
 void CC3Scene::updateShadows( float dt )
 {
+	CC3_PROFILE_SCOPE( "CC3Scene::updateShadows" );
+
 	CCObject* obj = NULL;
 	CCARRAY_FOREACH( m_lights, obj )
 	{
@@ -523,6 +530,8 @@ void CC3Scene::drawSceneWithVisitor( CC3NodeDrawingVisitor* visitor )
 {
 	if ( !isVisible() ) 
 		return;
+
+	CC3_PROFILE_SCOPE( "CC3Scene::drawSceneWithVisitor" );
 	
 	// Check and clear any GL error that occurred before 3D code
 	// LogGLErrorState(@"before drawing %@", self);
@@ -540,6 +549,13 @@ void CC3Scene::drawSceneWithVisitor( CC3NodeDrawingVisitor* visitor )
 
 	draw2DBillboardsWithVisitor( visitor );	// Back to 2D now
 
+	// Adjust texture residency to what was needed to draw this frame
+	if ( CC3TextureStreamer::isStreamingEnabled() )
+	{
+		CC3_PROFILE_SCOPE( "CC3TextureStreamer::processFrame" );
+		CC3TextureStreamer::sharedTextureStreamer()->processFrame();
+	}
+
 	// Check and clear any GL error that occurred during 3D code
 	//LogGLErrorState(@"after drawing %@", self);
 	//LogTrace(@"******* %@ exiting drawing visit", self);
@@ -550,7 +566,10 @@ void CC3Scene::drawSceneContentWithVisitor( CC3NodeDrawingVisitor* visitor )
 	illuminateWithVisitor( visitor );		// Light up your world!
 	drawBackdropWithVisitor( visitor );		// Draw the backdrop if it exists
 
-	visitor->visit( this );					// Draw the scene components
+	{
+		CC3_PROFILE_SCOPE( "CC3Scene::drawNodes" );
+		visitor->visit( this );				// Draw the scene components
+	}
 	
 	// Shadows are drawn with a specialized visitor
 	if ( m_pShadowVisitor )
@@ -731,6 +750,8 @@ void CC3Scene::drawShadowsWithVisitor( CC3NodeDrawingVisitor* visitor )
 	if ( !doesContainShadows() )
 		return;
 
+	CC3_PROFILE_SCOPE( "CC3Scene::drawShadows" );
+
 	visitor->getGL()->setClearStencil( 0 );
 	visitor->getRenderSurface()->clearStencilContent();
 
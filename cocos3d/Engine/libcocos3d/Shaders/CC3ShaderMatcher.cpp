@@ -96,6 +96,9 @@ std::string CC3ShaderMatcherBase::vertexShaderFileForMeshNode( CC3MeshNode* aMes
 	if (aMeshNode->isDrawingPointSprites()) 
 		return "CC3PointSprites.vsh";
 		
+	if (aMeshNode->getMesh() && aMeshNode->getMesh()->hasCompressedVertexContent())
+		return "CC3TexturableCompressed.vsh";
+
 	return "CC3Texturable.vsh";
 }
 
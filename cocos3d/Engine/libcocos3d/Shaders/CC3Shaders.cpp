@@ -1028,6 +1028,8 @@ void CC3ShaderProgram::prewarm()
 
 void CC3ShaderProgram::bindWithVisitor( CC3NodeDrawingVisitor* visitor )
 {
+	CC3_PROFILE_SCOPE( "CC3ShaderProgram::bind" );
+
 	CC3OpenGL* gl = visitor->getGL();
 	gl->useShaderProgram( getProgramID() );
 	gl->clearUnboundVertexAttributes();
@@ -1065,6 +1067,7 @@ void CC3ShaderProgram::populateNodeScopeUniformsWithVisitor( CC3NodeDrawingVisit
 
 void CC3ShaderProgram::populateDrawScopeUniformsWithVisitor( CC3NodeDrawingVisitor* visitor )
 {
+	CC3_PROFILE_SCOPE( "CC3ShaderProgram::populateDrawScopeUniforms" );
 	populateUniforms( m_uniformsDrawScope, visitor );
 }
 
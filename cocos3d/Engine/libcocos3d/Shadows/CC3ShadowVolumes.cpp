@@ -682,6 +682,8 @@ bool CC3ShadowVolumeMeshNode::isReadyToUpdate()
  */
 void CC3ShadowVolumeMeshNode::updateShadow()
 {
+	CC3_PROFILE_SCOPE( "CC3ShadowVolumeMeshNode::updateShadow" );
+
 	//LogTrace(@"Testing to update %@ with shadow lag count %i", self, _shadowLagCount);
 	if (isReadyToUpdate())
 	{
@@ -298,4 +298,226 @@ CCObject* CC3PerformanceStatisticsHistogram::copyWithZone( CCZone* zone )
 	return pVal;
 }
 
+#ifdef _WIN32
+#define CC3ProfilerMemoryBarrier()		MemoryBarrier()
+#else
+#define CC3ProfilerMemoryBarrier()		__sync_synchronize()
+#endif
+
+/**
+ * The ring buffer of scopes recorded by a single thread. Only the owning thread writes to the
+ * buffer. The eventCount is published after each event is written, so readers on other threads
+ * can detect, and discard, any events that were overwritten while they were being read.
+ */
+struct CC3ProfileThreadBuffer
+{
+	CC3ProfileEvent				events[kCC3ProfilerEventCapacity];
+	const char*					openNames[kCC3ProfilerMaxDepth];
+	unsigned long long			openStartTimes[kCC3ProfilerMaxDepth];
+	GLuint						depth;
+	volatile GLuint				eventCount;		// Total number of events ever written
+	volatile GLuint				firstEventCount;	// Events before this count were discarded by reset
+	GLuint						threadNumber;
+};
+
+static bool _isProfilingEnabled = false;
+static CC3FrameProfiler* _sharedProfiler = NULL;
+
+CC3FrameProfiler::CC3FrameProfiler()
+{
+	m_startTime = 0;
+}
+
+CC3FrameProfiler::~CC3FrameProfiler()
+{
+	pthread_key_delete( m_threadBufferKey );
+	pthread_mutex_destroy( &m_mutex );
+	for (GLuint i = 0; i < m_threadBuffers.size(); i++)
+		delete m_threadBuffers[i];
+	m_threadBuffers.clear();
+}
+
+void CC3FrameProfiler::init()
+{
+	pthread_key_create( &m_threadBufferKey, NULL );
+	pthread_mutex_init( &m_mutex, NULL );
+	m_startTime = CC3Platform::getCurrentMicroseconds();
+}
+
+CC3ProfileThreadBuffer* CC3FrameProfiler::getThreadBuffer()
+{
+	CC3ProfileThreadBuffer* buffer = (CC3ProfileThreadBuffer*)pthread_getspecific( m_threadBufferKey );
+	if ( buffer )
+		return buffer;
+
+	// First scope on this thread. Thread buffers are retained after their thread exits,
+	// so that the scopes they contain can still be exported.
+	buffer = new CC3ProfileThreadBuffer;
+	buffer->depth = 0;
+	buffer->eventCount = 0;
+	buffer->firstEventCount = 0;
+
+	pthread_mutex_lock( &m_mutex );
+	buffer->threadNumber = (GLuint)m_threadBuffers.size() + 1;
+	m_threadBuffers.push_back( buffer );
+	pthread_mutex_unlock( &m_mutex );
+
+	pthread_setspecific( m_threadBufferKey, buffer );
+	return buffer;
+}
+
+void CC3FrameProfiler::beginScope( const char* name )
+{
+	CC3ProfileThreadBuffer* buffer = getThreadBuffer();
+	if ( buffer->depth < kCC3ProfilerMaxDepth )
+	{
+		buffer->openNames[buffer->depth] = name;
+		buffer->openStartTimes[buffer->depth] = CC3Platform::getCurrentMicroseconds();
+	}
+	buffer->depth++;
+}
+
+void CC3FrameProfiler::endScope()
+{
+	CC3ProfileThreadBuffer* buffer = getThreadBuffer();
+	if ( buffer->depth == 0 )
+		return;
+
+	buffer->depth--;
+	if ( buffer->depth >= kCC3ProfilerMaxDepth )
+		return;
+
+	unsigned long long startTime = buffer->openStartTimes[buffer->depth];
+	CC3ProfileEvent& event = buffer->events[buffer->eventCount & (kCC3ProfilerEventCapacity - 1)];
+	event.name = buffer->openNames[buffer->depth];
+	event.startTime = startTime;
+	event.duration = (GLuint)(CC3Platform::getCurrentMicroseconds() - startTime);
+	event.depth = buffer->depth;
+
+	CC3ProfilerMemoryBarrier();		// Publish the event before the count
+	buffer->eventCount++;
+}
+
+void CC3FrameProfiler::reset()
+{
+	pthread_mutex_lock( &m_mutex );
+	for (GLuint i = 0; i < m_threadBuffers.size(); i++)
+		m_threadBuffers[i]->firstEventCount = m_threadBuffers[i]->eventCount;
+	pthread_mutex_unlock( &m_mutex );
+}
+
+GLuint CC3FrameProfiler::getEventCount()
+{
+	GLuint eventCount = 0;
+	pthread_mutex_lock( &m_mutex );
+	for (GLuint i = 0; i < m_threadBuffers.size(); i++)
+	{
+		CC3ProfileThreadBuffer* buffer = m_threadBuffers[i];
+		eventCount += MIN(buffer->eventCount - buffer->firstEventCount, kCC3ProfilerEventCapacity);
+	}
+	pthread_mutex_unlock( &m_mutex );
+	return eventCount;
+}
+
+/** Appends the specified string to the JSON text, as a quoted and escaped JSON string. */
+static void CC3AppendJSONString( std::string& json, const char* str )
+{
+	json += '"';
+	for (const char* c = str; c && *c; c++)
+	{
+		if ( *c == '"' || *c == '\\' )
+			json += '\\';
+		if ( (unsigned char)*c >= 0x20 )
+			json += *c;
+	}
+	json += '"';
+}
+
+std::string CC3FrameProfiler::exportChromeTrace()
+{
+	std::string json = "{\"traceEvents\":[";
+	bool isFirst = true;
+
+	// The mutex only guards the list of thread buffers. Recording continues while the events are copied.
+	pthread_mutex_lock( &m_mutex );
+	for (GLuint bIdx = 0; bIdx < m_threadBuffers.size(); bIdx++)
+	{
+		CC3ProfileThreadBuffer* buffer = m_threadBuffers[bIdx];
+		GLuint endCount = buffer->eventCount;
+		CC3ProfilerMemoryBarrier();
+		GLuint startCount = MAX(buffer->firstEventCount, (endCount > kCC3ProfilerEventCapacity) ? (endCount - kCC3ProfilerEventCapacity) : 0);
+
+		std::vector<CC3ProfileEvent> events;
+		events.reserve( endCount - startCount );
+		for (GLuint evtCount = startCount; evtCount < endCount; evtCount++)
+			events.push_back( buffer->events[evtCount & (kCC3ProfilerEventCapacity - 1)] );
+
+		// Discard any events that the owning thread overwrote while they were being copied
+		CC3ProfilerMemoryBarrier();
+		GLuint overwrittenCount = buffer->eventCount - endCount;
+		GLuint firstValid = MIN(overwrittenCount, (GLuint)events.size());
+
+		for (GLuint eIdx = firstValid; eIdx < events.size(); eIdx++)
+		{
+			const CC3ProfileEvent& event = events[eIdx];
+			json += isFirst ? "\n" : ",\n";
+			isFirst = false;
+			json += "{\"name\":";
+			CC3AppendJSONString( json, event.name );
+			json += CC3String::stringWithFormat( (char*)",\"cat\":\"cocos3d\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%u,\"pid\":1,\"tid\":%u,\"args\":{\"depth\":%u}}",
+												 event.startTime - m_startTime, event.duration, buffer->threadNumber, event.depth );
+		}
+	}
+	pthread_mutex_unlock( &m_mutex );
+
+	json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return json;
+}
+
+bool CC3FrameProfiler::writeChromeTraceToFile( const std::string& filePath )
+{
+	FILE* file = fopen( filePath.c_str(), "wb" );
+	if ( !file )
+	{
+		CC3_WARNING( "CC3FrameProfiler could not open trace file %s", filePath.c_str() );
+		return false;
+	}
+
+	std::string json = exportChromeTrace();
+	bool wasWritten = (fwrite( json.c_str(), 1, json.length(), file ) == json.length());
+	fclose( file );
+	return wasWritten;
+}
+
+bool CC3FrameProfiler::isEnabled()
+{
+	return _isProfilingEnabled;
+}
+
+void CC3FrameProfiler::setIsEnabled( bool isEnabled )
+{
+	// Create the profiler before any scope can see the enabled flag
+	if ( isEnabled )
+		sharedProfiler();
+	CC3ProfilerMemoryBarrier();
+	_isProfilingEnabled = isEnabled;
+}
+
+CC3FrameProfiler* CC3FrameProfiler::sharedProfiler()
+{
+	if ( !_sharedProfiler )
+	{
+		_sharedProfiler = new CC3FrameProfiler;
+		_sharedProfiler->init();
+	}
+
+	return _sharedProfiler;
+}
+
+void CC3FrameProfiler::purge()
+{
+	_isProfilingEnabled = false;
+	CC_SAFE_RELEASE_NULL( _sharedProfiler );
+}
+
 NS_COCOS3D_END
@@ -29,6 +29,7 @@
  */
 #ifndef _CCL_PERFORMANCE_STATISTICS_H_
 #define _CCL_PERFORMANCE_STATISTICS_H_
+#include <pthread.h>
 
 NS_COCOS3D_BEGIN
 /**
@@ -298,6 +299,142 @@ protected:
 	GLint						m_frameRateHistogram[kCC3RateHistogramSize];
 };
 
+/** The number of timed scopes retained by CC3FrameProfiler for each thread. Must be a power of two. */
+#define kCC3ProfilerEventCapacity		8192
+
+/** The maximum nesting depth of timed scopes within a thread. Deeper scopes are not recorded. */
+#define kCC3ProfilerMaxDepth			32
+
+/** A single timed scope recorded by CC3FrameProfiler. */
+typedef struct
+{
+	const char*			name;			/**< The name of the scope. */
+	unsigned long long	startTime;		/**< The time at which the scope was entered, in microseconds. */
+	GLuint				duration;		/**< The time spent within the scope, in microseconds. */
+	GLuint				depth;			/**< The nesting depth of the scope within its thread. */
+} CC3ProfileEvent;
+
+struct CC3ProfileThreadBuffer;
+
+/**
+ * CC3FrameProfiler records the CPU time spent in nested, named scopes, such as updating the
+ * scene, culling and drawing nodes, sequencing, updating shadow volumes, populating shader
+ * uniforms and loading resources, so that the cause of a slow frame can be identified.
+ *
+ * Scopes are timed using the CC3_PROFILE_SCOPE macro, which times the remainder of the enclosing
+ * C++ block. Each thread records into its own fixed-size ring buffer, which is written only by
+ * that thread, so recording never takes a lock. Once the ring buffer of a thread is full, the
+ * oldest scopes of that thread are overwritten.
+ *
+ * The recorded scopes can be exported in the Chrome trace-event JSON format, which can be viewed
+ * in the chrome://tracing page of the Chrome browser, or in any compatible trace viewer.
+ *
+ * Profiling is disabled initially. While disabled, each CC3_PROFILE_SCOPE costs a single test of
+ * the isEnabled property. While enabled, each scope costs two reads of a high-resolution clock
+ * and a write into the ring buffer, which is low enough to leave profiling enabled in production
+ * builds. Defining CC3_PROFILING_ENABLED to 0 removes all scopes at compile time.
+ */
+class CC3FrameProfiler : public CCObject
+{
+public:
+	CC3FrameProfiler();
+	~CC3FrameProfiler();
+
+	void						init();
+
+	/**
+	 * Marks the start of a timed scope with the specified name on the current thread.
+	 *
+	 * The name is not copied, and must remain valid for the life of this profiler. Usually the
+	 * name is a string literal. Each invocation must be balanced by an invocation of endScope
+	 * on the same thread. Usually, the application will use the CC3_PROFILE_SCOPE macro instead.
+	 */
+	void						beginScope( const char* name );
+
+	/** Marks the end of the most recently begun scope on the current thread, and records it. */
+	void						endScope();
+
+	/**
+	 * Discards all scopes recorded so far, on all threads.
+	 *
+	 * Scopes that are open when this method is invoked are still recorded when they end.
+	 */
+	void						reset();
+
+	/** Returns the number of scopes currently retained, across all threads. */
+	GLuint						getEventCount();
+
+	/** Returns the recorded scopes in Chrome trace-event JSON format. */
+	std::string					exportChromeTrace();
+
+	/**
+	 * Writes the recorded scopes, in Chrome trace-event JSON format, to the file at the specified
+	 * absolute path, and returns whether the file was successfully written.
+	 */
+	bool						writeChromeTraceToFile( const std::string& filePath );
+
+	/**
+	 * Indicates whether scopes are being recorded.
+	 *
+	 * Enabling profiling creates the shared profiler, if needed. The initial value of this property is NO.
+	 */
+	static bool					isEnabled();
+	static void					setIsEnabled( bool isEnabled );
+
+	/** Returns the singleton profiler instance. */
+	static CC3FrameProfiler*	sharedProfiler();
+
+	/** Releases the singleton profiler instance. Profiling should be disabled before invoking this method. */
+	static void					purge();
+
+protected:
+	CC3ProfileThreadBuffer*		getThreadBuffer();
+
+protected:
+	std::vector<CC3ProfileThreadBuffer*> m_threadBuffers;
+	pthread_key_t				m_threadBufferKey;
+	pthread_mutex_t				m_mutex;
+	unsigned long long			m_startTime;
+};
+
+/**
+ * Times the remainder of the enclosing C++ block as a CC3FrameProfiler scope.
+ *
+ * The scope is recorded only if profiling was enabled when the scope was entered.
+ */
+class CC3ProfileScope
+{
+public:
+	CC3ProfileScope( const char* name ) : m_isActive( CC3FrameProfiler::isEnabled() )
+	{
+		if ( m_isActive )
+			CC3FrameProfiler::sharedProfiler()->beginScope( name );
+	}
+
+	~CC3ProfileScope()
+	{
+		if ( m_isActive )
+			CC3FrameProfiler::sharedProfiler()->endScope();
+	}
+
+protected:
+	bool						m_isActive;
+};
+
+#ifndef CC3_PROFILING_ENABLED
+#define CC3_PROFILING_ENABLED			1
+#endif
+
+#define CC3_PROFILE_CONCAT_( a, b )		a##b
+#define CC3_PROFILE_CONCAT( a, b )		CC3_PROFILE_CONCAT_( a, b )
+
+#if CC3_PROFILING_ENABLED
+/** Times the remainder of the enclosing C++ block as a CC3FrameProfiler scope with the specified name. */
+#define CC3_PROFILE_SCOPE( name )		cocos3d::CC3ProfileScope CC3_PROFILE_CONCAT( _cc3ProfileScope, __LINE__ )( name )
+#else
+#define CC3_PROFILE_SCOPE( name )
+#endif
+
 NS_COCOS3D_END
 
 #endif
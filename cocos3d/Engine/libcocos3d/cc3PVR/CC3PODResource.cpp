@@ -31,6 +31,8 @@
 
 NS_COCOS3D_BEGIN
 
+static bool _shouldOptimizeVertexOrder = false;
+
 enum PodResourceNodeType
 {
     kTypeMeshNode       = 1,
@@ -138,9 +140,30 @@ void CC3PODResource::build()
 	buildMeshes();
 	buildNodes();
 	buildSoftBodyNode();
+
+	if ( _shouldOptimizeVertexOrder )
+	{
+		CCObject* pObj = NULL;
+		CCARRAY_FOREACH( getNodes(), pObj )
+		{
+			CC3Node* aNode = (CC3Node*)pObj;
+			aNode->optimizeVertexOrder( false );
+		}
+	}
+
 	deleteCPVRTModelPOD();
 }
 
+bool CC3PODResource::shouldOptimizeVertexOrder()
+{
+	return _shouldOptimizeVertexOrder;
+}
+
+void CC3PODResource::setShouldOptimizeVertexOrder( bool shouldOptimize )
+{
+	_shouldOptimizeVertexOrder = shouldOptimize;
+}
+
 bool CC3PODResource::saveToFile( const std::string& filePath )
 {	
 #pragma _NOTE_TODO( "saveToFile( const std::string& filePath )" )
@@ -187,6 +187,20 @@ public:
 	bool						shouldAutoBuild();
 	void						setShouldAutoBuild( bool autoBuild );
 
+	/**
+	 * Indicates whether the triangles and vertices of the meshes loaded from POD files should be
+	 * reordered for the GL post-transform vertex cache and for sequential vertex fetching, by
+	 * invoking the optimizeVertexOrder method on each node built by the build method.
+	 *
+	 * Overdraw clustering is not applied during loading. To also reduce overdraw, leave this
+	 * property disabled, and invoke the optimizeVertexOrder method on the loaded nodes directly.
+	 *
+	 * The value of this property affects all POD files loaded while that value is in effect.
+	 * The initial value of this property is NO.
+	 */
+	static bool					shouldOptimizeVertexOrder();
+	static void					setShouldOptimizeVertexOrder( bool shouldOptimize );
+
 	/**
 	 * Template method that extracts and builds all components. This is automatically invoked from
 	 * the loadFromFile: method if the POD file was successfully loaded, and the shouldAutoBuild
@@ -199,6 +213,7 @@ public:
 	 *   - mesh models, by invoking the buildMeshes template method
 	 *   - nodes, by invoking the buildNodes template method
 	 *   - a soft body node if needed
+	 *   - the vertex order of all meshes, if the shouldOptimizeVertexOrder property is enabled
 	 *
 	 * This template method can be overridden in a subclass if specialized processing is required.
 	 */
@@ -132,6 +132,7 @@
 #include "Materials/CC3Material.h"
 #include "Materials/CC3STBImage.h"
 #include "Materials/CC3Texture.h"
+#include "Materials/CC3TextureStreamer.h"
 #include "Materials/CC3TextureUnit.h"
 
 /// cc3PVR